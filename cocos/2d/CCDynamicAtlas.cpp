@@ -0,0 +1,590 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCDynamicAtlas.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "renderer/ccGLStateCache.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    // transparent border around each packed image, keeps linear filtering from sampling the neighbours
+    const int PADDING = 2;
+
+    struct PackRect
+    {
+        int x, y, width, height;
+
+        bool contains(const PackRect& other) const
+        {
+            return other.x >= x && other.y >= y
+                && other.x + other.width <= x + width
+                && other.y + other.height <= y + height;
+        }
+
+        bool intersects(const PackRect& other) const
+        {
+            return other.x < x + width && other.x + other.width > x
+                && other.y < y + height && other.y + other.height > y;
+        }
+    };
+
+    // MaxRects bin packer using the best short side fit heuristic
+    class MaxRectsBin
+    {
+    public:
+        void init(int width, int height)
+        {
+            _freeRects.clear();
+            _freeRects.push_back({0, 0, width, height});
+        }
+
+        bool insert(int width, int height, PackRect& result)
+        {
+            int bestShortSide = INT_MAX;
+            int bestLongSide = INT_MAX;
+            const PackRect* best = nullptr;
+
+            for (auto& freeRect : _freeRects)
+            {
+                if (freeRect.width < width || freeRect.height < height)
+                    continue;
+
+                int leftoverHoriz = freeRect.width - width;
+                int leftoverVert = freeRect.height - height;
+                int shortSide = std::min(leftoverHoriz, leftoverVert);
+                int longSide = std::max(leftoverHoriz, leftoverVert);
+                if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide))
+                {
+                    best = &freeRect;
+                    bestShortSide = shortSide;
+                    bestLongSide = longSide;
+                }
+            }
+
+            if (!best)
+                return false;
+
+            result = {best->x, best->y, width, height};
+            place(result);
+            return true;
+        }
+
+        void free(const PackRect& rect)
+        {
+            _freeRects.push_back(rect);
+            prune();
+        }
+
+    private:
+        void place(const PackRect& used)
+        {
+            std::vector<PackRect> split;
+            for (auto it = _freeRects.begin(); it != _freeRects.end(); )
+            {
+                const PackRect freeRect = *it;
+                if (!freeRect.intersects(used))
+                {
+                    ++it;
+                    continue;
+                }
+                it = _freeRects.erase(it);
+
+                // keep the parts of the free rect that lie outside the used one
+                if (used.x > freeRect.x)
+                    split.push_back({freeRect.x, freeRect.y, used.x - freeRect.x, freeRect.height});
+                if (used.x + used.width < freeRect.x + freeRect.width)
+                    split.push_back({used.x + used.width, freeRect.y, freeRect.x + freeRect.width - used.x - used.width, freeRect.height});
+                if (used.y > freeRect.y)
+                    split.push_back({freeRect.x, freeRect.y, freeRect.width, used.y - freeRect.y});
+                if (used.y + used.height < freeRect.y + freeRect.height)
+                    split.push_back({freeRect.x, used.y + used.height, freeRect.width, freeRect.y + freeRect.height - used.y - used.height});
+            }
+            _freeRects.insert(_freeRects.end(), split.begin(), split.end());
+            prune();
+        }
+
+        void prune()
+        {
+            for (size_t i = 0; i < _freeRects.size(); ++i)
+            {
+                for (size_t j = i + 1; j < _freeRects.size(); )
+                {
+                    if (_freeRects[j].contains(_freeRects[i]))
+                    {
+                        _freeRects.erase(_freeRects.begin() + i);
+                        --i;
+                        break;
+                    }
+                    if (_freeRects[i].contains(_freeRects[j]))
+                    {
+                        _freeRects.erase(_freeRects.begin() + j);
+                        continue;
+                    }
+                    ++j;
+                }
+            }
+        }
+
+        std::vector<PackRect> _freeRects;
+    };
+
+    PackRect toPackRect(const Rect& rect)
+    {
+        return {(int)rect.origin.x, (int)rect.origin.y, (int)rect.size.width, (int)rect.size.height};
+    }
+}
+
+struct DynamicAtlas::Page
+{
+    Texture2D* texture;
+    MaxRectsBin bin;
+    // sprite frames and regions
+    int entryCount;
+    GLuint framebuffer;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // CPU copy of the page, used by VolatileTextureMgr to restore it after the GL context is lost
+    Image* image;
+#endif
+};
+
+static DynamicAtlas* s_sharedDynamicAtlas = nullptr;
+
+DynamicAtlas* DynamicAtlas::getInstance()
+{
+    if (!s_sharedDynamicAtlas)
+    {
+        s_sharedDynamicAtlas = new (std::nothrow) DynamicAtlas();
+    }
+    return s_sharedDynamicAtlas;
+}
+
+void DynamicAtlas::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedDynamicAtlas);
+}
+
+DynamicAtlas::DynamicAtlas()
+: _enabled(false)
+, _pageSize(1024)
+, _maxImageSize(256)
+, _regionGeneration(0)
+, _rendererRecreatedListener(nullptr)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the framebuffers are gone with the context, and the restored pages only hold the packed images
+    _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*) {
+        for (auto page : _pages)
+        {
+            page->framebuffer = 0;
+        }
+        ++_regionGeneration;
+    });
+    Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+    // Director::reset removes all the listeners before destroying the atlas
+    _rendererRecreatedListener->retain();
+#endif
+}
+
+DynamicAtlas::~DynamicAtlas()
+{
+    setEnabled(false);
+    removeAllSpriteFrames();
+
+    if (_rendererRecreatedListener)
+    {
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_rendererRecreatedListener);
+        CC_SAFE_RELEASE_NULL(_rendererRecreatedListener);
+    }
+}
+
+void DynamicAtlas::setEnabled(bool enabled)
+{
+    if (_enabled == enabled)
+        return;
+
+    _enabled = enabled;
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (_enabled)
+        scheduler->schedule(CC_SCHEDULE_SELECTOR(DynamicAtlas::tick), this, 1.0f, false);
+    else
+        scheduler->unschedule(CC_SCHEDULE_SELECTOR(DynamicAtlas::tick), this);
+}
+
+Texture2D* DynamicAtlas::getPageTexture(ssize_t index) const
+{
+    CCASSERT(index >= 0 && index < (ssize_t)_pages.size(), "DynamicAtlas: page index out of range");
+    return _pages[index]->texture;
+}
+
+SpriteFrame* DynamicAtlas::getSpriteFrame(const std::string& key) const
+{
+    auto it = _entries.find(key);
+    if (it != _entries.end())
+        return it->second.spriteFrame;
+    return nullptr;
+}
+
+SpriteFrame* DynamicAtlas::addImage(const std::string& filename)
+{
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    if (fullpath.empty())
+        return nullptr;
+
+    SpriteFrame* spriteFrame = getSpriteFrame(fullpath);
+    if (spriteFrame)
+        return spriteFrame;
+
+    Image* image = new (std::nothrow) Image();
+    do
+    {
+        CC_BREAK_IF(!image || !image->initWithImageFile(fullpath, Texture2D::PixelFormat::RGBA8888));
+        // the pages hold premultiplied RGBA8888 pixels
+        CC_BREAK_IF(image->getRenderFormat() != Texture2D::PixelFormat::RGBA8888);
+        CC_BREAK_IF(!image->hasPremultipliedAlpha());
+
+        int width = image->getWidth();
+        int height = image->getHeight();
+        CC_BREAK_IF(width > _maxImageSize || height > _maxImageSize);
+
+        Page* page = nullptr;
+        Rect allocated;
+        CC_BREAK_IF(!allocate(width, height, &page, allocated));
+
+        int x = (int)allocated.origin.x + PADDING;
+        int y = (int)allocated.origin.y + PADDING;
+        page->texture->updateWithData(image->getData(), x, y, width, height);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        unsigned char* pageData = page->image->getData();
+        for (int row = 0; row < height; ++row)
+        {
+            memcpy(pageData + ((y + row) * _pageSize + x) * 4, image->getData() + row * width * 4, width * 4);
+        }
+#endif
+
+        Rect rectInPixels(x, y, width, height);
+        spriteFrame = addEntry(fullpath, page, allocated, rectInPixels, Vec2::ZERO, CC_SIZE_PIXELS_TO_POINTS(rectInPixels.size));
+    } while (0);
+
+    CC_SAFE_RELEASE(image);
+    return spriteFrame;
+}
+
+SpriteFrame* DynamicAtlas::addSpriteFrame(SpriteFrame* spriteFrame, const std::string& key)
+{
+    CCASSERT(spriteFrame, "DynamicAtlas: spriteFrame must not be nullptr");
+
+    SpriteFrame* packed = getSpriteFrame(key);
+    if (packed)
+        return packed;
+
+    Texture2D* texture = spriteFrame->getTexture();
+    if (!texture || spriteFrame->isRotated()
+        || texture->getPixelFormat() != Texture2D::PixelFormat::RGBA8888
+        || !texture->hasPremultipliedAlpha())
+    {
+        return nullptr;
+    }
+
+    const Rect& rect = spriteFrame->getRectInPixels();
+    int width = (int)rect.size.width;
+    int height = (int)rect.size.height;
+    if (width > _maxImageSize || height > _maxImageSize)
+        return nullptr;
+
+    Page* page = nullptr;
+    Rect allocated;
+    if (!allocate(width, height, &page, allocated))
+        return nullptr;
+
+    int x = (int)allocated.origin.x + PADDING;
+    int y = (int)allocated.origin.y + PADDING;
+
+    // copy the rect on the GPU by reading the source texture through a framebuffer
+    GLint oldFBO = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+    GLuint fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->getName(), 0);
+
+    bool copied = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    if (copied)
+    {
+        GL::bindTexture2D(page->texture->getName());
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, x, y, (GLint)rect.origin.x, (GLint)rect.origin.y, width, height);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        unsigned char* pageData = page->image->getData();
+        for (int row = 0; row < height; ++row)
+        {
+            glReadPixels((GLint)rect.origin.x, (GLint)rect.origin.y + row, width, 1, GL_RGBA, GL_UNSIGNED_BYTE,
+                         pageData + ((y + row) * _pageSize + x) * 4);
+        }
+#endif
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+    glDeleteFramebuffers(1, &fbo);
+
+    if (!copied)
+    {
+        CCLOG("cocos2d: DynamicAtlas: can't read the texture of sprite frame %s", key.c_str());
+        page->bin.free(toPackRect(allocated));
+        if (page->entryCount == 0)
+        {
+            releasePage(page);
+            _pages.erase(std::find(_pages.begin(), _pages.end(), page));
+        }
+        return nullptr;
+    }
+
+    return addEntry(key, page, allocated, Rect(x, y, width, height), spriteFrame->getOffset(), spriteFrame->getOriginalSize());
+}
+
+bool DynamicAtlas::allocate(int width, int height, Page** page, Rect& allocated)
+{
+    int paddedWidth = width + PADDING * 2;
+    int paddedHeight = height + PADDING * 2;
+    if (paddedWidth > _pageSize || paddedHeight > _pageSize)
+        return false;
+
+    PackRect result;
+    for (auto candidate : _pages)
+    {
+        if (candidate->bin.insert(paddedWidth, paddedHeight, result))
+        {
+            *page = candidate;
+            allocated.setRect(result.x, result.y, result.width, result.height);
+            return true;
+        }
+    }
+
+    Page* newPage = createPage();
+    if (!newPage || !newPage->bin.insert(paddedWidth, paddedHeight, result))
+    {
+        if (newPage)
+            releasePage(newPage);
+        return false;
+    }
+
+    _pages.push_back(newPage);
+    *page = newPage;
+    allocated.setRect(result.x, result.y, result.width, result.height);
+    return true;
+}
+
+DynamicAtlas::Page* DynamicAtlas::createPage()
+{
+    ssize_t dataLen = _pageSize * _pageSize * 4;
+    unsigned char* data = (unsigned char*)calloc(dataLen, 1);
+    if (!data)
+        return nullptr;
+
+    Page* page = nullptr;
+    Image* image = new (std::nothrow) Image();
+    Texture2D* texture = new (std::nothrow) Texture2D();
+    do
+    {
+        CC_BREAK_IF(!image || !image->initWithRawData(data, dataLen, _pageSize, _pageSize, 8, true));
+        CC_BREAK_IF(!texture || !texture->initWithImage(image, Texture2D::PixelFormat::RGBA8888));
+
+        page = new (std::nothrow) Page();
+        page->texture = texture;
+        page->bin.init(_pageSize, _pageSize);
+        page->entryCount = 0;
+        page->framebuffer = 0;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        VolatileTextureMgr::addImage(texture, image);
+        page->image = image;
+        image->retain();
+#endif
+        texture = nullptr;
+    } while (0);
+
+    free(data);
+    CC_SAFE_RELEASE(image);
+    CC_SAFE_RELEASE(texture);
+    return page;
+}
+
+void DynamicAtlas::releasePage(Page* page)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    CC_SAFE_RELEASE(page->image);
+#endif
+    if (page->framebuffer)
+    {
+        glDeleteFramebuffers(1, &page->framebuffer);
+    }
+    // sprites still using the page keep its texture alive
+    page->texture->release();
+    delete page;
+}
+
+SpriteFrame* DynamicAtlas::addEntry(const std::string& key, Page* page, const Rect& allocated, const Rect& rectInPixels,
+                                    const Vec2& offset, const Size& originalSize)
+{
+    SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(page->texture, CC_RECT_PIXELS_TO_POINTS(rectInPixels),
+                                                              false, offset, originalSize);
+    spriteFrame->retain();
+
+    Entry entry;
+    entry.spriteFrame = spriteFrame;
+    entry.page = page;
+    entry.allocated = allocated;
+    _entries[key] = entry;
+    ++page->entryCount;
+
+    return spriteFrame;
+}
+
+void DynamicAtlas::removeUnusedSpriteFrames()
+{
+    for (auto it = _entries.begin(); it != _entries.end(); )
+    {
+        Entry& entry = it->second;
+        if (entry.spriteFrame->getReferenceCount() == 1)
+        {
+            entry.page->bin.free(toPackRect(entry.allocated));
+            --entry.page->entryCount;
+            entry.spriteFrame->release();
+            it = _entries.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (auto it = _pages.begin(); it != _pages.end(); )
+    {
+        if ((*it)->entryCount == 0)
+        {
+            releasePage(*it);
+            it = _pages.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void DynamicAtlas::removeAllSpriteFrames()
+{
+    for (auto& item : _entries)
+    {
+        item.second.spriteFrame->release();
+    }
+    _entries.clear();
+
+    for (auto page : _pages)
+    {
+        releasePage(page);
+    }
+    _pages.clear();
+}
+
+DynamicAtlas::Page* DynamicAtlas::findPage(Texture2D* texture) const
+{
+    for (auto page : _pages)
+    {
+        if (page->texture == texture)
+            return page;
+    }
+    return nullptr;
+}
+
+Texture2D* DynamicAtlas::allocateRegion(int width, int height, Rect& rectInPixels)
+{
+    Page* page = nullptr;
+    Rect allocated;
+    if (!allocate(width, height, &page, allocated))
+        return nullptr;
+
+    ++page->entryCount;
+    rectInPixels.setRect(allocated.origin.x + PADDING, allocated.origin.y + PADDING, width, height);
+    return page->texture;
+}
+
+void DynamicAtlas::releaseRegion(Texture2D* texture, const Rect& rectInPixels)
+{
+    auto page = findPage(texture);
+    if (!page)
+        return;
+
+    Rect allocated(rectInPixels.origin.x - PADDING, rectInPixels.origin.y - PADDING,
+                   rectInPixels.size.width + PADDING * 2, rectInPixels.size.height + PADDING * 2);
+    page->bin.free(toPackRect(allocated));
+    if (--page->entryCount == 0)
+    {
+        releasePage(page);
+        _pages.erase(std::find(_pages.begin(), _pages.end(), page));
+    }
+}
+
+GLuint DynamicAtlas::getPageFramebuffer(Texture2D* texture)
+{
+    auto page = findPage(texture);
+    if (!page)
+        return 0;
+
+    if (!page->framebuffer)
+    {
+        GLint oldFBO = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+        glGenFramebuffers(1, &page->framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, page->framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture->getName(), 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            CCLOG("cocos2d: DynamicAtlas: can't render into a page");
+            glDeleteFramebuffers(1, &page->framebuffer);
+            page->framebuffer = 0;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+    }
+    return page->framebuffer;
+}
+
+void DynamicAtlas::tick(float dt)
+{
+    removeUnusedSpriteFrames();
+}
+
+NS_CC_END
@@ -0,0 +1,166 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCDYNAMICATLAS_H__
+#define __CCDYNAMICATLAS_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "base/CCRef.h"
+#include "2d/CCSpriteFrame.h"
+#include "platform/CCGL.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+class Image;
+class EventListenerCustom;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class DynamicAtlas
+ * @brief Singleton that packs small images and sprite frames into shared texture pages at runtime.
+ *
+ * Sprites created from loose files each own a texture, so the renderer can not batch them.
+ * When the dynamic atlas is enabled, Sprite::initWithFile() places images that are small enough
+ * into a page with a MaxRects packer and uses a SpriteFrame of the page instead,
+ * so sprites sharing a page are drawn with a single draw call.
+ *
+ * Frames that are only referenced by the atlas are released periodically and their space is
+ * reused by later insertions; a page is destroyed once all of its frames are released.
+ *
+ * Regions of the pages can also be reserved for pixels rendered on the GPU, such as the effects baked by Label.
+ */
+class CC_DLL DynamicAtlas : public Ref
+{
+public:
+    /** Returns the shared instance of the dynamic atlas. */
+    static DynamicAtlas* getInstance();
+
+    /** Destroys the shared instance and releases all the pages. */
+    static void destroyInstance();
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~DynamicAtlas();
+
+    /** Enables or disables packing of images loaded by Sprite::initWithFile(). Disabled by default. */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /** Sets the width and height in pixels of pages created from now on. Default is 1024. */
+    void setPageSize(int size) { _pageSize = size; }
+    int getPageSize() const { return _pageSize; }
+
+    /** Sets the largest width or height in pixels of an image that is packed. Default is 256. */
+    void setMaxImageSize(int size) { _maxImageSize = size; }
+    int getMaxImageSize() const { return _maxImageSize; }
+
+    /** Returns a SpriteFrame of an atlas page holding the image file.
+     * The image is loaded and packed the first time it is requested.
+     * @return nullptr if the image is too large or its format can not be packed.
+     */
+    SpriteFrame* addImage(const std::string& filename);
+
+    /** Copies the rect of a sprite frame into an atlas page and returns a SpriteFrame of the page.
+     * Only RGBA8888 frames that are not rotated can be packed.
+     * @param key The key used to look up the packed frame again.
+     * @return nullptr if the frame can not be packed.
+     */
+    SpriteFrame* addSpriteFrame(SpriteFrame* spriteFrame, const std::string& key);
+
+    /** Returns a packed SpriteFrame given its key, nullptr if it is not in the atlas. */
+    SpriteFrame* getSpriteFrame(const std::string& key) const;
+
+    /** Releases the frames only referenced by the atlas, freeing their space in the pages.
+     * Called once per second by the scheduler while the atlas is enabled.
+     */
+    void removeUnusedSpriteFrames();
+
+    /** Releases all the frames and pages. */
+    void removeAllSpriteFrames();
+
+    /** Returns the number of pages. */
+    ssize_t getPageCount() const { return _pages.size(); }
+
+    /** Returns the texture of a page. */
+    Texture2D* getPageTexture(ssize_t index) const;
+
+    /** Reserves an empty rect of a page for pixels rendered into it with getPageFramebuffer.
+     * Regions are available whether or not the atlas is enabled, and stay reserved until releaseRegion.
+     * @param rectInPixels Set to the rect of the region in the page.
+     * @return The texture of the page, nullptr if the region does not fit in a page.
+     */
+    Texture2D* allocateRegion(int width, int height, Rect& rectInPixels);
+
+    /** Frees a region reserved with allocateRegion. */
+    void releaseRegion(Texture2D* texture, const Rect& rectInPixels);
+
+    /** Returns a framebuffer rendering into the page of texture, created on first use. 0 if texture is not a page. */
+    GLuint getPageFramebuffer(Texture2D* texture);
+
+    /** Incremented when the GL context is recreated, the pixels rendered into the regions must then be rendered again. */
+    unsigned int getRegionGeneration() const { return _regionGeneration; }
+
+protected:
+    struct Page;
+    struct Entry
+    {
+        SpriteFrame* spriteFrame;
+        Page* page;
+        Rect allocated;
+    };
+
+    DynamicAtlas();
+
+    bool allocate(int width, int height, Page** page, Rect& allocated);
+    Page* createPage();
+    void releasePage(Page* page);
+    Page* findPage(Texture2D* texture) const;
+    SpriteFrame* addEntry(const std::string& key, Page* page, const Rect& allocated, const Rect& rectInPixels,
+                          const Vec2& offset, const Size& originalSize);
+    void tick(float dt);
+
+    bool _enabled;
+    int _pageSize;
+    int _maxImageSize;
+    std::vector<Page*> _pages;
+    std::unordered_map<std::string, Entry> _entries;
+    unsigned int _regionGeneration;
+    EventListenerCustom* _rendererRecreatedListener;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCDYNAMICATLAS_H__
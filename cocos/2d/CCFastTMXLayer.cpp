@@ -47,6 +47,17 @@ const int TMXLayer::FAST_TMX_ORIENTATION_ORTHO = 0;
 const int TMXLayer::FAST_TMX_ORIENTATION_HEX = 1;
 const int TMXLayer::FAST_TMX_ORIENTATION_ISO = 2;
 
+// 4 vertices per tile, the quads of a full chunk are addressed with 16 bit indices
+const int TMXLayer::CHUNK_SIZE = 32;
+
+TMXLayer::Chunk::Chunk()
+: populated(false)
+, dirty(false)
+, vertexBuffer(nullptr)
+, vertexData(nullptr)
+{
+}
+
 // FastTMXLayer - init & alloc & dealloc
 TMXLayer * TMXLayer::create(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo)
 {
@@ -93,6 +104,7 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
     this->setContentSize(CC_SIZE_PIXELS_TO_POINTS(Size(_layerSize.width * _mapTileSize.width, _layerSize.height * _mapTileSize.height)));
 
     this->tileToNodeTransform();
+    this->setupChunks();
 
     // shader, and other stuff
     setGLProgram(GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR));
@@ -115,8 +127,8 @@ TMXLayer::TMXLayer()
 , _useAutomaticVertexZ(false)
 , _quadsDirty(true)
 , _dirty(true)
-, _vertexBuffer(nullptr)
-, _vData(nullptr)
+, _chunksWide(0)
+, _chunksHigh(0)
 , _indexBuffer(nullptr)
 {
 }
@@ -126,17 +138,26 @@ TMXLayer::~TMXLayer()
     CC_SAFE_RELEASE(_tileSet);
     CC_SAFE_RELEASE(_texture);
     CC_SAFE_DELETE_ARRAY(_tiles);
-    CC_SAFE_RELEASE(_vData);
-    CC_SAFE_RELEASE(_vertexBuffer);
+    for (auto& chunk : _chunks)
+    {
+        releaseChunk(chunk);
+    }
     CC_SAFE_RELEASE(_indexBuffer);
 
 }
 
 void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
 {
-    updateTotalQuads();
+    if (_quadsDirty)
+    {
+        for (auto& chunk : _chunks)
+        {
+            chunk.dirty = true;
+        }
+        _quadsDirty = false;
+    }
 
-    if( flags != 0 || _dirty || _quadsDirty )
+    if( flags != 0 || _dirty )
     {
         Size s = Director::getInstance()->getVisibleSize();
         auto rect = Rect(0, 0, s.width, s.height);
@@ -145,25 +166,36 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         inv.inverse();
         rect = RectApplyTransform(rect, inv);
 
-        updateTiles(rect);
-        updateIndexBuffer();
-        updatePrimitives();
+        updateVisibleChunks(rect);
         _dirty = false;
     }
 
-    if(_renderCommands.size() < static_cast<size_t>(_primitives.size()))
+    size_t commandCount = 0;
+    for (int chunkIndex : _visibleChunks)
+    {
+        auto& chunk = _chunks[chunkIndex];
+        if (!chunk.populated || chunk.dirty)
+        {
+            populateChunk(chunk, chunkIndex % _chunksWide, chunkIndex / _chunksWide);
+        }
+        commandCount += chunk.primitives.size();
+    }
+
+    // the commands of the previous frame are already rendered
+    if(_renderCommands.size() < commandCount)
     {
-        _renderCommands.resize(_primitives.size());
+        _renderCommands.resize(commandCount);
     }
 
+    auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
     int index = 0;
-    for(const auto& iter : _primitives)
+    for (int chunkIndex : _visibleChunks)
     {
-        if(iter.second->getCount() > 0)
+        auto& chunk = _chunks[chunkIndex];
+        for (ssize_t i = 0; i < chunk.primitives.size(); ++i)
         {
             auto& cmd = _renderCommands[index++];
-            auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
-            cmd.init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
+            cmd.init(chunk.vertexZs[i], _texture->getName(), getGLProgramState(), blendfunc, chunk.primitives.at(i), _modelViewTransform, flags);
             renderer->addCommand(&cmd);
         }
     }
@@ -181,7 +213,7 @@ void TMXLayer::onDraw(Primitive *primitive)
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, primitive->getCount() * 4);
 }
 
-void TMXLayer::updateTiles(const Rect& culledRect)
+void TMXLayer::updateVisibleChunks(const Rect& culledRect)
 {
     Rect visibleTiles = culledRect;
     Size mapTileSize = CC_SIZE_PIXELS_TO_POINTS(_mapTileSize);
@@ -222,82 +254,145 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         tilesOverY = ceil(overTileRect.origin.y + overTileRect.size.height) - floor(overTileRect.origin.y);
     }
 
-    _indicesVertexZNumber.clear();
-
-    for(const auto& iter : _indicesVertexZOffsets)
-    {
-        _indicesVertexZNumber[iter.first] = iter.second;
-    }
-
     int yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
     int yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
     int xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
     int xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
 
-    for (int y =  yBegin; y < yEnd; ++y)
+    _visibleChunks.clear();
+    if (xBegin >= xEnd || yBegin >= yEnd)
     {
-        for (int x = xBegin; x < xEnd; ++x)
-        {
-            int tileIndex = getTileIndexByPos(x, y);
-            if(_tiles[tileIndex] == 0) continue;
-
-            int vertexZ = getVertexZForPos(Vec2(x,y));
-            auto iter = _indicesVertexZNumber.find(vertexZ);
-            int offset = iter->second;
-            iter->second++;
-
-            int quadIndex = _tileToQuadIndex[tileIndex];
-            CC_ASSERT(-1 != quadIndex);
-            _indices[6 * offset + 0] = quadIndex * 4 + 0;
-            _indices[6 * offset + 1] = quadIndex * 4 + 1;
-            _indices[6 * offset + 2] = quadIndex * 4 + 2;
-            _indices[6 * offset + 3] = quadIndex * 4 + 3;
-            _indices[6 * offset + 4] = quadIndex * 4 + 2;
-            _indices[6 * offset + 5] = quadIndex * 4 + 1;
-
-        } // for x
-    } // for y
-
-    for(const auto& iter : _indicesVertexZOffsets)
-    {
-        _indicesVertexZNumber[iter.first] -= iter.second;
-        if(_indicesVertexZNumber[iter.first] == 0)
+        return;
+    }
+
+    for (int chunkY = yBegin / CHUNK_SIZE, chunkYEnd = (yEnd - 1) / CHUNK_SIZE; chunkY <= chunkYEnd; ++chunkY)
+    {
+        for (int chunkX = xBegin / CHUNK_SIZE, chunkXEnd = (xEnd - 1) / CHUNK_SIZE; chunkX <= chunkXEnd; ++chunkX)
         {
-            _indicesVertexZNumber.erase(iter.first);
+            _visibleChunks.push_back(chunkX + chunkY * _chunksWide);
         }
     }
+}
+
+void TMXLayer::setupChunks()
+{
+    for (auto& chunk : _chunks)
+    {
+        releaseChunk(chunk);
+    }
 
+    _chunksWide = ((int)_layerSize.width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    _chunksHigh = ((int)_layerSize.height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    // the chunks are built when they are visible
+    _chunks.clear();
+    _chunks.resize(_chunksWide * _chunksHigh);
+    _visibleChunks.clear();
+    _dirty = true;
 }
 
-void TMXLayer::updateVertexBuffer()
+void TMXLayer::populateChunk(Chunk& chunk, int chunkX, int chunkY)
 {
-    GL::bindVAO(0);
-    if(nullptr == _vData)
+    chunk.populated = true;
+    chunk.dirty = false;
+
+    int xBegin = chunkX * CHUNK_SIZE;
+    int yBegin = chunkY * CHUNK_SIZE;
+    int xEnd = std::min((int)_layerSize.width, xBegin + CHUNK_SIZE);
+    int yEnd = std::min((int)_layerSize.height, yBegin + CHUNK_SIZE);
+
+    // count the quads of each vertex z to sort them
+    std::map<int/*vertexZ*/, int/*offset by quads*/> vertexZOffsets;
+    for (int y = yBegin; y < yEnd; ++y)
     {
-        _vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), (int)_totalQuads.size() * 4);
-        _vData = VertexData::create();
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
-        _vData->setStream(_vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
-        CC_SAFE_RETAIN(_vData);
-        CC_SAFE_RETAIN(_vertexBuffer);
+        for (int x = xBegin; x < xEnd; ++x)
+        {
+            if (_tiles[getTileIndexByPos(x, y)] != 0)
+            {
+                ++vertexZOffsets[getVertexZForPos(Vec2(x, y))];
+            }
+        }
     }
-    if(_vertexBuffer)
+
+    chunk.vertexZs.clear();
+    chunk.primitives.clear();
+    if (vertexZOffsets.empty())
     {
-        _vertexBuffer->updateVertices((void*)&_totalQuads[0], (int)_totalQuads.size() * 4, 0);
+        return;
     }
 
-}
+    int quadCount = 0;
+    std::vector<int> quadCounts;
+    for (auto& iter : vertexZOffsets)
+    {
+        chunk.vertexZs.push_back(iter.first);
+        quadCounts.push_back(iter.second);
+        std::swap(quadCount, iter.second);
+        quadCount += iter.second;
+    }
 
-void TMXLayer::updateIndexBuffer()
-{
-    if(nullptr == _indexBuffer)
+    _chunkQuads.resize(quadCount);
+    for (int y = yBegin; y < yEnd; ++y)
     {
-        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)_indices.size());
+        for (int x = xBegin; x < xEnd; ++x)
+        {
+            int tileGID = _tiles[getTileIndexByPos(x, y)];
+            if (tileGID == 0) continue;
+
+            int z = getVertexZForPos(Vec2(x, y));
+            setupTileQuad(_chunkQuads[vertexZOffsets[z]++], x, y, tileGID, z);
+        }
+    }
+
+    if (nullptr == _indexBuffer)
+    {
+        int maxQuads = CHUNK_SIZE * CHUNK_SIZE;
+        std::vector<GLushort> indices(6 * maxQuads);
+        for (int i = 0; i < maxQuads; ++i)
+        {
+            indices[6 * i + 0] = i * 4 + 0;
+            indices[6 * i + 1] = i * 4 + 1;
+            indices[6 * i + 2] = i * 4 + 2;
+            indices[6 * i + 3] = i * 4 + 3;
+            indices[6 * i + 4] = i * 4 + 2;
+            indices[6 * i + 5] = i * 4 + 1;
+        }
+        _indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)indices.size());
+        _indexBuffer->updateIndices(&indices[0], (int)indices.size(), 0);
         CC_SAFE_RETAIN(_indexBuffer);
     }
-    _indexBuffer->updateIndices(&_indices[0], (int)_indices.size(), 0);
 
+    GL::bindVAO(0);
+    if (nullptr == chunk.vertexBuffer || chunk.vertexBuffer->getVertexNumber() < quadCount * 4)
+    {
+        CC_SAFE_RELEASE_NULL(chunk.vertexData);
+        chunk.vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), quadCount * 4);
+        chunk.vertexData = VertexData::create();
+        chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+        chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+        chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+        CC_SAFE_RETAIN(chunk.vertexData);
+    }
+    chunk.vertexBuffer->updateVertices((void*)&_chunkQuads[0], quadCount * 4, 0);
+
+    int start = 0;
+    for (int count : quadCounts)
+    {
+        auto primitive = Primitive::create(chunk.vertexData, _indexBuffer, GL_TRIANGLES);
+        primitive->setStart(start * 6);
+        primitive->setCount(count * 6);
+        chunk.primitives.pushBack(primitive);
+        start += count;
+    }
+}
+
+void TMXLayer::releaseChunk(Chunk& chunk)
+{
+    chunk.primitives.clear();
+    chunk.vertexZs.clear();
+    CC_SAFE_RELEASE_NULL(chunk.vertexData);
+    chunk.vertexBuffer = nullptr;
+    chunk.populated = false;
+    chunk.dirty = false;
 }
 
 // FastTMXLayer - setup Tiles
@@ -393,158 +488,89 @@ Mat4 TMXLayer::tileToNodeTransform()
 
 }
 
-void TMXLayer::updatePrimitives()
+void TMXLayer::setupTileQuad(V3F_C4B_T2F_Quad& quad, int x, int y, int tileGID, float z)
 {
-    for(const auto& iter : _indicesVertexZNumber)
-    {
-        int start = _indicesVertexZOffsets.at(iter.first);
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size texSize = _tileSet->_imageSize;
 
-        auto primitiveIter= _primitives.find(iter.first);
-        if(primitiveIter == _primitives.end())
-        {
-            auto primitive = Primitive::create(_vData, _indexBuffer, GL_TRIANGLES);
-            primitive->setCount(iter.second * 6);
-            primitive->setStart(start * 6);
+    Vec3 nodePos(float(x), float(y), 0);
+    _tileToNodeTransform.transformPoint(&nodePos);
 
-            _primitives.insert(iter.first, primitive);
-        }
-        else
-        {
-            primitiveIter->second->setCount(iter.second * 6);
-            primitiveIter->second->setStart(start * 6);
-        }
-    }
-}
+    float left, right, top, bottom;
 
-void TMXLayer::updateTotalQuads()
-{
-    if(_quadsDirty)
-    {
-        Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-        Size texSize = _tileSet->_imageSize;
-        _tileToQuadIndex.clear();
-        _totalQuads.resize(int(_layerSize.width * _layerSize.height));
-        _indices.resize(6 * int(_layerSize.width * _layerSize.height));
-        _tileToQuadIndex.resize(int(_layerSize.width * _layerSize.height),-1);
-        _indicesVertexZOffsets.clear();
-
-        int quadIndex = 0;
-        for(int y = 0; y < _layerSize.height; ++y)
-        {
-            for(int x =0; x < _layerSize.width; ++x)
-            {
-                int tileIndex = getTileIndexByPos(x, y);
-                int tileGID = _tiles[tileIndex];
-
-                if(tileGID == 0) continue;
-
-                _tileToQuadIndex[tileIndex] = quadIndex;
-
-                auto& quad = _totalQuads[quadIndex];
-
-                Vec3 nodePos(float(x), float(y), 0);
-                _tileToNodeTransform.transformPoint(&nodePos);
-
-                float left, right, top, bottom, z;
-
-                z = getVertexZForPos(Vec2(x, y));
-                auto iter = _indicesVertexZOffsets.find(z);
-                if(iter == _indicesVertexZOffsets.end())
-                {
-                    _indicesVertexZOffsets[z] = 1;
-                }
-                else
-                {
-                    iter->second++;
-                }
-                // vertices
-                if (tileGID & kTMXTileDiagonalFlag)
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.height;
-                    bottom = nodePos.y + tileSize.width;
-                    top = nodePos.y;
-                }
-                else
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.width;
-                    bottom = nodePos.y + tileSize.height;
-                    top = nodePos.y;
-                }
-
-                if(tileGID & kTMXTileVerticalFlag)
-                    std::swap(top, bottom);
-                if(tileGID & kTMXTileHorizontalFlag)
-                    std::swap(left, right);
-
-                if(tileGID & kTMXTileDiagonalFlag)
-                {
-                    // FIXME: not working correctly
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = left;
-                    quad.br.vertices.y = top;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = right;
-                    quad.tl.vertices.y = bottom;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                else
-                {
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = right;
-                    quad.br.vertices.y = bottom;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = left;
-                    quad.tl.vertices.y = top;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-
-                // texcoords
-                Rect tileTexture = _tileSet->getRectForGID(tileGID);
-                left   = (tileTexture.origin.x / texSize.width);
-                right  = left + (tileTexture.size.width / texSize.width);
-                bottom = (tileTexture.origin.y / texSize.height);
-                top    = bottom + (tileTexture.size.height / texSize.height);
-
-                quad.bl.texCoords.u = left;
-                quad.bl.texCoords.v = bottom;
-                quad.br.texCoords.u = right;
-                quad.br.texCoords.v = bottom;
-                quad.tl.texCoords.u = left;
-                quad.tl.texCoords.v = top;
-                quad.tr.texCoords.u = right;
-                quad.tr.texCoords.v = top;
-
-                quad.bl.colors = Color4B::WHITE;
-                quad.br.colors = Color4B::WHITE;
-                quad.tl.colors = Color4B::WHITE;
-                quad.tr.colors = Color4B::WHITE;
-
-                ++quadIndex;
-            }
-        }
+    // vertices
+    if (tileGID & kTMXTileDiagonalFlag)
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.height;
+        bottom = nodePos.y + tileSize.width;
+        top = nodePos.y;
+    }
+    else
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.width;
+        bottom = nodePos.y + tileSize.height;
+        top = nodePos.y;
+    }
 
-        int offset = 0;
-        for(auto iter = _indicesVertexZOffsets.begin(); iter != _indicesVertexZOffsets.end(); ++iter)
-        {
-            std::swap(offset, iter->second);
-            offset += iter->second;
-        }
-        updateVertexBuffer();
+    if(tileGID & kTMXTileVerticalFlag)
+        std::swap(top, bottom);
+    if(tileGID & kTMXTileHorizontalFlag)
+        std::swap(left, right);
 
-        _quadsDirty = false;
+    if(tileGID & kTMXTileDiagonalFlag)
+    {
+        // FIXME: not working correctly
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = left;
+        quad.br.vertices.y = top;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = right;
+        quad.tl.vertices.y = bottom;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    else
+    {
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = right;
+        quad.br.vertices.y = bottom;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = left;
+        quad.tl.vertices.y = top;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
     }
+
+    // texcoords
+    Rect tileTexture = _tileSet->getRectForGID(tileGID);
+    left   = (tileTexture.origin.x / texSize.width);
+    right  = left + (tileTexture.size.width / texSize.width);
+    bottom = (tileTexture.origin.y / texSize.height);
+    top    = bottom + (tileTexture.size.height / texSize.height);
+
+    quad.bl.texCoords.u = left;
+    quad.bl.texCoords.v = bottom;
+    quad.br.texCoords.u = right;
+    quad.br.texCoords.v = bottom;
+    quad.tl.texCoords.u = left;
+    quad.tl.texCoords.v = top;
+    quad.tr.texCoords.u = right;
+    quad.tr.texCoords.v = top;
+
+    quad.bl.colors = Color4B::WHITE;
+    quad.br.colors = Color4B::WHITE;
+    quad.tl.colors = Color4B::WHITE;
+    quad.tr.colors = Color4B::WHITE;
 }
 
 // removing / getting tiles
@@ -677,8 +703,13 @@ void TMXLayer::setFlaggedTileGIDByIndex(int index, int gid)
 {
     if(gid == _tiles[index]) return;
     _tiles[index] = gid;
-    _quadsDirty = true;
-    _dirty = true;
+
+    // only the chunk of the tile is rebuilt
+    int chunkIndex = getChunkIndexByTileIndex(index);
+    if (chunkIndex < (int)_chunks.size())
+    {
+        _chunks[chunkIndex].dirty = true;
+    }
 }
 
 void TMXLayer::removeChild(Node* node, bool cleanup)
@@ -29,7 +29,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 #include "2d/CCTMXXMLParser.h"
 #include "renderer/CCPrimitiveCommand.h"
-#include "base/CCMap.h"
+#include "base/CCVector.h"
 
 NS_CC_BEGIN
 
@@ -69,6 +69,10 @@ namespace experimental{
  * For further information, please see the programming guide:
  * http://www.cocos2d-iphone.org/wiki/doku.php/prog_guide:tiled_maps
 
+ * The tiles are rendered by chunks of CHUNK_SIZE x CHUNK_SIZE tiles, each with its own vertex buffer.
+ * A chunk is built the first time it is visible and rebuilt when one of its tiles changes,
+ * only the chunks intersecting the screen are drawn.
+
  * @since v3.2
  * @js NA
  */
@@ -191,7 +195,7 @@ public:
      *
      * @param tiles The pointer to the map of tiles.
      */
-    void setTiles(uint32_t* tiles) { _tiles = tiles; _quadsDirty = true;};
+    void setTiles(uint32_t* tiles) { _tiles = tiles; _quadsDirty = true; _dirty = true; };
 
     /** Tileset information for the layer.
      *
@@ -271,7 +275,25 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *layerInfo, TMXMapInfo *mapInfo);
 
 protected:
-    void updateTiles(const Rect& culledRect);
+    struct Chunk
+    {
+        Chunk();
+
+        bool populated;
+        bool dirty;
+        // owned by the vertex data
+        VertexBuffer* vertexBuffer;
+        VertexData* vertexData;
+        // one primitive per vertex z, the quads are sorted by vertex z
+        std::vector<int> vertexZs;
+        Vector<Primitive*> primitives;
+    };
+
+    void updateVisibleChunks(const Rect& culledRect);
+    void setupChunks();
+    void populateChunk(Chunk& chunk, int chunkX, int chunkY);
+    void releaseChunk(Chunk& chunk);
+    void setupTileQuad(V3F_C4B_T2F_Quad& quad, int x, int y, int tileGID, float z);
     Vec2 calculateLayerOffset(const Vec2& offset);
 
     /* The layer recognizes some special properties, like cc_vertez */
@@ -285,15 +307,13 @@ protected:
     //Flip flags is packed into gid
     void setFlaggedTileGIDByIndex(int index, int gid);
 
-    //
-    void updateTotalQuads();
-
     void onDraw(Primitive* primitive);
     inline int getTileIndexByPos(int x, int y) const { return x + y * (int) _layerSize.width; }
-
-    void updateVertexBuffer();
-    void updateIndexBuffer();
-    void updatePrimitives();
+    inline int getChunkIndexByTileIndex(int tileIndex) const
+    {
+        int width = (int) _layerSize.width;
+        return (tileIndex % width) / CHUNK_SIZE + (tileIndex / width) / CHUNK_SIZE * _chunksWide;
+    }
 protected:
 
     //! name of the layer
@@ -330,27 +350,28 @@ protected:
     Mat4 _tileToNodeTransform;
     /** data for rendering */
     bool _quadsDirty;
-    std::vector<int> _tileToQuadIndex;
-    std::vector<V3F_C4B_T2F_Quad> _totalQuads;
-    std::vector<GLushort> _indices;
-    std::map<int/*vertexZ*/, int/*offset to _indices by quads*/> _indicesVertexZOffsets;
-    std::unordered_map<int/*vertexZ*/, int/*number to quads*/> _indicesVertexZNumber;
     std::vector<PrimitiveCommand> _renderCommands;
     bool _dirty;
 
-    VertexBuffer* _vertexBuffer;
-
-    VertexData* _vData;
+    /** chunks of the layer, row by row */
+    std::vector<Chunk> _chunks;
+    int _chunksWide;
+    int _chunksHigh;
+    std::vector<int> _visibleChunks;
+    /** quads of the chunk being built */
+    std::vector<V3F_C4B_T2F_Quad> _chunkQuads;
 
+    /** indices of the quads of a full chunk, shared by the chunks */
     IndexBuffer* _indexBuffer;
 
-    Map<int , Primitive*> _primitives;
-
 public:
     /** Possible orientations of the TMX map */
     static const int FAST_TMX_ORIENTATION_ORTHO;
     static const int FAST_TMX_ORIENTATION_HEX;
     static const int FAST_TMX_ORIENTATION_ISO;
+
+    /** Width and height of a chunk, in tiles */
+    static const int CHUNK_SIZE;
 };
 
 // end of tilemap_parallax_nodes group
@@ -35,6 +35,13 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCData.h"
+#include "platform/CCFileUtils.h"
+
+#include <algorithm>
+#include <climits>
+#include <memory>
 
 NS_CC_BEGIN
 
@@ -42,6 +49,69 @@ const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+const char* FontAtlas::CMD_UPDATE_FONTATLAS = "__cc_UPDATE_FONTATLAS";
+
+namespace
+{
+    const char GLYPH_CACHE_MAGIC[4] = { 'C', 'C', 'G', 'C' };
+    const uint16_t GLYPH_CACHE_VERSION = 1;
+
+    // followed by letterCount GlyphCacheLetter and pageCount pages of pageWidth * pageHeight * bytesPerPixel bytes
+    struct GlyphCacheHeader
+    {
+        char magic[4];
+        uint16_t version;
+        uint16_t bytesPerPixel;
+        float fontSize;
+        float outlineSize;
+        uint32_t distanceField;
+        float contentScaleFactor;
+        int32_t pageWidth;
+        int32_t pageHeight;
+        int32_t pageCount;
+        int32_t letterCount;
+        // where the next glyph goes in the last page
+        float currentPageOrigX;
+        float currentPageOrigY;
+        int32_t currentLineHeight;
+    };
+
+    struct GlyphCacheLetter
+    {
+        uint32_t utf16Char;
+        int32_t validDefinition;
+        float U;
+        float V;
+        float width;
+        float height;
+        float offsetX;
+        float offsetY;
+        int32_t textureID;
+        int32_t xAdvance;
+    };
+}
+
+static int s_defaultPageWidth = FontAtlas::CacheTextureWidth;
+static int s_defaultPageHeight = FontAtlas::CacheTextureHeight;
+static int s_defaultMaxPageCount = 0;
+static bool s_defaultAsyncRasterization = false;
+
+void FontAtlas::setDefaultPageSize(int width, int height)
+{
+    CCASSERT(width > 0 && height > 0, "FontAtlas: invalid page size");
+    s_defaultPageWidth = width;
+    s_defaultPageHeight = height;
+}
+
+void FontAtlas::setDefaultMaxPageCount(int count)
+{
+    s_defaultMaxPageCount = count;
+}
+
+void FontAtlas::setDefaultAsyncRasterization(bool async)
+{
+    s_defaultAsyncRasterization = async;
+}
 
 FontAtlas::FontAtlas(Font &theFont)
 : _font(&theFont)
@@ -52,6 +122,13 @@ FontAtlas::FontAtlas(Font &theFont)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
 , _currLineHeight(0)
+, _pageWidth(s_defaultPageWidth)
+, _pageHeight(s_defaultPageHeight)
+, _currentPageDirtyY(0)
+, _maxPageCount(s_defaultMaxPageCount)
+, _asyncRasterization(s_defaultAsyncRasterization)
+, _generation(0)
+, _keepPageData(false)
 {
     _font->retain();
 
@@ -71,7 +148,7 @@ FontAtlas::FontAtlas(Font &theFont)
         {
             _letterPadding += 2 * FontFreeType::DistanceMapSpread;
         }
-        _currentPageDataSize = CacheTextureWidth * CacheTextureHeight;
+        _currentPageDataSize = _pageWidth * _pageHeight;
         auto outlineSize = _fontFreeType->getOutlineSize();
         if(outlineSize > 0)
         {
@@ -84,10 +161,11 @@ FontAtlas::FontAtlas(Font &theFont)
 
         auto  pixelFormat = outlineSize > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
         texture->initWithData(_currentPageData, _currentPageDataSize,
-            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+            pixelFormat, _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight) );
 
         addTexture(texture,0);
         texture->release();
+        _pageLastUsedFrame.push_back(0);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
@@ -131,7 +209,11 @@ void FontAtlas::reset()
     _currentPage = 0;
     _currentPageOrigX = 0;
     _currentPageOrigY = 0;
+    _currentPageDirtyY = 0;
     _letterDefinitions.clear();
+    _pageLastUsedFrame.clear();
+    removeCachedLayouts();
+    ++_generation;
 }
 
 void FontAtlas::releaseTextures()
@@ -166,6 +248,7 @@ void FontAtlas::addLetterDefinition(char16_t utf16Char, const FontLetterDefiniti
 
 void FontAtlas::scaleFontLetterDefinition(float scaleFactor)
 {
+    removeCachedLayouts();
     for (auto&& fontDefinition : _letterDefinitions) {
         auto& letterDefinition = fontDefinition.second;
         letterDefinition.width *= scaleFactor;
@@ -291,6 +374,11 @@ void FontAtlas::findNewCharacters(const std::u16string& u16Text, std::unordered_
             {
                 newChars.push_back(u16Text[i]);
             }
+            else if (outIterator->second.width > 0)
+            {
+                // keeps the page out of the recycling while the text is laid out
+                touchPage(outIterator->second.textureID);
+            }
         }
     }
 
@@ -332,115 +420,491 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16Text)
         return false;
     }
 
+    if (_asyncRasterization)
+    {
+        // placeholders with the final advance and without pixels, patched by addGlyphsRenderedAsync
+        FontLetterDefinition placeholder;
+        memset(&placeholder, 0, sizeof(placeholder));
+        std::vector<char16_t> utf16Chars;
+        std::vector<unsigned short> charCodes;
+        utf16Chars.reserve(codeMapOfNewChar.size());
+        charCodes.reserve(codeMapOfNewChar.size());
+        for (auto&& it : codeMapOfNewChar)
+        {
+            placeholder.xAdvance = _fontFreeType->getGlyphAdvance(it.second);
+            placeholder.validDefinition = placeholder.xAdvance != 0;
+            _letterDefinitions[it.first] = placeholder;
+            utf16Chars.push_back(it.first);
+            charCodes.push_back(it.second);
+        }
+
+        auto glyphs = std::make_shared<std::vector<GlyphBitmap>>();
+        auto font = _fontFreeType;
+        unsigned int generation = _generation;
+
+        // the atlas and its font stay alive until the glyphs are added
+        retain();
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [this, utf16Chars, glyphs, generation](void*) {
+            addGlyphsRenderedAsync(utf16Chars, *glyphs, generation);
+            release();
+        }, nullptr, [font, charCodes, glyphs]() {
+            glyphs->resize(charCodes.size());
+            for (size_t i = 0; i < charCodes.size(); ++i)
+            {
+                font->renderGlyph(charCodes[i], (*glyphs)[i]);
+            }
+        });
+        return true;
+    }
+
+    GlyphBitmap glyph;
+    for (auto&& it : codeMapOfNewChar)
+    {
+        _fontFreeType->renderGlyph(it.second, glyph);
+        addGlyph(it.first, glyph);
+    }
+    updateCurrentPageTexture(_currentPageOrigY + _currLineHeight);
+
+    return true;
+}
+
+void FontAtlas::addGlyphsRenderedAsync(const std::vector<char16_t>& utf16Chars, const std::vector<GlyphBitmap>& glyphs, unsigned int generation)
+{
+    // the atlas was purged meanwhile
+    if (generation != _generation)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < utf16Chars.size(); ++i)
+    {
+        addGlyph(utf16Chars[i], glyphs[i]);
+    }
+    updateCurrentPageTexture(_currentPageOrigY + _currLineHeight);
+    // laid out with the placeholders
+    removeCachedLayouts();
+
+    Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+}
+
+void FontAtlas::addGlyph(char16_t utf16Char, const GlyphBitmap& glyph)
+{
     int adjustForDistanceMap = _letterPadding / 2;
     int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
-    int glyphHeight;
-    Rect tempRect;
-    FontLetterDefinition tempDef;
-
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
-    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
 
-    float startY = _currentPageOrigY;
+    FontLetterDefinition tempDef;
+    tempDef.xAdvance = glyph.xAdvance;
 
-    for (auto&& it : codeMapOfNewChar)
+    int glyphWidth = 0;
+    int glyphHeight = 0;
+    if (!glyph.pixels.empty())
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        tempDef.width = glyph.rect.size.width + _letterPadding + _letterEdgeExtend;
+        glyphWidth = std::max(static_cast<int>(tempDef.width), static_cast<int>(glyph.width) + _letterEdgeExtend);
+        glyphHeight = static_cast<int>(glyph.height) + _letterEdgeExtend;
+        if (glyphWidth > _pageWidth || glyphHeight > _pageHeight)
         {
-            tempDef.validDefinition = true;
-            tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
-            tempDef.height = tempRect.size.height + _letterPadding + _letterEdgeExtend;
-            tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
-            tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
+            CCLOG("cocos2d: FontAtlas: glyph %d is larger than the %dx%d pages", (int)utf16Char, _pageWidth, _pageHeight);
+            glyphWidth = 0;
+        }
+    }
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
-            {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
-                }
-            }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+    if (glyphWidth > 0)
+    {
+        tempDef.validDefinition = true;
+        tempDef.height = glyph.rect.size.height + _letterPadding + _letterEdgeExtend;
+        tempDef.offsetX = glyph.rect.origin.x - adjustForDistanceMap - adjustForExtend;
+        tempDef.offsetY = _fontAscender + glyph.rect.origin.y - adjustForDistanceMap - adjustForExtend;
+
+        if (_currentPageOrigX + glyphWidth > _pageWidth)
+        {
+            _currentPageOrigY += _currLineHeight;
+            _currLineHeight = 0;
+            _currentPageOrigX = 0;
+            if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= _pageHeight)
             {
-                _currLineHeight = glyphHeight;
+                startNewPage();
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
-
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
-            tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
-            // take from pixels to points
-            tempDef.width = tempDef.width / scaleFactor;
-            tempDef.height = tempDef.height / scaleFactor;
-            tempDef.U = tempDef.U / scaleFactor;
-            tempDef.V = tempDef.V / scaleFactor;
         }
-        else{
-            if (tempDef.xAdvance)
-                tempDef.validDefinition = true;
-            else
-                tempDef.validDefinition = false;
-
-            tempDef.width = 0;
-            tempDef.height = 0;
-            tempDef.U = 0;
-            tempDef.V = 0;
-            tempDef.offsetX = 0;
-            tempDef.offsetY = 0;
-            tempDef.textureID = 0;
-            _currentPageOrigX += 1;
+        if (_currentPageOrigY + glyphHeight > _pageHeight)
+        {
+            startNewPage();
         }
+        if (glyphHeight > _currLineHeight)
+        {
+            _currLineHeight = glyphHeight;
+        }
+
+        int bytesPerPixel = glyph.bytesPerPixel;
+        int destX = static_cast<int>(_currentPageOrigX) + adjustForExtend;
+        int destY = static_cast<int>(_currentPageOrigY) + adjustForExtend;
+        size_t rowSize = glyph.width * bytesPerPixel;
+        for (long y = 0; y < glyph.height; ++y)
+        {
+            memcpy(_currentPageData + ((destY + y) * _pageWidth + destX) * bytesPerPixel, glyph.pixels.data() + y * rowSize, rowSize);
+        }
+        touchPage(_currentPage);
+
+        tempDef.U = _currentPageOrigX;
+        tempDef.V = _currentPageOrigY;
+        tempDef.textureID = _currentPage;
+        _currentPageOrigX += glyphWidth + 1;
+        // take from pixels to points
+        tempDef.width = tempDef.width / scaleFactor;
+        tempDef.height = tempDef.height / scaleFactor;
+        tempDef.U = tempDef.U / scaleFactor;
+        tempDef.V = tempDef.V / scaleFactor;
+    }
+    else{
+        if (tempDef.xAdvance)
+            tempDef.validDefinition = true;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width = 0;
+        tempDef.height = 0;
+        tempDef.U = 0;
+        tempDef.V = 0;
+        tempDef.offsetX = 0;
+        tempDef.offsetY = 0;
+        tempDef.textureID = 0;
+        _currentPageOrigX += 1;
+    }
+
+    _letterDefinitions[utf16Char] = tempDef;
+}
 
-        _letterDefinitions[it.first] = tempDef;
+void FontAtlas::startNewPage()
+{
+    updateCurrentPageTexture(_pageHeight);
+    if (_keepPageData)
+    {
+        _keptPages.emplace_back(_currentPageData, _currentPageData + _currentPageDataSize);
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    memset(_currentPageData, 0, _currentPageDataSize);
+    _currentPageOrigX = 0;
+    _currentPageOrigY = 0;
+    _currLineHeight = 0;
+    _currentPageDirtyY = 0;
+
+    int page = findPageToRecycle();
+    if (page < 0)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        page = static_cast<int>(_atlasTextures.size());
+        auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+        auto tex = new (std::nothrow) Texture2D;
+        if (_antialiasEnabled)
+        {
+            tex->setAntiAliasTexParameters();
+        }
+        else
+        {
+            tex->setAliasTexParameters();
+        }
+        tex->initWithData(_currentPageData, _currentPageDataSize,
+            pixelFormat, _pageWidth, _pageHeight, Size(_pageWidth, _pageHeight));
+        addTexture(tex, page);
+        tex->release();
+        _pageLastUsedFrame.push_back(0);
+        _currentPage = page;
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        // the labels render the removed glyphs again when they need them
+        for (auto it = _letterDefinitions.begin(); it != _letterDefinitions.end();)
+        {
+            if (it->second.textureID == page && it->second.width > 0)
+                it = _letterDefinitions.erase(it);
+            else
+                ++it;
+        }
+        _currentPage = page;
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+    }
+    touchPage(_currentPage);
+}
+
+int FontAtlas::findPageToRecycle() const
+{
+    if (_maxPageCount <= 0 || static_cast<int>(_atlasTextures.size()) < _maxPageCount)
+    {
+        return -1;
+    }
+
+    // the least recently drawn page, not drawn during this frame or the previous one
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    int page = -1;
+    for (int i = 0; i < static_cast<int>(_pageLastUsedFrame.size()); ++i)
+    {
+        unsigned int lastUsed = _pageLastUsedFrame[i];
+        if (i == _currentPage || lastUsed + 1 >= frame)
+            continue;
+        if (page < 0 || lastUsed < _pageLastUsedFrame[page])
+            page = i;
+    }
+    return page;
+}
+
+void FontAtlas::updateCurrentPageTexture(int endY)
+{
+    endY = std::min(endY, _pageHeight);
+    if (endY > _currentPageDirtyY)
+    {
+        int bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+        unsigned char *data = _currentPageData + _pageWidth * _currentPageDirtyY * bytesPerPixel;
+        _atlasTextures[_currentPage]->updateWithData(data, 0, _currentPageDirtyY, _pageWidth, endY - _currentPageDirtyY);
+    }
+    // the glyphs added later to the current row are uploaded with it
+    _currentPageDirtyY = static_cast<int>(_currentPageOrigY);
+}
+
+void FontAtlas::touchPage(int slot)
+{
+    if (slot >= 0 && slot < static_cast<int>(_pageLastUsedFrame.size()))
+    {
+        _pageLastUsedFrame[slot] = Director::getInstance()->getTotalFrames();
+    }
+}
+
+Ref* FontAtlas::getCachedLayout(const std::string& key) const
+{
+    return _cachedLayouts.at(key);
+}
+
+void FontAtlas::cacheLayout(const std::string& key, Ref* layout, int maxCount)
+{
+    if (maxCount <= 0)
+        return;
+
+    if (_cachedLayouts.find(key) == _cachedLayouts.end())
+    {
+        _cachedLayoutKeys.push_back(key);
+    }
+    _cachedLayouts.insert(key, layout);
+
+    while (static_cast<int>(_cachedLayoutKeys.size()) > maxCount)
+    {
+        _cachedLayouts.erase(_cachedLayoutKeys.front());
+        _cachedLayoutKeys.pop_front();
+    }
+}
+
+void FontAtlas::removeCachedLayouts()
+{
+    _cachedLayouts.clear();
+    _cachedLayoutKeys.clear();
+}
+
+bool FontAtlas::bakeGlyphCache(const std::u16string& utf16Text, const std::string& filename)
+{
+    if (_fontFreeType == nullptr || !_letterDefinitions.empty())
+    {
+        CCLOG("cocos2d: FontAtlas: a glyph cache is baked with a TTF atlas without glyphs");
+        return false;
+    }
+
+    // every page is kept, in order
+    bool asyncRasterization = _asyncRasterization;
+    int maxPageCount = _maxPageCount;
+    _asyncRasterization = false;
+    _maxPageCount = 0;
+    _keepPageData = true;
+    prepareLetterDefinitions(utf16Text);
+    _asyncRasterization = asyncRasterization;
+    _maxPageCount = maxPageCount;
+    _keepPageData = false;
+
+    std::vector<std::vector<unsigned char>> pages;
+    pages.swap(_keptPages);
+    pages.emplace_back(_currentPageData, _currentPageData + _currentPageDataSize);
+
+    GlyphCacheHeader header;
+    memcpy(header.magic, GLYPH_CACHE_MAGIC, sizeof(GLYPH_CACHE_MAGIC));
+    header.version = GLYPH_CACHE_VERSION;
+    header.bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+    header.fontSize = _fontFreeType->getFontSize();
+    header.outlineSize = _fontFreeType->getOutlineSize();
+    header.distanceField = _fontFreeType->isDistanceFieldEnabled() ? 1 : 0;
+    header.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+    header.pageWidth = _pageWidth;
+    header.pageHeight = _pageHeight;
+    header.pageCount = (int32_t)pages.size();
+    header.letterCount = (int32_t)_letterDefinitions.size();
+    header.currentPageOrigX = _currentPageOrigX;
+    header.currentPageOrigY = _currentPageOrigY;
+    header.currentLineHeight = _currLineHeight;
+
+    size_t lettersSize = _letterDefinitions.size() * sizeof(GlyphCacheLetter);
+    size_t size = sizeof(header) + lettersSize + pages.size() * _currentPageDataSize;
+    unsigned char* buffer = (unsigned char*)malloc(size);
+    if (!buffer)
+        return false;
+
+    unsigned char* p = buffer;
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    for (auto&& item : _letterDefinitions)
+    {
+        const FontLetterDefinition& def = item.second;
+        GlyphCacheLetter letter;
+        letter.utf16Char = item.first;
+        letter.validDefinition = def.validDefinition ? 1 : 0;
+        letter.U = def.U;
+        letter.V = def.V;
+        letter.width = def.width;
+        letter.height = def.height;
+        letter.offsetX = def.offsetX;
+        letter.offsetY = def.offsetY;
+        letter.textureID = def.textureID;
+        letter.xAdvance = def.xAdvance;
+        memcpy(p, &letter, sizeof(letter));
+        p += sizeof(letter);
+    }
+    for (auto&& page : pages)
+    {
+        memcpy(p, page.data(), page.size());
+        p += page.size();
+    }
+
+    Data data;
+    data.fastSet(buffer, size);
+    return FileUtils::getInstance()->writeDataToFile(data, filename);
+}
+
+bool FontAtlas::loadGlyphCache(const Data& data)
+{
+    if (_fontFreeType == nullptr || !_letterDefinitions.empty())
+    {
+        CCLOG("cocos2d: FontAtlas: a glyph cache is loaded in a TTF atlas without glyphs");
+        return false;
+    }
+
+    if (data.getSize() < (ssize_t)sizeof(GlyphCacheHeader) || memcmp(data.getBytes(), GLYPH_CACHE_MAGIC, sizeof(GLYPH_CACHE_MAGIC)) != 0)
+    {
+        CCLOG("cocos2d: FontAtlas: not a glyph cache");
+        return false;
+    }
+
+    auto header = reinterpret_cast<const GlyphCacheHeader*>(data.getBytes());
+    int bytesPerPixel = _fontFreeType->getOutlineSize() > 0 ? 2 : 1;
+    if (header->version != GLYPH_CACHE_VERSION)
+    {
+        CCLOG("cocos2d: FontAtlas: unsupported glyph cache version %d", header->version);
+        return false;
+    }
+    if (header->bytesPerPixel != bytesPerPixel
+        || header->fontSize != _fontFreeType->getFontSize()
+        || header->outlineSize != _fontFreeType->getOutlineSize()
+        || (header->distanceField != 0) != _fontFreeType->isDistanceFieldEnabled()
+        || header->contentScaleFactor != CC_CONTENT_SCALE_FACTOR())
+    {
+        CCLOG("cocos2d: FontAtlas: the glyph cache was baked for another font configuration");
+        return false;
+    }
+
+    // 64 bits so that the sizes of a corrupt cache can not overflow
+    if (header->pageCount < 1 || header->letterCount < 0 || header->pageWidth <= 0 || header->pageHeight <= 0)
+    {
+        CCLOG("cocos2d: FontAtlas: the glyph cache is corrupt");
+        return false;
+    }
+    uint64_t pageSize = (uint64_t)header->pageWidth * header->pageHeight * bytesPerPixel;
+    uint64_t expected = sizeof(GlyphCacheHeader) + (uint64_t)header->letterCount * sizeof(GlyphCacheLetter) + (uint64_t)header->pageCount * pageSize;
+    if (pageSize > INT_MAX || (uint64_t)data.getSize() < expected)
+    {
+        CCLOG("cocos2d: FontAtlas: the glyph cache is truncated");
+        return false;
+    }
+
+    auto letters = reinterpret_cast<const GlyphCacheLetter*>(data.getBytes() + sizeof(GlyphCacheHeader));
+    auto pages = reinterpret_cast<const unsigned char*>(letters + header->letterCount);
+
+    // everything is checked before the atlas changes
+    bool valid = header->currentPageOrigX >= 0 && header->currentPageOrigX <= header->pageWidth
+        && header->currentPageOrigY >= 0 && header->currentPageOrigY <= header->pageHeight
+        && header->currentLineHeight >= 0;
+    for (int i = 0; valid && i < header->letterCount; ++i)
+    {
+        valid = letters[i].validDefinition == 0 || (letters[i].textureID >= 0 && letters[i].textureID < header->pageCount);
+    }
+    if (!valid)
+    {
+        CCLOG("cocos2d: FontAtlas: the glyph cache is corrupt");
+        return false;
+    }
+
+    // the pages are created before the atlas changes, so that it is left as it was when the memory runs out
+    Vector<Texture2D*> textures(header->pageCount);
+    auto  pixelFormat = bytesPerPixel == 2 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    for (int i = 0; i < header->pageCount; ++i)
+    {
+        auto tex = new (std::nothrow) Texture2D;
+        if (!tex)
+        {
+            CCLOG("cocos2d: FontAtlas: not enough memory for the glyph cache");
+            return false;
+        }
+        if (_antialiasEnabled)
+        {
+            tex->setAntiAliasTexParameters();
+        }
+        else
+        {
+            tex->setAliasTexParameters();
+        }
+        tex->initWithData(pages + i * pageSize, (ssize_t)pageSize, pixelFormat, header->pageWidth, header->pageHeight, Size(header->pageWidth, header->pageHeight));
+        textures.pushBack(tex);
+        tex->release();
+    }
+
+    if (_currentPageDataSize != (int)pageSize)
+    {
+        auto pageData = new (std::nothrow) unsigned char[(size_t)pageSize];
+        if (!pageData)
+        {
+            CCLOG("cocos2d: FontAtlas: not enough memory for the glyph cache");
+            return false;
+        }
+        delete []_currentPageData;
+        _currentPageDataSize = (int)pageSize;
+        _currentPageData = pageData;
+    }
+    _pageWidth = header->pageWidth;
+    _pageHeight = header->pageHeight;
+
+    releaseTextures();
+    _pageLastUsedFrame.clear();
+    for (int i = 0; i < header->pageCount; ++i)
+    {
+        addTexture(textures.at(i), i);
+        _pageLastUsedFrame.push_back(0);
+    }
+
+    // new glyphs go after the baked ones in the last page
+    _currentPage = header->pageCount - 1;
+    memcpy(_currentPageData, pages + _currentPage * pageSize, (size_t)pageSize);
+    _currentPageOrigX = header->currentPageOrigX;
+    _currentPageOrigY = header->currentPageOrigY;
+    _currLineHeight = header->currentLineHeight;
+    _currentPageDirtyY = static_cast<int>(_currentPageOrigY);
+
+    FontLetterDefinition def;
+    for (int i = 0; i < header->letterCount; ++i)
+    {
+        const GlyphCacheLetter& letter = letters[i];
+        def.validDefinition = letter.validDefinition != 0;
+        def.U = letter.U;
+        def.V = letter.V;
+        def.width = letter.width;
+        def.height = letter.height;
+        def.offsetX = letter.offsetX;
+        def.offsetY = letter.offsetY;
+        def.textureID = letter.textureID;
+        def.xAdvance = letter.xAdvance;
+        _letterDefinitions[(char16_t)letter.utf16Char] = def;
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
 
     return true;
 }
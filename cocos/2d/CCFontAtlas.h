@@ -29,10 +29,13 @@
 /// @cond DO_NOT_SHOW
 
 #include <string>
+#include <vector>
+#include <deque>
 #include <unordered_map>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
+#include "base/CCMap.h"
 #include "platform/CCStdC.h" // ssize_t on windows
 
 NS_CC_BEGIN
@@ -42,6 +45,8 @@ class Texture2D;
 class EventCustom;
 class EventListenerCustom;
 class FontFreeType;
+class Data;
+struct GlyphBitmap;
 
 struct FontLetterDefinition
 {
@@ -63,6 +68,18 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    /** Dispatched with the atlas as user data when letter definitions changed: glyphs rendered in the background
+     were added, or the glyphs of a recycled page removed. The labels using the atlas update their letters.
+     */
+    static const char* CMD_UPDATE_FONTATLAS;
+
+    /** Sets the size of the pages of the atlases created afterwards, CacheTextureWidth x CacheTextureHeight by default. */
+    static void setDefaultPageSize(int width, int height);
+    /** Sets the page budget of the atlases created afterwards, see setMaxPageCount. */
+    static void setDefaultMaxPageCount(int count);
+    /** Sets whether the atlases created afterwards render the glyphs in the background, see setAsyncRasterization. */
+    static void setDefaultAsyncRasterization(bool async);
+
     /**
      * @js ctor
      */
@@ -83,6 +100,46 @@ public:
     float getLineHeight() const { return _lineHeight; }
     void  setLineHeight(float newHeight);
 
+    int getPageWidth() const { return _pageWidth; }
+    int getPageHeight() const { return _pageHeight; }
+
+    /** Sets the number of pages after which a full page is recycled instead of adding a new one, 0 (no limit) by default.
+     The least recently drawn page is cleared and its glyphs are rendered again when a label needs them.
+     A page drawn during the current or the previous frame is never recycled, the atlas grows past the budget instead.
+     */
+    void setMaxPageCount(int count) { _maxPageCount = count; }
+    int getMaxPageCount() const { return _maxPageCount; }
+
+    /** Sets whether new glyphs are rendered on a worker thread, false by default.
+     prepareLetterDefinitions then adds placeholders with the final advance and no pixels, so the layout of the labels
+     is already right, and the glyphs appear a few frames later, announced with CMD_UPDATE_FONTATLAS.
+     */
+    void setAsyncRasterization(bool async) { _asyncRasterization = async; }
+    bool isAsyncRasterization() const { return _asyncRasterization; }
+
+    /** Marks a page as drawn during this frame, called by Label::draw. */
+    void touchPage(int slot);
+
+    /** Renders the glyphs of utf16Text and writes the pages and the letter definitions to a binary glyph cache,
+     loaded at startup with loadGlyphCache instead of rendering the glyphs again. The atlas must not hold glyphs yet.
+     */
+    bool bakeGlyphCache(const std::u16string& utf16Text, const std::string& filename);
+
+    /** Replaces the pages and letter definitions of an atlas without glyphs by the ones of a glyph cache.
+     The cache must have been baked with the same font size, effect and content scale factor,
+     the glyphs missing from it are rendered as usual.
+     */
+    bool loadGlyphCache(const Data& data);
+
+    /** Returns a layout cached with cacheLayout, or nullptr. */
+    Ref* getCachedLayout(const std::string& key) const;
+
+    /** Keeps the layout of a string for the labels using this atlas, dropping the oldest layouts past maxCount.
+     The layouts are dropped when the metrics of the glyphs change.
+     */
+    void cacheLayout(const std::string& key, Ref* layout, int maxCount);
+    void removeCachedLayouts();
+
     Texture2D* getTexture(int slot);
     const Font* getFont() const { return _font; }
 
@@ -124,6 +181,14 @@ protected:
      */
     void scaleFontLetterDefinition(float scaleFactor);
 
+    /** Copies a rendered glyph in the current page, starting a new page or recycling one when it is full. */
+    void addGlyph(char16_t utf16Char, const GlyphBitmap& glyph);
+    void startNewPage();
+    int findPageToRecycle() const;
+    /** Uploads the rows of the current page changed since the last upload. */
+    void updateCurrentPageTexture(int endY);
+    void addGlyphsRenderedAsync(const std::vector<char16_t>& utf16Chars, const std::vector<GlyphBitmap>& glyphs, unsigned int generation);
+
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<char16_t, FontLetterDefinition> _letterDefinitions;
     float _lineHeight;
@@ -145,6 +210,23 @@ protected:
     bool _antialiasEnabled;
     int _currLineHeight;
 
+    int _pageWidth;
+    int _pageHeight;
+    int _currentPageDirtyY;
+    int _maxPageCount;
+    std::vector<unsigned int> _pageLastUsedFrame;
+    bool _asyncRasterization;
+    // incremented by reset, the glyphs of an older generation rendered in the background are dropped
+    unsigned int _generation;
+
+    // pages filled while baking a glyph cache, uploaded pages are otherwise not kept in memory
+    bool _keepPageData;
+    std::vector<std::vector<unsigned char>> _keptPages;
+
+    // layouts of the labels, in insertion order
+    Map<std::string, Ref*> _cachedLayouts;
+    std::deque<std::string> _cachedLayoutKeys;
+
     friend class Label;
 };
 
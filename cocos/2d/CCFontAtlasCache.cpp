@@ -31,10 +31,13 @@
 #include "2d/CCFontCharMap.h"
 #include "2d/CCLabel.h"
 #include "2d/CCSpriteFrame.h"
+#include "base/ccUTF8.h"
+#include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+float FontAtlasCache::_sharedDistanceFieldFontSize = 0.0f;
 #define ATLAS_MAP_KEY_BUFFER 255
 
 void FontAtlasCache::purgeCachedData()
@@ -47,29 +50,42 @@ void FontAtlasCache::purgeCachedData()
     _atlasMap.clear();
 }
 
-FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
+std::string FontAtlasCache::getTTFAtlasName(const _ttfConfig* config, float* fontSize, bool* useDistanceField)
 {
-    bool useDistanceField = config->distanceFieldEnabled;
+    *useDistanceField = config->distanceFieldEnabled;
     if(config->outlineSize > 0)
     {
-        useDistanceField = false;
+        *useDistanceField = false;
+    }
+
+    *fontSize = config->fontSize;
+    if (*useDistanceField && _sharedDistanceFieldFontSize > 0)
+    {
+        *fontSize = _sharedDistanceFieldFontSize;
     }
 
     char tmp[ATLAS_MAP_KEY_BUFFER];
-    if (useDistanceField) {
-        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "df %.2f %d %s", config->fontSize, config->outlineSize,
+    if (*useDistanceField) {
+        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "df %.2f %d %s", *fontSize, config->outlineSize,
                  config->fontFilePath.c_str());
     } else {
-        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "%.2f %d %s", config->fontSize, config->outlineSize,
+        snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "%.2f %d %s", *fontSize, config->outlineSize,
                  config->fontFilePath.c_str());
     }
-    std::string atlasName = tmp;
+    return tmp;
+}
+
+FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
+{
+    float fontSize;
+    bool useDistanceField;
+    std::string atlasName = getTTFAtlasName(config, &fontSize, &useDistanceField);
 
     auto it = _atlasMap.find(atlasName);
 
     if ( it == _atlasMap.end() )
     {
-        auto font = FontFreeType::create(config->fontFilePath, config->fontSize, config->glyphs,
+        auto font = FontFreeType::create(config->fontFilePath, fontSize, config->glyphs,
             config->customGlyphs, useDistanceField, config->outlineSize);
         if (font)
         {
@@ -277,4 +293,64 @@ void FontAtlasCache::unloadFontAtlasTTF(const std::string& fontFileName)
     }
 }
 
+bool FontAtlasCache::bakeGlyphCache(const _ttfConfig* config, const std::string& utf8Text, const std::string& filename)
+{
+    std::u16string utf16Text;
+    if (!StringUtils::UTF8ToUTF16(utf8Text, utf16Text))
+        return false;
+
+    float fontSize;
+    bool useDistanceField;
+    getTTFAtlasName(config, &fontSize, &useDistanceField);
+
+    // a private atlas, the glyphs of the labels already using the cached one must not be baked
+    auto font = FontFreeType::create(config->fontFilePath, fontSize, GlyphCollection::DYNAMIC,
+        nullptr, useDistanceField, config->outlineSize);
+    if (!font)
+        return false;
+
+    auto atlas = font->createFontAtlas();
+    if (!atlas)
+        return false;
+
+    bool ret = atlas->bakeGlyphCache(utf16Text, filename);
+    atlas->release();
+    return ret;
+}
+
+bool FontAtlasCache::loadGlyphCache(const _ttfConfig* config, const std::string& filename)
+{
+    float fontSize;
+    bool useDistanceField;
+    std::string atlasName = getTTFAtlasName(config, &fontSize, &useDistanceField);
+    if (_atlasMap.find(atlasName) != _atlasMap.end())
+    {
+        CCLOG("cocos2d: FontAtlasCache: the atlas of %s is already in use", config->fontFilePath.c_str());
+        return false;
+    }
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    if (data.isNull())
+        return false;
+
+    auto font = FontFreeType::create(config->fontFilePath, fontSize, GlyphCollection::DYNAMIC,
+        nullptr, useDistanceField, config->outlineSize);
+    if (!font)
+        return false;
+
+    auto atlas = font->createFontAtlas();
+    if (!atlas)
+        return false;
+
+    if (!atlas->loadGlyphCache(data))
+    {
+        atlas->release();
+        return false;
+    }
+
+    // this reference is the cache's own, the atlas stays loaded when its labels are released
+    _atlasMap[atlasName] = atlas;
+    return true;
+}
+
 NS_CC_END
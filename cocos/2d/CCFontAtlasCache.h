@@ -71,8 +71,26 @@ public:
     */
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
+    /** Sets the font size of the glyphs of the distance field atlases, 0 by default.
+     When not 0, the distance field TTF labels without outline of every size share one atlas per font file,
+     rendered at this size and scaled by the labels. Affects the atlases created afterwards.
+     */
+    static void setSharedDistanceFieldFontSize(float fontSize) { _sharedDistanceFieldFontSize = fontSize; }
+    static float getSharedDistanceFieldFontSize() { return _sharedDistanceFieldFontSize; }
+
+    /** Renders the glyphs of utf8Text with the font of config and writes them to a glyph cache file. */
+    static bool bakeGlyphCache(const _ttfConfig* config, const std::string& utf8Text, const std::string& filename);
+
+    /** Creates the atlas of config from a glyph cache file baked by bakeGlyphCache, to skip rendering the glyphs at runtime.
+     Call it before any label uses the atlas. The cache keeps the atlas until it is purged.
+     */
+    static bool loadGlyphCache(const _ttfConfig* config, const std::string& filename);
+
 private:
+    static std::string getTTFAtlasName(const _ttfConfig* config, float* fontSize, bool* useDistanceField);
+
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static float _sharedDistanceFieldFontSize;
 };
 
 NS_CC_END
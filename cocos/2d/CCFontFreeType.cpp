@@ -25,12 +25,16 @@ THE SOFTWARE.
 
 #include "2d/CCFontFreeType.h"
 #include FT_BBOX_H
-#include "edtaa3func/edtaa3func.h"
 #include "2d/CCFontAtlas.h"
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
 
+#include <mutex>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
 NS_CC_BEGIN
 
 
@@ -49,6 +53,9 @@ typedef struct _DataRef
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
 
+// FreeType objects are not thread safe, FontAtlas may render glyphs on a worker thread
+static std::mutex s_freeTypeMutex;
+
 FontFreeType * FontFreeType::create(const std::string &fontName, float fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,int outline /* = 0 */)
 {
     FontFreeType *tempFont =  new FontFreeType(distanceFieldEnabled,outline);
@@ -82,6 +89,7 @@ bool FontFreeType::initFreeType()
 
 void FontFreeType::shutdownFreeType()
 {
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
     if (_FTInitialized == true)
     {
         FT_Done_FreeType(_FTlibrary);
@@ -102,12 +110,14 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /
 , _distanceFieldEnabled(distanceFieldEnabled)
 , _outlineSize(0.0f)
 , _lineHeight(0)
+, _fontSize(0.0f)
 , _fontAtlas(nullptr)
 , _encoding(FT_ENCODING_UNICODE)
 , _usedGlyphs(GlyphCollection::ASCII)
 {
     if (outline > 0)
     {
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
         _outlineSize = outline * CC_CONTENT_SCALE_FACTOR();
         FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
         FT_Stroker_Set(_stroker,
@@ -120,6 +130,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */,int outline /
 
 bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 {
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
     FT_Face face;
     // save font name locally
     _fontName = fontName;
@@ -175,6 +186,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
     // store the face globally
     _fontRef = face;
+    _fontSize = fontSize;
     _lineHeight = static_cast<int>(_fontRef->size->metrics.height >> 6);
 
     // done and good
@@ -183,6 +195,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
     if (_FTInitialized)
     {
         if (_stroker)
@@ -239,6 +252,7 @@ int * FontFreeType::getHorizontalKerningForTextUTF16(const std::u16string& text,
     bool hasKerning = FT_HAS_KERNING( _fontRef ) != 0;
     if (hasKerning)
     {
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
         for (int c = 1; c < outNumLetters; ++c)
         {
             sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
@@ -450,88 +464,108 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar,
     return ret;
 }
 
+namespace
+{
+    const float DISTANCE_INFINITY = 1e20f;
+
+    // squared euclidean distance transform of one row or column, in linear time (Felzenszwalb and Huttenlocher):
+    // the lower envelope of the parabolas rooted at every pixel
+    void squaredDistanceTransform1D(float* grid, int offset, int stride, int length, float* f, int* v, float* z)
+    {
+        v[0] = 0;
+        z[0] = -DISTANCE_INFINITY;
+        z[1] = DISTANCE_INFINITY;
+        f[0] = grid[offset];
+
+        for (int q = 1, k = 0; q < length; ++q)
+        {
+            f[q] = grid[offset + q * stride];
+            float s = 0;
+            do
+            {
+                int r = v[k];
+                s = (f[q] - f[r] + q * q - r * r) / (q - r) / 2;
+            } while (s <= z[k] && --k > -1);
+
+            ++k;
+            v[k] = q;
+            z[k] = s;
+            z[k + 1] = DISTANCE_INFINITY;
+        }
+
+        for (int q = 0, k = 0; q < length; ++q)
+        {
+            while (z[k + 1] < q)
+                ++k;
+            int r = v[k];
+            grid[offset + q * stride] = f[r] + (q - r) * (q - r);
+        }
+    }
+
+    void squaredDistanceTransform(float* grid, int width, int height, float* f, int* v, float* z)
+    {
+        for (int x = 0; x < width; ++x)
+            squaredDistanceTransform1D(grid, x, width, height, f, v, z);
+        for (int y = 0; y < height; ++y)
+            squaredDistanceTransform1D(grid, y * width, 1, width, f, v, z);
+    }
+}
+
 unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 {
-    long pixelAmount = (width + 2 * FontFreeType::DistanceMapSpread) * (height + 2 * FontFreeType::DistanceMapSpread);
-
-    short * xdist = (short *)  malloc( pixelAmount * sizeof(short) );
-    short * ydist = (short *)  malloc( pixelAmount * sizeof(short) );
-    double * gx   = (double *) calloc( pixelAmount, sizeof(double) );
-    double * gy      = (double *) calloc( pixelAmount, sizeof(double) );
-    double * data    = (double *) calloc( pixelAmount, sizeof(double) );
-    double * outside = (double *) calloc( pixelAmount, sizeof(double) );
-    double * inside  = (double *) calloc( pixelAmount, sizeof(double) );
-    long i,j;
-
-    // Convert img into double (data) rescale image levels between 0 and 1
-    long outWidth = width + 2 * FontFreeType::DistanceMapSpread;
-    for (i = 0; i < width; ++i)
+    const int spread = FontFreeType::DistanceMapSpread;
+    long outWidth = width + 2 * spread;
+    long outHeight = height + 2 * spread;
+    long pixelAmount = outWidth * outHeight;
+
+    // squared distances to the nearest pixel inside and outside the glyph, the border is outside;
+    // antialiased pixels start at their distance to the 0.5 coverage edge
+    std::vector<float> outside(pixelAmount, DISTANCE_INFINITY);
+    std::vector<float> inside(pixelAmount, 0.0f);
+    for (long j = 0; j < height; ++j)
     {
-        for (j = 0; j < height; ++j)
+        for (long i = 0; i < width; ++i)
         {
-            data[j * outWidth + FontFreeType::DistanceMapSpread + i] = img[j * width + i] / 255.0;
+            long index = (j + spread) * outWidth + i + spread;
+            unsigned char coverage = img[j * width + i];
+            if (coverage == 255)
+            {
+                outside[index] = 0.0f;
+                inside[index] = DISTANCE_INFINITY;
+            }
+            else if (coverage > 0)
+            {
+                float a = coverage / 255.0f;
+                float outsideDistance = std::max(0.0f, 0.5f - a);
+                float insideDistance = std::max(0.0f, a - 0.5f);
+                outside[index] = outsideDistance * outsideDistance;
+                inside[index] = insideDistance * insideDistance;
+            }
         }
     }
 
-    width += 2 * FontFreeType::DistanceMapSpread;
-    height += 2 * FontFreeType::DistanceMapSpread;
-
-    // Transform background (outside contour, in areas of 0's)
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, outside);
-    for( i=0; i< pixelAmount; i++)
-        if( outside[i] < 0.0 )
-            outside[i] = 0.0;
-
-    // Transform foreground (inside contour, in areas of 1's)
-    for( i=0; i< pixelAmount; i++)
-        data[i] = 1 - data[i];
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, inside);
-    for( i=0; i< pixelAmount; i++)
-        if( inside[i] < 0.0 )
-            inside[i] = 0.0;
-
-    // The bipolar distance field is now outside-inside
-    double dist;
-    /* Single channel 8-bit output (bad precision and range, but simple) */
+    long maxLength = std::max(outWidth, outHeight);
+    std::vector<float> f(maxLength);
+    std::vector<float> z(maxLength + 1);
+    std::vector<int> v(maxLength);
+    squaredDistanceTransform(outside.data(), (int)outWidth, (int)outHeight, f.data(), v.data(), z.data());
+    squaredDistanceTransform(inside.data(), (int)outWidth, (int)outHeight, f.data(), v.data(), z.data());
+
+    // The bipolar distance field is outside-inside, single channel 8-bit output
     unsigned char *out = (unsigned char *) malloc( pixelAmount * sizeof(unsigned char) );
-    for( i=0; i < pixelAmount; i++)
+    for (long i = 0; i < pixelAmount; ++i)
     {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
+        float dist = std::sqrt(outside[i]) - std::sqrt(inside[i]);
+        dist = 128.0f - dist * 16;
         if( dist < 0 ) dist = 0;
         if( dist > 255 ) dist = 255;
         out[i] = (unsigned char) dist;
     }
-    /* Dual channel 16-bit output (more complicated, but good precision and range) */
-    /*unsigned char *out = (unsigned char *) malloc( pixelAmount * 3 * sizeof(unsigned char) );
-    for( i=0; i< pixelAmount; i++)
-    {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
-        if( dist < 0.0 ) dist = 0.0;
-        if( dist >= 256.0 ) dist = 255.999;
-        // R channel is a copy of the original grayscale image
-        out[3*i] = img[i];
-        // G channel is fraction
-        out[3*i + 1] = (unsigned char) ( 256 - (dist - floor(dist)* 256.0 ));
-        // B channel is truncated integer part
-        out[3*i + 2] = (unsigned char)dist;
-    }*/
-
-    free( xdist );
-    free( ydist );
-    free( gx );
-    free( gy );
-    free( data );
-    free( outside );
-    free( inside );
 
     return out;
 }
 
-void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
+void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight,int destWidth)
 {
     int iX = posX;
     int iY = posY;
@@ -557,7 +591,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 dest[index + 2] = out[index2 + 2];*/
 
                 //Single channel 8-bit output
-                dest[iX + ( iY * FontAtlas::CacheTextureWidth )] = distanceMap[bitmap_y + x];
+                dest[iX + ( iY * destWidth )] = distanceMap[bitmap_y + x];
 
                 iX += 1;
             }
@@ -577,9 +611,9 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             for (int x = 0; x < bitmapWidth; ++x)
             {
                 tempChar = bitmap[(bitmap_y + x) * 2];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2] = tempChar;
                 tempChar = bitmap[(bitmap_y + x) * 2 + 1];
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) ) * 2 + 1] = tempChar;
+                dest[(iX + ( iY * destWidth ) ) * 2 + 1] = tempChar;
 
                 iX += 1;
             }
@@ -600,7 +634,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
                 unsigned char cTemp = bitmap[bitmap_y + x];
 
                 // the final pixel
-                dest[(iX + ( iY * FontAtlas::CacheTextureWidth ) )] = cTemp;
+                dest[(iX + ( iY * destWidth ) )] = cTemp;
 
                 iX += 1;
             }
@@ -611,6 +645,52 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
     }
 }
 
+bool FontFreeType::renderGlyph(unsigned short charCode, GlyphBitmap& glyph)
+{
+    unsigned char* bitmap = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+        bitmap = getGlyphBitmap(charCode, glyph.width, glyph.height, glyph.rect, glyph.xAdvance);
+
+        glyph.bytesPerPixel = _outlineSize > 0 ? 2 : 1;
+        glyph.pixels.clear();
+        if (bitmap && glyph.width > 0 && glyph.height > 0)
+        {
+            // the bitmap of the face is overwritten by the next glyph
+            glyph.pixels.assign(bitmap, bitmap + glyph.width * glyph.height * glyph.bytesPerPixel);
+        }
+        if (_outlineSize > 0)
+        {
+            delete [] bitmap;
+        }
+    }
+
+    if (!glyph.pixels.empty() && _distanceFieldEnabled)
+    {
+        auto distanceMap = makeDistanceMap(glyph.pixels.data(), glyph.width, glyph.height);
+        glyph.width += 2 * DistanceMapSpread;
+        glyph.height += 2 * DistanceMapSpread;
+        glyph.pixels.assign(distanceMap, distanceMap + glyph.width * glyph.height);
+        free(distanceMap);
+    }
+
+    return !glyph.pixels.empty();
+}
+
+int FontFreeType::getGlyphAdvance(unsigned short charCode)
+{
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+    if (_fontRef == nullptr)
+        return 0;
+
+    // the same hinting as getGlyphBitmap, so the advance is the same
+    FT_Int32 flags = _distanceFieldEnabled ? FT_LOAD_NO_HINTING | FT_LOAD_NO_AUTOHINT : FT_LOAD_NO_AUTOHINT;
+    if (FT_Load_Char(_fontRef, charCode, flags))
+        return 0;
+
+    return static_cast<int>(_fontRef->glyph->metrics.horiAdvance >> 6);
+}
+
 void FontFreeType::setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs /* = nullptr */)
 {
     _usedGlyphs = glyphs;
@@ -31,6 +31,7 @@
 #include "2d/CCFont.h"
 
 #include <string>
+#include <vector>
 #include <ft2build.h>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -48,6 +49,17 @@
 
 NS_CC_BEGIN
 
+/** The pixels of a glyph rendered by FontFreeType::renderGlyph, ready to be copied in a FontAtlas page. */
+struct GlyphBitmap
+{
+    std::vector<unsigned char> pixels;  // empty for glyphs without pixels, such as spaces
+    long width;
+    long height;
+    int bytesPerPixel;
+    Rect rect;
+    int xAdvance;
+};
+
 class CC_DLL FontFreeType : public Font
 {
 public:
@@ -62,7 +74,16 @@ public:
 
     float getOutlineSize() const { return _outlineSize; }
 
-    void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight);
+    void renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight,int destWidth);
+
+    /** Renders a glyph, with its distance map or outline, into glyph.pixels.
+     * Unlike getGlyphBitmap it may be called from any thread, the FreeType calls of all the fonts are serialized.
+     * @return False if the glyph has no pixels, glyph.xAdvance is 0 if the font has no such glyph.
+     */
+    bool renderGlyph(unsigned short charCode, GlyphBitmap& glyph);
+
+    /** Returns the advance of a glyph without rendering it, 0 if the font has no such glyph. May be called from any thread. */
+    int getGlyphAdvance(unsigned short charCode);
 
     FT_Encoding getEncoding() const { return _encoding; }
 
@@ -72,6 +93,9 @@ public:
 
     int getFontAscender() const;
 
+    /** Returns the size the font was created with, in points. */
+    float getFontSize() const { return _fontSize; }
+
     const char* getFontFamily() const;
 
     virtual FontAtlas* createFontAtlas() override;
@@ -107,6 +131,7 @@ private:
     bool _distanceFieldEnabled;
     float _outlineSize;
     int _lineHeight;
+    float _fontSize;
     FontAtlas* _fontAtlas;
 
     GlyphCollection _usedGlyphs;
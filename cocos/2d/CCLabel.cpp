@@ -41,6 +41,10 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontFreeType.h"
+#include "2d/CCDynamicAtlas.h"
+#include "platform/CCGLView.h"
+#include "renderer/CCGLProgramCache.h"
 #include "2d/CCSpriteFrame.h"
 
 NS_CC_BEGIN
@@ -387,6 +391,7 @@ Label::Label()
 , _horizontalKernings(nullptr)
 , _purgeTextureListener(nullptr)
 , _resetTextureListener(nullptr)
+, _updateTextureListener(nullptr)
 #if CC_LABEL_DEBUG_DRAW
 , _debugDrawNode(nullptr)
 #endif
@@ -438,6 +443,12 @@ Label::Label()
 , _useA8Shader(false)
 , _shadowDirty(false)
 , _shadowEnabled(false)
+, _atlasUpdated(false)
+, _effectCacheEnabled(false)
+, _effectCacheDirty(true)
+, _effectCacheTexture(nullptr)
+, _effectCacheScale(0.0f)
+, _effectCacheGeneration(0)
 {
     setAnchorPoint(Vec2::ANCHOR_MIDDLE);
     setColor(Color3B::WHITE);
@@ -476,6 +487,15 @@ Label::Label()
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    _updateTextureListener = EventListenerCustom::create(FontAtlas::CMD_UPDATE_FONTATLAS, [this](EventCustom* event){
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
+        {
+            _contentDirty = true;
+            _atlasUpdated = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_updateTextureListener, 3);
 }
 
 Label::~Label()
@@ -495,6 +515,10 @@ Label::~Label()
     _purgeTextureListener = nullptr;
     _eventDispatcher->removeEventListener(_resetTextureListener);
     _resetTextureListener = nullptr;
+    _eventDispatcher->removeEventListener(_updateTextureListener);
+    _updateTextureListener = nullptr;
+
+    releaseEffectCache();
 
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
@@ -579,6 +603,40 @@ void Label::reset()
     }
     _strikethroughEnabled = false;
     setRotationSkewX(0);        // reverse italics
+
+    _lineStarts.clear();
+    _lineQuadStarts.clear();
+    _layoutText.clear();
+    _layoutSignature.clear();
+
+    releaseEffectCache();
+    _effectCacheEnabled = false;
+}
+
+static int s_layoutCacheSize = 64;
+
+// the result of multilineTextWrap, shared through the font atlas by the labels showing the same string
+class Label::CachedLayout : public Ref
+{
+public:
+    std::vector<LetterInfo> lettersInfo;
+    std::vector<float> linesWidth;
+    std::vector<LineStart> lineStarts;
+    int numberOfLines;
+    float textDesiredHeight;
+    float tailoredTopY;
+    float tailoredBottomY;
+    Size contentSize;
+};
+
+void Label::setLayoutCacheSize(int size)
+{
+    s_layoutCacheSize = size;
+}
+
+int Label::getLayoutCacheSize()
+{
+    return s_layoutCacheSize;
 }
 
 //  ETC1 ALPHA supports, for LabelType::BMFONT & LabelType::CHARMAP
@@ -654,6 +712,8 @@ void Label::setFontAtlas(FontAtlas* atlas,bool distanceFieldEnabled /* = false *
     }
 
     _fontAtlas = atlas;
+    // laid out with other glyphs
+    _layoutSignature.clear();
     if (_reusedLetter == nullptr)
     {
         _reusedLetter = Sprite::create();
@@ -883,6 +943,7 @@ bool Label::alignText()
                     _batchNodes.pushBack(batchNode);
                 }
             }
+            _lineQuadStarts.clear();
         }
         if (_batchNodes.empty())
         {
@@ -890,19 +951,62 @@ bool Label::alignText()
         }
         _reusedLetter->setBatchNode(_batchNodes.at(0));
 
-        _lengthOfString = 0;
-        _textDesiredHeight = 0.f;
-        _linesWidth.clear();
-        if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
+        // the shrink overflow scales the glyphs while wrapping, its layouts are neither kept nor cached
+        bool reuseLayout = _overflow != Overflow::SHRINK;
+        updateBMFontScale();
+        std::string signature = getLayoutSignature();
+        int firstLine = 0;
+        if (reuseLayout && !_atlasUpdated && signature == _layoutSignature)
         {
-            multilineTextWrapByWord();
+            firstLine = getFirstChangedLine();
         }
-        else
+
+        std::vector<float> linesOffsetX;
+        linesOffsetX.swap(_linesOffsetX);
+        float letterOffsetY = _letterOffsetY;
+        float tailoredTopY = _tailoredTopY;
+        float tailoredBottomY = _tailoredBottomY;
+        Size contentSize = _contentSize;
+
+        std::string cacheKey;
+        if (reuseLayout && s_layoutCacheSize > 0)
         {
-            multilineTextWrapByChar();
+            cacheKey = signature;
+            cacheKey.append(reinterpret_cast<const char*>(_utf16Text.data()), _utf16Text.size() * sizeof(char16_t));
+        }
+        if (cacheKey.empty() || !restoreCachedLayout(cacheKey))
+        {
+            // only the wrap reads the kernings, a cached layout already has them applied
+            computeHorizontalKernings(_utf16Text);
+            _lengthOfString = 0;
+            _textDesiredHeight = 0.f;
+            if (_maxLineWidth > 0.f && !_lineBreakWithoutSpaces)
+            {
+                multilineTextWrapByWord(firstLine);
+            }
+            else
+            {
+                multilineTextWrapByChar(firstLine);
+            }
+            if (!cacheKey.empty())
+            {
+                cacheLayout(cacheKey);
+            }
         }
         computeAlignmentOffset();
 
+        // the quads of the lines kept by the wrap are kept when they do not move
+        int firstQuadLine = 0;
+        if (firstLine > 0
+            && _letterOffsetY == letterOffsetY && _tailoredTopY == tailoredTopY && _tailoredBottomY == tailoredBottomY
+            && _contentSize.equals(contentSize)
+            && static_cast<size_t>(firstLine + 1) * _batchNodes.size() <= _lineQuadStarts.size()
+            && linesOffsetX.size() >= static_cast<size_t>(firstLine)
+            && std::equal(linesOffsetX.begin(), linesOffsetX.begin() + firstLine, _linesOffsetX.begin()))
+        {
+            firstQuadLine = firstLine;
+        }
+
         if(_overflow == Overflow::SHRINK){
             float fontSize = this->getRenderingFontSize();
 
@@ -911,7 +1015,11 @@ bool Label::alignText()
             }
         }
 
-        if(!updateQuads()){
+        _layoutText = _utf16Text;
+        _layoutSignature = reuseLayout ? signature : std::string();
+        _atlasUpdated = false;
+
+        if(!updateQuads(firstQuadLine)){
             ret = false;
             if(_overflow == Overflow::SHRINK){
                 this->shrinkLabelToContentSize(CC_CALLBACK_0(Label::isHorizontalClamp, this));
@@ -940,8 +1048,21 @@ bool Label::computeHorizontalKernings(const std::u16string& stringToRender)
 
     if(!_horizontalKernings)
         return false;
-    else
-        return true;
+
+    // kernings of a shared distance field atlas are in the units of its font size
+    if (_currentLabelType == LabelType::TTF && _useDistanceField)
+    {
+        float atlasFontSize = ((FontFreeType*)_fontAtlas->getFont())->getFontSize();
+        if (atlasFontSize > 0 && atlasFontSize != _fontConfig.fontSize)
+        {
+            float scale = _fontConfig.fontSize / atlasFontSize;
+            for (int i = 0; i < letterCount; ++i)
+            {
+                _horizontalKernings[i] = (int)(_horizontalKernings[i] * scale);
+            }
+        }
+    }
+    return true;
 }
 
 bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
@@ -955,17 +1076,134 @@ bool Label::isHorizontalClamped(float letterPositionX, int lineIndex)
     }
 }
 
-bool Label::updateQuads()
+std::string Label::getLayoutSignature() const
+{
+    // everything multilineTextWrap reads besides the string and the glyphs of the atlas
+    const float values[] = {
+        _bmfontScale, _maxLineWidth, _labelWidth, _labelHeight, _lineHeight, _lineSpacing, _additionalKerning,
+        CC_CONTENT_SCALE_FACTOR()
+    };
+    const int flags[] = {
+        static_cast<int>(_currentLabelType), static_cast<int>(_overflow), _enableWrap, _lineBreakWithoutSpaces
+    };
+    std::string signature(reinterpret_cast<const char*>(values), sizeof(values));
+    signature.append(reinterpret_cast<const char*>(flags), sizeof(flags));
+    return signature;
+}
+
+int Label::getFirstChangedLine() const
+{
+    size_t length = std::min(_layoutText.size(), _utf16Text.size());
+    auto changed = static_cast<int>(std::mismatch(_utf16Text.begin(), _utf16Text.begin() + length, _layoutText.begin()).first - _utf16Text.begin());
+    if (changed == 0 || _lineStarts.empty())
+    {
+        return 0;
+    }
+
+    // the line of the last unchanged letter
+    int line = static_cast<int>(_lineStarts.size()) - 1;
+    while (line > 0 && _lineStarts[line].letterIndex > changed - 1)
+    {
+        --line;
+    }
+    // a changed word at the start of that line may now fit at the end of the previous one
+    return std::max(0, line - 1);
+}
+
+bool Label::restoreCachedLayout(const std::string& key)
+{
+    auto layout = static_cast<CachedLayout*>(_fontAtlas->getCachedLayout(key));
+    if (!layout)
+    {
+        return false;
+    }
+
+    // the atlas indices are not cached, the ones of the kept quads stay valid
+    size_t count = layout->lettersInfo.size();
+    size_t keptCount = std::min(count, _lettersInfo.size());
+    for (size_t i = 0; i < keptCount; ++i)
+    {
+        int atlasIndex = _lettersInfo[i].atlasIndex;
+        _lettersInfo[i] = layout->lettersInfo[i];
+        _lettersInfo[i].atlasIndex = atlasIndex;
+    }
+    _lettersInfo.insert(_lettersInfo.end(), layout->lettersInfo.begin() + keptCount, layout->lettersInfo.end());
+
+    _linesWidth = layout->linesWidth;
+    _lineStarts = layout->lineStarts;
+    _numberOfLines = layout->numberOfLines;
+    _textDesiredHeight = layout->textDesiredHeight;
+    _tailoredTopY = layout->tailoredTopY;
+    _tailoredBottomY = layout->tailoredBottomY;
+    _lengthOfString = static_cast<int>(_utf16Text.length());
+    setContentSize(layout->contentSize);
+    return true;
+}
+
+void Label::cacheLayout(const std::string& key)
+{
+    auto layout = new (std::nothrow) CachedLayout;
+    if (!layout)
+    {
+        return;
+    }
+
+    layout->lettersInfo.assign(_lettersInfo.begin(), _lettersInfo.begin() + std::min(_lettersInfo.size(), _utf16Text.size()));
+    layout->linesWidth = _linesWidth;
+    layout->lineStarts = _lineStarts;
+    layout->numberOfLines = _numberOfLines;
+    layout->textDesiredHeight = _textDesiredHeight;
+    layout->tailoredTopY = _tailoredTopY;
+    layout->tailoredBottomY = _tailoredBottomY;
+    layout->contentSize = _contentSize;
+    _fontAtlas->cacheLayout(key, layout, s_layoutCacheSize);
+    layout->release();
+}
+
+bool Label::updateQuads(int firstLine)
 {
     bool ret = true;
-    for (auto&& batchNode : _batchNodes)
+    size_t batchCount = _batchNodes.size();
+    int firstLetter = 0;
+    if (firstLine > 0)
     {
-        batchNode->getTextureAtlas()->removeAllQuads();
+        // the quads of the letters before firstLine are kept
+        firstLetter = _lineStarts[firstLine].letterIndex;
+        for (size_t batch = 0; batch < batchCount; ++batch)
+        {
+            auto textureAtlas = _batchNodes.at(batch)->getTextureAtlas();
+            ssize_t keptQuads = _lineQuadStarts[firstLine * batchCount + batch];
+            if (textureAtlas->getTotalQuads() > keptQuads)
+            {
+                textureAtlas->removeQuadsAtIndex(keptQuads, textureAtlas->getTotalQuads() - keptQuads);
+            }
+        }
+    }
+    else
+    {
+        for (auto&& batchNode : _batchNodes)
+        {
+            batchNode->getTextureAtlas()->removeAllQuads();
+        }
     }
 
+    _lineQuadStarts.resize(firstLine * batchCount);
+    int quadLine = firstLine;
+    int lineCount = static_cast<int>(_lineStarts.size());
+    auto recordLineQuadStarts = [&](int letterIndex) {
+        for (; quadLine < lineCount && _lineStarts[quadLine].letterIndex <= letterIndex; ++quadLine)
+        {
+            for (auto&& batchNode : _batchNodes)
+            {
+                _lineQuadStarts.push_back(static_cast<int>(batchNode->getTextureAtlas()->getTotalQuads()));
+            }
+        }
+    };
+
     bool letterClamp = false;
-    for (int ctr = 0; ctr < _lengthOfString; ++ctr)
+    for (int ctr = firstLetter; ctr < _lengthOfString; ++ctr)
     {
+        recordLineQuadStarts(ctr);
         if (_lettersInfo[ctr].valid)
         {
             auto& letterDef = _fontAtlas->_letterDefinitions[_lettersInfo[ctr].utf16Char];
@@ -1055,6 +1293,14 @@ bool Label::updateQuads()
         }
     }
 
+    if (ret)
+    {
+        recordLineQuadStarts(_lengthOfString);
+    }
+    else
+    {
+        _lineQuadStarts.clear();
+    }
 
     return ret;
 }
@@ -1469,6 +1715,7 @@ void Label::updateContent()
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
     bool updateFinished = true;
+    _effectCacheDirty = true;
 
     if (_fontAtlas)
     {
@@ -1478,7 +1725,6 @@ void Label::updateContent()
             _utf16Text = utf16String;
         }
 
-        computeHorizontalKernings(_utf16Text);
         updateFinished = alignText();
     }
     else
@@ -1616,6 +1862,11 @@ void Label::onDraw(const Mat4& transform, bool transformUpdated)
     glprogram->use();
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
 
+    drawEffects(glprogram, transform);
+}
+
+void Label::drawEffects(GLProgram* glprogram, const Mat4& transform)
+{
     if (_shadowEnabled)
     {
         if (_boldEnabled)
@@ -1680,7 +1931,26 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if (_insideBounds)
 #endif
     {
-        if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
+        if (_currentLabelType == LabelType::TTF)
+        {
+            // keeps the pages of the visible letters out of the glyph recycling
+            for (ssize_t index = 0; index < _batchNodes.size(); ++index)
+            {
+                if (_batchNodes.at(index)->getTextureAtlas()->getTotalQuads() > 0)
+                {
+                    _fontAtlas->touchPage(static_cast<int>(index));
+                }
+            }
+        }
+
+        if (_effectCacheEnabled && updateEffectCache(renderer, transform))
+        {
+            _quadCommand.init(_globalZOrder, _effectCacheTexture,
+                GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP),
+                BlendFunc::ALPHA_PREMULTIPLIED, &_effectCacheQuad, 1, transform, flags);
+            renderer->addCommand(&_quadCommand);
+        }
+        else if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
         {
             for (auto&& it : _letters)
             {
@@ -1703,6 +1973,269 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     }
 }
 
+void Label::setEffectCacheEnabled(bool enabled)
+{
+    if (_effectCacheEnabled == enabled)
+        return;
+
+    _effectCacheEnabled = enabled;
+    _effectCacheDirty = true;
+    if (!enabled)
+    {
+        releaseEffectCache();
+    }
+}
+
+std::string Label::getEffectCacheSignature() const
+{
+    // everything drawEffects reads besides the quads of the letters
+    const float values[] = {
+        _textColorF.r, _textColorF.g, _textColorF.b, _textColorF.a,
+        _effectColorF.r, _effectColorF.g, _effectColorF.b, _effectColorF.a,
+        _shadowColor4F.r, _shadowColor4F.g, _shadowColor4F.b, _shadowColor4F.a,
+        _shadowOffset.width, _shadowOffset.height
+    };
+    const int flags[] = {
+        static_cast<int>(_currLabelEffect), _shadowEnabled, _boldEnabled,
+        static_cast<int>(_blendFunc.src), static_cast<int>(_blendFunc.dst)
+    };
+    const GLProgramState* programState = getGLProgramState();
+    std::string signature(reinterpret_cast<const char*>(values), sizeof(values));
+    signature.append(reinterpret_cast<const char*>(flags), sizeof(flags));
+    signature.append(reinterpret_cast<const char*>(&programState), sizeof(programState));
+    if (isEffectCacheColorBaked())
+    {
+        const GLubyte displayed[] = { _displayedColor.r, _displayedColor.g, _displayedColor.b, _displayedOpacity };
+        signature.append(reinterpret_cast<const char*>(displayed), sizeof(displayed));
+    }
+    return signature;
+}
+
+bool Label::isEffectCacheColorBaked() const
+{
+    // onDrawShadow draws the shadow of a bitmap font by changing the color of the label, which also takes
+    // the color of the parent, the picture can only be drawn with the displayed color
+    return _currentLabelType != LabelType::TTF && _shadowEnabled;
+}
+
+bool Label::updateEffectCache(Renderer* renderer, const Mat4& transform)
+{
+    if (!_letters.empty() || _batchNodes.empty())
+    {
+        releaseEffectCache();
+        return false;
+    }
+
+    // pixels per point of the label on screen
+    float scale = std::max(Vec3(transform.m[0], transform.m[1], transform.m[2]).length(),
+                           Vec3(transform.m[4], transform.m[5], transform.m[6]).length());
+    auto glview = _director->getOpenGLView();
+    if (glview)
+    {
+        scale *= std::max(glview->getScaleX(), glview->getScaleY()) * glview->getRetinaFactor();
+    }
+    if (scale <= 0.0f)
+    {
+        return false;
+    }
+
+    // the picture is baked white and opaque, the quad applies the displayed color and opacity, premultiplied
+    Color4B color = Color4B::WHITE;
+    if (!isEffectCacheColorBaked())
+    {
+        float opacity = _displayedOpacity / 255.0f;
+        color = Color4B(_displayedColor.r * opacity, _displayedColor.g * opacity, _displayedColor.b * opacity, _displayedOpacity);
+    }
+    _effectCacheQuad.bl.colors = color;
+    _effectCacheQuad.br.colors = color;
+    _effectCacheQuad.tl.colors = color;
+    _effectCacheQuad.tr.colors = color;
+
+    auto dynamicAtlas = DynamicAtlas::getInstance();
+    std::string signature = getEffectCacheSignature();
+    if (_effectCacheTexture && !_effectCacheDirty
+        && _effectCacheGeneration == dynamicAtlas->getRegionGeneration()
+        && signature == _effectCacheSignature
+        && scale < _effectCacheScale * 1.25f && scale > _effectCacheScale * 0.8f)
+    {
+        return true;
+    }
+
+    // bounds of the letters and of their shadow
+    Vec2 bottomLeft(FLT_MAX, FLT_MAX);
+    Vec2 topRight(-FLT_MAX, -FLT_MAX);
+    for (auto&& batchNode : _batchNodes)
+    {
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto quads = textureAtlas->getQuads();
+        for (ssize_t index = 0; index < textureAtlas->getTotalQuads(); ++index)
+        {
+            bottomLeft.x = std::min(bottomLeft.x, std::min(quads[index].bl.vertices.x, quads[index].tr.vertices.x));
+            bottomLeft.y = std::min(bottomLeft.y, std::min(quads[index].bl.vertices.y, quads[index].tr.vertices.y));
+            topRight.x = std::max(topRight.x, std::max(quads[index].bl.vertices.x, quads[index].tr.vertices.x));
+            topRight.y = std::max(topRight.y, std::max(quads[index].bl.vertices.y, quads[index].tr.vertices.y));
+        }
+    }
+    if (bottomLeft.x > topRight.x || bottomLeft.y > topRight.y)
+    {
+        releaseEffectCache();
+        return false;
+    }
+    if (_shadowEnabled)
+    {
+        Vec2 offset(_shadowOffset.width, _shadowOffset.height);
+        bottomLeft = Vec2(std::min(bottomLeft.x, bottomLeft.x + offset.x), std::min(bottomLeft.y, bottomLeft.y + offset.y));
+        topRight = Vec2(std::max(topRight.x, topRight.x + offset.x), std::max(topRight.y, topRight.y + offset.y));
+    }
+
+    // with a transparent border of one pixel, drawn magnified the quad does not sample the other regions
+    int width = static_cast<int>(std::ceil((topRight.x - bottomLeft.x) * scale)) + 2;
+    int height = static_cast<int>(std::ceil((topRight.y - bottomLeft.y) * scale)) + 2;
+    if (!_effectCacheTexture || width > _effectCacheRect.size.width || height > _effectCacheRect.size.height
+        || !dynamicAtlas->getPageFramebuffer(_effectCacheTexture))
+    {
+        releaseEffectCache();
+        _effectCacheTexture = dynamicAtlas->allocateRegion(width, height, _effectCacheRect);
+        if (!_effectCacheTexture || !dynamicAtlas->getPageFramebuffer(_effectCacheTexture))
+        {
+            releaseEffectCache();
+            return false;
+        }
+        _effectCacheTexture->retain();
+    }
+
+    _effectCacheSize.setSize(width, height);
+    _effectCacheOrigin.set(bottomLeft.x - 1.0f / scale, bottomLeft.y - 1.0f / scale);
+    _effectCacheScale = scale;
+    _effectCacheGeneration = dynamicAtlas->getRegionGeneration();
+    _effectCacheSignature = signature;
+    _effectCacheDirty = false;
+
+    // the rows of the framebuffer go up, the bottom of the picture is at the origin of the rect
+    float left = _effectCacheOrigin.x;
+    float bottom = _effectCacheOrigin.y;
+    float right = left + width / scale;
+    float top = bottom + height / scale;
+    float pageWidth = static_cast<float>(_effectCacheTexture->getPixelsWide());
+    float pageHeight = static_cast<float>(_effectCacheTexture->getPixelsHigh());
+    float u0 = _effectCacheRect.origin.x / pageWidth;
+    float u1 = (_effectCacheRect.origin.x + width) / pageWidth;
+    float v0 = _effectCacheRect.origin.y / pageHeight;
+    float v1 = (_effectCacheRect.origin.y + height) / pageHeight;
+
+    _effectCacheQuad.bl.vertices.set(left, bottom, 0.0f);
+    _effectCacheQuad.br.vertices.set(right, bottom, 0.0f);
+    _effectCacheQuad.tl.vertices.set(left, top, 0.0f);
+    _effectCacheQuad.tr.vertices.set(right, top, 0.0f);
+    _effectCacheQuad.bl.texCoords = Tex2F(u0, v0);
+    _effectCacheQuad.br.texCoords = Tex2F(u1, v0);
+    _effectCacheQuad.tl.texCoords = Tex2F(u0, v1);
+    _effectCacheQuad.tr.texCoords = Tex2F(u1, v1);
+
+    // renders before the quad command, the renderer flushes its batch for it
+    _effectCacheBakeCommand.init(_globalZOrder);
+    _effectCacheBakeCommand.func = CC_CALLBACK_0(Label::onBakeEffects, this);
+    renderer->addCommand(&_effectCacheBakeCommand);
+    return true;
+}
+
+void Label::releaseEffectCache()
+{
+    if (_effectCacheTexture)
+    {
+        DynamicAtlas::getInstance()->releaseRegion(_effectCacheTexture, _effectCacheRect);
+        CC_SAFE_RELEASE_NULL(_effectCacheTexture);
+    }
+    _effectCacheDirty = true;
+}
+
+void Label::onBakeEffects()
+{
+    GLuint framebuffer = _effectCacheTexture ? DynamicAtlas::getInstance()->getPageFramebuffer(_effectCacheTexture) : 0;
+    if (!framebuffer)
+    {
+        return;
+    }
+
+    GLint oldFBO = 0;
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+    // a RenderTexture being drawn may have set its own viewport
+    GLint oldViewport[4];
+    glGetIntegerv(GL_VIEWPORT, oldViewport);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    GLint x = static_cast<GLint>(_effectCacheRect.origin.x);
+    GLint y = static_cast<GLint>(_effectCacheRect.origin.y);
+    GLsizei width = static_cast<GLsizei>(_effectCacheSize.width);
+    GLsizei height = static_cast<GLsizei>(_effectCacheSize.height);
+    glViewport(x, y, width, height);
+
+    // clears the region only, the rest of the page holds other pictures and sprites
+    GLboolean scissorEnabled = glIsEnabled(GL_SCISSOR_TEST);
+    GLint oldScissorBox[4];
+    glGetIntegerv(GL_SCISSOR_BOX, oldScissorBox);
+    GLfloat oldClearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, oldClearColor);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(x, y, width, height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(oldClearColor[0], oldClearColor[1], oldClearColor[2], oldClearColor[3]);
+
+    Mat4 oldProjection = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    Mat4 projection;
+    Mat4::createOrthographicOffCenter(_effectCacheOrigin.x, _effectCacheOrigin.x + width / _effectCacheScale,
+                                      _effectCacheOrigin.y, _effectCacheOrigin.y + height / _effectCacheScale,
+                                      -1.0f, 1.0f, &projection);
+    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, projection);
+
+    // the quads of the letters are drawn in the label space, the shader must transform them
+    auto glprogram = getGLProgram();
+    auto glprogramCache = GLProgramCache::getInstance();
+    if (glprogram == glprogramCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP))
+    {
+        glprogram = glprogramCache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR);
+    }
+    glprogram->use();
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+    // the page holds premultiplied alpha whatever the blend function of the label
+    glBlendFuncSeparate(_blendFunc.src, _blendFunc.dst, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    // the letters are baked white and opaque unless the displayed color has to be baked
+    bool colorBaked = isEffectCacheColorBaked();
+    Color3B displayedColor = _displayedColor;
+    GLubyte displayedOpacity = _displayedOpacity;
+    if (!colorBaked)
+    {
+        _displayedColor = Color3B::WHITE;
+        _displayedOpacity = 255;
+        updateColor();
+    }
+
+    Mat4 shadowTransform = _shadowTransform;
+    Mat4::createTranslation(_shadowOffset.width, _shadowOffset.height, 0.0f, &_shadowTransform);
+    drawEffects(glprogram, Mat4::IDENTITY);
+    _shadowTransform = shadowTransform;
+
+    if (!colorBaked)
+    {
+        _displayedColor = displayedColor;
+        _displayedOpacity = displayedOpacity;
+        updateColor();
+    }
+
+    // back to the state GL::blendFunc knows
+    glBlendFunc(_blendFunc.src, _blendFunc.dst);
+    if (!scissorEnabled)
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    glScissor(oldScissorBox[0], oldScissorBox[1], oldScissorBox[2], oldScissorBox[3]);
+    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, oldProjection);
+    glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+    glViewport(oldViewport[0], oldViewport[1], oldViewport[2], oldViewport[3]);
+}
+
 void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
     if (! _visible || (_utf8Text.empty() && _children.empty()) )
@@ -2266,6 +2799,10 @@ void Label::updateLetterSpriteScale(Sprite* sprite)
     {
         sprite->setScale(_bmfontScale);
     }
+    else if (_currentLabelType == LabelType::TTF && _useDistanceField)
+    {
+        sprite->setScale(_bmfontScale);
+    }
     else
     {
         if (std::abs(_bmFontSize) < FLT_EPSILON)
@@ -88,6 +88,7 @@ enum class TextFormatter : char
 
 class Sprite;
 class SpriteBatchNode;
+class Texture2D;
 class DrawNode;
 class EventListenerCustom;
 class SpriteFrame;
@@ -407,6 +408,19 @@ public:
      */
     virtual void disableEffect(LabelEffect effect);
 
+    /**
+     * Draws the label from a picture of its letters and effects, baked into a DynamicAtlas page.
+     * The picture is rendered again only when the string, the layout, the text or effect colors or the effects change,
+     * and the label is then drawn as one quad batched with the other baked labels and packed sprites,
+     * instead of rendering every effect pass each frame.
+     * The displayed color and opacity tint the quad of the picture, so fading or tinting the label does not render it again.
+     * The picture is baked at the resolution of the label on screen and rendered again when its scale changes much.
+     * Labels whose letters are modified with getLetter are not baked. Disabled by default.
+     * @warning Not support system font.
+     */
+    void setEffectCacheEnabled(bool enabled);
+    bool isEffectCacheEnabled() const { return _effectCacheEnabled; }
+
     /**
     * Return whether the shadow effect is enabled.
     */
@@ -589,6 +603,15 @@ public:
 
     FontAtlas* getFontAtlas() { return _fontAtlas; }
 
+    /**
+     * Sets how many string layouts each font atlas keeps for its labels, 64 by default, 0 disables the cache.
+     * A label showing a string already laid out with the same font and layout properties, such as a counter
+     * or a timer, reuses the cached layout instead of wrapping the string again.
+     * @warning Not support system font.
+     */
+    static void setLayoutCacheSize(int size);
+    static int getLayoutCacheSize();
+
     virtual const BlendFunc& getBlendFunc() const override { return _blendFunc; }
     virtual void setBlendFunc(const BlendFunc &blendFunc) override;
 
@@ -644,6 +667,19 @@ protected:
         int lineIndex;
     };
 
+    // state of multilineTextWrap at the first letter of a line, to resume the wrap from there
+    struct LineStart
+    {
+        int letterIndex;
+        float nextTokenY;
+        float highestY;
+        float lowestY;
+        float longestLine;
+        bool nextChangeSize;
+    };
+
+    class CachedLayout;
+
     enum class LabelType : char {
         TTF,
         BMFONT,
@@ -657,11 +693,12 @@ protected:
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
+    void drawEffects(GLProgram* glProgram, const Mat4& transform);
     void drawSelf(Renderer* renderer, uint32_t flags);
 
-    bool multilineTextWrapByChar();
-    bool multilineTextWrapByWord();
-    bool multilineTextWrap(const std::function<int(const std::u16string&, int, int)>& lambda);
+    bool multilineTextWrapByChar(int firstLine = 0);
+    bool multilineTextWrapByWord(int firstLine = 0);
+    bool multilineTextWrap(const std::function<int(const std::u16string&, int, int)>& lambda, int firstLine = 0);
     void shrinkLabelToContentSize(const std::function<bool(void)>& lambda);
     bool isHorizontalClamp();
     bool isVerticalClamp();
@@ -676,7 +713,18 @@ protected:
     void recordLetterInfo(const cocos2d::Vec2& point, char16_t utf16Char, int letterIndex, int lineIndex);
     void recordPlaceholderInfo(int letterIndex, char16_t utf16Char);
 
-    bool updateQuads();
+    bool updateQuads(int firstLine = 0);
+
+    bool updateEffectCache(Renderer* renderer, const Mat4& transform);
+    void releaseEffectCache();
+    void onBakeEffects();
+    std::string getEffectCacheSignature() const;
+    bool isEffectCacheColorBaked() const;
+
+    std::string getLayoutSignature() const;
+    int getFirstChangedLine() const;
+    bool restoreCachedLayout(const std::string& key);
+    void cacheLayout(const std::string& key);
 
     void createSpriteForSystemFont(const FontDefinition& fontDef);
     void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
@@ -702,6 +750,13 @@ protected:
     std::vector<LetterInfo> _lettersInfo;
     std::vector<float> _linesWidth;
     std::vector<float> _linesOffsetX;
+    std::vector<LineStart> _lineStarts;
+    // quads of each batch node before each line: _lineQuadStarts[line * _batchNodes.size() + batch]
+    std::vector<int> _lineQuadStarts;
+
+    // string and layout properties of the last layout, the lines before the first changed one are kept
+    std::u16string _layoutText;
+    std::string _layoutSignature;
 
     std::unordered_map<int, Sprite*> _letters;
 
@@ -717,6 +772,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _updateTextureListener;
 
 #if CC_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
@@ -796,6 +852,23 @@ protected:
     bool _useA8Shader;
     bool _shadowDirty;
     bool _shadowEnabled;
+    // set when the glyphs of the atlas were rendered again, the quads of the kept lines are stale
+    bool _atlasUpdated;
+
+    // picture of the label in a DynamicAtlas page, see setEffectCacheEnabled
+    bool _effectCacheEnabled;
+    bool _effectCacheDirty;
+    Texture2D* _effectCacheTexture;
+    // the region reserved in the page, and the part of it drawn
+    Rect _effectCacheRect;
+    Size _effectCacheSize;
+    // the letters and effects fill the rect from this point of the label, at _effectCacheScale pixels per point
+    Vec2 _effectCacheOrigin;
+    float _effectCacheScale;
+    unsigned int _effectCacheGeneration;
+    std::string _effectCacheSignature;
+    V3F_C4B_T2F_Quad _effectCacheQuad;
+    CustomCommand _effectCacheBakeCommand;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Label);
 };
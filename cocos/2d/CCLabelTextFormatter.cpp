@@ -29,6 +29,7 @@
 #include "base/CCDirector.h"
 #include "2d/CCFontAtlas.h"
 #include "2d/CCFontFNT.h"
+#include "2d/CCFontFreeType.h"
 
 NS_CC_BEGIN
 
@@ -129,12 +130,16 @@ void Label::updateBMFontScale()
         FontFNT *bmFont = (FontFNT*)font;
         float originalFontSize = bmFont->getOriginalFontSize();
         _bmfontScale = _bmFontSize * CC_CONTENT_SCALE_FACTOR() / originalFontSize;
+    }else if (_currentLabelType == LabelType::TTF && _useDistanceField) {
+        // the glyphs of a shared distance field atlas are rendered at another size
+        float atlasFontSize = ((FontFreeType*)font)->getFontSize();
+        _bmfontScale = atlasFontSize > 0 ? _fontConfig.fontSize / atlasFontSize : 1.0f;
     }else{
         _bmfontScale = 1.0f;
     }
 }
 
-bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int, int)>& nextTokenLen)
+bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int, int)>& nextTokenLen, int firstLine)
 {
     int textLen = getStringLength();
     int lineIndex = 0;
@@ -150,10 +155,27 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
     FontLetterDefinition letterDef;
     Vec2 letterPosition;
     bool nextChangeSize = true;
+    int index = 0;
 
     this->updateBMFontScale();
 
-    for (int index = 0; index < textLen; )
+    // the lines before firstLine are kept from the previous wrap
+    if (firstLine > 0 && firstLine < static_cast<int>(_lineStarts.size()))
+    {
+        const LineStart& lineStart = _lineStarts[firstLine];
+        lineIndex = firstLine;
+        index = lineStart.letterIndex;
+        nextTokenY = lineStart.nextTokenY;
+        highestY = lineStart.highestY;
+        lowestY = lineStart.lowestY;
+        longestLine = lineStart.longestLine;
+        nextChangeSize = lineStart.nextChangeSize;
+    }
+    _linesWidth.resize(lineIndex);
+    _lineStarts.resize(lineIndex);
+    _lineStarts.push_back({index, nextTokenY, highestY, lowestY, longestLine, nextChangeSize});
+
+    while (index < textLen)
     {
         auto character = _utf16Text[index];
         if (character == (char16_t)TextFormatter::NewLine)
@@ -165,6 +187,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
             nextTokenY -= _lineHeight*_bmfontScale + lineSpacing;
             recordPlaceholderInfo(index, character);
             index++;
+            _lineStarts.push_back({index, nextTokenY, highestY, lowestY, longestLine, nextChangeSize});
             continue;
         }
 
@@ -207,6 +230,7 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
                 nextTokenX = 0.f;
                 nextTokenY -= (_lineHeight*_bmfontScale + lineSpacing);
                 newLine = true;
+                _lineStarts.push_back({index, nextTokenY, highestY, lowestY, longestLine, nextChangeSize});
                 break;
             }
             else
@@ -272,14 +296,14 @@ bool Label::multilineTextWrap(const std::function<int(const std::u16string&, int
     return true;
 }
 
-bool Label::multilineTextWrapByWord()
+bool Label::multilineTextWrapByWord(int firstLine)
 {
-    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this));
+    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstWordLen, this), firstLine);
 }
 
-bool Label::multilineTextWrapByChar()
+bool Label::multilineTextWrapByChar(int firstLine)
 {
-    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstCharLen, this));
+    return multilineTextWrap(CC_CALLBACK_3(Label::getFirstCharLen, this), firstLine);
 }
 
 bool Label::isVerticalClamp()
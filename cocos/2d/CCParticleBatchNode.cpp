@@ -31,6 +31,7 @@
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCGrid.h"
 #include "2d/CCParticleSystem.h"
+#include "2d/CCParticleManager.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCQuadCommand.h"
 #include "renderer/CCRenderer.h"
@@ -163,6 +164,9 @@ void ParticleBatchNode::addChild(Node * aChild, int zOrder, const std::string &n
 
 void ParticleBatchNode::addChildByTagOrName(ParticleSystem* child, int zOrder, int tag, const std::string &name, bool setTag)
 {
+    // the atlas quads may be moved or reallocated
+    ParticleManager::getInstance()->waitForUpdate();
+
     // If this is the 1st children, then copy blending function
     if (_children.empty())
     {
@@ -244,6 +248,8 @@ void ParticleBatchNode::reorderChild(Node * aChild, int zOrder)
         return;
     }
 
+    ParticleManager::getInstance()->waitForUpdate();
+
     // no reordering if only 1 child
     if (!_children.empty())
     {
@@ -366,6 +372,8 @@ void  ParticleBatchNode::removeChild(Node* aChild, bool cleanup)
 
     ParticleSystem* child = static_cast<ParticleSystem*>(aChild);
 
+    ParticleManager::getInstance()->waitForUpdate();
+
     // remove child helper
     _textureAtlas->removeQuadsAtIndex(child->getAtlasIndex(), child->getTotalParticles());
 
@@ -386,6 +394,8 @@ void ParticleBatchNode::removeChildAtIndex(int index, bool doCleanup)
 
 void ParticleBatchNode::removeAllChildrenWithCleanup(bool doCleanup)
 {
+    ParticleManager::getInstance()->waitForUpdate();
+
     for(const auto &child : _children)
         static_cast<ParticleSystem*>(child)->setBatchNode(nullptr);
 
@@ -398,6 +408,8 @@ void ParticleBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t
 {
     CC_PROFILER_START("CCParticleBatchNode - draw");
 
+    ParticleManager::getInstance()->waitForUpdate();
+
     if( _textureAtlas->getTotalQuads() == 0 )
     {
         return;
@@ -0,0 +1,601 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCParticleKernels.h"
+
+#include <math.h>
+#include <algorithm>
+
+#include "2d/CCParticleSystem.h"
+
+//#define PARTICLE_USE_SSE    : SSE2 code used
+//#define PARTICLE_USE_NEON   : NEON code used
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define PARTICLE_USE_SSE
+    #include <emmintrin.h>
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (__aarch64__)
+    #define PARTICLE_USE_NEON
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    const float PI_F = 3.14159265358979f;
+    const float HALF_PI_F = 1.57079632679490f;
+    const float INV_TWO_PI_F = 0.159154943091895f;
+    // 2 * PI split in an exactly representable part and the rest, for the range reduction
+    const float TWO_PI_HI = 6.28125f;
+    const float TWO_PI_LO = 1.9353071795864769e-3f;
+    const float DEG_TO_RAD = 0.01745329252f;
+
+    // multiplier and increment of the ParticleSystem random generator
+    const uint32_t RANDOM_A = 134775813u;
+    const uint32_t RANDOM_C = 1u;
+
+    inline float randomM11(uint32_t* seed)
+    {
+        *seed = *seed * RANDOM_A + RANDOM_C;
+        union {
+            uint32_t d;
+            float f;
+        } u;
+        u.d = ((*seed & 0x7fff) << 8) | 0x40000000;
+        return u.f - 3.0f;
+    }
+
+    // one particle at a time
+    struct ScalarLanes
+    {
+        typedef float Float;
+        static const int WIDTH = 1;
+
+        static Float load(const float* p) { return *p; }
+        static void store(float* p, Float v) { *p = v; }
+        static Float set(float v) { return v; }
+        static Float add(Float a, Float b) { return a + b; }
+        static Float sub(Float a, Float b) { return a - b; }
+        static Float mul(Float a, Float b) { return a * b; }
+        static Float div(Float a, Float b) { return a / b; }
+        static Float sqrt(Float a) { return sqrtf(a); }
+        static Float min(Float a, Float b) { return a < b ? a : b; }
+        static Float max(Float a, Float b) { return a > b ? a : b; }
+        static Float floor(Float a) { return floorf(a); }
+        static Float greater(Float a, Float b) { return a > b ? 1.0f : 0.0f; }
+        static Float less(Float a, Float b) { return a < b ? 1.0f : 0.0f; }
+        static Float greaterEqual(Float a, Float b) { return a >= b ? 1.0f : 0.0f; }
+        static Float select(Float mask, Float a, Float b) { return mask != 0.0f ? a : b; }
+    };
+
+#if defined (PARTICLE_USE_SSE)
+    struct SimdLanes
+    {
+        typedef __m128 Float;
+        static const int WIDTH = 4;
+
+        static Float load(const float* p) { return _mm_loadu_ps(p); }
+        static void store(float* p, Float v) { _mm_storeu_ps(p, v); }
+        static Float set(float v) { return _mm_set1_ps(v); }
+        static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+        static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+        static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+        static Float div(Float a, Float b) { return _mm_div_ps(a, b); }
+        static Float sqrt(Float a) { return _mm_sqrt_ps(a); }
+        static Float min(Float a, Float b) { return _mm_min_ps(a, b); }
+        static Float max(Float a, Float b) { return _mm_max_ps(a, b); }
+        static Float floor(Float a)
+        {
+            Float t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+            return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+        }
+        static Float greater(Float a, Float b) { return _mm_cmpgt_ps(a, b); }
+        static Float less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+        static Float greaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+        static Float select(Float mask, Float a, Float b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+    };
+#elif defined (PARTICLE_USE_NEON)
+    struct SimdLanes
+    {
+        typedef float32x4_t Float;
+        static const int WIDTH = 4;
+
+        static Float load(const float* p) { return vld1q_f32(p); }
+        static void store(float* p, Float v) { vst1q_f32(p, v); }
+        static Float set(float v) { return vdupq_n_f32(v); }
+        static Float add(Float a, Float b) { return vaddq_f32(a, b); }
+        static Float sub(Float a, Float b) { return vsubq_f32(a, b); }
+        static Float mul(Float a, Float b) { return vmulq_f32(a, b); }
+#if defined (__aarch64__)
+        static Float div(Float a, Float b) { return vdivq_f32(a, b); }
+        static Float sqrt(Float a) { return vsqrtq_f32(a); }
+        static Float floor(Float a) { return vrndmq_f32(a); }
+#else
+        static Float div(Float a, Float b)
+        {
+            // reciprocal estimate refined by two Newton-Raphson steps
+            Float r = vrecpeq_f32(b);
+            r = vmulq_f32(vrecpsq_f32(b, r), r);
+            r = vmulq_f32(vrecpsq_f32(b, r), r);
+            return vmulq_f32(a, r);
+        }
+        static Float sqrt(Float a)
+        {
+            Float r = vrsqrteq_f32(a);
+            r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+            r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+            // the estimate of 1/sqrt(0) is infinite
+            return select(greater(a, vdupq_n_f32(0.0f)), vmulq_f32(a, r), vdupq_n_f32(0.0f));
+        }
+        static Float floor(Float a)
+        {
+            Float t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+            uint32x4_t correction = vandq_u32(vcgtq_f32(t, a), vreinterpretq_u32_f32(vdupq_n_f32(1.0f)));
+            return vsubq_f32(t, vreinterpretq_f32_u32(correction));
+        }
+#endif
+        static Float min(Float a, Float b) { return vminq_f32(a, b); }
+        static Float max(Float a, Float b) { return vmaxq_f32(a, b); }
+        static Float greater(Float a, Float b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+        static Float less(Float a, Float b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+        static Float greaterEqual(Float a, Float b) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+        static Float select(Float mask, Float a, Float b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+    };
+#else
+    typedef ScalarLanes SimdLanes;
+#endif
+
+    // runs the kernel over the widest multiple of the SIMD width, then over the remaining particles
+    template <typename Kernel, typename... Args>
+    inline void runKernel(int count, Args&&... args)
+    {
+        int simdEnd = count - count % SimdLanes::WIDTH;
+        Kernel::template run<SimdLanes>(0, simdEnd, args...);
+        Kernel::template run<ScalarLanes>(simdEnd, count, args...);
+    }
+
+    // sin on any range: reduction to [-PI, PI], folding to [-PI/2, PI/2] and a degree 11 polynomial
+    template <typename L>
+    inline typename L::Float sinLanes(typename L::Float x)
+    {
+        typedef typename L::Float Float;
+
+        Float k = L::floor(L::add(L::mul(x, L::set(INV_TWO_PI_F)), L::set(0.5f)));
+        x = L::sub(x, L::mul(k, L::set(TWO_PI_HI)));
+        x = L::sub(x, L::mul(k, L::set(TWO_PI_LO)));
+
+        x = L::select(L::greater(x, L::set(HALF_PI_F)), L::sub(L::set(PI_F), x), x);
+        x = L::select(L::less(x, L::set(-HALF_PI_F)), L::sub(L::set(-PI_F), x), x);
+
+        Float x2 = L::mul(x, x);
+        Float p = L::set(-2.5052108385e-8f);
+        p = L::add(L::mul(p, x2), L::set(2.7557319224e-6f));
+        p = L::add(L::mul(p, x2), L::set(-1.9841269841e-4f));
+        p = L::add(L::mul(p, x2), L::set(8.3333333333e-3f));
+        p = L::add(L::mul(p, x2), L::set(-1.6666666667e-1f));
+        return L::add(x, L::mul(L::mul(p, x2), x));
+    }
+
+    template <typename L>
+    inline typename L::Float cosLanes(typename L::Float x)
+    {
+        return sinLanes<L>(L::add(x, L::set(HALF_PI_F)));
+    }
+
+    struct ComputeDeltasKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, float* deltas, const float* start, const float* timeToLive)
+        {
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                L::store(deltas + i, L::div(L::sub(L::load(deltas + i), L::load(start + i)), L::load(timeToLive + i)));
+            }
+        }
+    };
+
+    struct IntegrateKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, float* values, const float* deltas, float dt)
+        {
+            typename L::Float vdt = L::set(dt);
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                L::store(values + i, L::add(L::load(values + i), L::mul(L::load(deltas + i), vdt)));
+            }
+        }
+    };
+
+    struct IntegrateClampedKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, float* values, const float* deltas, float dt, float minValue)
+        {
+            typename L::Float vdt = L::set(dt);
+            typename L::Float vmin = L::set(minValue);
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                L::store(values + i, L::max(vmin, L::add(L::load(values + i), L::mul(L::load(deltas + i), vdt))));
+            }
+        }
+    };
+
+    struct GravityKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, ParticleData& data, float dt, float gravityX, float gravityY, float yCoordFlipped)
+        {
+            typedef typename L::Float Float;
+            Float vdt = L::set(dt);
+            Float vgx = L::set(gravityX);
+            Float vgy = L::set(gravityY);
+            Float vflip = L::set(yCoordFlipped);
+            Float one = L::set(1.0f);
+            Float zero = L::set(0.0f);
+            Float tolerance = L::set(MATH_TOLERANCE);
+
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                Float x = L::load(data.posx + i);
+                Float y = L::load(data.posy + i);
+
+                // normalized position, zero when too close to the emitter
+                Float length = L::sqrt(L::add(L::mul(x, x), L::mul(y, y)));
+                Float inv = L::select(L::greaterEqual(length, tolerance), L::div(one, length), zero);
+                Float rx = L::mul(x, inv);
+                Float ry = L::mul(y, inv);
+
+                // radial * (rx, ry) + tangential * (-ry, rx) + gravity
+                Float radialAccel = L::load(data.modeA.radialAccel + i);
+                Float tangentialAccel = L::load(data.modeA.tangentialAccel + i);
+                Float ax = L::add(L::sub(L::mul(rx, radialAccel), L::mul(ry, tangentialAccel)), vgx);
+                Float ay = L::add(L::add(L::mul(ry, radialAccel), L::mul(rx, tangentialAccel)), vgy);
+
+                Float dirX = L::add(L::load(data.modeA.dirX + i), L::mul(ax, vdt));
+                Float dirY = L::add(L::load(data.modeA.dirY + i), L::mul(ay, vdt));
+                L::store(data.modeA.dirX + i, dirX);
+                L::store(data.modeA.dirY + i, dirY);
+
+                L::store(data.posx + i, L::add(x, L::mul(L::mul(dirX, vdt), vflip)));
+                L::store(data.posy + i, L::add(y, L::mul(L::mul(dirY, vdt), vflip)));
+            }
+        }
+    };
+
+    struct RadiusKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, ParticleData& data, float dt, float yCoordFlipped)
+        {
+            typedef typename L::Float Float;
+            Float vdt = L::set(dt);
+            Float vflip = L::set(yCoordFlipped);
+            Float zero = L::set(0.0f);
+
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                Float angle = L::add(L::load(data.modeB.angle + i), L::mul(L::load(data.modeB.degreesPerSecond + i), vdt));
+                Float radius = L::add(L::load(data.modeB.radius + i), L::mul(L::load(data.modeB.deltaRadius + i), vdt));
+                L::store(data.modeB.angle + i, angle);
+                L::store(data.modeB.radius + i, radius);
+
+                L::store(data.posx + i, L::sub(zero, L::mul(cosLanes<L>(angle), radius)));
+                L::store(data.posy + i, L::mul(L::sub(zero, L::mul(sinLanes<L>(angle), radius)), vflip));
+            }
+        }
+    };
+
+    // emitter relative position of the particles, moved with the emitter unless they are grouped
+    template <typename L, bool FOLLOW_START>
+    inline void particlePosition(const ParticleData& data, int i, const Vec2& offset, const float* m, const Vec2& current,
+                                 typename L::Float& x, typename L::Float& y)
+    {
+        x = L::add(L::load(data.posx + i), L::set(offset.x));
+        y = L::add(L::load(data.posy + i), L::set(offset.y));
+        if (FOLLOW_START)
+        {
+            typename L::Float dx = L::sub(L::set(current.x), L::load(data.startPosX + i));
+            typename L::Float dy = L::sub(L::set(current.y), L::load(data.startPosY + i));
+            x = L::sub(x, L::add(L::mul(L::set(m[0]), dx), L::mul(L::set(m[1]), dy)));
+            y = L::sub(y, L::add(L::mul(L::set(m[2]), dx), L::mul(L::set(m[3]), dy)));
+        }
+    }
+
+    // color channels scaled to [0, 255]
+    template <typename L, bool PREMULTIPLY>
+    inline void particleColor(const ParticleData& data, int i, float channels[4][4])
+    {
+        typedef typename L::Float Float;
+        Float scale = L::set(255.0f);
+        Float zero = L::set(0.0f);
+        Float a = L::load(data.colorA + i);
+        Float rgbScale = PREMULTIPLY ? L::mul(a, scale) : scale;
+        L::store(channels[0], L::min(L::max(L::mul(L::load(data.colorR + i), rgbScale), zero), scale));
+        L::store(channels[1], L::min(L::max(L::mul(L::load(data.colorG + i), rgbScale), zero), scale));
+        L::store(channels[2], L::min(L::max(L::mul(L::load(data.colorB + i), rgbScale), zero), scale));
+        L::store(channels[3], L::min(L::max(L::mul(a, scale), zero), scale));
+    }
+
+    template <bool FOLLOW_START>
+    struct QuadPositionKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, const ParticleData& data, V3F_C4B_T2F_Quad* quads,
+                        const Vec2& offset, const float* m, const Vec2& current)
+        {
+            typedef typename L::Float Float;
+            Float half = L::set(0.5f);
+            Float toRadians = L::set(-DEG_TO_RAD);
+            float corners[8][4];
+
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                Float x, y;
+                particlePosition<L, FOLLOW_START>(data, i, offset, m, current, x, y);
+
+                Float size2 = L::mul(L::load(data.size + i), half);
+                Float r = L::mul(L::load(data.rotation + i), toRadians);
+                Float hc = L::mul(size2, cosLanes<L>(r));
+                Float hs = L::mul(size2, sinLanes<L>(r));
+
+                // bottom-left, bottom-right, top-right, top-left
+                L::store(corners[0], L::add(L::sub(hs, hc), x));
+                L::store(corners[1], L::sub(L::sub(y, hs), hc));
+                L::store(corners[2], L::add(L::add(hc, hs), x));
+                L::store(corners[3], L::add(L::sub(hs, hc), y));
+                L::store(corners[4], L::add(L::sub(hc, hs), x));
+                L::store(corners[5], L::add(L::add(hs, hc), y));
+                L::store(corners[6], L::sub(L::sub(x, hc), hs));
+                L::store(corners[7], L::add(L::sub(hc, hs), y));
+
+                for (int lane = 0; lane < L::WIDTH; ++lane)
+                {
+                    V3F_C4B_T2F_Quad& quad = quads[i + lane];
+                    quad.bl.vertices.x = corners[0][lane];
+                    quad.bl.vertices.y = corners[1][lane];
+                    quad.br.vertices.x = corners[2][lane];
+                    quad.br.vertices.y = corners[3][lane];
+                    quad.tr.vertices.x = corners[4][lane];
+                    quad.tr.vertices.y = corners[5][lane];
+                    quad.tl.vertices.x = corners[6][lane];
+                    quad.tl.vertices.y = corners[7][lane];
+                }
+            }
+        }
+    };
+
+    template <bool PREMULTIPLY>
+    struct QuadColorKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, const ParticleData& data, V3F_C4B_T2F_Quad* quads)
+        {
+            float channels[4][4];
+
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                particleColor<L, PREMULTIPLY>(data, i, channels);
+
+                for (int lane = 0; lane < L::WIDTH; ++lane)
+                {
+                    Color4B color((GLubyte)channels[0][lane], (GLubyte)channels[1][lane],
+                                  (GLubyte)channels[2][lane], (GLubyte)channels[3][lane]);
+                    V3F_C4B_T2F_Quad& quad = quads[i + lane];
+                    quad.bl.colors = color;
+                    quad.br.colors = color;
+                    quad.tl.colors = color;
+                    quad.tr.colors = color;
+                }
+            }
+        }
+    };
+
+    template <bool FOLLOW_START, bool PREMULTIPLY>
+    struct RecordKernel
+    {
+        template <typename L>
+        static void run(int begin, int end, const ParticleData& data, ParticleRecord* records, int copies,
+                        const Vec2& offset, const float* m, const Vec2& current)
+        {
+            typedef typename L::Float Float;
+            float positions[2][4];
+            float channels[4][4];
+
+            for (int i = begin; i < end; i += L::WIDTH)
+            {
+                Float x, y;
+                particlePosition<L, FOLLOW_START>(data, i, offset, m, current, x, y);
+                L::store(positions[0], x);
+                L::store(positions[1], y);
+                particleColor<L, PREMULTIPLY>(data, i, channels);
+
+                for (int lane = 0; lane < L::WIDTH; ++lane)
+                {
+                    ParticleRecord* record = records + (i + lane) * copies;
+                    record->x = positions[0][lane];
+                    record->y = positions[1][lane];
+                    record->size = data.size[i + lane];
+                    record->rotation = data.rotation[i + lane];
+                    record->color.r = (GLubyte)channels[0][lane];
+                    record->color.g = (GLubyte)channels[1][lane];
+                    record->color.b = (GLubyte)channels[2][lane];
+                    record->color.a = (GLubyte)channels[3][lane];
+                    for (int copy = 1; copy < copies; ++copy)
+                    {
+                        record[copy] = record[0];
+                    }
+                }
+            }
+        }
+    };
+}
+
+void ParticleKernels::randomRange(float* values, int count, float base, float variance, uint32_t* seed,
+                                  float minValue, float maxValue)
+{
+    int i = 0;
+
+#if defined (PARTICLE_USE_SSE) || defined (PARTICLE_USE_NEON)
+    if (count >= 4)
+    {
+        // lane n holds the seed n + 1 steps ahead, every lane then jumps 4 steps at once:
+        // seed' = A^4 * seed + (A^3 + A^2 + A + 1) * C
+        uint32_t laneSeeds[4];
+        uint32_t s = *seed;
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            s = s * RANDOM_A + RANDOM_C;
+            laneSeeds[lane] = s;
+        }
+        const uint32_t a2 = RANDOM_A * RANDOM_A;
+        const uint32_t jumpA = a2 * a2;
+        const uint32_t jumpC = (a2 * RANDOM_A + a2 + RANDOM_A + 1) * RANDOM_C;
+        int simdEnd = count - count % 4;
+
+#if defined (PARTICLE_USE_SSE)
+        __m128i seeds = _mm_loadu_si128((const __m128i*)laneSeeds);
+        const __m128i mantissaMask = _mm_set1_epi32(0x7fff);
+        const __m128i exponent = _mm_set1_epi32(0x40000000);
+        const __m128i multiplier = _mm_set1_epi32((int)jumpA);
+        const __m128i increment = _mm_set1_epi32((int)jumpC);
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 vbase = _mm_set1_ps(base);
+        const __m128 vvariance = _mm_set1_ps(variance);
+        const __m128 vmin = _mm_set1_ps(minValue);
+        const __m128 vmax = _mm_set1_ps(maxValue);
+        uint32_t lastSeed = *seed;
+
+        for (; i < simdEnd; i += 4)
+        {
+            __m128i bits = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(seeds, mantissaMask), 8), exponent);
+            __m128 random = _mm_sub_ps(_mm_castsi128_ps(bits), three);
+            __m128 v = _mm_add_ps(vbase, _mm_mul_ps(vvariance, random));
+            _mm_storeu_ps(values + i, _mm_min_ps(_mm_max_ps(v, vmin), vmax));
+
+            lastSeed = (uint32_t)_mm_cvtsi128_si32(_mm_shuffle_epi32(seeds, _MM_SHUFFLE(3, 3, 3, 3)));
+
+            // SSE2 has no 32 bit low multiply, multiply the even and odd lanes separately
+            __m128i even = _mm_mul_epu32(seeds, multiplier);
+            __m128i odd = _mm_mul_epu32(_mm_srli_si128(seeds, 4), _mm_srli_si128(multiplier, 4));
+            __m128i product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                                 _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+            seeds = _mm_add_epi32(product, increment);
+        }
+#else
+        uint32x4_t seeds = vld1q_u32(laneSeeds);
+        const uint32x4_t mantissaMask = vdupq_n_u32(0x7fff);
+        const uint32x4_t exponent = vdupq_n_u32(0x40000000);
+        const uint32x4_t multiplier = vdupq_n_u32(jumpA);
+        const uint32x4_t increment = vdupq_n_u32(jumpC);
+        const float32x4_t three = vdupq_n_f32(3.0f);
+        const float32x4_t vbase = vdupq_n_f32(base);
+        const float32x4_t vvariance = vdupq_n_f32(variance);
+        const float32x4_t vmin = vdupq_n_f32(minValue);
+        const float32x4_t vmax = vdupq_n_f32(maxValue);
+        uint32_t lastSeed = *seed;
+
+        for (; i < simdEnd; i += 4)
+        {
+            uint32x4_t bits = vorrq_u32(vshlq_n_u32(vandq_u32(seeds, mantissaMask), 8), exponent);
+            float32x4_t random = vsubq_f32(vreinterpretq_f32_u32(bits), three);
+            float32x4_t v = vaddq_f32(vbase, vmulq_f32(vvariance, random));
+            vst1q_f32(values + i, vminq_f32(vmaxq_f32(v, vmin), vmax));
+
+            lastSeed = vgetq_lane_u32(seeds, 3);
+            seeds = vaddq_u32(vmulq_u32(seeds, multiplier), increment);
+        }
+#endif
+        *seed = lastSeed;
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] = std::min(std::max(base + variance * randomM11(seed), minValue), maxValue);
+    }
+}
+
+void ParticleKernels::computeDeltas(float* deltas, const float* start, const float* timeToLive, int count)
+{
+    runKernel<ComputeDeltasKernel>(count, deltas, start, timeToLive);
+}
+
+void ParticleKernels::integrate(float* values, const float* deltas, int count, float dt)
+{
+    runKernel<IntegrateKernel>(count, values, deltas, dt);
+}
+
+void ParticleKernels::integrateClamped(float* values, const float* deltas, int count, float dt, float minValue)
+{
+    runKernel<IntegrateClampedKernel>(count, values, deltas, dt, minValue);
+}
+
+void ParticleKernels::updateGravityMode(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped)
+{
+    runKernel<GravityKernel>(count, data, dt, gravityX, gravityY, yCoordFlipped);
+}
+
+void ParticleKernels::updateRadiusMode(ParticleData& data, int count, float dt, float yCoordFlipped)
+{
+    runKernel<RadiusKernel>(count, data, dt, yCoordFlipped);
+}
+
+void ParticleKernels::updateQuadPositions(const ParticleData& data, int count, V3F_C4B_T2F_Quad* quads,
+                                          const Vec2& offset, const float* startTransform, const Vec2& currentPosition)
+{
+    if (startTransform)
+        runKernel<QuadPositionKernel<true>>(count, data, quads, offset, startTransform, currentPosition);
+    else
+        runKernel<QuadPositionKernel<false>>(count, data, quads, offset, startTransform, currentPosition);
+}
+
+void ParticleKernels::updateQuadColors(const ParticleData& data, int count, V3F_C4B_T2F_Quad* quads, bool premultiply)
+{
+    if (premultiply)
+        runKernel<QuadColorKernel<true>>(count, data, quads);
+    else
+        runKernel<QuadColorKernel<false>>(count, data, quads);
+}
+
+void ParticleKernels::updateRecords(const ParticleData& data, int count, ParticleRecord* records, int copies, bool premultiply,
+                                    const Vec2& offset, const float* startTransform, const Vec2& currentPosition)
+{
+    if (startTransform)
+    {
+        if (premultiply)
+            runKernel<RecordKernel<true, true>>(count, data, records, copies, offset, startTransform, currentPosition);
+        else
+            runKernel<RecordKernel<true, false>>(count, data, records, copies, offset, startTransform, currentPosition);
+    }
+    else
+    {
+        if (premultiply)
+            runKernel<RecordKernel<false, true>>(count, data, records, copies, offset, startTransform, currentPosition);
+        else
+            runKernel<RecordKernel<false, false>>(count, data, records, copies, offset, startTransform, currentPosition);
+    }
+}
+
+NS_CC_END
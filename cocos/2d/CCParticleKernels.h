@@ -0,0 +1,110 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCPARTICLEKERNELS_H__
+#define __CCPARTICLEKERNELS_H__
+
+#include <stdint.h>
+#include <float.h>
+
+#include "base/ccTypes.h"
+
+NS_CC_BEGIN
+
+class ParticleData;
+
+/** @struct ParticleRecord
+ * One particle as sent to the GPU by ParticleSystemQuad in RenderMode::GPU_EXPANDED, expanded to a quad by the vertex shader.
+ */
+struct ParticleRecord
+{
+    GLfloat x;
+    GLfloat y;
+    GLfloat size;
+    GLfloat rotation;   // in degrees, clockwise
+    Color4B color;
+};
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticleKernels
+ * @brief Data parallel loops over the ParticleData arrays, used by ParticleSystem and ParticleSystemQuad.
+ *
+ * The loops run four particles at a time with SSE2 or NEON when the compiler targets them,
+ * and the same code one particle at a time for the remaining particles or on other CPUs.
+ * Every loop is specialized per emitter mode or position type so it contains no per particle branch.
+ * @js NA
+ */
+class CC_DLL ParticleKernels
+{
+public:
+    /** Writes count consecutive values of the ParticleSystem random sequence,
+     * clamped to [minValue, maxValue]: values[i] = base + variance * random(-1, 1).
+     * The sequence is the same one ParticleSystem generates one value at a time, so results do not depend on the CPU.
+     */
+    static void randomRange(float* values, int count, float base, float variance, uint32_t* seed,
+                            float minValue = -FLT_MAX, float maxValue = FLT_MAX);
+
+    /** Turns end values into per second deltas in place: deltas[i] = (deltas[i] - start[i]) / timeToLive[i]. */
+    static void computeDeltas(float* deltas, const float* start, const float* timeToLive, int count);
+
+    /** values[i] += deltas[i] * dt */
+    static void integrate(float* values, const float* deltas, int count, float dt);
+
+    /** values[i] = max(minValue, values[i] + deltas[i] * dt) */
+    static void integrateClamped(float* values, const float* deltas, int count, float dt, float minValue);
+
+    /** Applies radial, tangential and gravity acceleration and moves the particles of a gravity mode emitter. */
+    static void updateGravityMode(ParticleData& data, int count, float dt, float gravityX, float gravityY, float yCoordFlipped);
+
+    /** Rotates and moves the particles of a radius mode emitter. */
+    static void updateRadiusMode(ParticleData& data, int count, float dt, float yCoordFlipped);
+
+    /** Writes the quad vertex positions of count particles.
+     * The position of a particle is (posx, posy) + offset - startTransform * (currentPosition - startPos).
+     * @param startTransform Row major 2x2 matrix, nullptr when the particles do not follow their start position (grouped).
+     */
+    static void updateQuadPositions(const ParticleData& data, int count, V3F_C4B_T2F_Quad* quads,
+                                    const Vec2& offset, const float* startTransform, const Vec2& currentPosition);
+
+    /** Writes the vertex colors of count particles, with the rgb multiplied by alpha when premultiply is set. */
+    static void updateQuadColors(const ParticleData& data, int count, V3F_C4B_T2F_Quad* quads, bool premultiply);
+
+    /** Writes one record per particle, the same position and color as updateQuadPositions and updateQuadColors,
+     * without computing the corners. Each record is written copies times in a row, 4 when the GPU cannot draw
+     * instances and the record is read per vertex.
+     */
+    static void updateRecords(const ParticleData& data, int count, ParticleRecord* records, int copies, bool premultiply,
+                              const Vec2& offset, const float* startTransform, const Vec2& currentPosition);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLEKERNELS_H__
@@ -0,0 +1,301 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCParticleManager.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "2d/CCParticleSystem.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCThreadPool.h"
+#include "base/CCProfiling.h"
+
+NS_CC_BEGIN
+
+static ParticleManager* s_sharedParticleManager = nullptr;
+
+ParticleManager* ParticleManager::getInstance()
+{
+    if (!s_sharedParticleManager)
+    {
+        s_sharedParticleManager = new (std::nothrow) ParticleManager();
+    }
+    return s_sharedParticleManager;
+}
+
+void ParticleManager::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedParticleManager);
+}
+
+ParticleManager::ParticleManager()
+: _enabled(false)
+, _threadCount(std::max(1, (int)std::thread::hardware_concurrency() - 1))
+, _minParallelParticles(256)
+, _threadPool(nullptr)
+, _afterVisitListener(nullptr)
+, _updatingSystems(false)
+, _hasRemovedSystems(false)
+, _hasPendingUpdate(false)
+, _pendingTasks(0)
+{
+}
+
+ParticleManager::~ParticleManager()
+{
+    setEnabled(false);
+    waitForUpdate();
+    // the destructor of the pool joins its threads
+    delete _threadPool;
+}
+
+void ParticleManager::setEnabled(bool enabled)
+{
+    if (_enabled == enabled)
+        return;
+
+    waitForUpdate();
+    _enabled = enabled;
+
+    auto director = Director::getInstance();
+    auto scheduler = director->getScheduler();
+    auto eventDispatcher = director->getEventDispatcher();
+    if (_enabled)
+    {
+        // same priority as the update of a particle system, after the actions and the default updates
+        scheduler->scheduleUpdate(this, 1, false);
+
+        // joins the work when no particle system was drawn
+        _afterVisitListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom*) {
+            waitForUpdate();
+        });
+        // Director::reset removes all the listeners before destroying the manager
+        CC_SAFE_RETAIN(_afterVisitListener);
+    }
+    else
+    {
+        scheduler->unscheduleUpdate(this);
+        if (_afterVisitListener)
+        {
+            eventDispatcher->removeEventListener(_afterVisitListener);
+            CC_SAFE_RELEASE_NULL(_afterVisitListener);
+        }
+
+        for (auto system : _systems)
+        {
+            if (system)
+            {
+                system->_updatedByManager = false;
+                system->scheduleUpdateWithPriority(1);
+                if (system->_updatePaused)
+                    scheduler->pauseTarget(system);
+            }
+        }
+        _systems.clear();
+    }
+}
+
+void ParticleManager::setThreadCount(int count)
+{
+    waitForUpdate();
+
+    _threadCount = std::max(1, count);
+    delete _threadPool;
+    _threadPool = nullptr;
+}
+
+ssize_t ParticleManager::getParticleSystemCount() const
+{
+    return std::count_if(_systems.begin(), _systems.end(), [](ParticleSystem* system) {
+        return system != nullptr;
+    });
+}
+
+void ParticleManager::addParticleSystem(ParticleSystem* system)
+{
+    CCASSERT(!system->_updatedByManager, "ParticleManager: the particle system is already registered");
+
+    system->_updatedByManager = true;
+    _systems.push_back(system);
+}
+
+void ParticleManager::removeParticleSystem(ParticleSystem* system)
+{
+    waitForUpdate();
+
+    auto it = std::find(_systems.begin(), _systems.end(), system);
+    if (it == _systems.end())
+        return;
+
+    system->_updatedByManager = false;
+    if (_updatingSystems)
+    {
+        // update is iterating the systems
+        *it = nullptr;
+        _hasRemovedSystems = true;
+        _updatedSystems.erase(std::remove(_updatedSystems.begin(), _updatedSystems.end(), system), _updatedSystems.end());
+    }
+    else
+    {
+        _systems.erase(it);
+    }
+}
+
+void ParticleManager::update(float dt)
+{
+    waitForUpdate();
+
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleManager - update");
+
+    // emission and lifetimes on the main thread, in registration order, so the random sequence does not depend
+    // on the threads; a system may remove itself or other systems from the scene here
+    int particleCount = 0;
+    _updatingSystems = true;
+    for (size_t i = 0; i < _systems.size(); ++i)
+    {
+        // the systems are not scheduled, so the scheduler does not know whether they are paused
+        ParticleSystem* system = _systems[i];
+        if (!system || !system->isRunning() || system->_updatePaused)
+            continue;
+
+        if (!system->updateLifetimes(dt))
+            continue;
+
+        system->prepareParticleQuads();
+        _updatedSystems.push_back(system);
+        particleCount += system->_particleCount;
+    }
+    _updatingSystems = false;
+
+    if (_hasRemovedSystems)
+    {
+        _systems.erase(std::remove(_systems.begin(), _systems.end(), nullptr), _systems.end());
+        _hasRemovedSystems = false;
+    }
+
+    if (_updatedSystems.empty())
+    {
+        CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleManager - update");
+        return;
+    }
+    _hasPendingUpdate = true;
+
+    // not worth waking the worker threads
+    if (particleCount < _minParallelParticles)
+    {
+        updateSystems(0, _updatedSystems.size(), dt);
+        CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleManager - update");
+        return;
+    }
+
+    if (!_threadPool)
+    {
+        _threadPool = experimental::ThreadPool::newFixedThreadPool(_threadCount);
+    }
+
+    // one task per thread, with consecutive systems of about the same number of particles
+    size_t taskCount = std::min((size_t)_threadCount, _updatedSystems.size());
+    int particlesPerTask = (particleCount + (int)taskCount - 1) / (int)taskCount;
+    std::vector<std::pair<size_t, size_t>> ranges;
+    size_t begin = 0;
+    int taskParticles = 0;
+    for (size_t i = 0; i < _updatedSystems.size(); ++i)
+    {
+        taskParticles += _updatedSystems[i]->_particleCount;
+        if (taskParticles >= particlesPerTask && ranges.size() + 1 < taskCount)
+        {
+            ranges.push_back(std::make_pair(begin, i + 1));
+            begin = i + 1;
+            taskParticles = 0;
+        }
+    }
+    if (begin < _updatedSystems.size())
+    {
+        ranges.push_back(std::make_pair(begin, _updatedSystems.size()));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_taskMutex);
+        _pendingTasks = (int)ranges.size();
+    }
+    for (const auto& range : ranges)
+    {
+        size_t first = range.first;
+        size_t last = range.second;
+        _threadPool->pushTask([this, first, last, dt](int /*threadId*/) {
+            updateSystems(first, last, dt);
+            finishTask();
+        });
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleManager - update");
+}
+
+void ParticleManager::updateSystems(size_t begin, size_t end, float dt)
+{
+    for (size_t i = begin; i < end; ++i)
+    {
+        ParticleSystem* system = _updatedSystems[i];
+        system->updateParticles(dt);
+        system->fillParticleQuads();
+    }
+}
+
+void ParticleManager::finishTask()
+{
+    std::lock_guard<std::mutex> lock(_taskMutex);
+    if (--_pendingTasks == 0)
+    {
+        _taskCondition.notify_all();
+    }
+}
+
+void ParticleManager::waitForUpdate()
+{
+    if (!_hasPendingUpdate)
+        return;
+
+    {
+        std::unique_lock<std::mutex> lock(_taskMutex);
+        _taskCondition.wait(lock, [this] { return _pendingTasks == 0; });
+    }
+    _hasPendingUpdate = false;
+
+    // GL calls stay on the main thread
+    for (auto system : _updatedSystems)
+    {
+        system->_transformSystemDirty = false;
+        if (system->isVisible() && !system->getBatchNode())
+        {
+            system->postStep();
+        }
+    }
+    _updatedSystems.clear();
+}
+
+NS_CC_END
@@ -0,0 +1,131 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCPARTICLEMANAGER_H__
+#define __CCPARTICLEMANAGER_H__
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include "base/CCRef.h"
+
+NS_CC_BEGIN
+
+class ParticleSystem;
+class EventListenerCustom;
+
+namespace experimental {
+    class ThreadPool;
+}
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class ParticleManager
+ * @brief Updates all the running particle systems of the scene together, on worker threads.
+ *
+ * When enabled, a ParticleSystem entering the scene registers itself here instead of scheduling its own update.
+ * Every frame the manager emits and ages the particles of each system on the main thread, in registration order,
+ * so the random sequence is the same as with per system updates. The movement of the particles and the quads
+ * are then computed on the worker threads, every system writing only its own particles and quads.
+ * The work is joined before the first particle system or particle batch node draws, or at the latest after the visit,
+ * and before any call that changes the particle arrays.
+ */
+class CC_DLL ParticleManager : public Ref
+{
+public:
+    /** Returns the shared instance of the particle manager. */
+    static ParticleManager* getInstance();
+
+    /** Destroys the shared instance, waiting for the pending work. */
+    static void destroyInstance();
+
+    /** Enables the parallel update. Disabled by default.
+     * Systems entering the scene afterwards are updated by the manager,
+     * disabling it gives the registered systems back their own scheduled update.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /** Sets the number of worker threads, by default one less than the number of CPU cores and at least one. */
+    void setThreadCount(int count);
+    int getThreadCount() const { return _threadCount; }
+
+    /** Sets the number of particles under which a frame is updated on the main thread, 256 by default. */
+    void setMinParallelParticles(int count) { _minParallelParticles = count; }
+    int getMinParallelParticles() const { return _minParallelParticles; }
+
+    /** Returns the number of particle systems updated by the manager. */
+    ssize_t getParticleSystemCount() const;
+
+    /** Registers a running particle system, called by ParticleSystem::onEnter. */
+    void addParticleSystem(ParticleSystem* system);
+    /** Unregisters a particle system, called by ParticleSystem::onExit. Waits for the pending work first. */
+    void removeParticleSystem(ParticleSystem* system);
+
+    /** Waits for the worker threads and uploads the updated particles. Does nothing when no work is pending. */
+    void waitForUpdate();
+
+    /** Starts the update of all the registered particle systems. Scheduled every frame while enabled. */
+    virtual void update(float dt);
+
+CC_CONSTRUCTOR_ACCESS:
+    ParticleManager();
+    virtual ~ParticleManager();
+
+protected:
+    void updateSystems(size_t begin, size_t end, float dt);
+    void finishTask();
+
+    bool _enabled;
+    int _threadCount;
+    int _minParallelParticles;
+    experimental::ThreadPool* _threadPool;
+    EventListenerCustom* _afterVisitListener;
+
+    // weak references, cleared by removeParticleSystem
+    std::vector<ParticleSystem*> _systems;
+    bool _updatingSystems;
+    bool _hasRemovedSystems;
+
+    // systems handed to the worker threads this frame
+    std::vector<ParticleSystem*> _updatedSystems;
+    bool _hasPendingUpdate;
+
+    //FIXME: std::atomic<int> isn't supported by ndk-r10e while compiling with `armeabi` arch.
+    // So using a mutex here instead.
+    int _pendingTasks;
+    std::mutex _taskMutex;
+    std::condition_variable _taskCondition;
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCPARTICLEMANAGER_H__
@@ -47,6 +47,8 @@ THE SOFTWARE.
 #include <string>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleManager.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
@@ -78,23 +80,6 @@ NS_CC_BEGIN
 //
 
 
-inline void nomalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
 /**
  A more effect random number getter function, get from ejoy2d.
  */
@@ -220,6 +205,8 @@ ParticleSystem::ParticleSystem()
 , _yCoordFlipped(1)
 , _positionType(PositionType::FREE)
 , _paused(false)
+, _updatedByManager(false)
+, _updatePaused(false)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -599,30 +586,18 @@ void ParticleSystem::addParticles(int count)
     int start = _particleCount;
     _particleCount += count;
 
+    int added = _particleCount - start;
+
     //life
-    for (int i = start; i < _particleCount ; ++i)
-    {
-        float theLife = _life + _lifeVar * RANDOM_M11(&RANDSEED);
-        _particleData.timeToLive[i] = MAX(0, theLife);
-    }
+    ParticleKernels::randomRange(_particleData.timeToLive + start, added, _life, _lifeVar, &RANDSEED, 0);
 
     //position
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posx[i] = _sourcePosition.x + _posVar.x * RANDOM_M11(&RANDSEED);
-    }
-
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posy[i] = _sourcePosition.y + _posVar.y * RANDOM_M11(&RANDSEED);
-    }
+    ParticleKernels::randomRange(_particleData.posx + start, added, _sourcePosition.x, _posVar.x, &RANDSEED);
+    ParticleKernels::randomRange(_particleData.posy + start, added, _sourcePosition.y, _posVar.y, &RANDSEED);
 
     //color
 #define SET_COLOR(c, b, v)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
-}
+ParticleKernels::randomRange(c + start, added, b, v, &RANDSEED, 0, 1);
 
     SET_COLOR(_particleData.colorR, _startColor.r, _startColorVar.r);
     SET_COLOR(_particleData.colorG, _startColor.g, _startColorVar.g);
@@ -635,10 +610,7 @@ c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
     SET_COLOR(_particleData.deltaColorA, _endColor.a, _endColorVar.a);
 
 #define SET_DELTA_COLOR(c, dc)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
-}
+ParticleKernels::computeDeltas(dc + start, c + start, _particleData.timeToLive + start, added);
 
     SET_DELTA_COLOR(_particleData.colorR, _particleData.deltaColorR);
     SET_DELTA_COLOR(_particleData.colorG, _particleData.deltaColorG);
@@ -646,20 +618,12 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     SET_DELTA_COLOR(_particleData.colorA, _particleData.deltaColorA);
 
     //size
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.size[i] = _startSize + _startSizeVar * RANDOM_M11(&RANDSEED);
-        _particleData.size[i] = MAX(0, _particleData.size[i]);
-    }
+    ParticleKernels::randomRange(_particleData.size + start, added, _startSize, _startSizeVar, &RANDSEED, 0);
 
     if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
     {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            float endSize = _endSize + _endSizeVar * RANDOM_M11(&RANDSEED);
-            endSize = MAX(0, endSize);
-            _particleData.deltaSize[i] = (endSize - _particleData.size[i]) / _particleData.timeToLive[i];
-        }
+        ParticleKernels::randomRange(_particleData.deltaSize + start, added, _endSize, _endSizeVar, &RANDSEED, 0);
+        ParticleKernels::computeDeltas(_particleData.deltaSize + start, _particleData.size + start, _particleData.timeToLive + start, added);
     }
     else
     {
@@ -670,15 +634,9 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     }
 
     // rotation
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.rotation[i] = _startSpin + _startSpinVar * RANDOM_M11(&RANDSEED);
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        float endA = _endSpin + _endSpinVar * RANDOM_M11(&RANDSEED);
-        _particleData.deltaRotation[i] = (endA - _particleData.rotation[i]) / _particleData.timeToLive[i];
-    }
+    ParticleKernels::randomRange(_particleData.rotation + start, added, _startSpin, _startSpinVar, &RANDSEED);
+    ParticleKernels::randomRange(_particleData.deltaRotation + start, added, _endSpin, _endSpinVar, &RANDSEED);
+    ParticleKernels::computeDeltas(_particleData.deltaRotation + start, _particleData.rotation + start, _particleData.timeToLive + start, added);
 
     // position
     Vec2 pos;
@@ -704,16 +662,10 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
 
         // radial accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::randomRange(_particleData.modeA.radialAccel + start, added, modeA.radialAccel, modeA.radialAccelVar, &RANDSEED);
 
         // tangential accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::randomRange(_particleData.modeA.tangentialAccel + start, added, modeA.tangentialAccel, modeA.tangentialAccelVar, &RANDSEED);
         
         // rotation is dir
         if( modeA.rotationIsDir )
@@ -749,10 +701,7 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         //Need to check by Jacky
         // Set the default diameter of the particle from the source position
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::randomRange(_particleData.modeB.radius + start, added, modeB.startRadius, modeB.startRadiusVar, &RANDSEED);
 
         for (int i = start; i < _particleCount; ++i)
         {
@@ -773,11 +722,8 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
         }
         else
         {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float endRadius = modeB.endRadius + modeB.endRadiusVar * RANDOM_M11(&RANDSEED);
-                _particleData.modeB.deltaRadius[i] = (endRadius - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
-            }
+            ParticleKernels::randomRange(_particleData.modeB.deltaRadius + start, added, modeB.endRadius, modeB.endRadiusVar, &RANDSEED);
+            ParticleKernels::computeDeltas(_particleData.modeB.deltaRadius + start, _particleData.modeB.radius + start, _particleData.timeToLive + start, added);
         }
     }
 }
@@ -795,7 +741,11 @@ void ParticleSystem::onEnter()
     Node::onEnter();
 
     // update after action in run!
-    this->scheduleUpdateWithPriority(1);
+    auto manager = ParticleManager::getInstance();
+    if (manager->isEnabled())
+        manager->addParticleSystem(this);
+    else
+        this->scheduleUpdateWithPriority(1);
 }
 
 void ParticleSystem::onExit()
@@ -808,10 +758,25 @@ void ParticleSystem::onExit()
     }
 #endif
 
-    this->unscheduleUpdate();
+    if (_updatedByManager)
+        ParticleManager::getInstance()->removeParticleSystem(this);
+    else
+        this->unscheduleUpdate();
     Node::onExit();
 }
 
+void ParticleSystem::pause()
+{
+    Node::pause();
+    _updatePaused = true;
+}
+
+void ParticleSystem::resume()
+{
+    Node::resume();
+    _updatePaused = false;
+}
+
 void ParticleSystem::stopSystem()
 {
     _isActive = false;
@@ -821,6 +786,8 @@ void ParticleSystem::stopSystem()
 
 void ParticleSystem::resetSystem()
 {
+    waitForParallelUpdate();
+
     _isActive = true;
     _elapsed = 0;
     for (int i = 0; i < _particleCount; ++i)
@@ -839,6 +806,26 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    waitForParallelUpdate();
+
+    if (!updateLifetimes(dt))
+        return;
+
+    updateParticles(dt);
+    updateParticleQuads();
+    _transformSystemDirty = false;
+
+    // only update gl buffer when visible
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+bool ParticleSystem::updateLifetimes(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -863,151 +850,73 @@ void ParticleSystem::update(float dt)
         }
     }
 
+    for (int i = 0; i < _particleCount; ++i)
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
-
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            if (_particleData.timeToLive[i] <= 0.0f)
-            {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        }
-
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    nomalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
+        _particleData.timeToLive[i] -= dt;
+    }
 
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
-        }
-        else
+    for (int i = 0; i < _particleCount; ++i)
+    {
+        if (_particleData.timeToLive[i] <= 0.0f)
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
+            int j = _particleCount - 1;
+            while (j > 0 && _particleData.timeToLive[j] <= 0)
             {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
+                _particleCount--;
+                j--;
             }
-
-            for (int i = 0; i < _particleCount; ++i)
+            _particleData.copyParticle(i, _particleCount - 1);
+            if (_batchNode)
             {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
+                //disable the switched particle
+                int currentIndex = _particleData.atlasIndex[i];
+                _batchNode->disableParticle(_atlasIndex + currentIndex);
+                //switch indexes
+                _particleData.atlasIndex[_particleCount - 1] = currentIndex;
             }
-
-            for (int i = 0; i < _particleCount; ++i)
+            --_particleCount;
+            if( _particleCount == 0 && _isAutoRemoveOnFinish )
             {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
+                if (!_updatedByManager)
+                    this->unscheduleUpdate();
+                _parent->removeChild(this, true);
+                return false;
             }
         }
+    }
 
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
-
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
-
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
+    return true;
+}
 
-        updateParticleQuads();
-        _transformSystemDirty = false;
+void ParticleSystem::updateParticles(float dt)
+{
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        // this is cocos2d-x v3.0
+        // if (_configName.length()>0 && _yCoordFlipped != -1)
+        ParticleKernels::updateGravityMode(_particleData, _particleCount, dt, modeA.gravity.x, modeA.gravity.y, _yCoordFlipped);
     }
-
-    // only update gl buffer when visible
-    if (_visible && ! _batchNode)
+    else
     {
-        postStep();
+        ParticleKernels::updateRadiusMode(_particleData, _particleCount, dt, _yCoordFlipped);
     }
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+    //Why use so many for-loop separately instead of putting them together?
+    //When the processor needs to read from or write to a location in memory,
+    //it first checks whether a copy of that data is in the cache.
+    //And every property's memory of the particle system is continuous,
+    //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
+    //It was proved to be effective especially for low-end machine. 
+
+    //color r,g,b,a
+    ParticleKernels::integrate(_particleData.colorR, _particleData.deltaColorR, _particleCount, dt);
+    ParticleKernels::integrate(_particleData.colorG, _particleData.deltaColorG, _particleCount, dt);
+    ParticleKernels::integrate(_particleData.colorB, _particleData.deltaColorB, _particleCount, dt);
+    ParticleKernels::integrate(_particleData.colorA, _particleData.deltaColorA, _particleCount, dt);
+    //size
+    ParticleKernels::integrateClamped(_particleData.size, _particleData.deltaSize, _particleCount, dt, 0);
+    //angle
+    ParticleKernels::integrate(_particleData.rotation, _particleData.deltaRotation, _particleCount, dt);
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -1020,6 +929,22 @@ void ParticleSystem::updateParticleQuads()
     //should be overridden
 }
 
+void ParticleSystem::prepareParticleQuads()
+{
+    //should be overridden
+}
+
+void ParticleSystem::fillParticleQuads()
+{
+    //should be overridden
+}
+
+void ParticleSystem::waitForParallelUpdate()
+{
+    if (_updatedByManager)
+        ParticleManager::getInstance()->waitForUpdate();
+}
+
 void ParticleSystem::postStep()
 {
     // should be overridden
@@ -1091,6 +1016,7 @@ bool ParticleSystem::isBlendAdditive() const
 void ParticleSystem::setTangentialAccel(float t)
 {
     CCASSERT( _emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.tangentialAccel = t;
 }
 
@@ -1103,6 +1029,7 @@ float ParticleSystem::getTangentialAccel() const
 void ParticleSystem::setTangentialAccelVar(float t)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.tangentialAccelVar = t;
 }
 
@@ -1115,6 +1042,7 @@ float ParticleSystem::getTangentialAccelVar() const
 void ParticleSystem::setRadialAccel(float t)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.radialAccel = t;
 }
 
@@ -1127,6 +1055,7 @@ float ParticleSystem::getRadialAccel() const
 void ParticleSystem::setRadialAccelVar(float t)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.radialAccelVar = t;
 }
 
@@ -1139,6 +1068,7 @@ float ParticleSystem::getRadialAccelVar() const
 void ParticleSystem::setRotationIsDir(bool t)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.rotationIsDir = t;
 }
 
@@ -1151,6 +1081,7 @@ bool ParticleSystem::getRotationIsDir() const
 void ParticleSystem::setGravity(const Vec2& g)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.gravity = g;
 }
 
@@ -1163,6 +1094,7 @@ const Vec2& ParticleSystem::getGravity()
 void ParticleSystem::setSpeed(float speed)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.speed = speed;
 }
 
@@ -1175,6 +1107,7 @@ float ParticleSystem::getSpeed() const
 void ParticleSystem::setSpeedVar(float speedVar)
 {
     CCASSERT(_emitterMode == Mode::GRAVITY, "Particle Mode should be Gravity");
+    waitForParallelUpdate();
     modeA.speedVar = speedVar;
 }
 
@@ -1188,6 +1121,7 @@ float ParticleSystem::getSpeedVar() const
 void ParticleSystem::setStartRadius(float startRadius)
 {
     CCASSERT(_emitterMode == Mode::RADIUS, "Particle Mode should be Radius");
+    waitForParallelUpdate();
     modeB.startRadius = startRadius;
 }
 
@@ -1200,6 +1134,7 @@ float ParticleSystem::getStartRadius() const
 void ParticleSystem::setStartRadiusVar(float startRadiusVar)
 {
     CCASSERT(_emitterMode == Mode::RADIUS, "Particle Mode should be Radius");
+    waitForParallelUpdate();
     modeB.startRadiusVar = startRadiusVar;
 }
 
@@ -1212,6 +1147,7 @@ float ParticleSystem::getStartRadiusVar() const
 void ParticleSystem::setEndRadius(float endRadius)
 {
     CCASSERT(_emitterMode == Mode::RADIUS, "Particle Mode should be Radius");
+    waitForParallelUpdate();
     modeB.endRadius = endRadius;
 }
 
@@ -1224,6 +1160,7 @@ float ParticleSystem::getEndRadius() const
 void ParticleSystem::setEndRadiusVar(float endRadiusVar)
 {
     CCASSERT(_emitterMode == Mode::RADIUS, "Particle Mode should be Radius");
+    waitForParallelUpdate();
     modeB.endRadiusVar = endRadiusVar;
 }
 
@@ -1236,6 +1173,7 @@ float ParticleSystem::getEndRadiusVar() const
 void ParticleSystem::setRotatePerSecond(float degrees)
 {
     CCASSERT(_emitterMode == Mode::RADIUS, "Particle Mode should be Radius");
+    waitForParallelUpdate();
     modeB.rotatePerSecond = degrees;
 }
 
@@ -1248,6 +1186,7 @@ float ParticleSystem::getRotatePerSecond() const
 void ParticleSystem::setRotatePerSecondVar(float degrees)
 {
     CCASSERT(_emitterMode == Mode::RADIUS, "Particle Mode should be Radius");
+    waitForParallelUpdate();
     modeB.rotatePerSecondVar = degrees;
 }
 
@@ -1270,6 +1209,7 @@ int ParticleSystem::getTotalParticles() const
 void ParticleSystem::setTotalParticles(int var)
 {
     CCASSERT( var <= _allocatedParticles, "Particle: resizing particle array only supported for quads");
+    waitForParallelUpdate();
     _totalParticles = var;
 }
 
@@ -1306,6 +1246,8 @@ ParticleBatchNode* ParticleSystem::getBatchNode(void) const
 
 void ParticleSystem::setBatchNode(ParticleBatchNode* batchNode)
 {
+    waitForParallelUpdate();
+
     if( _batchNode != batchNode ) {
 
         _batchNode = batchNode; // weak reference
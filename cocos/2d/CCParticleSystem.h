@@ -39,6 +39,7 @@ NS_CC_BEGIN
  */
 
 class ParticleBatchNode;
+class ParticleManager;
 
 /** @struct sParticle
 Structure that contains the values of each particle.
@@ -567,7 +568,7 @@ public:
      *
      * @param mode The mode of the emitter.
      */
-    inline void setEmitterMode(Mode mode) { _emitterMode = mode; };
+    inline void setEmitterMode(Mode mode) { waitForParallelUpdate(); _emitterMode = mode; };
 
     /** Gets the start size in pixels of each particle.
      *
@@ -744,6 +745,8 @@ public:
     virtual void onEnter() override;
     virtual void onExit() override;
     virtual void update(float dt) override;
+    virtual void pause() override;
+    virtual void resume() override;
     virtual Texture2D* getTexture() const override;
     virtual void setTexture(Texture2D *texture) override;
     /**
@@ -815,6 +818,23 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    /** Emits new particles, ages the living ones and removes the dead ones. Main thread only.
+     @return False if the system removed itself from its parent.
+     */
+    bool updateLifetimes(float dt);
+    /** Moves the particles and updates their color, size and rotation. Only touches the particle data,
+     so it may run on a worker thread.
+     */
+    void updateParticles(float dt);
+    /** Reads the node state needed by fillParticleQuads, on the main thread. */
+    virtual void prepareParticleQuads();
+    /** Writes the quads from the particle data and the state read by prepareParticleQuads, may run on a worker thread. */
+    virtual void fillParticleQuads();
+    /** Waits for the ParticleManager if it updates this system on its worker threads. */
+    void waitForParallelUpdate();
+
+    friend class ParticleManager;
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -970,6 +990,12 @@ protected:
     /** is the emitter paused */
     bool _paused;
 
+    /** whether the system is updated by the ParticleManager instead of its own scheduled update */
+    bool _updatedByManager;
+
+    /** whether the node is paused, the scheduler only knows it for the systems with their own scheduled update */
+    bool _updatePaused;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
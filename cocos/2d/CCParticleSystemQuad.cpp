@@ -33,7 +33,9 @@ THE SOFTWARE.
 
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
 #include "renderer/CCTextureAtlas.h"
+#include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCDirector.h"
@@ -45,16 +47,40 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+namespace
+{
+    // static vertex stream of RenderMode::GPU_EXPANDED
+    struct ParticleCorner
+    {
+        Vec2 corner;        // -0.5 or 0.5 on each axis
+        Tex2F texCoords;
+    };
+}
+
 ParticleSystemQuad::ParticleSystemQuad()
 :_quads(nullptr)
 ,_indices(nullptr)
 ,_VAOname(0)
+,_renderMode(RenderMode::QUAD)
+,_instanced(false)
+,_records(nullptr)
+,_allocatedRecords(0)
+,_cornersDirty(true)
+,_quadGrouped(false)
+,_quadOpacityModifyRGB(false)
 {
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(_recordBuffers, 0, sizeof(_recordBuffers));
+    memset(_quadStartTransform, 0, sizeof(_quadStartTransform));
 }
 
 ParticleSystemQuad::~ParticleSystemQuad()
 {
+    CC_SAFE_FREE(_records);
+    if (_recordBuffers[0])
+    {
+        glDeleteBuffers(2, &_recordBuffers[0]);
+    }
     if (nullptr == _batchNode)
     {
         CC_SAFE_FREE(_quads);
@@ -176,6 +202,8 @@ void ParticleSystemQuad::initTexCoordsWithRect(const Rect& pointRect)
     // Important. Texture in cocos2d are inverted, so the Y component should be inverted
     std::swap(top, bottom);
 
+    _cornersDirty = true;
+
     V3F_C4B_T2F_Quad *quads = nullptr;
     unsigned int start = 0, end = 0;
     if (_batchNode)
@@ -262,61 +290,42 @@ void ParticleSystemQuad::initIndices()
     }
 }
 
-inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPosition,float size,float rotation)
+void ParticleSystemQuad::updateParticleQuads()
 {
-    // vertices
-    GLfloat size_2 = size/2;
-    GLfloat x1 = -size_2;
-    GLfloat y1 = -size_2;
-
-    GLfloat x2 = size_2;
-    GLfloat y2 = size_2;
-    GLfloat x = newPosition.x;
-    GLfloat y = newPosition.y;
-
-    GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(rotation);
-    GLfloat cr = cosf(r);
-    GLfloat sr = sinf(r);
-    GLfloat ax = x1 * cr - y1 * sr + x;
-    GLfloat ay = x1 * sr + y1 * cr + y;
-    GLfloat bx = x2 * cr - y1 * sr + x;
-    GLfloat by = x2 * sr + y1 * cr + y;
-    GLfloat cx = x2 * cr - y2 * sr + x;
-    GLfloat cy = x2 * sr + y2 * cr + y;
-    GLfloat dx = x1 * cr - y2 * sr + x;
-    GLfloat dy = x1 * sr + y2 * cr + y;
-
-    // bottom-left
-    quad->bl.vertices.x = ax;
-    quad->bl.vertices.y = ay;
-
-    // bottom-right vertex:
-    quad->br.vertices.x = bx;
-    quad->br.vertices.y = by;
-
-    // top-left vertex:
-    quad->tl.vertices.x = dx;
-    quad->tl.vertices.y = dy;
-
-    // top-right vertex:
-    quad->tr.vertices.x = cx;
-    quad->tr.vertices.y = cy;
+    prepareParticleQuads();
+    fillParticleQuads();
 }
 
-void ParticleSystemQuad::updateParticleQuads()
+void ParticleSystemQuad::prepareParticleQuads()
 {
-    if (_particleCount <= 0) {
-        return;
-    }
+    _quadPosition = _position;
+    _quadGrouped = _positionType == PositionType::GROUPED;
+    _quadOpacityModifyRGB = _opacityModifyRGB;
 
-    Vec2 currentPosition;
-    if (_positionType == PositionType::FREE)
+    if( _positionType == PositionType::FREE )
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _quadCurrentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        // only the linear part of the transform applies to the distance between two world positions
+        const float* m = getWorldToNodeTransform().m;
+        _quadStartTransform[0] = m[0];
+        _quadStartTransform[1] = m[4];
+        _quadStartTransform[2] = m[1];
+        _quadStartTransform[3] = m[5];
     }
-    else if (_positionType == PositionType::RELATIVE)
+    else if( _positionType == PositionType::RELATIVE )
     {
-        currentPosition = _position;
+        _quadCurrentPosition = _position;
+        _quadStartTransform[0] = 1;
+        _quadStartTransform[1] = 0;
+        _quadStartTransform[2] = 0;
+        _quadStartTransform[3] = 1;
+    }
+}
+
+void ParticleSystemQuad::fillParticleQuads()
+{
+    if (_particleCount <= 0) {
+        return;
     }
 
     V3F_C4B_T2F_Quad *startQuad;
@@ -325,119 +334,33 @@ void ParticleSystemQuad::updateParticleQuads()
     {
         V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
         startQuad = &(batchQuads[_atlasIndex]);
-        pos = _position;
+        pos = _quadPosition;
     }
     else
     {
         startQuad = &(_quads[0]);
     }
 
-    if( _positionType == PositionType::FREE )
-    {
-        Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
-        worldToNodeTM.transformPoint(&p1);
-        Vec3 p2;
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            p2.set(*startX, *startY, 0);
-            worldToNodeTM.transformPoint(&p2);
-            newPos.set(*x,*y);
-            p2 = p1 - p2;
-            newPos.x -= p2.x - pos.x;
-            newPos.y -= p2.y - pos.y;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
-    }
-    else if( _positionType == PositionType::RELATIVE )
-    {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            newPos.set(*x, *y);
-            newPos.x = *x - (currentPosition.x - *startX);
-            newPos.y = *y - (currentPosition.y - *startY);
-            newPos += pos;
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
-    }
-    else
+    const float* startTransform = _quadGrouped ? nullptr : _quadStartTransform;
+    if (isGPUExpanded())
     {
-        Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
-        {
-            newPos.set(*x + pos.x, *y + pos.y);
-            updatePosWithParticle(quadStart, newPos, *s, *r);
-        }
+        ParticleKernels::updateRecords(_particleData, _particleCount, _records, _instanced ? 1 : 4, _quadOpacityModifyRGB,
+                                       pos, startTransform, _quadCurrentPosition);
+        return;
     }
 
-    //set color
-    if(_opacityModifyRGB)
-    {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
+    ParticleKernels::updateQuadPositions(_particleData, _particleCount, startQuad, pos, startTransform, _quadCurrentPosition);
 
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
-        {
-            GLubyte colorR = *r * *a * 255;
-            GLubyte colorG = *g * *a * 255;
-            GLubyte colorB = *b * *a * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
-        }
-    }
-    else
-    {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
-
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
-        {
-            GLubyte colorR = *r * 255;
-            GLubyte colorG = *g * 255;
-            GLubyte colorB = *b * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
-        }
-    }
+    //set color
+    ParticleKernels::updateQuadColors(_particleData, _particleCount, startQuad, _quadOpacityModifyRGB);
 }
 
 void ParticleSystemQuad::postStep()
 {
+    // the records are uploaded by onDrawExpanded
+    if (isGPUExpanded())
+        return;
+
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
 
     // Option 1: Sub Data
@@ -460,8 +383,16 @@ void ParticleSystemQuad::postStep()
 // overriding draw method
 void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    waitForParallelUpdate();
+
+    if (_particleCount > 0 && isGPUExpanded())
+    {
+        _expandedCommand.init(_globalZOrder, transform, flags);
+        _expandedCommand.func = CC_CALLBACK_0(ParticleSystemQuad::onDrawExpanded, this, transform, flags);
+        renderer->addCommand(&_expandedCommand);
+    }
     //quad command
-    if(_particleCount > 0)
+    else if(_particleCount > 0)
     {
         _quadCommand.init(_globalZOrder, _texture, getGLProgramState(), _blendFunc, _quads, _particleCount, transform, flags);
         renderer->addCommand(&_quadCommand);
@@ -470,6 +401,8 @@ void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_
 
 void ParticleSystemQuad::setTotalParticles(int tp)
 {
+    waitForParallelUpdate();
+
     // If we are setting the total number of particles to a number higher
     // than what is allocated, we need to allocate new arrays
     if( tp > _allocatedParticles )
@@ -539,6 +472,13 @@ void ParticleSystemQuad::setTotalParticles(int tp)
         _totalParticles = tp;
     }
 
+    _cornersDirty = true;
+    if (_renderMode == RenderMode::GPU_EXPANDED && !allocRecords())
+    {
+        _renderMode = RenderMode::QUAD;
+        setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+    }
+
     // fixed issue #5762
     // reset the emission rate
     setEmissionRate(_totalParticles / _life);
@@ -608,6 +548,8 @@ void ParticleSystemQuad::listenRendererRecreated(EventCustom* event)
     //when comes to foreground in android, _buffersVBO and _VAOname is a wild handle
     //before recreating, we need to reset them to 0
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(_recordBuffers, 0, sizeof(_recordBuffers));
+    _cornersDirty = true;
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         _VAOname = 0;
@@ -644,8 +586,143 @@ bool ParticleSystemQuad::allocMemory()
     return true;
 }
 
+void ParticleSystemQuad::setRenderMode(RenderMode mode)
+{
+    if (_renderMode == mode)
+        return;
+
+    waitForParallelUpdate();
+
+    if (mode == RenderMode::GPU_EXPANDED)
+    {
+        _instanced = Configuration::getInstance()->supportsInstancedArrays();
+        _renderMode = mode;
+        if (!allocRecords())
+        {
+            _renderMode = RenderMode::QUAD;
+            return;
+        }
+        _cornersDirty = true;
+        // a custom shader set by the user is kept
+        if (getGLProgram() == GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP))
+        {
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_PARTICLE_EXPANDED));
+        }
+    }
+    else
+    {
+        _renderMode = mode;
+        CC_SAFE_FREE(_records);
+        _allocatedRecords = 0;
+        if (getGLProgram() == GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_PARTICLE_EXPANDED))
+        {
+            setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP));
+        }
+    }
+
+    // the quads or records of the current particles are written by the next update
+    updateParticleQuads();
+}
+
+bool ParticleSystemQuad::allocRecords()
+{
+    int count = _allocatedParticles * (_instanced ? 1 : 4);
+    if (count <= _allocatedRecords)
+        return true;
+
+    ParticleRecord* records = (ParticleRecord*)realloc(_records, count * sizeof(ParticleRecord));
+    if (!records)
+    {
+        CCLOG("cocos2d: Particle system: not enough memory for the particle records");
+        return false;
+    }
+    _records = records;
+    _allocatedRecords = count;
+    return true;
+}
+
+void ParticleSystemQuad::updateCornerBuffer()
+{
+    // every quad has the same texture coordinates, the ones of the first quad
+    const V3F_C4B_T2F_Quad& quad = _quads[0];
+    const ParticleCorner corners[4] = {
+        { Vec2(-0.5f,  0.5f), quad.tl.texCoords },
+        { Vec2(-0.5f, -0.5f), quad.bl.texCoords },
+        { Vec2( 0.5f,  0.5f), quad.tr.texCoords },
+        { Vec2( 0.5f, -0.5f), quad.br.texCoords },
+    };
+
+    // without instancing the corners are repeated for every particle, to match the repeated records
+    int quadCount = _instanced ? 1 : _totalParticles;
+    std::vector<ParticleCorner> buffer(quadCount * 4);
+    for (int i = 0; i < quadCount; ++i)
+    {
+        memcpy(&buffer[i * 4], corners, sizeof(corners));
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _recordBuffers[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleCorner) * buffer.size(), buffer.data(), GL_STATIC_DRAW);
+    _cornersDirty = false;
+}
+
+void ParticleSystemQuad::onDrawExpanded(const Mat4& transform, uint32_t /*flags*/)
+{
+    getGLProgramState()->apply(transform);
+    if (_texture)
+    {
+        GL::bindTexture2D(_texture->getName());
+    }
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+    GL::bindVAO(0);
+
+    if (!_recordBuffers[0])
+    {
+        glGenBuffers(2, &_recordBuffers[0]);
+    }
+    if (_cornersDirty)
+    {
+        updateCornerBuffer();
+    }
+
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX | (1 << GLProgram::VERTEX_ATTRIB_TEX_COORD1));
+
+    // orphans the buffer of the previous frame
+    int copies = _instanced ? 1 : 4;
+    glBindBuffer(GL_ARRAY_BUFFER, _recordBuffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleRecord) * _particleCount * copies, _records, GL_STREAM_DRAW);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleRecord), (GLvoid*) offsetof(ParticleRecord, x));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleRecord), (GLvoid*) offsetof(ParticleRecord, color));
+
+    glBindBuffer(GL_ARRAY_BUFFER, _recordBuffers[1]);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleCorner), (GLvoid*) offsetof(ParticleCorner, texCoords));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD1, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleCorner), (GLvoid*) offsetof(ParticleCorner, corner));
+
+    // the indices of the first quad are the ones of every instance
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    if (_instanced)
+    {
+        GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_POSITION, 1);
+        GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_COLOR, 1);
+        GL::drawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (GLvoid*)0, _particleCount);
+        GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_POSITION, 0);
+        GL::vertexAttribDivisor(GLProgram::VERTEX_ATTRIB_COLOR, 0);
+    }
+    else
+    {
+        glDrawElements(GL_TRIANGLES, (GLsizei)_particleCount * 6, GL_UNSIGNED_SHORT, (GLvoid*)0);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _particleCount * 4);
+    CHECK_GL_ERROR_DEBUG();
+}
+
 void ParticleSystemQuad::setBatchNode(ParticleBatchNode * batchNode)
 {
+    waitForParallelUpdate();
+
     if( _batchNode != batchNode )
     {
         ParticleBatchNode* oldBatch = _batchNode;
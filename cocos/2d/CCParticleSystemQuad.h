@@ -30,9 +30,12 @@ THE SOFTWARE.
 
 #include "2d/CCParticleSystem.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCCustomCommand.h"
 
 NS_CC_BEGIN
 
+struct ParticleRecord;
+
 class SpriteFrame;
 class EventCustom;
 
@@ -52,12 +55,30 @@ Special features and Limitations:
 - The particles can be rotated.
 - It supports subrects.
 - It supports batched rendering since 1.1.
+- Without a batch node, the quads can be built by the vertex shader from one small record per particle, see RenderMode.
 @since v0.8
 @js NA
 */
 class CC_DLL ParticleSystemQuad : public ParticleSystem
 {
 public:
+    /** @enum RenderMode
+     * How a particle system without batch node sends its particles to the GPU.
+     */
+    enum class RenderMode
+    {
+        /** The four vertices of every particle are computed on the CPU. */
+        QUAD,
+        /** A 20 bytes record per particle (position, size, rotation and color) is uploaded every frame,
+         * and the vertex shader computes the corners. The records are drawn as instances when the GPU supports
+         * instanced arrays, 20 bytes per particle instead of 96. Otherwise each record is repeated for the four
+         * vertices of its quad, 80 bytes per particle, GLES 2 has no vertex id to share one record: the upload
+         * is barely smaller, only the corner math moves to the GPU.
+         * The default shader of the system is replaced by GLProgram::SHADER_NAME_PARTICLE_EXPANDED, a custom
+         * shader is kept and has to read the records.
+         */
+        GPU_EXPANDED
+    };
 
     /** Creates a Particle Emitter.
      *
@@ -110,6 +131,12 @@ public:
      */
     void listenRendererRecreated(EventCustom* event);
 
+    /** Sets how the particles are sent to the GPU, RenderMode::QUAD by default.
+     * RenderMode::GPU_EXPANDED is ignored while the system is drawn by a ParticleBatchNode.
+     */
+    void setRenderMode(RenderMode mode);
+    RenderMode getRenderMode() const { return _renderMode; }
+
     /**
      * @js NA
      * @lua NA
@@ -163,6 +190,9 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool initWithTotalParticles(int numberOfParticles) override;
 
 protected:
+    virtual void prepareParticleQuads() override;
+    virtual void fillParticleQuads() override;
+
     /** initializes the indices for the vertices*/
     void initIndices();
 
@@ -176,6 +206,11 @@ protected:
     void setupVBO();
     bool allocMemory();
 
+    bool isGPUExpanded() const { return _renderMode == RenderMode::GPU_EXPANDED && !_batchNode; }
+    bool allocRecords();
+    void updateCornerBuffer();
+    void onDrawExpanded(const Mat4& transform, uint32_t flags);
+
     V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered
     GLushort            *_indices;      // indices
     GLuint              _VAOname;
@@ -183,6 +218,21 @@ protected:
 
     QuadCommand _quadCommand;           // quad command
 
+    // node state read by prepareParticleQuads, the setters of these do not wait for the ParticleManager
+    Vec2 _quadCurrentPosition;
+    float _quadStartTransform[4];       // row major 2x2
+    Vec2 _quadPosition;
+    bool _quadGrouped;
+    bool _quadOpacityModifyRGB;
+
+    RenderMode _renderMode;
+    bool _instanced;                    // one record per particle, drawn as instances
+    ParticleRecord* _records;
+    int _allocatedRecords;
+    GLuint _recordBuffers[2];           //0: records  1: quad corners and texture coordinates
+    bool _cornersDirty;
+    CustomCommand _expandedCommand;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystemQuad);
 };
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "2d/CCAnimationCache.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCRenderer.h"
@@ -179,6 +180,16 @@ bool Sprite::initWithFile(const std::string& filename)
     _fileName = filename;
     _fileType = 0;
 
+    DynamicAtlas* dynamicAtlas = DynamicAtlas::getInstance();
+    if (dynamicAtlas->isEnabled())
+    {
+        SpriteFrame* frame = dynamicAtlas->addImage(filename);
+        if (frame)
+        {
+            return initWithSpriteFrame(frame);
+        }
+    }
+
     Texture2D *texture = _director->getTextureCache()->addImage(filename);
     if (texture)
     {
@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "base/CCAsyncTaskPool.h"
+#include "2d/CCSpriteSheetBinary.h"
 
 using namespace std;
 
@@ -49,6 +51,55 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+namespace
+{
+    bool getSheetPixelFormat(const std::string& pixelFormatName, Texture2D::PixelFormat& pixelFormat)
+    {
+        static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
+            {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
+            {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
+            {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
+            {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
+            {"RGB565", Texture2D::PixelFormat::RGB565},
+            {"A8", Texture2D::PixelFormat::A8},
+            {"ALPHA", Texture2D::PixelFormat::A8},
+            {"I8", Texture2D::PixelFormat::I8},
+            {"AI88", Texture2D::PixelFormat::AI88},
+            {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
+            //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+            {"RGB888", Texture2D::PixelFormat::RGB888}
+        };
+
+        auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+        if (pixelFormatIt == pixelFormats.end())
+            return false;
+        pixelFormat = pixelFormatIt->second;
+        return true;
+    }
+
+    std::string getSheetTexturePath(const std::string& plist, const std::string& textureFileName)
+    {
+        if (!textureFileName.empty())
+        {
+            // build texture path relative to plist file
+            return FileUtils::getInstance()->fullPathFromRelativeFile(textureFileName, plist);
+        }
+
+        // build texture path by replacing file extension
+        std::string texturePath = plist;
+
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of(".");
+        texturePath = texturePath.erase(startPos);
+
+        // append .png
+        texturePath = texturePath.append(".png");
+
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+        return texturePath;
+    }
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -308,26 +359,24 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
-        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
-        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
-        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
-        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
-        {"RGB565", Texture2D::PixelFormat::RGB565},
-        {"A8", Texture2D::PixelFormat::A8},
-        {"ALPHA", Texture2D::PixelFormat::A8},
-        {"I8", Texture2D::PixelFormat::I8},
-        {"AI88", Texture2D::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
-        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", Texture2D::PixelFormat::RGB888}
-    };
+    Texture2D *texture = addSheetTexture(texturePath, pixelFormatName);
+    
+    if (texture)
+    {
+        addSpriteFramesWithDictionary(dict, texture);
+    }
+    else
+    {
+        CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+    }
+}
 
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
+Texture2D* SpriteFrameCache::addSheetTexture(const std::string& texturePath, const std::string& pixelFormatName)
+{
+    Texture2D *texture = nullptr;
+    Texture2D::PixelFormat pixelFormat;
+    if (getSheetPixelFormat(pixelFormatName, pixelFormat))
     {
-        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
         const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
         Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
         texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
@@ -337,15 +386,103 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
     {
         texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
     }
-    
-    if (texture)
+    return texture;
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinaryData(const Data& data, Texture2D* texture)
+{
+    auto header = SpriteSheetBinary::getHeader(data);
+    if (!header)
+        return;
+
+    const SpriteSheetBinary::FrameRecord* frames = SpriteSheetBinary::getFrames(data);
+    const SpriteSheetBinary::AliasRecord* aliases = SpriteSheetBinary::getAliases(data);
+    const int32_t* polygonData = SpriteSheetBinary::getPolygonData(data);
+    Size textureSize(header->textureWidth, header->textureHeight);
+
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    _spriteFrames.reserve(_spriteFrames.size() + header->frameCount);
+
+    for (uint32_t i = 0; i < header->frameCount; ++i)
     {
-        addSpriteFramesWithDictionary(dict, texture);
+        const SpriteSheetBinary::FrameRecord& record = frames[i];
+        std::string spriteFrameName = SpriteSheetBinary::getString(data, record.name);
+        if (_spriteFrames.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        Size sourceSize(record.sourceWidth, record.sourceHeight);
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(record.x, record.y, record.width, record.height),
+                                                                  record.rotated != 0,
+                                                                  Vec2(record.offsetX, record.offsetY),
+                                                                  sourceSize);
+
+        if (record.vertexCount > 0)
+        {
+            std::vector<int> vertices(polygonData + record.vertices, polygonData + record.vertices + record.vertexCount);
+            std::vector<int> verticesUV(polygonData + record.verticesUV, polygonData + record.verticesUV + record.vertexCount);
+            std::vector<int> indices(polygonData + record.indices, polygonData + record.indices + record.indexCount);
+
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, verticesUV, indices, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (record.hasAnchor)
+        {
+            spriteFrame->setAnchorPoint(Vec2(record.anchorX, record.anchorY));
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr) {
+                image = new (std::nothrow) Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+        // add sprite frame
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
     }
-    else
+    CC_SAFE_RELEASE(image);
+
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        std::string oneAlias = SpriteSheetBinary::getString(data, aliases[i].name);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+        _spriteFramesAliases[oneAlias] = Value(SpriteSheetBinary::getString(data, frames[aliases[i].frameIndex].name));
+    }
+}
+
+bool SpriteFrameCache::addSpriteFramesWithBinaryData(const Data& data, const std::string& plist)
+{
+    auto header = SpriteSheetBinary::getHeader(data);
+    if (!header)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite sheet %s", plist.c_str());
+        return false;
+    }
+
+    const char* textureFileName = SpriteSheetBinary::getString(data, header->textureFileName);
+    const char* pixelFormatName = SpriteSheetBinary::getString(data, header->pixelFormatName);
+    std::string texturePath = getSheetTexturePath(plist, textureFileName);
+
+    Texture2D *texture = addSheetTexture(texturePath, pixelFormatName);
+    if (!texture)
     {
         CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        return false;
     }
+
+    addSpriteFramesWithBinaryData(data, texture);
+    return true;
 }
 
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
@@ -356,12 +493,99 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture
     }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-    addSpriteFramesWithDictionary(dict, texture);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    // a corrupt binary sheet falls back to the .plist parser, which rejects it
+    if (SpriteSheetBinary::getHeader(data))
+    {
+        addSpriteFramesWithBinaryData(data, texture);
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
+        addSpriteFramesWithDictionary(dict, texture);
+    }
     _loadedFileNames->insert(plist);
 }
 
+void SpriteFrameCache::addSpriteFramesWithFilesAsync(const std::vector<std::string>& plists, const std::function<void()>& callback)
+{
+    // counts the sheets still loading, the callback runs when the last one is added
+    auto pending = std::make_shared<int>(0);
+    auto finish = [pending, callback]() {
+        if (--(*pending) == 0 && callback)
+        {
+            callback();
+        }
+    };
+
+    for (const auto& plist : plists)
+    {
+        if (_loadedFileNames->find(plist) != _loadedFileNames->end())
+        {
+            continue;
+        }
+
+        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+        if (fullPath.empty())
+        {
+            CCLOG("cocos2d: SpriteFrameCache: can not find %s", plist.c_str());
+            continue;
+        }
+
+        ++(*pending);
+        auto sheet = std::make_shared<Data>();
+
+        // parse on the io thread, .plist sheets are converted to the binary layout so the main thread only creates frames
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [this, plist, sheet, finish](void*) {
+            auto header = SpriteSheetBinary::getHeader(*sheet);
+            if (!header || _loadedFileNames->find(plist) != _loadedFileNames->end())
+            {
+                if (!header)
+                    CCLOG("cocos2d: SpriteFrameCache: can not parse %s", plist.c_str());
+                finish();
+                return;
+            }
+
+            const char* textureFileName = SpriteSheetBinary::getString(*sheet, header->textureFileName);
+            const char* pixelFormatName = SpriteSheetBinary::getString(*sheet, header->pixelFormatName);
+            std::string texturePath = getSheetTexturePath(plist, textureFileName);
+
+            // TextureCache captures the default pixel format when the request is queued
+            const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+            Texture2D::PixelFormat pixelFormat;
+            if (getSheetPixelFormat(pixelFormatName, pixelFormat))
+                Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+
+            Director::getInstance()->getTextureCache()->addImageAsync(texturePath, [this, plist, sheet, finish](Texture2D* texture) {
+                if (!texture)
+                {
+                    CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+                }
+                else if (_loadedFileNames->find(plist) == _loadedFileNames->end())
+                {
+                    addSpriteFramesWithBinaryData(*sheet, texture);
+                    _loadedFileNames->insert(plist);
+                }
+                finish();
+            });
+            Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+        }, nullptr, [fullPath, sheet]() {
+            Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+            if (!SpriteSheetBinary::getHeader(data))
+            {
+                ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
+                data = SpriteSheetBinary::createWithDictionary(dict);
+            }
+            *sheet = std::move(data);
+        });
+    }
+
+    if (*pending == 0 && callback)
+    {
+        callback();
+    }
+}
+
 void SpriteFrameCache::addSpriteFramesWithFileContent(const std::string& plist_content, Texture2D *texture)
 {
     ValueMap dict = FileUtils::getInstance()->getValueMapFromData(plist_content.c_str(), static_cast<int>(plist_content.size()));
@@ -377,8 +601,24 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
     }
     
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    addSpriteFramesWithDictionary(dict, textureFileName);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    if (SpriteSheetBinary::getHeader(data))
+    {
+        Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(textureFileName);
+        if (texture)
+        {
+            addSpriteFramesWithBinaryData(data, texture);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
+        addSpriteFramesWithDictionary(dict, textureFileName);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -396,8 +636,17 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        if (SpriteSheetBinary::getHeader(data))
+        {
+            if (addSpriteFramesWithBinaryData(data, plist))
+            {
+                _loadedFileNames->insert(plist);
+            }
+            return;
+        }
 
-        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
 
         string texturePath("");
 
@@ -408,25 +657,7 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
             texturePath = metadataDict["textureFileName"].asString();
         }
 
-        if (!texturePath.empty())
-        {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
-        }
-        else
-        {
-            // build texture path by replacing file extension
-            texturePath = plist;
-
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of(".");
-            texturePath = texturePath.erase(startPos);
-
-            // append .png
-            texturePath = texturePath.append(".png");
-
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
-        }
+        texturePath = getSheetTexturePath(plist, texturePath);
         addSpriteFramesWithDictionary(dict, texturePath);
         _loadedFileNames->insert(plist);
     }
@@ -509,14 +740,29 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    if (dict.empty())
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    auto header = SpriteSheetBinary::getHeader(data);
+    if (header)
     {
-        CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
-        return;
+        const SpriteSheetBinary::FrameRecord* frames = SpriteSheetBinary::getFrames(data);
+        std::vector<std::string> keysToRemove;
+        for (uint32_t i = 0; i < header->frameCount; ++i)
+        {
+            keysToRemove.push_back(SpriteSheetBinary::getString(data, frames[i].name));
+        }
+        _spriteFrames.erase(keysToRemove);
     }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
+        if (dict.empty())
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
+            return;
+        }
 
-    removeSpriteFramesFromDictionary(dict);
+        removeSpriteFramesFromDictionary(dict);
+    }
 
     // remove it from the cache
     set<string>::iterator ret = _loadedFileNames->find(plist);
@@ -718,7 +964,31 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+    auto header = SpriteSheetBinary::getHeader(data);
+    if (header)
+    {
+        const char* textureFileName = SpriteSheetBinary::getString(data, header->textureFileName);
+        std::string texturePath = getSheetTexturePath(plist, textureFileName);
+
+        Texture2D *texture = nullptr;
+        if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
+            texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
+
+        if (texture)
+        {
+            removeSpriteFramesFromFile(plist);
+            addSpriteFramesWithBinaryData(data, texture);
+            _loadedFileNames->insert(plist);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+        return true;
+    }
+
+    ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
 
     string texturePath("");
 
@@ -32,9 +32,12 @@ THE SOFTWARE.
 
 #include <set>
 #include <string>
+#include <vector>
+#include <functional>
 #include "2d/CCSpriteFrame.h"
 #include "base/CCRef.h"
 #include "base/CCValue.h"
+#include "base/CCData.h"
 #include "base/CCMap.h"
 
 NS_CC_BEGIN
@@ -149,6 +152,17 @@ public:
      */
     void addSpriteFramesWithFileContent(const std::string& plist_content, Texture2D *texture);
 
+    /** Adds multiple Sprite Frames from several sprite sheet files without blocking the main thread.
+     * The files are read and parsed on a worker thread and the textures are decoded by the TextureCache
+     * loading thread; the frames are added on the main thread.
+     * Both .plist files and binary sprite sheets (see SpriteSheetBinary) are supported.
+     *
+     * @param plists Sprite sheet file names, the textures are found as in addSpriteFramesWithFile(const std::string&).
+     * @param callback Called on the main thread once every sheet is added.
+     * @js NA
+     */
+    void addSpriteFramesWithFilesAsync(const std::vector<std::string>& plists, const std::function<void()>& callback);
+
     /** Adds an sprite frame with a given name.
      If the name already exists, then the contents of the old name will be replaced with the new one.
      *
@@ -238,6 +252,17 @@ protected:
      */
     void addSpriteFramesWithDictionary(ValueMap& dictionary, const std::string &texturePath);
     
+    /*Adds multiple Sprite Frames from a binary sprite sheet. The texture will be associated with the created sprite frames.
+     */
+    void addSpriteFramesWithBinaryData(const Data& data, Texture2D *texture);
+
+    /*Adds multiple Sprite Frames from a binary sprite sheet, loading the texture it refers to.
+     */
+    bool addSpriteFramesWithBinaryData(const Data& data, const std::string& plist);
+
+    /** Loads the texture of a sprite sheet with the pixel format named in its metadata. */
+    Texture2D* addSheetTexture(const std::string& texturePath, const std::string& pixelFormatName);
+
     /** Removes multiple Sprite Frames from Dictionary.
     * @since v0.99.5
     */
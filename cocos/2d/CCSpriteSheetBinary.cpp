@@ -0,0 +1,357 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCSpriteSheetBinary.h"
+
+#include <vector>
+#include <cstdlib>
+
+#include "base/CCNS.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const char SHEET_MAGIC[4] = { 'C', 'C', 'S', 'F' };
+    const uint16_t SHEET_VERSION = 1;
+
+    class StringTable
+    {
+    public:
+        uint32_t add(const std::string& str)
+        {
+            uint32_t offset = (uint32_t)_buffer.size();
+            _buffer.insert(_buffer.end(), str.begin(), str.end());
+            _buffer.push_back('\0');
+            return offset;
+        }
+
+        // keeps the following section 4 bytes aligned
+        void pad()
+        {
+            while (_buffer.size() % 4)
+                _buffer.push_back('\0');
+        }
+
+        const std::vector<char>& buffer() const { return _buffer; }
+
+    private:
+        std::vector<char> _buffer;
+    };
+
+    uint32_t appendIntegerList(const std::string& str, std::vector<int32_t>& polygonData, uint32_t& count)
+    {
+        uint32_t start = (uint32_t)polygonData.size();
+        const char* p = str.c_str();
+        char* end = nullptr;
+        while (*p)
+        {
+            long value = strtol(p, &end, 10);
+            if (end == p)
+                break;
+            polygonData.push_back((int32_t)value);
+            p = end;
+        }
+        count = (uint32_t)polygonData.size() - start;
+        return start;
+    }
+}
+
+bool SpriteSheetBinary::isBinary(const Data& data)
+{
+    return data.getSize() >= (ssize_t)sizeof(Header)
+        && memcmp(data.getBytes(), SHEET_MAGIC, sizeof(SHEET_MAGIC)) == 0;
+}
+
+const SpriteSheetBinary::Header* SpriteSheetBinary::getHeader(const Data& data)
+{
+    if (!isBinary(data))
+        return nullptr;
+
+    auto header = reinterpret_cast<const Header*>(data.getBytes());
+    if (header->version != SHEET_VERSION)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: unsupported version %d", header->version);
+        return nullptr;
+    }
+
+    // 64 bits so that the counts of a corrupt file can not overflow the sum
+    uint64_t expected = sizeof(Header)
+        + (uint64_t)header->frameCount * sizeof(FrameRecord)
+        + (uint64_t)header->aliasCount * sizeof(AliasRecord)
+        + (uint64_t)header->polygonDataCount * sizeof(int32_t)
+        + header->stringTableSize;
+    if ((uint64_t)data.getSize() < expected)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: data is truncated");
+        return nullptr;
+    }
+
+    // every offset is checked here, so that the readers can use the records as they are
+    auto isValidString = [header](uint32_t offset, bool optional) {
+        return (optional && offset == NO_STRING) || offset < header->stringTableSize;
+    };
+    auto isValidRange = [header](uint32_t start, uint32_t count) {
+        return (uint64_t)start + count <= header->polygonDataCount;
+    };
+
+    const char* strings = reinterpret_cast<const char*>(getPolygonData(data) + header->polygonDataCount);
+    bool valid = (header->stringTableSize == 0 || strings[header->stringTableSize - 1] == '\0')
+        && isValidString(header->textureFileName, true)
+        && isValidString(header->pixelFormatName, true);
+
+    const FrameRecord* frames = getFrames(data);
+    const int32_t* polygonData = getPolygonData(data);
+    for (uint32_t i = 0; valid && i < header->frameCount; ++i)
+    {
+        const FrameRecord& frame = frames[i];
+        valid = isValidString(frame.name, false);
+        if (valid && frame.vertexCount > 0)
+        {
+            valid = isValidRange(frame.vertices, frame.vertexCount)
+                && isValidRange(frame.verticesUV, frame.vertexCount)
+                && isValidRange(frame.indices, frame.indexCount);
+            for (uint32_t j = 0; valid && j < frame.indexCount; ++j)
+            {
+                int32_t index = polygonData[frame.indices + j];
+                valid = index >= 0 && (uint32_t)index < frame.vertexCount / 2;
+            }
+        }
+    }
+
+    const AliasRecord* aliases = getAliases(data);
+    for (uint32_t i = 0; valid && i < header->aliasCount; ++i)
+    {
+        valid = isValidString(aliases[i].name, false) && aliases[i].frameIndex < header->frameCount;
+    }
+
+    if (!valid)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: data is corrupt");
+        return nullptr;
+    }
+    return header;
+}
+
+const SpriteSheetBinary::FrameRecord* SpriteSheetBinary::getFrames(const Data& data)
+{
+    return reinterpret_cast<const FrameRecord*>(data.getBytes() + sizeof(Header));
+}
+
+const SpriteSheetBinary::AliasRecord* SpriteSheetBinary::getAliases(const Data& data)
+{
+    auto header = reinterpret_cast<const Header*>(data.getBytes());
+    return reinterpret_cast<const AliasRecord*>(getFrames(data) + header->frameCount);
+}
+
+const int32_t* SpriteSheetBinary::getPolygonData(const Data& data)
+{
+    auto header = reinterpret_cast<const Header*>(data.getBytes());
+    return reinterpret_cast<const int32_t*>(getAliases(data) + header->aliasCount);
+}
+
+const char* SpriteSheetBinary::getString(const Data& data, uint32_t offset)
+{
+    auto header = reinterpret_cast<const Header*>(data.getBytes());
+    if (offset == NO_STRING || offset >= header->stringTableSize)
+        return "";
+    auto strings = reinterpret_cast<const char*>(getPolygonData(data) + header->polygonDataCount);
+    return strings + offset;
+}
+
+Data SpriteSheetBinary::createWithDictionary(ValueMap& dictionary)
+{
+    Data ret;
+    if (dictionary["frames"].getType() != Value::Type::MAP)
+        return ret;
+
+    ValueMap& framesDict = dictionary["frames"].asValueMap();
+    int format = 0;
+
+    StringTable strings;
+    Header header;
+    memcpy(header.magic, SHEET_MAGIC, sizeof(SHEET_MAGIC));
+    header.version = SHEET_VERSION;
+    header.reserved = 0;
+    header.textureFileName = NO_STRING;
+    header.pixelFormatName = NO_STRING;
+    header.textureWidth = 0;
+    header.textureHeight = 0;
+
+    if (dictionary.find("metadata") != dictionary.end())
+    {
+        ValueMap& metadataDict = dictionary["metadata"].asValueMap();
+        format = metadataDict["format"].asInt();
+
+        if (metadataDict.find("size") != metadataDict.end())
+        {
+            Size textureSize = SizeFromString(metadataDict["size"].asString());
+            header.textureWidth = textureSize.width;
+            header.textureHeight = textureSize.height;
+        }
+        if (metadataDict.find("textureFileName") != metadataDict.end())
+        {
+            header.textureFileName = strings.add(metadataDict["textureFileName"].asString());
+        }
+        if (metadataDict.find("pixelFormat") != metadataDict.end())
+        {
+            header.pixelFormatName = strings.add(metadataDict["pixelFormat"].asString());
+        }
+    }
+
+    if (format < 0 || format > 3)
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: format %d is not supported", format);
+        return ret;
+    }
+
+    std::vector<FrameRecord> frames;
+    std::vector<AliasRecord> aliases;
+    std::vector<int32_t> polygonData;
+    frames.reserve(framesDict.size());
+
+    for (auto iter = framesDict.begin(); iter != framesDict.end(); ++iter)
+    {
+        ValueMap& frameDict = iter->second.asValueMap();
+
+        FrameRecord frame;
+        memset(&frame, 0, sizeof(frame));
+        frame.name = strings.add(iter->first);
+
+        if (format == 0)
+        {
+            frame.x = frameDict["x"].asFloat();
+            frame.y = frameDict["y"].asFloat();
+            frame.width = frameDict["width"].asFloat();
+            frame.height = frameDict["height"].asFloat();
+            frame.offsetX = frameDict["offsetX"].asFloat();
+            frame.offsetY = frameDict["offsetY"].asFloat();
+            frame.sourceWidth = (float)std::abs(frameDict["originalWidth"].asInt());
+            frame.sourceHeight = (float)std::abs(frameDict["originalHeight"].asInt());
+        }
+        else if (format == 1 || format == 2)
+        {
+            Rect rect = RectFromString(frameDict["frame"].asString());
+            Vec2 offset = PointFromString(frameDict["offset"].asString());
+            Size sourceSize = SizeFromString(frameDict["sourceSize"].asString());
+            frame.x = rect.origin.x;
+            frame.y = rect.origin.y;
+            frame.width = rect.size.width;
+            frame.height = rect.size.height;
+            frame.offsetX = offset.x;
+            frame.offsetY = offset.y;
+            frame.sourceWidth = sourceSize.width;
+            frame.sourceHeight = sourceSize.height;
+            frame.rotated = (format == 2 && frameDict["rotated"].asBool()) ? 1 : 0;
+        }
+        else
+        {
+            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
+            Vec2 spriteOffset = PointFromString(frameDict["spriteOffset"].asString());
+            Size spriteSourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
+            frame.x = textureRect.origin.x;
+            frame.y = textureRect.origin.y;
+            frame.width = spriteSize.width;
+            frame.height = spriteSize.height;
+            frame.offsetX = spriteOffset.x;
+            frame.offsetY = spriteOffset.y;
+            frame.sourceWidth = spriteSourceSize.width;
+            frame.sourceHeight = spriteSourceSize.height;
+            frame.rotated = frameDict["textureRotated"].asBool() ? 1 : 0;
+
+            for (const auto& value : frameDict["aliases"].asValueVector())
+            {
+                AliasRecord alias;
+                alias.name = strings.add(value.asString());
+                alias.frameIndex = (uint32_t)frames.size();
+                aliases.push_back(alias);
+            }
+
+            if (frameDict.find("vertices") != frameDict.end())
+            {
+                uint32_t uvCount = 0;
+                frame.vertices = appendIntegerList(frameDict["vertices"].asString(), polygonData, frame.vertexCount);
+                frame.verticesUV = appendIntegerList(frameDict["verticesUV"].asString(), polygonData, uvCount);
+                frame.indices = appendIntegerList(frameDict["triangles"].asString(), polygonData, frame.indexCount);
+                CCASSERT(uvCount == frame.vertexCount, "SpriteSheetBinary: vertices and verticesUV differ in size");
+            }
+            if (frameDict.find("anchor") != frameDict.end())
+            {
+                Vec2 anchor = PointFromString(frameDict["anchor"].asString());
+                frame.anchorX = anchor.x;
+                frame.anchorY = anchor.y;
+                frame.hasAnchor = 1;
+            }
+        }
+        frames.push_back(frame);
+    }
+    strings.pad();
+
+    header.frameCount = (uint32_t)frames.size();
+    header.aliasCount = (uint32_t)aliases.size();
+    header.polygonDataCount = (uint32_t)polygonData.size();
+    header.stringTableSize = (uint32_t)strings.buffer().size();
+
+    size_t framesSize = frames.size() * sizeof(FrameRecord);
+    size_t aliasesSize = aliases.size() * sizeof(AliasRecord);
+    size_t polygonSize = polygonData.size() * sizeof(int32_t);
+    size_t size = sizeof(Header) + framesSize + aliasesSize + polygonSize + strings.buffer().size();
+
+    unsigned char* buffer = (unsigned char*)malloc(size);
+    if (!buffer)
+        return ret;
+
+    unsigned char* p = buffer;
+    memcpy(p, &header, sizeof(Header));
+    p += sizeof(Header);
+    if (framesSize) { memcpy(p, frames.data(), framesSize); p += framesSize; }
+    if (aliasesSize) { memcpy(p, aliases.data(), aliasesSize); p += aliasesSize; }
+    if (polygonSize) { memcpy(p, polygonData.data(), polygonSize); p += polygonSize; }
+    if (!strings.buffer().empty()) { memcpy(p, strings.buffer().data(), strings.buffer().size()); }
+
+    ret.fastSet(buffer, size);
+    return ret;
+}
+
+bool SpriteSheetBinary::convertFile(const std::string& plist, const std::string& binaryFile)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    if (dict.empty())
+    {
+        CCLOG("cocos2d: SpriteSheetBinary: can not load %s", plist.c_str());
+        return false;
+    }
+
+    Data data = createWithDictionary(dict);
+    if (data.isNull())
+        return false;
+
+    return FileUtils::getInstance()->writeDataToFile(data, binaryFile);
+}
+
+NS_CC_END
@@ -0,0 +1,122 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCSPRITESHEETBINARY_H__
+#define __CCSPRITESHEETBINARY_H__
+
+#include <stdint.h>
+#include <string>
+
+#include "base/CCData.h"
+#include "base/CCValue.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class SpriteSheetBinary
+ * @brief Compact binary form of a sprite sheet .plist, read by SpriteFrameCache without building a ValueMap.
+ *
+ * The file holds a header, the frame records, the alias records, the polygon integers and a string table,
+ * in this order. All values are little endian and every section is 4 bytes aligned, so the records are
+ * read in place from the loaded file data.
+ */
+class CC_DLL SpriteSheetBinary
+{
+public:
+    static const uint32_t NO_STRING = 0xffffffff;
+
+#pragma pack(push, 1)
+    struct Header
+    {
+        char magic[4];              // "CCSF"
+        uint16_t version;
+        uint16_t reserved;
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t polygonDataCount;  // number of int32 values
+        uint32_t stringTableSize;
+        uint32_t textureFileName;   // string offset or NO_STRING
+        uint32_t pixelFormatName;   // string offset or NO_STRING
+        float textureWidth;
+        float textureHeight;
+    };
+
+    struct FrameRecord
+    {
+        uint32_t name;
+        float x, y, width, height;
+        float offsetX, offsetY;
+        float sourceWidth, sourceHeight;
+        float anchorX, anchorY;
+        uint8_t rotated;
+        uint8_t hasAnchor;
+        uint8_t reserved[2];
+        uint32_t vertexCount;       // number of int32 values, the same for vertices and verticesUV
+        uint32_t vertices;          // index into the polygon data
+        uint32_t verticesUV;
+        uint32_t indexCount;
+        uint32_t indices;
+    };
+
+    struct AliasRecord
+    {
+        uint32_t name;
+        uint32_t frameIndex;
+    };
+#pragma pack(pop)
+
+    /** Returns true if the data starts like a binary sprite sheet. */
+    static bool isBinary(const Data& data);
+
+    /** Checks the layout and every offset of a binary sprite sheet and returns its header, nullptr if the data is not valid.
+     * The other getters expect data accepted by getHeader.
+     */
+    static const Header* getHeader(const Data& data);
+
+    static const FrameRecord* getFrames(const Data& data);
+    static const AliasRecord* getAliases(const Data& data);
+    static const int32_t* getPolygonData(const Data& data);
+    /** Returns a string of the string table, an empty string for NO_STRING or an offset out of the table. */
+    static const char* getString(const Data& data, uint32_t offset);
+
+    /** Builds a binary sprite sheet from a dictionary loaded from a .plist file, in any of the formats 0 to 3.
+     * Safe to call from any thread.
+     * @return Null data if the dictionary is not a sprite sheet.
+     */
+    static Data createWithDictionary(ValueMap& dictionary);
+
+    /** Converts a sprite sheet .plist file to a binary sprite sheet file. */
+    static bool convertFile(const std::string& plist, const std::string& binaryFile);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCSPRITESHEETBINARY_H__
@@ -29,16 +29,254 @@ THE SOFTWARE.
 #include "2d/CCTMXXMLParser.h"
 #include <unordered_map>
 #include <sstream>
+#include <zlib.h>
 #include "2d/CCTMXTiledMap.h"
-#include "base/ZipUtils.h"
-#include "base/base64.h"
+#include "base/CCData.h"
 #include "base/CCDirector.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash/xxhash.h"
 
 using namespace std;
 
 NS_CC_BEGIN
 
+namespace
+{
+    int base64Value(char c)
+    {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+') return 62;
+        if (c == '/') return 63;
+        // white spaces and padding
+        return -1;
+    }
+
+    const char BINARY_MAP_MAGIC[4] = { 'C', 'C', 'T', 'M' };
+    const uint16_t BINARY_MAP_VERSION = 3;
+    // properties nest, deeper values are refused rather than overflowing the stack
+    const int BINARY_MAP_MAX_VALUE_DEPTH = 32;
+
+    enum
+    {
+        BinaryMapLayer,
+        BinaryMapObjectGroup
+    };
+
+    // little endian values, strings and arrays prefixed by their uint32 length,
+    // the tiles of a layer aligned on 4 bytes so that they can be used in place
+    class BinaryMapWriter
+    {
+    public:
+        void writeBytes(const void* bytes, size_t length)
+        {
+            auto begin = static_cast<const unsigned char*>(bytes);
+            _buffer.insert(_buffer.end(), begin, begin + length);
+        }
+        void writeUInt8(uint8_t value) { writeBytes(&value, sizeof(value)); }
+        void writeUInt32(uint32_t value) { writeBytes(&value, sizeof(value)); }
+        void writeInt32(int32_t value) { writeBytes(&value, sizeof(value)); }
+        void writeFloat(float value) { writeBytes(&value, sizeof(value)); }
+        void writeDouble(double value) { writeBytes(&value, sizeof(value)); }
+        void writeSize(const Size& size) { writeFloat(size.width); writeFloat(size.height); }
+        void writeVec2(const Vec2& vec) { writeFloat(vec.x); writeFloat(vec.y); }
+        void writeString(const std::string& str)
+        {
+            writeUInt32((uint32_t)str.size());
+            writeBytes(str.data(), str.size());
+        }
+        void align()
+        {
+            _buffer.resize((_buffer.size() + 3) & ~(size_t)3);
+        }
+
+        void writeValue(const Value& value)
+        {
+            writeUInt8((uint8_t)value.getType());
+            switch (value.getType())
+            {
+                case Value::Type::BYTE:
+                    writeUInt8(value.asByte());
+                    break;
+                case Value::Type::INTEGER:
+                    writeInt32(value.asInt());
+                    break;
+                case Value::Type::UNSIGNED:
+                    writeUInt32(value.asUnsignedInt());
+                    break;
+                case Value::Type::FLOAT:
+                    writeFloat(value.asFloat());
+                    break;
+                case Value::Type::DOUBLE:
+                    writeDouble(value.asDouble());
+                    break;
+                case Value::Type::BOOLEAN:
+                    writeUInt8(value.asBool() ? 1 : 0);
+                    break;
+                case Value::Type::STRING:
+                    writeString(value.asString());
+                    break;
+                case Value::Type::VECTOR:
+                {
+                    const ValueVector& vector = value.asValueVector();
+                    writeUInt32((uint32_t)vector.size());
+                    for (const auto& item : vector)
+                        writeValue(item);
+                    break;
+                }
+                case Value::Type::MAP:
+                {
+                    const ValueMap& map = value.asValueMap();
+                    writeUInt32((uint32_t)map.size());
+                    for (const auto& item : map)
+                    {
+                        writeString(item.first);
+                        writeValue(item.second);
+                    }
+                    break;
+                }
+                case Value::Type::INT_KEY_MAP:
+                {
+                    const ValueMapIntKey& map = value.asIntKeyMap();
+                    writeUInt32((uint32_t)map.size());
+                    for (const auto& item : map)
+                    {
+                        writeInt32(item.first);
+                        writeValue(item.second);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        std::vector<unsigned char>& getBuffer() { return _buffer; }
+
+    private:
+        std::vector<unsigned char> _buffer;
+    };
+
+    // reads zeros once the end of the data is passed, isValid tells whether it was
+    class BinaryMapReader
+    {
+    public:
+        BinaryMapReader(const unsigned char* bytes, size_t length)
+        : _bytes(bytes)
+        , _length(length)
+        , _offset(0)
+        , _valid(true)
+        {
+        }
+
+        bool isValid() const { return _valid; }
+
+        const unsigned char* readBytes(size_t length)
+        {
+            if (!_valid || length > _length - _offset)
+            {
+                _valid = false;
+                return nullptr;
+            }
+            const unsigned char* bytes = _bytes + _offset;
+            _offset += length;
+            return bytes;
+        }
+        template <typename T>
+        T read()
+        {
+            T value = 0;
+            const unsigned char* bytes = readBytes(sizeof(T));
+            if (bytes)
+                memcpy(&value, bytes, sizeof(T));
+            return value;
+        }
+        uint8_t readUInt8() { return read<uint8_t>(); }
+        uint32_t readUInt32() { return read<uint32_t>(); }
+        int32_t readInt32() { return read<int32_t>(); }
+        float readFloat() { return read<float>(); }
+        double readDouble() { return read<double>(); }
+        Size readSize() { float width = readFloat(); return Size(width, readFloat()); }
+        Vec2 readVec2() { float x = readFloat(); return Vec2(x, readFloat()); }
+        std::string readString()
+        {
+            uint32_t length = readUInt32();
+            const unsigned char* bytes = readBytes(length);
+            return bytes ? std::string((const char*)bytes, length) : std::string();
+        }
+        void align()
+        {
+            size_t aligned = (_offset + 3) & ~(size_t)3;
+            readBytes(aligned - _offset);
+        }
+
+        Value readValue(int depth = 0)
+        {
+            if (depth > BINARY_MAP_MAX_VALUE_DEPTH)
+            {
+                _valid = false;
+                return Value::Null;
+            }
+            switch ((Value::Type)readUInt8())
+            {
+                case Value::Type::BYTE:
+                    return Value(readUInt8());
+                case Value::Type::INTEGER:
+                    return Value((int)readInt32());
+                case Value::Type::UNSIGNED:
+                    return Value((unsigned int)readUInt32());
+                case Value::Type::FLOAT:
+                    return Value(readFloat());
+                case Value::Type::DOUBLE:
+                    return Value(readDouble());
+                case Value::Type::BOOLEAN:
+                    return Value(readUInt8() != 0);
+                case Value::Type::STRING:
+                    return Value(readString());
+                case Value::Type::VECTOR:
+                {
+                    ValueVector vector;
+                    uint32_t count = readUInt32();
+                    for (uint32_t i = 0; i < count && _valid; ++i)
+                        vector.push_back(readValue(depth + 1));
+                    return Value(std::move(vector));
+                }
+                case Value::Type::MAP:
+                {
+                    ValueMap map;
+                    uint32_t count = readUInt32();
+                    for (uint32_t i = 0; i < count && _valid; ++i)
+                    {
+                        std::string key = readString();
+                        map[key] = readValue(depth + 1);
+                    }
+                    return Value(std::move(map));
+                }
+                case Value::Type::INT_KEY_MAP:
+                {
+                    ValueMapIntKey map;
+                    uint32_t count = readUInt32();
+                    for (uint32_t i = 0; i < count && _valid; ++i)
+                    {
+                        int key = readInt32();
+                        map[key] = readValue(depth + 1);
+                    }
+                    return Value(std::move(map));
+                }
+                default:
+                    return Value::Null;
+            }
+        }
+
+    private:
+        const unsigned char* _bytes;
+        size_t _length;
+        size_t _offset;
+        bool _valid;
+    };
+}
+
 // implementation TMXLayerInfo
 TMXLayerInfo::TMXLayerInfo()
 : _name("")
@@ -164,10 +402,261 @@ bool TMXMapInfo::initWithXML(const std::string& tmxString, const std::string& re
 
 bool TMXMapInfo::initWithTMXFile(const std::string& tmxFile)
 {
+    // the binary map converted from the tmx file is loaded instead of parsing the XML
+    auto fileUtils = FileUtils::getInstance();
+    std::string binaryFile = getBinaryFileName(tmxFile);
+    if (fileUtils->isFileExist(binaryFile))
+    {
+        // the tileset images are next to the binary map, it is stale once the content of the tmx file changed
+        Data sourceData = fileUtils->isFileExist(tmxFile) ? fileUtils->getDataFromFile(tmxFile) : Data::Null;
+        internalInit(binaryFile, "");
+        if (loadBinaryData(fileUtils->getDataFromFile(_TMXFileName), sourceData))
+        {
+            return true;
+        }
+
+        CCLOG("cocos2d: TMXMapInfo: %s is not a valid binary map, parsing %s", binaryFile.c_str(), tmxFile.c_str());
+        _layers.clear();
+        _tilesets.clear();
+        _objectGroups.clear();
+        _allChildren.clear();
+        _properties.clear();
+        _tileProperties.clear();
+    }
+
     internalInit(tmxFile, "");
     return parseXMLFile(_TMXFileName);
 }
 
+bool TMXMapInfo::initWithBinaryData(const Data& data, const std::string& resourcePath)
+{
+    internalInit("", resourcePath);
+    return loadBinaryData(data, Data::Null);
+}
+
+std::string TMXMapInfo::getBinaryFileName(const std::string& tmxFile)
+{
+    size_t dot = tmxFile.find_last_of('.');
+    size_t slash = tmxFile.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return tmxFile + ".tmxb";
+    }
+    return tmxFile.substr(0, dot) + ".tmxb";
+}
+
+bool TMXMapInfo::saveBinaryFile(const std::string& filename) const
+{
+    BinaryMapWriter writer;
+    writer.writeBytes(BINARY_MAP_MAGIC, sizeof(BINARY_MAP_MAGIC));
+    writer.writeUInt32(BINARY_MAP_VERSION);
+    // hash of the tmx file the map was parsed from, no hash when it was parsed from a string
+    Data sourceData = _TMXFileName.empty() ? Data::Null : FileUtils::getInstance()->getDataFromFile(_TMXFileName);
+    writer.writeUInt32(sourceData.isNull() ? 0 : 1);
+    writer.writeUInt32(sourceData.isNull() ? 0 : XXH32(sourceData.getBytes(), (int)sourceData.getSize(), 0));
+    writer.writeInt32(_orientation);
+    writer.writeInt32(_staggerAxis);
+    writer.writeInt32(_staggerIndex);
+    writer.writeInt32(_hexSideLength);
+    writer.writeSize(_mapSize);
+    writer.writeSize(_tileSize);
+    writer.writeValue(Value(_properties));
+    writer.writeValue(Value(_tileProperties));
+
+    writer.writeUInt32((uint32_t)_tilesets.size());
+    for (const auto& tileset : _tilesets)
+    {
+        writer.writeString(tileset->_name);
+        writer.writeInt32(tileset->_firstGid);
+        writer.writeSize(tileset->_tileSize);
+        writer.writeInt32(tileset->_spacing);
+        writer.writeInt32(tileset->_margin);
+        writer.writeVec2(tileset->_tileOffset);
+        // resolved again against the location of the binary map
+        writer.writeString(tileset->_originSourceImage);
+        writer.writeSize(tileset->_imageSize);
+    }
+
+    writer.writeUInt32((uint32_t)_allChildren.size());
+    for (const auto& child : _allChildren)
+    {
+        auto layer = dynamic_cast<TMXLayerInfo*>(child);
+        if (layer)
+        {
+            writer.writeUInt8(BinaryMapLayer);
+            writer.writeString(layer->_name);
+            writer.writeSize(layer->_layerSize);
+            writer.writeUInt8(layer->_visible ? 1 : 0);
+            writer.writeUInt8(layer->_opacity);
+            writer.writeVec2(layer->_offset);
+            writer.writeValue(Value(layer->_properties));
+
+            uint32_t tileCount = layer->_tiles ? (uint32_t)(layer->_layerSize.width * layer->_layerSize.height) : 0;
+            writer.writeUInt32(tileCount);
+            writer.align();
+            writer.writeBytes(layer->_tiles, tileCount * sizeof(uint32_t));
+            continue;
+        }
+
+        auto group = dynamic_cast<TMXObjectGroupInfo*>(child);
+        if (group)
+        {
+            writer.writeUInt8(BinaryMapObjectGroup);
+            writer.writeString(group->_groupName);
+            writer.writeVec2(group->_positionOffset);
+            writer.writeValue(Value(group->_properties));
+            writer.writeValue(Value(group->_objects));
+            writer.writeUInt8(group->_visible ? 1 : 0);
+            writer.writeUInt8(group->_color.r);
+            writer.writeUInt8(group->_color.g);
+            writer.writeUInt8(group->_color.b);
+            writer.writeUInt8(group->_opacity);
+        }
+    }
+
+    std::vector<unsigned char>& buffer = writer.getBuffer();
+    Data data;
+    data.copy(buffer.data(), buffer.size());
+    return FileUtils::getInstance()->writeDataToFile(data, filename);
+}
+
+bool TMXMapInfo::loadBinaryData(const Data& data, const Data& sourceData)
+{
+    if (data.getSize() < (ssize_t)sizeof(BINARY_MAP_MAGIC) || memcmp(data.getBytes(), BINARY_MAP_MAGIC, sizeof(BINARY_MAP_MAGIC)) != 0)
+    {
+        CCLOG("cocos2d: TMXMapInfo: not a binary map");
+        return false;
+    }
+
+    BinaryMapReader reader(data.getBytes(), data.getSize());
+    reader.readBytes(sizeof(BINARY_MAP_MAGIC));
+    uint32_t version = reader.readUInt32();
+    if (version != BINARY_MAP_VERSION)
+    {
+        CCLOG("cocos2d: TMXMapInfo: unsupported binary map version %u", version);
+        return false;
+    }
+    uint32_t hasSourceHash = reader.readUInt32();
+    uint32_t sourceHash = reader.readUInt32();
+    if (!sourceData.isNull() && hasSourceHash && sourceHash != XXH32(sourceData.getBytes(), (int)sourceData.getSize(), 0))
+    {
+        CCLOG("cocos2d: TMXMapInfo: binary map was not written from its tmx file");
+        return false;
+    }
+
+    _orientation = reader.readInt32();
+    _staggerAxis = reader.readInt32();
+    _staggerIndex = reader.readInt32();
+    _hexSideLength = reader.readInt32();
+    _mapSize = reader.readSize();
+    _tileSize = reader.readSize();
+    Value properties = reader.readValue();
+    if (properties.getType() == Value::Type::MAP)
+        _properties = std::move(properties.asValueMap());
+    Value tileProperties = reader.readValue();
+    if (tileProperties.getType() == Value::Type::INT_KEY_MAP)
+        _tileProperties = std::move(tileProperties.asIntKeyMap());
+
+    std::string dir;
+    if (_TMXFileName.find_last_of("/") != string::npos)
+    {
+        dir = _TMXFileName.substr(0, _TMXFileName.find_last_of("/") + 1);
+    }
+    else if (!_resources.empty())
+    {
+        dir = _resources + "/";
+    }
+
+    uint32_t tilesetCount = reader.readUInt32();
+    for (uint32_t i = 0; i < tilesetCount && reader.isValid(); ++i)
+    {
+        TMXTilesetInfo* tileset = new (std::nothrow) TMXTilesetInfo();
+        tileset->_name = reader.readString();
+        tileset->_firstGid = reader.readInt32();
+        tileset->_tileSize = reader.readSize();
+        tileset->_spacing = reader.readInt32();
+        tileset->_margin = reader.readInt32();
+        tileset->_tileOffset = reader.readVec2();
+        tileset->_originSourceImage = reader.readString();
+        tileset->_sourceImage = dir + tileset->_originSourceImage;
+        tileset->_imageSize = reader.readSize();
+        _tilesets.pushBack(tileset);
+        tileset->release();
+    }
+
+    uint32_t childCount = reader.readUInt32();
+    for (uint32_t i = 0; i < childCount && reader.isValid(); ++i)
+    {
+        uint8_t kind = reader.readUInt8();
+        if (kind == BinaryMapLayer)
+        {
+            TMXLayerInfo* layer = new (std::nothrow) TMXLayerInfo();
+            layer->_name = reader.readString();
+            layer->_layerSize = reader.readSize();
+            layer->_visible = reader.readUInt8() != 0;
+            layer->_opacity = reader.readUInt8();
+            layer->_offset = reader.readVec2();
+            Value layerProperties = reader.readValue();
+            if (layerProperties.getType() == Value::Type::MAP)
+                layer->_properties = std::move(layerProperties.asValueMap());
+
+            uint32_t tileCount = reader.readUInt32();
+            reader.align();
+            size_t tilesSize = (size_t)tileCount * sizeof(uint32_t);
+            const unsigned char* tiles = reader.readBytes(tilesSize);
+            // the layers own their tiles and edit them, one copy of the stored array
+            if (tiles && tileCount == (uint32_t)(layer->_layerSize.width * layer->_layerSize.height))
+            {
+                layer->_tiles = (uint32_t*)malloc(tilesSize);
+                if (layer->_tiles)
+                    memcpy(layer->_tiles, tiles, tilesSize);
+            }
+
+            _allChildren.pushBack(layer);
+            _layers.pushBack(layer);
+            layer->release();
+            if (!layer->_tiles)
+            {
+                CCLOG("cocos2d: TMXMapInfo: invalid tiles of binary map layer %s", layer->_name.c_str());
+                return false;
+            }
+        }
+        else if (kind == BinaryMapObjectGroup)
+        {
+            TMXObjectGroupInfo* group = new (std::nothrow) TMXObjectGroupInfo();
+            group->_groupName = reader.readString();
+            group->_positionOffset = reader.readVec2();
+            Value groupProperties = reader.readValue();
+            if (groupProperties.getType() == Value::Type::MAP)
+                group->_properties = std::move(groupProperties.asValueMap());
+            Value objects = reader.readValue();
+            if (objects.getType() == Value::Type::VECTOR)
+                group->_objects = std::move(objects.asValueVector());
+            group->_visible = reader.readUInt8() != 0;
+            group->_color.r = reader.readUInt8();
+            group->_color.g = reader.readUInt8();
+            group->_color.b = reader.readUInt8();
+            group->_opacity = reader.readUInt8();
+
+            _allChildren.pushBack(group);
+            _objectGroups.pushBack(group);
+            group->release();
+        }
+        else
+        {
+            CCLOG("cocos2d: TMXMapInfo: unknown binary map child %d", kind);
+            return false;
+        }
+    }
+
+    if (!reader.isValid())
+    {
+        CCLOG("cocos2d: TMXMapInfo: truncated binary map");
+        return false;
+    }
+    return true;
+}
+
 TMXMapInfo::TMXMapInfo()
 : _orientation(TMXOrientationOrtho)
 , _staggerAxis(TMXStaggerAxis_Y)
@@ -182,12 +671,27 @@ TMXMapInfo::TMXMapInfo()
 , _xmlTileIndex(0)
 , _currentFirstGID(-1)
 , _recordFirstGID(true)
+, _tileData(nullptr)
+, _tileDataSize(0)
+, _tileDataOffset(0)
+, _tileDataBase64(false)
+, _base64Bits(0)
+, _base64BitCount(0)
+, _tileDataStream(nullptr)
+, _csvGID(0)
+, _csvHasDigits(false)
 {
 }
 
 TMXMapInfo::~TMXMapInfo()
 {
     CCLOGINFO("deallocing TMXMapInfo: %p", this);
+    // parsing stopped in the tile data, the tiles belong to the layer
+    if (_tileDataStream)
+    {
+        inflateEnd(_tileDataStream);
+        delete _tileDataStream;
+    }
 }
 
 bool TMXMapInfo::parseXMLString(const std::string& xmlString)
@@ -496,6 +1000,7 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             int layerAttribs = tmxMapInfo->getLayerAttribs();
             tmxMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribBase64);
             tmxMapInfo->setStoringCharacters(true);
+            beginTileData(true, compression == "gzip" || compression == "zlib");
 
             if (compression == "gzip")
             {
@@ -514,6 +1019,7 @@ void TMXMapInfo::startElement(void *ctx, const char *name, const char **atts)
             int layerAttribs = tmxMapInfo->getLayerAttribs();
             tmxMapInfo->setLayerAttribs(layerAttribs | TMXLayerAttribCSV);
             tmxMapInfo->setStoringCharacters(true);
+            beginTileData(false, false);
         }
     }
     else if (elementName == "object")
@@ -718,87 +1224,10 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
 
     if (elementName == "data")
     {
-        if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
-        {
-            tmxMapInfo->setStoringCharacters(false);
-
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-
-            std::string currentString = tmxMapInfo->getCurrentString();
-            unsigned char *buffer;
-            auto len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
-            if (!buffer)
-            {
-                CCLOG("cocos2d: TiledMap: decode data error");
-                return;
-            }
-
-            if (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib))
-            {
-                unsigned char *deflated = nullptr;
-                Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                ssize_t sizeHint = s.width * s.height * sizeof(unsigned int);
-
-                ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "inflatedLen should be equal to sizeHint!");
-
-                free(buffer);
-                buffer = nullptr;
-
-                if (!deflated)
-                {
-                    CCLOG("cocos2d: TiledMap: inflate data error");
-                    return;
-                }
-
-                layer->_tiles = reinterpret_cast<uint32_t*>(deflated);
-            }
-            else
-            {
-                layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
-            }
-
-            tmxMapInfo->setCurrentString("");
-        }
-        else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribCSV)
+        if (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribBase64 | TMXLayerAttribCSV))
         {
-            unsigned char *buffer;
-            
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            
             tmxMapInfo->setStoringCharacters(false);
-            std::string currentString = tmxMapInfo->getCurrentString();
-            
-            vector<string> gidTokens;
-            istringstream filestr(currentString);
-            string sRow;
-            while(getline(filestr, sRow, '\n')) {
-                string sGID;
-                istringstream rowstr(sRow);
-                while (getline(rowstr, sGID, ',')) {
-                    gidTokens.push_back(sGID);
-                }
-            }
-            
-            // 32-bits per gid
-            buffer = (unsigned char*)malloc(gidTokens.size() * 4);
-            if (!buffer)
-            {
-                CCLOG("cocos2d: TiledMap: CSV buffer not allocated.");
-                return;
-            }
-            
-            uint32_t* bufferPtr = reinterpret_cast<uint32_t*>(buffer);
-            for(auto gidToken : gidTokens) {
-                auto tileGid = (uint32_t)strtol(gidToken.c_str(), nullptr, 10);
-                *bufferPtr = tileGid;
-                bufferPtr++;
-            }
-            
-            layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
-            
-            tmxMapInfo->setCurrentString("");
+            endTileData();
         }
         else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribNone)
         {
@@ -835,14 +1264,179 @@ void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string text(ch, 0, len);
 
     if (tmxMapInfo->isStoringCharacters())
     {
-        std::string currentString = tmxMapInfo->getCurrentString();
-        currentString += text;
-        tmxMapInfo->setCurrentString(currentString);
+        if (_tileData)
+        {
+            if (_tileDataBase64)
+            {
+                decodeBase64TileData(ch, len);
+            }
+            else
+            {
+                decodeCSVTileData(ch, len);
+            }
+        }
+        else
+        {
+            _currentString.append(ch, len);
+        }
+    }
+}
+
+void TMXMapInfo::beginTileData(bool base64, bool compressed)
+{
+    TMXLayerInfo* layer = _layers.back();
+    Size layerSize = layer->_layerSize;
+
+    // zero filled, the missing tiles are empty
+    _tileDataSize = (size_t)layerSize.width * (size_t)layerSize.height * sizeof(uint32_t);
+    _tileDataOffset = 0;
+    _tileData = (unsigned char*)calloc(_tileDataSize, 1);
+    if (!_tileData)
+    {
+        CCLOG("cocos2d: TiledMap: tiles buffer not allocated.");
+        return;
+    }
+    layer->_tiles = reinterpret_cast<uint32_t*>(_tileData);
+
+    _tileDataBase64 = base64;
+    _base64Bits = 0;
+    _base64BitCount = 0;
+    _csvGID = 0;
+    _csvHasDigits = false;
+
+    if (compressed)
+    {
+        _tileDataStream = new (std::nothrow) z_stream();
+        // 15 + 32: zlib or gzip header detected automatically
+        if (_tileDataStream && inflateInit2(_tileDataStream, 15 + 32) != Z_OK)
+        {
+            delete _tileDataStream;
+            _tileDataStream = nullptr;
+        }
+        if (!_tileDataStream)
+        {
+            CCLOG("cocos2d: TiledMap: inflate data error");
+            _tileDataSize = 0;
+        }
+    }
+}
+
+void TMXMapInfo::decodeBase64TileData(const char* ch, int len)
+{
+    unsigned char decoded[1024];
+    size_t decodedLength = 0;
+
+    for (int i = 0; i < len; ++i)
+    {
+        int value = base64Value(ch[i]);
+        if (value < 0)
+        {
+            continue;
+        }
+
+        _base64Bits = (_base64Bits << 6) | value;
+        _base64BitCount += 6;
+        if (_base64BitCount >= 8)
+        {
+            _base64BitCount -= 8;
+            decoded[decodedLength++] = (unsigned char)(_base64Bits >> _base64BitCount);
+
+            if (decodedLength == sizeof(decoded))
+            {
+                writeTileData(decoded, decodedLength);
+                decodedLength = 0;
+            }
+        }
+    }
+
+    if (decodedLength > 0)
+    {
+        writeTileData(decoded, decodedLength);
+    }
+}
+
+void TMXMapInfo::decodeCSVTileData(const char* ch, int len)
+{
+    for (int i = 0; i < len; ++i)
+    {
+        char c = ch[i];
+        if (c >= '0' && c <= '9')
+        {
+            _csvGID = _csvGID * 10 + (c - '0');
+            _csvHasDigits = true;
+        }
+        else if ((c == ',' || c == '\n') && _csvHasDigits)
+        {
+            writeTileData(reinterpret_cast<const unsigned char*>(&_csvGID), sizeof(_csvGID));
+            _csvGID = 0;
+            _csvHasDigits = false;
+        }
+    }
+}
+
+void TMXMapInfo::writeTileData(const unsigned char* bytes, size_t length)
+{
+    if (_tileDataStream)
+    {
+        _tileDataStream->next_in = const_cast<Bytef*>(bytes);
+        _tileDataStream->avail_in = (uInt)length;
+
+        while (_tileDataStream->avail_in > 0 && _tileDataOffset < _tileDataSize)
+        {
+            _tileDataStream->next_out = _tileData + _tileDataOffset;
+            _tileDataStream->avail_out = (uInt)(_tileDataSize - _tileDataOffset);
+
+            int err = inflate(_tileDataStream, Z_NO_FLUSH);
+            _tileDataOffset = _tileDataSize - _tileDataStream->avail_out;
+
+            if (err == Z_STREAM_END)
+            {
+                break;
+            }
+            if (err != Z_OK)
+            {
+                CCLOG("cocos2d: TiledMap: inflate data error");
+                // ignores the rest of the data
+                _tileDataSize = _tileDataOffset;
+                break;
+            }
+        }
+    }
+    else
+    {
+        size_t copied = std::min(length, _tileDataSize - _tileDataOffset);
+        memcpy(_tileData + _tileDataOffset, bytes, copied);
+        _tileDataOffset += copied;
+    }
+}
+
+void TMXMapInfo::endTileData()
+{
+    if (_csvHasDigits)
+    {
+        writeTileData(reinterpret_cast<const unsigned char*>(&_csvGID), sizeof(_csvGID));
+        _csvGID = 0;
+        _csvHasDigits = false;
     }
+
+    if (_tileDataStream)
+    {
+        inflateEnd(_tileDataStream);
+        delete _tileDataStream;
+        _tileDataStream = nullptr;
+    }
+
+    if (_tileData && _tileDataOffset < _tileDataSize)
+    {
+        CCLOG("cocos2d: TiledMap: the tile data of layer %s is incomplete", _layers.back()->_name.c_str());
+    }
+
+    _tileData = nullptr;
+    _tileDataSize = 0;
+    _tileDataOffset = 0;
 }
 
 NS_CC_END
@@ -39,10 +39,13 @@ THE SOFTWARE.
 
 #include <string>
 
+struct z_stream_s;
+
 NS_CC_BEGIN
 
 class TMXLayerInfo;
 class TMXTilesetInfo;
+class Data;
 
 /** @file
 * Internal TMX parser
@@ -232,6 +235,15 @@ public:
     bool initWithTMXFile(const std::string& tmxFile);
     /** initializes a TMX format with an XML string and a TMX resource path */
     bool initWithXML(const std::string& tmxString, const std::string& resourcePath);
+    /** initializes a TMX format with a binary map written by saveBinaryFile and a TMX resource path */
+    bool initWithBinaryData(const Data& data, const std::string& resourcePath);
+    /** writes the parsed map to a binary map. initWithTMXFile loads the binary map named by getBinaryFileName
+     instead of parsing the tmx file when it exists, the layer tiles are copied as they are stored.
+     The size of the tmx file is stored too, the tmx file is parsed again once its size changed.
+     */
+    bool saveBinaryFile(const std::string& filename) const;
+    /** returns the name of the binary map of a tmx file, its extension replaced by ".tmxb" */
+    static std::string getBinaryFileName(const std::string& tmxFile);
     /** initializes parsing of an XML file, either a tmx (Map) file or tsx (Tileset) file */
     bool parseXMLFile(const std::string& xmlFilename);
     /* initializes parsing of an XML string, either a tmx (Map) string or tsx (Tileset) string */
@@ -342,6 +354,15 @@ public:
 
 protected:
     void internalInit(const std::string& tmxFileName, const std::string& resourcePath);
+    /* sourceData is the tmx file the binary map must have been written from, a null Data skips the check */
+    bool loadBinaryData(const Data& data, const Data& sourceData);
+
+    /* the base64 and csv tile data is decoded while it is parsed, straight into the tiles of the layer */
+    void beginTileData(bool base64, bool compressed);
+    void decodeBase64TileData(const char* ch, int len);
+    void decodeCSVTileData(const char* ch, int len);
+    void writeTileData(const unsigned char* bytes, size_t length);
+    void endTileData();
 
     /// map orientation
     int    _orientation;
@@ -387,6 +408,20 @@ protected:
     int _currentFirstGID;
     bool _recordFirstGID;
     std::string _externalTilesetFilename;
+
+    //! tiles of the layer being decoded
+    unsigned char* _tileData;
+    size_t _tileDataSize;
+    size_t _tileDataOffset;
+    bool _tileDataBase64;
+    //! base64 bits not written yet
+    unsigned int _base64Bits;
+    int _base64BitCount;
+    //! inflate stream of compressed tile data
+    z_stream_s* _tileDataStream;
+    //! csv gid being parsed
+    uint32_t _csvGID;
+    bool _csvHasDigits;
 };
 
 // end of tilemap_parallax_nodes group
@@ -36,6 +36,7 @@ cocos2d.cpp \
 2d/CCComponent.cpp \
 2d/CCComponentContainer.cpp \
 2d/CCDrawNode.cpp \
+2d/CCDynamicAtlas.cpp \
 2d/CCDrawingPrimitives.cpp \
 2d/CCFastTMXLayer.cpp \
 2d/CCFastTMXTiledMap.cpp \
@@ -61,6 +62,8 @@ cocos2d.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
+2d/CCParticleKernels.cpp \
+2d/CCParticleManager.cpp \
 2d/CCParticleSystem.cpp \
 2d/CCParticleSystemQuad.cpp \
 2d/CCProgressTimer.cpp \
@@ -71,6 +74,7 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCSpriteSheetBinary.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
 2d/CCTMXTiledMap.cpp \
@@ -170,7 +174,6 @@ storage/local-storage/LocalStorage-android.cpp \
 ../external/sources/unzip/ioapi_mem.cpp \
 ../external/sources/unzip/ioapi.cpp \
 ../external/sources/unzip/unzip.cpp \
-../external/sources/edtaa3func/edtaa3func.cpp \
 ../external/sources/xxhash/xxhash.c \
 ../external/sources/poly2tri/common/shapes.cc \
 ../external/sources/poly2tri/sweep/advancing_front.cc \
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "base/CCEventCustom.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include "renderer/ccGLStateCache.h"
 
 NS_CC_BEGIN
 
@@ -43,6 +44,8 @@ Configuration::Configuration()
 , _maxModelviewStackDepth(0)
 , _supportsPVRTC(false)
 , _supportsETC1(false)
+, _supportsETC2(false)
+, _supportsASTC(false)
 //, _supportsS3TC(false)
 //, _supportsATITC(false)
 , _supportsNPOT(false)
@@ -51,6 +54,7 @@ Configuration::Configuration()
 , _supportsShareableVAO(false)
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
+, _supportsInstancedArrays(false)
 , _supportsOESMapBuffer(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
@@ -131,6 +135,14 @@ void Configuration::gatherGPUInfo()
     _supportsETC1 = checkForGLExtension("GL_OES_compressed_ETC1_RGB8_texture");
     _valueDict["gl.supports_ETC1"] = Value(_supportsETC1);
 
+    const char* glVersion = (const char*)glGetString(GL_VERSION);
+    bool isGLES3 = glVersion && strstr(glVersion, "OpenGL ES 3");
+    _supportsETC2 = isGLES3 || checkForGLExtension("GL_ARB_ES3_compatibility") || checkForGLExtension("GL_OES_compressed_ETC2_RGBA8_texture");
+    _valueDict["gl.supports_ETC2"] = Value(_supportsETC2);
+
+    _supportsASTC = checkForGLExtension("GL_KHR_texture_compression_astc_ldr");
+    _valueDict["gl.supports_ASTC"] = Value(_supportsASTC);
+
 //    _supportsS3TC = checkForGLExtension("GL_EXT_texture_compression_s3tc");
 //    _valueDict["gl.supports_S3TC"] = Value(_supportsS3TC);
 //
@@ -161,6 +173,11 @@ void Configuration::gatherGPUInfo()
     _supportsOESPackedDepthStencil = checkForGLExtension("GL_OES_packed_depth_stencil");
     _valueDict["gl.supports_OES_packed_depth_stencil"] = Value(_supportsOESPackedDepthStencil);
 
+    _supportsInstancedArrays = (isGLES3 && GL::loadInstancedArrays(""))
+        || (checkForGLExtension("GL_EXT_instanced_arrays") && GL::loadInstancedArrays("EXT"))
+        || (checkForGLExtension("GL_ANGLE_instanced_arrays") && GL::loadInstancedArrays("ANGLE"));
+    _valueDict["gl.supports_instanced_arrays"] = Value(_supportsInstancedArrays);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -224,6 +241,16 @@ bool Configuration::supportsETC() const
 #endif
 }
 
+bool Configuration::supportsETC2() const
+{
+    return _supportsETC2;
+}
+
+bool Configuration::supportsASTC() const
+{
+    return _supportsASTC;
+}
+
 //bool Configuration::supportsS3TC() const
 //{
 //#ifdef GL_EXT_texture_compression_s3tc
@@ -274,6 +301,11 @@ bool Configuration::supportsMapBuffer() const
 #endif
 }
 
+bool Configuration::supportsInstancedArrays() const
+{
+    return _supportsInstancedArrays;
+}
+
 bool Configuration::supportsOESDepth24() const
 {
     return _supportsOESDepth24;
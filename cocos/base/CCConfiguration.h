@@ -107,6 +107,19 @@ public:
      */
     bool supportsETC() const;
 
+    /** Whether or not ETC2/EAC Texture Compressed is supported.
+     * It is core in OpenGL ES 3.0, and exposed by GL_ARB_ES3_compatibility on desktop.
+     *
+     * @return Is true if supports ETC2 Texture Compressed.
+     */
+    bool supportsETC2() const;
+
+    /** Whether or not ASTC (LDR profile) Texture Compressed is supported.
+     *
+     * @return Is true if supports ASTC Texture Compressed.
+     */
+    bool supportsASTC() const;
+
     /** Whether or not S3TC Texture Compressed is supported.
      *
      * @return Is true if supports S3TC Texture Compressed.
@@ -163,6 +176,14 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not instanced drawing is supported, from OpenGL ES 3 or the
+     * `GL_EXT_instanced_arrays` / `GL_ANGLE_instanced_arrays` extensions.
+     * When true, GL::vertexAttribDivisor() and GL::drawElementsInstanced() can be used.
+     *
+     * @return Is true if supports instanced arrays.
+     */
+    bool supportsInstancedArrays() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -241,6 +262,8 @@ protected:
     GLint           _maxModelviewStackDepth;
     bool            _supportsPVRTC;
     bool            _supportsETC1;
+    bool            _supportsETC2;
+    bool            _supportsASTC;
 //    bool            _supportsS3TC;
 //    bool            _supportsATITC;
     bool            _supportsNPOT;
@@ -250,6 +273,7 @@ protected:
     bool            _supportsOESMapBuffer;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
+    bool            _supportsInstancedArrays;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -33,6 +33,8 @@ THE SOFTWARE.
 
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlas.h"
+#include "2d/CCParticleManager.h"
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
@@ -59,6 +61,9 @@ THE SOFTWARE.
 #include "base/CCAsyncTaskPool.h"
 #include "platform/CCApplication.h"
 #include "editor-support/spine/SkeletonBatch.h"
+#include "editor-support/spine/SkeletonCache.h"
+#include "editor-support/spine/SkeletonDataCache.h"
+#include "editor-support/spine/SkeletonSystem.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
 #include "base/CCScriptSupport.h"
@@ -639,6 +644,9 @@ void Director::purgeCachedData(void)
     if (s_SharedDirector->getOpenGLView())
     {
         SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
+        DynamicAtlas::getInstance()->removeUnusedSpriteFrames();
+        // before the textures, the atlases of the skeleton data hold theirs
+        spine::SkeletonDataCache::getInstance()->removeUnusedSkeletonData();
         _textureCache->removeUnusedTextures();
 
         // Note: some tests such as ActionsTest are leaking refcounted textures
@@ -1021,10 +1029,15 @@ void Director::reset()
 #endif
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
+    DynamicAtlas::destroyInstance();
+    ParticleManager::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destroyInstance();
+    spine::SkeletonSystem::destroyInstance();
+    spine::SkeletonDataCache::destroyInstance();
+    spine::SkeletonCache::destroyInstance();
     spine::SkeletonBatch::destroyInstance();
     
     // cocos2d-x specific data structures
@@ -123,6 +123,8 @@ THE SOFTWARE.
 #include "2d/CCNodeGrid.h"
 #include "2d/CCParticleBatchNode.h"
 #include "2d/CCParticleExamples.h"
+#include "2d/CCParticleKernels.h"
+#include "2d/CCParticleManager.h"
 #include "2d/CCParticleSystem.h"
 #include "2d/CCParticleSystemQuad.h"
 #include "2d/CCProgressTimer.h"
@@ -209,6 +211,8 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCSpriteSheetBinary.h"
+#include "2d/CCDynamicAtlas.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
@@ -10,6 +10,7 @@ LOCAL_SRC_FILES := CCScale9Sprite.cpp \
     Triangulate.cpp \
     physics/CCPhysicsDebugDraw.cpp \
     physics/CCPhysicsUtils.cpp \
+    physics/CCPhysicsRunner.cpp \
     physics/CCPhysicsAABBQueryCallback.cpp \
     physics/CCPhysicsContactListener.cpp \
     physics/CCPhysicsRayCastCallback.cpp \
@@ -30,6 +30,7 @@
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "base/CCAsyncTaskPool.h"
 
 #define STRINGIFY(A)  #A
 #include "CCGraphicsNode.vert"
@@ -65,13 +66,25 @@ GraphicsBuffer::GraphicsBuffer()
     verts = (VecVertex*)malloc(sizeof(VecVertex) * nVerts);
     indices = (GLushort*)malloc(sizeof(GLushort) * nIndices);
     
-    glGenBuffers(2, buffersVBO);
+    buffersVBO[0] = 0;
+    buffersVBO[1] = 0;
 }
     
 GraphicsBuffer::~GraphicsBuffer()
 {
-    CC_SAFE_DELETE(verts);
-    CC_SAFE_DELETE(indices);
+    CC_SAFE_FREE(verts);
+    CC_SAFE_FREE(indices);
+
+    if (buffersVBO[0]) {
+        glDeleteBuffers(2, buffersVBO);
+    }
+}
+
+void GraphicsBuffer::setupVBO()
+{
+    if (!buffersVBO[0]) {
+        glGenBuffers(2, buffersVBO);
+    }
 }
     
 bool GraphicsBuffer::allocVerts(int vertsCount)
@@ -108,6 +121,12 @@ void GraphicsBuffer::clear()
     vertsOffset = 0;
     indicesOffset = 0;
 }
+
+GraphicsBufferSet::GraphicsBufferSet()
+: buffer(nullptr)
+, nCommands(0)
+{
+}
     
 GraphicsNode* GraphicsNode::create()
 {
@@ -126,14 +145,20 @@ GraphicsNode::GraphicsNode()
 , _lineWidth(1)
 , _lineCap(CAP_BUTT)
 , _lineJoin(JOIN_MITER)
-, _nPoints(0)
 , _nPath(0)
 , _pathOffset(0)
-
-, _nCommands(0)
 , _curPath(nullptr)
-    
-, _buffer(nullptr)
+
+, _drawSet(&_bufferSets[0])
+, _tessellationSet(&_bufferSets[0])
+
+, _tessellationCacheEnabled(false)
+, _tessellationPass(0)
+
+, _asyncTessellation(false)
+, _tessellating(false)
+, _opsDirty(false)
+, _nOps(0)
 {
     _miterLimit = 10.0f;
 
@@ -181,14 +206,14 @@ void GraphicsNode::lineTo(float x, float y)
 
 void GraphicsNode::bezierCurveTo(float c1x, float c1y, float c2x, float c2y, float x, float y)
 {
-    VecPoint* last = _curPath->points.back();
+    const VecPoint& last = _curPath->points.back();
 
-    if (last->x == c1x && last->y == c1y && c2x == x && c2y == y) {
+    if (last.x == c1x && last.y == c1y && c2x == x && c2y == y) {
         this->lineTo(x, y);
         return;
     }
 
-    tesselateBezier(last->x,last->y, c1x,c1y, c2x,c2y, x,y, 0, PT_CORNER);
+    tesselateBezier(last.x,last.y, c1x,c1y, c2x,c2y, x,y, 0, PT_CORNER);
 
     _commandx = x;
     _commandy = y;
@@ -394,26 +419,15 @@ void GraphicsNode::beginPath()
 
 void GraphicsNode::stroke()
 {
-    float scale = (_scaleX + _scaleY) / 2;
-    float strokeWidth = _lineWidth * scale;
-
-    flattenPaths();
-    
-    expandStroke(strokeWidth*0.5f + _fringeWidth*0.5f, _lineCap, _lineJoin, _miterLimit);
+    addOp(true);
 
-    _buffer->vertsDirty = true;
-    _buffer->indicesDirty = true;
     _needUpdatePathOffset = true;
 }
 
 void GraphicsNode::fill()
 {
-    flattenPaths();
+    addOp(false);
 
-    expandFill(_fringeWidth, JOIN_MITER, 2.4f);
-
-    _buffer->vertsDirty = true;
-    _buffer->indicesDirty = true;
     _needUpdatePathOffset = true;
 }
 
@@ -426,43 +440,32 @@ void GraphicsNode::clear(bool clean)
             delete path;
         }
 
-        for (int i = (int)_points.size() - 1; i >=0; i--) {
-            VecPoint* p = _points[i];
-            _points.pop_back();
-            delete p;
-        }
+        // a worker may be filling a set
+        if (!_tessellating) {
+            clearBufferSet(_bufferSets[0], true);
+            clearBufferSet(_bufferSets[1], true);
 
-        for (int i = (int)_commands.size() - 1; i >=0; i--) {
-            Command* c = _commands[i];
-            _commands.pop_back();
-            delete c;
+            _tessellationCache.clear();
+            _ops.clear();
+            _tessellatedOps.clear();
         }
-        
-        for (int i = (int)_buffers.size() - 1; i >=0; i--) {
-            GraphicsBuffer* b = _buffers[i];
-            _buffers.pop_back();
-            delete b;
-        }
-        
-        _buffer = nullptr;
-    }
-    else if (_buffers.size() > 0) {
-        for (int i = (int)_buffers.size() - 1; i >=0; i--) {
-            GraphicsBuffer* b = _buffers[i];
-            b->clear();
-        }
-        
-        _buffer = _buffers[0];
     }
 
-    _nPoints = 0;
+    _nOps = 0;
+    if (_asyncTessellation || _tessellating) {
+        // the drawn tessellation is replaced when the next one is ready
+        _opsDirty = true;
+    }
+    else {
+        _opsDirty = false;
+        clearBufferSet(*_drawSet, false);
+        trimTessellationCache(_tessellationCacheEnabled);
+    }
 
     _nPath = 0;
     _pathOffset = 0;
 
     _curPath = nullptr;
-    
-    _nCommands = 0;
 }
 
 // static function
@@ -565,31 +568,18 @@ void GraphicsNode::tesselateBezier(float x1, float y1, float x2, float y2,
 
 void GraphicsNode::addPoint(Path* path, float x, float y, int flags)
 {
-    VecPoint* pt;
     if (path == NULL) return;
 
     if (path->points.size() > 0) {
-        pt = path->points.back();
-        if (pt->equals(Vec2(x, y))) {
-            pt->flags |= flags;
+        VecPoint& last = path->points.back();
+        if (last.equals(Vec2(x, y))) {
+            last.flags |= flags;
             return;
         }
     }
 
-    _nPoints ++;
-    if (_nPoints > _points.size()) {
-        pt = new VecPoint(x, y);
-        _points.push_back(pt);
-    }
-    else {
-        pt = _points[_nPoints - 1];
-        pt->reset();
-        pt->x = x;
-        pt->y = y;
-    }
-
-    pt->flags = (unsigned char)flags;
-    path->points.push_back(pt);
+    path->points.push_back(VecPoint(x, y));
+    path->points.back().flags = (unsigned char)flags;
 }
 
 Path* GraphicsNode::addPath()
@@ -619,19 +609,277 @@ Path* GraphicsNode::addPath()
     return path;
 }
 
-void GraphicsNode::expandStroke(float w, int lineCap, int lineJoin, float miterLimit)
+void GraphicsNode::endPath()
+{
+    if (_curPath && _curPath->points.size() <= 1) {
+        _nPath --;
+        _curPath = _nPath > 0 ? _paths[_nPath - 1] : nullptr;
+    }
+}
+
+void GraphicsNode::addOp(bool stroke)
+{
+    endPath();
+
+    bool async = _asyncTessellation || _tessellating;
+    if (!async && _opsDirty) {
+        flushOps();
+    }
+
+    TessellationOp syncOp;
+    if (async) {
+        _nOps ++;
+        if (_nOps > _ops.size()) {
+            _ops.push_back(TessellationOp());
+        }
+    }
+    TessellationOp& op = async ? _ops[_nOps - 1] : syncOp;
+
+    op.stroke = stroke;
+    if (stroke) {
+        float scale = (_scaleX + _scaleY) / 2;
+        float strokeWidth = _lineWidth * scale;
+
+        op.width = strokeWidth*0.5f + _fringeWidth*0.5f;
+        op.lineCap = _lineCap;
+        op.lineJoin = _lineJoin;
+        op.miterLimit = _miterLimit;
+        op.color = _strokeColor;
+        op.strokeMult = (_lineWidth*0.5f + _fringeWidth*0.5f) / _fringeWidth;
+    }
+    else {
+        op.width = _fringeWidth;
+        op.lineCap = CAP_BUTT;
+        op.lineJoin = JOIN_MITER;
+        op.miterLimit = 2.4f;
+        op.color = _fillColor;
+        op.strokeMult = 1;
+    }
+    op.fringeWidth = _fringeWidth;
+    op.tessTol = _tessTol;
+
+    int nPaths = maxi(0, _nPath - _pathOffset);
+    if (async) {
+        // the pooled copies keep their points storage
+        op.paths.resize(nPaths);
+        for (int i = 0; i < nPaths; i++) {
+            op.paths[i] = *_paths[_pathOffset + i];
+        }
+        _opsDirty = true;
+    }
+    else if (nPaths > 0) {
+        tessellate(&_paths[_pathOffset], nPaths, op, _tessellationCacheEnabled);
+    }
+}
+
+void GraphicsNode::tessellate(Path** paths, int nPaths, const TessellationOp& op, bool cacheEnabled)
+{
+    std::string key;
+    if (cacheEnabled) {
+        key = getTessellationKey(paths, nPaths, op);
+        if (drawCachedTessellation(key, op)) {
+            return;
+        }
+    }
+
+    GraphicsBuffer* buffer = _tessellationSet->buffer;
+    int vertsOffset = buffer ? buffer->vertsOffset : 0;
+    int indicesOffset = buffer ? buffer->indicesOffset : 0;
+
+    flattenPaths(paths, nPaths);
+
+    if (op.stroke) {
+        expandStroke(paths, nPaths, op);
+    }
+    else {
+        expandFill(paths, nPaths, op);
+    }
+
+    // an op is expanded in a single buffer, a buffer switched to is empty
+    if (_tessellationSet->buffer != buffer) {
+        buffer = _tessellationSet->buffer;
+        vertsOffset = 0;
+        indicesOffset = 0;
+    }
+
+    buffer->vertsDirty = true;
+    buffer->indicesDirty = true;
+
+    if (cacheEnabled) {
+        cacheTessellation(key, buffer, vertsOffset, indicesOffset);
+    }
+}
+
+void GraphicsNode::tessellateOps(std::vector<TessellationOp>& ops, int nOps, bool cacheEnabled)
+{
+    clearBufferSet(*_tessellationSet, false);
+    trimTessellationCache(cacheEnabled);
+
+    std::vector<Path*> paths;
+    for (int i = 0; i < nOps; i++) {
+        TessellationOp& op = ops[i];
+
+        paths.clear();
+        for (auto& path : op.paths) {
+            paths.push_back(&path);
+        }
+
+        if (!paths.empty()) {
+            tessellate(paths.data(), (int)paths.size(), op, cacheEnabled);
+        }
+    }
+}
+
+void GraphicsNode::flushOps()
+{
+    tessellateOps(_ops, _nOps, _tessellationCacheEnabled);
+
+    _nOps = 0;
+    _opsDirty = false;
+}
+
+void GraphicsNode::startAsyncTessellation()
+{
+    _tessellatedOps.resize(_nOps);
+    for (int i = 0; i < _nOps; i++) {
+        _tessellatedOps[i] = _ops[i];
+    }
+
+    int nOps = _nOps;
+    bool cacheEnabled = _tessellationCacheEnabled;
+
+    _tessellationSet = _drawSet == &_bufferSets[0] ? &_bufferSets[1] : &_bufferSets[0];
+    _opsDirty = false;
+    _tessellating = true;
+
+    // the node stays alive until the tessellation is done
+    retain();
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [this](void*) {
+        onAsyncTessellationFinished();
+        release();
+    }, nullptr, [this, nOps, cacheEnabled]() {
+        tessellateOps(_tessellatedOps, nOps, cacheEnabled);
+    });
+}
+
+void GraphicsNode::onAsyncTessellationFinished()
+{
+    _tessellating = false;
+    _drawSet = _tessellationSet;
+}
+
+std::string GraphicsNode::getTessellationKey(Path** paths, int nPaths, const TessellationOp& op)
+{
+    // the color and the stroke multiplier are set when the tessellation is drawn
+    const float params[] = {
+        op.stroke ? 1.0f : 0.0f, op.width, (float)op.lineCap, (float)op.lineJoin,
+        op.miterLimit, op.fringeWidth, op.tessTol
+    };
+    std::string key((const char*)params, sizeof(params));
+
+    for (int i = 0; i < nPaths; i++) {
+        Path* path = paths[i];
+        const float header[] = { path->closed ? 1.0f : 0.0f, path->complex ? 1.0f : 0.0f, (float)path->points.size() };
+        key.append((const char*)header, sizeof(header));
+
+        // calculateJoins only keeps the corner flag
+        for (auto& pt : path->points) {
+            const float point[] = { pt.x, pt.y, (pt.flags & PT_CORNER) ? 1.0f : 0.0f };
+            key.append((const char*)point, sizeof(point));
+        }
+    }
+
+    return key;
+}
+
+void GraphicsNode::cacheTessellation(const std::string& key, GraphicsBuffer* buffer, int vertsOffset, int indicesOffset)
+{
+    TessellationCacheEntry& entry = _tessellationCache[key];
+
+    entry.verts.assign(buffer->verts + vertsOffset, buffer->verts + buffer->vertsOffset);
+    entry.indices.resize(buffer->indicesOffset - indicesOffset);
+    for (int i = 0, n = (int)entry.indices.size(); i < n; i++) {
+        entry.indices[i] = buffer->indices[indicesOffset + i] - vertsOffset;
+    }
+    entry.lastUsed = _tessellationPass;
+}
+
+bool GraphicsNode::drawCachedTessellation(const std::string& key, const TessellationOp& op)
+{
+    auto iterator = _tessellationCache.find(key);
+    if (iterator == _tessellationCache.end()) {
+        return false;
+    }
+
+    TessellationCacheEntry& entry = iterator->second;
+    entry.lastUsed = _tessellationPass;
+
+    int nVerts = (int)entry.verts.size();
+    int nIndices = (int)entry.indices.size();
+
+    if (!_tessellationSet->buffer || !_tessellationSet->buffer->allocVerts(nVerts)) {
+        allocBuffer();
+        _tessellationSet->buffer->allocVerts(nVerts);
+    }
+
+    GraphicsBuffer* buffer = _tessellationSet->buffer;
+    buffer->allocIndices(nIndices);
+
+    int vertsOffset = buffer->vertsOffset;
+    int indicesOffset = buffer->indicesOffset;
+
+    if (nVerts > 0) {
+        memcpy(buffer->verts + vertsOffset, entry.verts.data(), sizeof(VecVertex) * nVerts);
+    }
+    for (int i = 0; i < nIndices; i++) {
+        buffer->indices[indicesOffset + i] = entry.indices[i] + vertsOffset;
+    }
+
+    buffer->vertsOffset += nVerts;
+    buffer->indicesOffset += nIndices;
+    buffer->vertsDirty = true;
+    buffer->indicesDirty = true;
+
+    pushCommand(op.color, op.strokeMult, vertsOffset, nVerts, indicesOffset, nIndices);
+
+    return true;
+}
+
+void GraphicsNode::trimTessellationCache(bool enabled)
+{
+    if (!enabled) {
+        _tessellationCache.clear();
+        return;
+    }
+
+    for (auto iterator = _tessellationCache.begin(); iterator != _tessellationCache.end();) {
+        if (iterator->second.lastUsed != _tessellationPass) {
+            iterator = _tessellationCache.erase(iterator);
+        }
+        else {
+            ++iterator;
+        }
+    }
+
+    _tessellationPass ++;
+}
+
+void GraphicsNode::expandStroke(Path** paths, int nPaths, const TessellationOp& op)
 {
 
     int cverts, i, j;
-    float aa = _fringeWidth;
-    int ncap = curveDivs(w, PI, _tessTol);
+    float w = op.width;
+    int lineCap = op.lineCap;
+    int lineJoin = op.lineJoin;
+    float aa = op.fringeWidth;
+    int ncap = curveDivs(w, PI, op.tessTol);
 
-    calculateJoins(w, lineJoin, miterLimit);
+    calculateJoins(paths, nPaths, w, lineJoin, op.miterLimit);
 
     // Calculate max vertex usage.
     cverts = 0;
-    for (i = _pathOffset; i < _nPath; i++) {
-        Path* path = _paths[i];
+    for (i = 0; i < nPaths; i++) {
+        Path* path = paths[i];
         int pathSize = (int)path->points.size();
 
         int loop = (path->closed == 0) ? 0 : 1;
@@ -650,18 +898,19 @@ void GraphicsNode::expandStroke(float w, int lineCap, int lineJoin, float miterL
         }
     }
 
-    if (!_buffer || !_buffer->allocVerts(cverts)) {
+    if (!_tessellationSet->buffer || !_tessellationSet->buffer->allocVerts(cverts)) {
         allocBuffer();
-        _buffer->allocVerts(cverts);
+        _tessellationSet->buffer->allocVerts(cverts);
     }
+
+    GraphicsBuffer* buffer = _tessellationSet->buffer;
+    buffer->allocIndices((cverts - 2*nPaths) * 3);
     
-    _buffer->allocIndices((cverts - 2*(_nPath-_pathOffset)) * 3);
-    
-    for (i = _pathOffset; i < _nPath; i++) {
-        VecVertex* verts = _buffer->verts + _buffer->vertsOffset;
-        int offset = _buffer->vertsOffset;
+    for (i = 0; i < nPaths; i++) {
+        VecVertex* verts = buffer->verts + buffer->vertsOffset;
+        int offset = buffer->vertsOffset;
         
-        Path* path = _paths[i];
+        Path* path = paths[i];
 
         VecPointVector& pts = path->points;
         int pathSize = (int)path->points.size();
@@ -676,14 +925,14 @@ void GraphicsNode::expandStroke(float w, int lineCap, int lineJoin, float miterL
 
         if (loop) {
             // Looping
-            p0 = pts.back();
-            p1 = pts.front();
+            p0 = &pts.back();
+            p1 = &pts.front();
             s = 0;
             e = pathSize;
         } else {
             // Add cap
-            p0 = pts[0];
-            p1 = pts[1];
+            p0 = &pts[0];
+            p1 = &pts[1];
             s = 1;
             e = pathSize-1;
         }
@@ -713,7 +962,7 @@ void GraphicsNode::expandStroke(float w, int lineCap, int lineJoin, float miterL
             }
             if (!loop || (loop && j < (e - 1))) {
                 p0 = p1;
-                p1 = pts[j + 1];
+                p1 = &pts[j + 1];
             }
         }
 
@@ -735,31 +984,31 @@ void GraphicsNode::expandStroke(float w, int lineCap, int lineJoin, float miterL
         }
 
         // stroke indices
-        int indicesOffset = _buffer->indicesOffset;
+        int indicesOffset = buffer->indicesOffset;
 
-        for (int start = offset+2, end = _buffer->vertsOffset; start < end; start++) {
-            _buffer->indices[_buffer->indicesOffset++] = start - 2;
-            _buffer->indices[_buffer->indicesOffset++] = start - 1;
-            _buffer->indices[_buffer->indicesOffset++] = start;
+        for (int start = offset+2, end = buffer->vertsOffset; start < end; start++) {
+            buffer->indices[buffer->indicesOffset++] = start - 2;
+            buffer->indices[buffer->indicesOffset++] = start - 1;
+            buffer->indices[buffer->indicesOffset++] = start;
         }
 
-        float strokeMult = (_lineWidth*0.5f + _fringeWidth*0.5f) / _fringeWidth;
-        pushCommand(_strokeColor, strokeMult, offset, _buffer->vertsOffset - offset, indicesOffset, _buffer->indicesOffset - indicesOffset);
+        pushCommand(op.color, op.strokeMult, offset, buffer->vertsOffset - offset, indicesOffset, buffer->indicesOffset - indicesOffset);
     }
 }
 
-void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
+void GraphicsNode::expandFill(Path** paths, int nPaths, const TessellationOp& op)
 {
     int cverts, convex, i, j;
-    float aa = _fringeWidth;
+    float w = op.width;
+    float aa = op.fringeWidth;
     int fringe = w > 0.0f;
 
-    calculateJoins(w, lineJoin, miterLimit);
+    calculateJoins(paths, nPaths, w, op.lineJoin, op.miterLimit);
 
     // Calculate max vertex usage.
     cverts = 0;
-    for (i = _pathOffset; i < _nPath; i++) {
-        Path* path = _paths[i];
+    for (i = 0; i < nPaths; i++) {
+        Path* path = paths[i];
         int pathSize = (int)path->points.size();
 
         cverts += pathSize;// + path->nbevel + 1;
@@ -769,18 +1018,19 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
         }
     }
 
-    if (!_buffer || !_buffer->allocVerts(cverts)) {
+    if (!_tessellationSet->buffer || !_tessellationSet->buffer->allocVerts(cverts)) {
         allocBuffer();
-        _buffer->allocVerts(cverts);
+        _tessellationSet->buffer->allocVerts(cverts);
     }
 
-    convex = _nPath == 1 && _paths[_pathOffset]->convex;
+    GraphicsBuffer* buffer = _tessellationSet->buffer;
+    convex = nPaths == 1 && paths[0]->convex;
 
-    for (i = _pathOffset; i < _nPath; i++) {
-        Path* path = _paths[i];
+    for (i = 0; i < nPaths; i++) {
+        Path* path = paths[i];
 
-        VecVertex* verts = _buffer->verts + _buffer->vertsOffset;
-        int offset = _buffer->vertsOffset;
+        VecVertex* verts = buffer->verts + buffer->vertsOffset;
+        int offset = buffer->vertsOffset;
         
         VecPointVector& pts = path->points;
         int pathSize = (int)pts.size();
@@ -794,8 +1044,8 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
 
         if (fringe) {
             // Looping
-            p0 = pts[pathSize-1];
-            p1 = pts[0];
+            p0 = &pts[pathSize-1];
+            p1 = &pts[0];
             for (j = 0; j < pathSize; ++j) {
                 if (p1->flags & PT_BEVEL) {
                     float dlx0 = p0->dy;
@@ -820,49 +1070,49 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
 
                 if (j < (pathSize - 1)) {
                     p0 = p1;
-                    p1 = pts[j + 1];
+                    p1 = &pts[j + 1];
                 }
             }
         } else {
             for (j = 0; j < pathSize; ++j) {
-                vset(pts[j]->x, pts[j]->y, 0.5f,1);
+                vset(pts[j].x, pts[j].y, 0.5f,1);
             }
         }
         
-        int nVerts = _buffer->vertsOffset - offset;
-        int indicesOffset = _buffer->indicesOffset;
+        int nVerts = buffer->vertsOffset - offset;
+        int indicesOffset = buffer->indicesOffset;
         
         if (path->complex) {
             // indices
             std::vector<int> indices;
-            Triangulate::process(verts, 0, _buffer->vertsOffset - offset, indices);
+            Triangulate::process(verts, 0, buffer->vertsOffset - offset, indices);
             int nIndices = (int)indices.size();
 
-            _buffer->allocIndices(nIndices);
+            buffer->allocIndices(nIndices);
             
             for (j = 0; j < nIndices; j++) {
-                _buffer->indices[j + _buffer->indicesOffset] = indices[j] + offset;
+                buffer->indices[j + buffer->indicesOffset] = indices[j] + offset;
             }
             
-            _buffer->indicesOffset += nIndices;
+            buffer->indicesOffset += nIndices;
         }
         else {
-            _buffer->allocIndices((nVerts - 2) * 3);
+            buffer->allocIndices((nVerts - 2) * 3);
             
             int first = offset;
-            for (int start = offset+2, end = _buffer->vertsOffset; start < end; start++) {
-                _buffer->indices[_buffer->indicesOffset++] = first;
-                _buffer->indices[_buffer->indicesOffset++] = start - 1;
-                _buffer->indices[_buffer->indicesOffset++] = start;
+            for (int start = offset+2, end = buffer->vertsOffset; start < end; start++) {
+                buffer->indices[buffer->indicesOffset++] = first;
+                buffer->indices[buffer->indicesOffset++] = start - 1;
+                buffer->indices[buffer->indicesOffset++] = start;
             }
         }
 
-        pushCommand(_fillColor, 1, offset, _buffer->vertsOffset - offset, indicesOffset, _buffer->indicesOffset - indicesOffset);
+        pushCommand(op.color, op.strokeMult, offset, buffer->vertsOffset - offset, indicesOffset, buffer->indicesOffset - indicesOffset);
         
         // Calculate fringe
         if (fringe) {
-            verts = _buffer->verts + _buffer->vertsOffset;
-            offset = _buffer->vertsOffset;
+            verts = buffer->verts + buffer->vertsOffset;
+            offset = buffer->vertsOffset;
             
             float lw = w + woff;
             float rw = w - woff;
@@ -877,12 +1127,12 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
             }
 
             // Looping
-            p0 = pts[pathSize-1];
-            p1 = pts[0];
+            p0 = &pts[pathSize-1];
+            p1 = &pts[0];
 
             for (j = 0; j < pathSize; ++j) {
                 if ((p1->flags & (PT_BEVEL | PT_INNERBEVEL)) != 0) {
-                    bevelJoin(p0, p1, lw, rw, lu, ru, _fringeWidth);
+                    bevelJoin(p0, p1, lw, rw, lu, ru, aa);
                 } else {
                     vset(p1->x + (p1->dmx * lw), p1->y + (p1->dmy * lw), lu,1);
                     vset(p1->x - (p1->dmx * rw), p1->y - (p1->dmy * rw), ru,1);
@@ -890,7 +1140,7 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
 
                 if (j < (pathSize - 1)) {
                     p0 = p1;
-                    p1 = pts[j + 1];
+                    p1 = &pts[j + 1];
                 }
             }
 
@@ -899,40 +1149,35 @@ void GraphicsNode::expandFill(float w, int lineJoin, float miterLimit)
             vset(verts[1].x, verts[1].y, ru,1);
 
             // fill stroke indices
-            nVerts = _buffer->vertsOffset - offset;
-            indicesOffset = _buffer->indicesOffset;
+            nVerts = buffer->vertsOffset - offset;
+            indicesOffset = buffer->indicesOffset;
             
-            _buffer->allocIndices((nVerts - 2) * 3);
+            buffer->allocIndices((nVerts - 2) * 3);
             
-            for (int start = offset+2, end = _buffer->vertsOffset; start < end; start++) {
-                _buffer->indices[_buffer->indicesOffset++] = start - 2;
-                _buffer->indices[_buffer->indicesOffset++] = start - 1;
-                _buffer->indices[_buffer->indicesOffset++] = start;
+            for (int start = offset+2, end = buffer->vertsOffset; start < end; start++) {
+                buffer->indices[buffer->indicesOffset++] = start - 2;
+                buffer->indices[buffer->indicesOffset++] = start - 1;
+                buffer->indices[buffer->indicesOffset++] = start;
             }
 
-            pushCommand(_fillColor, 1, offset, nVerts, indicesOffset, _buffer->indicesOffset - indicesOffset);
+            pushCommand(op.color, op.strokeMult, offset, nVerts, indicesOffset, buffer->indicesOffset - indicesOffset);
         }
     }
 }
 
-void GraphicsNode::flattenPaths()
+void GraphicsNode::flattenPaths(Path** paths, int nPaths)
 {
-    if (_curPath && _curPath->points.size() <= 1) {
-        _nPath --;
-        _curPath = _nPath > 0 ? _paths[_nPath - 1] : nullptr;
-    }
-
-    for (int i = _pathOffset; i < _nPath; i++) {
-        Path* path = _paths[i];
+    for (int i = 0; i < nPaths; i++) {
+        Path* path = paths[i];
         VecPointVector& pts = path->points;
 
-        VecPoint* p0 = pts.back();
-        VecPoint* p1 = pts.front();
+        VecPoint* p0 = &pts.back();
+        VecPoint* p1 = &pts.front();
 
         if(p0->equals(*p1)) {
             path->closed = true;
             pts.pop_back();
-            p0 = pts.back();
+            p0 = &pts.back();
         }
 
         for (int j = 0, size = (int)pts.size(); j < size; j++) {
@@ -944,14 +1189,14 @@ void GraphicsNode::flattenPaths()
             // Advance
             if (j < (size - 1)) {
                 p0 = p1;
-                p1 = pts[j + 1];
+                p1 = &pts[j + 1];
             }
         }
     }
 }
 
 
-void GraphicsNode::calculateJoins(float w, int lineJoin, float miterLimit)
+void GraphicsNode::calculateJoins(Path** paths, int nPaths, float w, int lineJoin, float miterLimit)
 {
     int i, j, ii, jj;
     float iw = 0.0f;
@@ -960,12 +1205,12 @@ void GraphicsNode::calculateJoins(float w, int lineJoin, float miterLimit)
         iw = 1.0f / w;
 
     // Calculate which joins needs extra vertices to append, and gather vertex count.
-    for (i = _pathOffset, ii = _nPath; i < ii; i++) {
-        Path* path = _paths[i];
+    for (i = 0, ii = nPaths; i < ii; i++) {
+        Path* path = paths[i];
 
         VecPointVector& pts = path->points;
-        VecPoint* p0 = pts[pts.size()-1];
-        VecPoint* p1 = pts[0];
+        VecPoint* p0 = &pts[pts.size()-1];
+        VecPoint* p1 = &pts[0];
         int nleft = 0;
 
         path->nbevel = 0;
@@ -1016,7 +1261,7 @@ void GraphicsNode::calculateJoins(float w, int lineJoin, float miterLimit)
 
             if (j < (jj - 1)) {
                 p0 = p1;
-                p1 = pts[j + 1];
+                p1 = &pts[j + 1];
             }
         }
 
@@ -1026,37 +1271,71 @@ void GraphicsNode::calculateJoins(float w, int lineJoin, float miterLimit)
 
 void GraphicsNode::allocBuffer()
 {
-    if (_buffer) {
-        const auto iterator = std::find(_buffers.begin(), _buffers.end(), _buffer);
-        if (iterator != _buffers.end() && (*iterator) != _buffers.back()) {
-            _buffer = *(iterator+1);
+    std::vector<GraphicsBuffer*>& buffers = _tessellationSet->buffers;
+    if (_tessellationSet->buffer) {
+        const auto iterator = std::find(buffers.begin(), buffers.end(), _tessellationSet->buffer);
+        if (iterator != buffers.end() && (*iterator) != buffers.back()) {
+            _tessellationSet->buffer = *(iterator+1);
             return;
         }
     }
     
     GraphicsBuffer* buffer = new GraphicsBuffer();
-    _buffer = buffer;
-    _buffers.push_back(buffer);
+    _tessellationSet->buffer = buffer;
+    buffers.push_back(buffer);
+}
+
+void GraphicsNode::clearBufferSet(GraphicsBufferSet& set, bool clean)
+{
+    if (clean) {
+        for (int i = (int)set.commands.size() - 1; i >=0; i--) {
+            Command* c = set.commands[i];
+            set.commands.pop_back();
+            delete c;
+        }
+
+        for (int i = (int)set.buffers.size() - 1; i >=0; i--) {
+            GraphicsBuffer* b = set.buffers[i];
+            set.buffers.pop_back();
+            delete b;
+        }
+
+        set.buffer = nullptr;
+    }
+    else if (set.buffers.size() > 0) {
+        for (int i = (int)set.buffers.size() - 1; i >=0; i--) {
+            GraphicsBuffer* b = set.buffers[i];
+            b->clear();
+        }
+
+        set.buffer = set.buffers[0];
+    }
+
+    set.nCommands = 0;
 }
 
     
 void GraphicsNode::vset(float x, float y, float u, float v)
 {
-    VecVertex* vtx = &_buffer->verts[_buffer->vertsOffset];
+    GraphicsBuffer* buffer = _tessellationSet->buffer;
+    VecVertex* vtx = &buffer->verts[buffer->vertsOffset];
 
     vtx->x = x;
     vtx->y = y;
     vtx->u = u;
     vtx->v = v;
     
-    _buffer->vertsOffset ++;
+    buffer->vertsOffset ++;
 }
 
-void GraphicsNode::pushCommand(cocos2d::Color4F& color, float strokeMult, int vertsOffset, int nVerts, int indicesOffset, int nIndices)
+void GraphicsNode::pushCommand(const cocos2d::Color4F& color, float strokeMult, int vertsOffset, int nVerts, int indicesOffset, int nIndices)
 {
+    CommandVector& commands = _tessellationSet->commands;
+    int& nCommands = _tessellationSet->nCommands;
+
     Command* lastCmd = nullptr;
-    if (_commands.size() >= _nCommands && _nCommands > 0) {
-        lastCmd = _commands[_nCommands - 1];
+    if (commands.size() >= nCommands && nCommands > 0) {
+        lastCmd = commands[nCommands - 1];
     }
 
     if (lastCmd &&
@@ -1064,20 +1343,20 @@ void GraphicsNode::pushCommand(cocos2d::Color4F& color, float strokeMult, int ve
         ((lastCmd->indicesOffset + lastCmd->nIndices) == indicesOffset) &&
         lastCmd->color.equals(color) &&
         lastCmd->strokeMult == strokeMult &&
-        lastCmd->buffer == _buffer) {
+        lastCmd->buffer == _tessellationSet->buffer) {
         lastCmd->nVerts += nVerts;
         lastCmd->nIndices += nIndices;
     }
     else {
         Command* cmd;
 
-        _nCommands ++;
-        if (_nCommands > _commands.size()) {
+        nCommands ++;
+        if (nCommands > commands.size()) {
             cmd = new Command();
-            _commands.push_back(cmd);
+            commands.push_back(cmd);
         }
         else {
-            cmd = _commands[_nCommands - 1];
+            cmd = commands[nCommands - 1];
         }
 
         cmd->color = color;
@@ -1086,7 +1365,7 @@ void GraphicsNode::pushCommand(cocos2d::Color4F& color, float strokeMult, int ve
         cmd->nVerts = nVerts;
         cmd->indicesOffset = indicesOffset;
         cmd->nIndices = nIndices;
-        cmd->buffer = _buffer;
+        cmd->buffer = _tessellationSet->buffer;
     }
 }
 
@@ -1280,6 +1559,15 @@ void GraphicsNode::bevelJoin(VecPoint* p0, VecPoint* p1, float lw, float rw, flo
 
 void GraphicsNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
+    if (_opsDirty && !_tessellating) {
+        if (_asyncTessellation) {
+            startAsyncTessellation();
+        }
+        else {
+            flushOps();
+        }
+    }
+
     _customCommand.init(_globalZOrder);
     _customCommand.func = CC_CALLBACK_0(GraphicsNode::onDraw, this, transform, flags);
     renderer->addCommand(&_customCommand);
@@ -1288,7 +1576,7 @@ void GraphicsNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flag
 
 void GraphicsNode::onDraw(const Mat4 &transform, uint32_t flags)
 {
-    if (_nCommands <=0) return;
+    if (_drawSet->nCommands <=0) return;
 
     auto program = getGLProgram();
     program->use();
@@ -1301,10 +1589,11 @@ void GraphicsNode::onDraw(const Mat4 &transform, uint32_t flags)
     GLint strokeMultLocation = program->getUniformLocation("strokeMult");
     
     // draw paths
-    for (int i = 0; i < _nCommands; i++) {
-        Command* cmd = _commands[i];
+    for (int i = 0; i < _drawSet->nCommands; i++) {
+        Command* cmd = _drawSet->commands[i];
         
         GraphicsBuffer* buffer = cmd->buffer;
+        buffer->setupVBO();
         
         glBindBuffer(GL_ARRAY_BUFFER, buffer->buffersVBO[0]);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->buffersVBO[1]);
@@ -27,6 +27,9 @@
 #ifndef __CREATOR_CCGRAPHICSNODE_H__
 #define __CREATOR_CCGRAPHICSNODE_H__
 
+#include <string>
+#include <unordered_map>
+
 #include "2d/CCNode.h"
 #include "renderer/CCCustomCommand.h"
 
@@ -92,8 +95,9 @@ public:
     float len;
 };
 
-typedef std::vector< VecPoint* > VecPointVector;
-    
+// the points of a path are stored contiguously, a pooled path keeps its storage when it is reused
+typedef std::vector< VecPoint > VecPointVector;
+
 
 struct Path
 {
@@ -116,6 +120,9 @@ public:
     void allocIndices(int indicesCount);
     
     void clear();
+
+    // creates the buffer objects on first use, the vertices may be written on a worker thread
+    void setupVBO();
     
     // verts
     int nVerts;
@@ -146,6 +153,45 @@ struct Command
 };
 typedef struct Command Command;
 typedef std::vector< Command* > CommandVector;
+
+// the tessellated geometry: the buffers and the commands drawing them
+struct GraphicsBufferSet
+{
+    GraphicsBufferSet();
+
+    std::vector<GraphicsBuffer*> buffers;
+    // buffer being filled
+    GraphicsBuffer* buffer;
+
+    int nCommands;
+    CommandVector commands;
+};
+
+// a stroke or a fill, with the state it was called with
+struct TessellationOp
+{
+    bool stroke;
+    float width;
+    LineCap lineCap;
+    LineJoin lineJoin;
+    float miterLimit;
+    float fringeWidth;
+    float tessTol;
+
+    cocos2d::Color4F color;
+    float strokeMult;
+
+    // copies of the paths, when tessellated in the background
+    std::vector<Path> paths;
+};
+
+// the vertices and indices of an op, the indices start at 0
+struct TessellationCacheEntry
+{
+    std::vector<VecVertex> verts;
+    std::vector<GLushort> indices;
+    unsigned int lastUsed;
+};
     
 
 class CC_DLL GraphicsNode : public cocos2d::Node
@@ -205,6 +251,20 @@ public:
     void fill();
 
     void clear(bool clean=false);
+
+    /** Keeps the tessellation of the strokes and fills of the previous drawing, disabled by default.
+     A stroke or fill of the same paths with the same line settings reuses it instead of tessellating the paths again,
+     only its color may differ. What was not drawn again since the previous clear() is dropped.
+     */
+    void setTessellationCacheEnabled(bool enabled) { _tessellationCacheEnabled = enabled; }
+    bool isTessellationCacheEnabled() { return _tessellationCacheEnabled; }
+
+    /** Tessellates the paths on a worker thread, disabled by default.
+     stroke() and fill() then record copies of the paths, tessellated when the node is drawn. The node draws the previous
+     tessellation until the new one is ready, a frame or more later.
+     */
+    void setAsyncTessellation(bool async) { _asyncTessellation = async; }
+    bool isAsyncTessellation() { return _asyncTessellation; }
 public:
 
     void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, uint32_t flags);
@@ -244,18 +304,36 @@ protected:
     void addPoint(Path* path, float x, float y, int flags);
     Path* addPath();
 
-    void flattenPaths();
+    // removes the current path when it has no segment
+    void endPath();
+    void addOp(bool stroke);
+
+    void tessellate(Path** paths, int nPaths, const TessellationOp& op, bool cacheEnabled);
+    void tessellateOps(std::vector<TessellationOp>& ops, int nOps, bool cacheEnabled);
+    // tessellates the ops recorded before switching to the synchronous tessellation
+    void flushOps();
+    void startAsyncTessellation();
+    void onAsyncTessellationFinished();
 
-    void expandStroke(float w, int lineCap, int lineJoin, float miterLimit);
-    void expandFill(float w, int lineJoin, float miterLimit);
+    std::string getTessellationKey(Path** paths, int nPaths, const TessellationOp& op);
+    void cacheTessellation(const std::string& key, GraphicsBuffer* buffer, int vertsOffset, int indicesOffset);
+    bool drawCachedTessellation(const std::string& key, const TessellationOp& op);
+    // drops the tessellations not used since the previous call
+    void trimTessellationCache(bool enabled);
 
-    void calculateJoins(float w, int lineJoin, float miterLimit);
+    void flattenPaths(Path** paths, int nPaths);
+
+    void expandStroke(Path** paths, int nPaths, const TessellationOp& op);
+    void expandFill(Path** paths, int nPaths, const TessellationOp& op);
+
+    void calculateJoins(Path** paths, int nPaths, float w, int lineJoin, float miterLimit);
 
     void allocBuffer();
+    void clearBufferSet(GraphicsBufferSet& set, bool clean);
     
     void vset(float x, float y, float u, float v);
 
-    void pushCommand(cocos2d::Color4F& color, float strokeMult, int vertsOffset, int nVerts, int indicesOffset, int nIndices);
+    void pushCommand(const cocos2d::Color4F& color, float strokeMult, int vertsOffset, int nVerts, int indicesOffset, int nIndices);
 
     void buttCapStart(VecPoint* p, float dx, float dy, float w, float d, float aa);
     void buttCapEnd(VecPoint* p, float dx, float dy, float w, float d, float aa);
@@ -288,25 +366,34 @@ protected:
     float _commandx;
     float _commandy;
 
-    // points
-    int _nPoints;
-    VecPointVector _points;
-    
-    // commands
-    int _nCommands;
-    CommandVector _commands;
-
-
     // path
     int _nPath;
     int _pathOffset;
     std::vector<Path*> _paths;
     
-    // buffer
-    std::vector<GraphicsBuffer*> _buffers;
-    GraphicsBuffer* _buffer;
-    
     Path* _curPath;
+
+    // buffers, double buffered with the asynchronous tessellation
+    GraphicsBufferSet _bufferSets[2];
+    // the set drawn by onDraw
+    GraphicsBufferSet* _drawSet;
+    // the set filled by the tessellation, the drawn set unless a worker fills the other one
+    GraphicsBufferSet* _tessellationSet;
+
+    // tessellation cache, only used by the thread tessellating
+    bool _tessellationCacheEnabled;
+    unsigned int _tessellationPass;
+    std::unordered_map<std::string, TessellationCacheEntry> _tessellationCache;
+
+    // asynchronous tessellation
+    bool _asyncTessellation;
+    bool _tessellating;
+    bool _opsDirty;
+    // ops recorded since the last clear
+    int _nOps;
+    std::vector<TessellationOp> _ops;
+    // copies of the ops tessellated by the worker
+    std::vector<TessellationOp> _tessellatedOps;
 };
 
 }
@@ -5,6 +5,61 @@ using namespace cocos2d;
 
 namespace creator {
 
+namespace {
+    bool isFixtureInWorld(b2World* world, b2Fixture* fixture)
+    {
+        for (b2Body* body = world->GetBodyList(); body; body = body->GetNext())
+        {
+            for (b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext())
+            {
+                if (f == fixture) return true;
+            }
+        }
+        return false;
+    }
+}
+
+PhysicsContactSnapshot::PhysicsContactSnapshot(b2Contact* contact, b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB,
+                                               const b2Manifold& manifold, float32 friction, float32 restitution, float32 tangentSpeed)
+: _contact(contact)
+{
+    // the members are set as b2Contact's constructor does, without linking the snapshot to the world
+    m_flags = e_enabledFlag;
+    m_prev = nullptr;
+    m_next = nullptr;
+    m_nodeA.contact = nullptr;
+    m_nodeA.prev = nullptr;
+    m_nodeA.next = nullptr;
+    m_nodeA.other = nullptr;
+    m_nodeB.contact = nullptr;
+    m_nodeB.prev = nullptr;
+    m_nodeB.next = nullptr;
+    m_nodeB.other = nullptr;
+    m_fixtureA = fixtureA;
+    m_fixtureB = fixtureB;
+    m_indexA = indexA;
+    m_indexB = indexB;
+    m_manifold = manifold;
+    m_toiCount = 0;
+    m_friction = friction;
+    m_restitution = restitution;
+    m_tangentSpeed = tangentSpeed;
+}
+
+PhysicsContactSnapshot::~PhysicsContactSnapshot()
+{
+}
+
+b2Contact* PhysicsContactSnapshot::getContact() const
+{
+    return _contact;
+}
+
+void PhysicsContactSnapshot::Evaluate(b2Manifold* manifold, const b2Transform& xfA, const b2Transform& xfB)
+{
+    *manifold = m_manifold;
+}
+
 std::vector<PhysicsContactListener*> PhysicsContactListener::__allInstances;
 
 const std::vector<PhysicsContactListener*>& PhysicsContactListener::getAllInstances()
@@ -13,6 +68,8 @@ const std::vector<PhysicsContactListener*>& PhysicsContactListener::getAllInstan
 }
 
 PhysicsContactListener::PhysicsContactListener() 
+: _batched(false)
+, _flushing(false)
 {
     __allInstances.push_back(this);
 }
@@ -50,6 +107,12 @@ void PhysicsContactListener::setPostSolve(const std::function<void(b2Contact* co
 void PhysicsContactListener::BeginContact(b2Contact* contact)
 {
     if (!_beginContact) return;
+    
+    if (_batched)
+    {
+        _recordContact(ContactEventType::BEGIN, contact);
+        return;
+    }
 
     b2Fixture* fixtureA = contact->GetFixtureA();
     b2Fixture* fixtureB = contact->GetFixtureB();
@@ -65,7 +128,22 @@ void PhysicsContactListener::BeginContact(b2Contact* contact)
 
 void PhysicsContactListener::EndContact(b2Contact* contact)
 {
+    // a callback of flushContacts destroyed a body, the contact is ended right away
+    if (_flushing) _liveContacts.erase(contact);
+    
     if (!_endContact) return;
+    
+    // only the steps of the worker thread are recorded, destroying a body on the main thread ends its contacts right away
+    if (_batched && !_flushing && contact->GetFixtureA()->GetBody()->GetWorld()->IsLocked())
+    {
+        _recordContact(ContactEventType::END, contact);
+        ContactRecord& record = _contactRecords.back();
+        record.manifold = *contact->GetManifold();
+        record.friction = contact->GetFriction();
+        record.restitution = contact->GetRestitution();
+        record.tangentSpeed = contact->GetTangentSpeed();
+        return;
+    }
 
     auto i = _contactMap.find(contact);
     if (i != _contactMap.end())
@@ -78,6 +156,12 @@ void PhysicsContactListener::EndContact(b2Contact* contact)
 void PhysicsContactListener::PreSolve(b2Contact* contact, const b2Manifold* oldManifold)
 {
     if (!_preSolve) return;
+    
+    if (_batched)
+    {
+        _recordContact(ContactEventType::PRE_SOLVE, contact);
+        return;
+    }
 
     if (_contactMap.find(contact) != _contactMap.end())
     {
@@ -88,6 +172,13 @@ void PhysicsContactListener::PreSolve(b2Contact* contact, const b2Manifold* oldM
 void PhysicsContactListener::PostSolve(b2Contact* contact, const b2ContactImpulse* impulse)
 {
     if (!_postSolve) return;
+    
+    if (_batched)
+    {
+        _recordContact(ContactEventType::POST_SOLVE, contact);
+        _contactRecords.back().impulse.init(impulse);
+        return;
+    }
 
     if (_contactMap.find(contact) != _contactMap.end())
     {
@@ -110,4 +201,108 @@ void PhysicsContactListener::unregisterContactFixture(b2Fixture* fixture)
     }
 }
 
+void PhysicsContactListener::setBatched(bool batched)
+{
+    _batched = batched;
+}
+
+bool PhysicsContactListener::isBatched() const
+{
+    return _batched;
+}
+
+void PhysicsContactListener::_recordContact(ContactEventType type, b2Contact* contact)
+{
+    ContactRecord record;
+    record.type = type;
+    record.contact = contact;
+    record.fixtureA = contact->GetFixtureA();
+    record.fixtureB = contact->GetFixtureB();
+    record.childIndexA = contact->GetChildIndexA();
+    record.childIndexB = contact->GetChildIndexB();
+    _contactRecords.push_back(record);
+}
+
+void PhysicsContactListener::flushContacts(b2World* world)
+{
+    if (_contactRecords.empty()) return;
+
+    // the contacts that ended in the batch are destroyed, their memory may hold a newer contact
+    _liveContacts.clear();
+    for (b2Contact* contact = world->GetContactList(); contact; contact = contact->GetNext())
+    {
+        _liveContacts.insert(contact);
+    }
+
+    std::vector<ContactRecord> records;
+    records.swap(_contactRecords);
+    _flushing = true;
+
+    for (const auto& record : records)
+    {
+        b2Contact* contact = record.contact;
+        const bool isLive = _liveContacts.find(contact) != _liveContacts.end() &&
+            contact->GetFixtureA() == record.fixtureA && contact->GetFixtureB() == record.fixtureB &&
+            contact->GetChildIndexA() == record.childIndexA && contact->GetChildIndexB() == record.childIndexB;
+
+        if (record.type == ContactEventType::END)
+        {
+            auto i = _contactMap.find(contact);
+            if (i == _contactMap.end()) continue;
+            _contactMap.erase(i);
+            if (!_endContact) continue;
+            
+            // stopped touching, the contact is still in the world
+            if (isLive)
+            {
+                _endContact(contact);
+                continue;
+            }
+            
+            // a callback of this flush may have destroyed the bodies of the fixtures
+            if (!isFixtureInWorld(world, record.fixtureA) || !isFixtureInWorld(world, record.fixtureB)) continue;
+            
+            PhysicsContactSnapshot snapshot(contact, record.fixtureA, record.childIndexA, record.fixtureB, record.childIndexB,
+                                            record.manifold, record.friction, record.restitution, record.tangentSpeed);
+            _endContact(&snapshot);
+            continue;
+        }
+
+        if (!isLive) continue;
+
+        switch (record.type)
+        {
+            case ContactEventType::BEGIN:
+                if (find(_contactFixtures.begin(), _contactFixtures.end(), record.fixtureA) != _contactFixtures.end() ||
+                    find(_contactFixtures.begin(), _contactFixtures.end(), record.fixtureB) != _contactFixtures.end())
+                {
+                    _contactMap[contact] = true;
+                    if (_beginContact) _beginContact(contact);
+                }
+                break;
+
+            case ContactEventType::PRE_SOLVE:
+                if (_preSolve && _contactMap.find(contact) != _contactMap.end())
+                {
+                    _preSolve(contact);
+                }
+                break;
+
+            case ContactEventType::POST_SOLVE:
+                if (_postSolve && _contactMap.find(contact) != _contactMap.end())
+                {
+                    _impulse = record.impulse;
+                    _postSolve(contact, &_impulse);
+                }
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    _flushing = false;
+    _liveContacts.clear();
+}
+
 }
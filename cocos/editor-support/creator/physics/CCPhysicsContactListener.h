@@ -30,11 +30,30 @@
 #include "CCPhysicsContactImpulse.h"
 
 #include <functional>
+#include <unordered_set>
 #include <vector>
 
 
 namespace creator {
 
+// Stands for a contact destroyed while the world stepped in batched mode, given to the end contact
+// callback in its place. It holds the fixtures, child indices, manifold and mixed values the contact
+// had when it ended, getContact returns the address of the destroyed contact, which must not be used.
+class CC_DLL PhysicsContactSnapshot : public b2Contact
+{
+public:
+    PhysicsContactSnapshot(b2Contact* contact, b2Fixture* fixtureA, int32 indexA, b2Fixture* fixtureB, int32 indexB,
+                           const b2Manifold& manifold, float32 friction, float32 restitution, float32 tangentSpeed);
+    virtual ~PhysicsContactSnapshot();
+    
+    b2Contact* getContact() const;
+    
+    virtual void Evaluate(b2Manifold* manifold, const b2Transform& xfA, const b2Transform& xfB) override;
+    
+protected:
+    b2Contact* _contact;
+};
+
 class CC_DLL PhysicsContactListener : public b2ContactListener
 {
 public:
@@ -58,7 +77,42 @@ public:
     void registerContactFixture(b2Fixture* fixture);
     void unregisterContactFixture(b2Fixture* fixture);
     
+    // When batched, the contacts are recorded while the world steps and flushContacts calls the callbacks,
+    // see PhysicsRunner. PreSolve is then reported after the step, disabling a contact from it has no effect.
+    // A contact destroyed in the step is given to EndContact as a PhysicsContactSnapshot. The contacts
+    // ending outside of a step, when a body is destroyed, are still reported right away.
+    void setBatched(bool batched);
+    bool isBatched() const;
+    void flushContacts(b2World* world);
+    
 protected:
+    enum class ContactEventType
+    {
+        BEGIN,
+        END,
+        PRE_SOLVE,
+        POST_SOLVE
+    };
+    
+    struct ContactRecord
+    {
+        ContactEventType type;
+        b2Contact* contact;
+        b2Fixture* fixtureA;
+        b2Fixture* fixtureB;
+        int32 childIndexA;
+        int32 childIndexB;
+        PhysicsContactImpulse impulse;
+        // the state of the contact when it ended, it may be destroyed right after
+        b2Manifold manifold;
+        float32 friction;
+        float32 restitution;
+        float32 tangentSpeed;
+    };
+    
+    void _recordContact(ContactEventType type, b2Contact* contact);
+    
+
     std::function<void(b2Contact* contact)> _beginContact;
     std::function<void(b2Contact* contact)> _endContact;
     std::function<void(b2Contact* contact)> _preSolve;
@@ -68,6 +122,11 @@ protected:
     PhysicsContactImpulse _impulse;
     
     std::unordered_map<b2Contact*, bool> _contactMap;
+    
+    bool _batched;
+    bool _flushing;
+    std::vector<ContactRecord> _contactRecords;
+    std::unordered_set<b2Contact*> _liveContacts;
 
     static std::vector<PhysicsContactListener*> __allInstances;
 };
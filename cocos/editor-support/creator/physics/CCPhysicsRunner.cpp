@@ -0,0 +1,206 @@
+#include "CCPhysicsRunner.h"
+
+using namespace cocos2d;
+
+namespace creator {
+
+std::function<void(b2World*)> PhysicsRunner::__afterStepCallback;
+
+void PhysicsRunner::setAfterStepCallback(const std::function<void(b2World*)>& callback)
+{
+    __afterStepCallback = callback;
+}
+
+PhysicsRunner::PhysicsRunner(b2World* world, PhysicsUtils* utils, PhysicsContactListener* listener)
+: _world(world)
+, _utils(utils)
+, _listener(listener)
+, _fixedTimeStep(1.0f / 60)
+, _velocityIterations(10)
+, _positionIterations(10)
+, _maxSubSteps(5)
+, _accumulator(0)
+, _alpha(1)
+, _afterUpdateListener(nullptr)
+, _afterDrawListener(nullptr)
+, _thread(nullptr)
+, _pendingSteps(0)
+, _stepping(false)
+, _stopping(false)
+{
+}
+
+PhysicsRunner::~PhysicsRunner()
+{
+    stop();
+    
+    if (_thread)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _stepCondition.notify_one();
+        _thread->join();
+        delete _thread;
+    }
+}
+
+void PhysicsRunner::start()
+{
+    if (isRunning()) return;
+    
+    if (!_thread)
+    {
+        _thread = new std::thread(&PhysicsRunner::_runThread, this);
+    }
+    
+    _accumulator = 0;
+    _alpha = 1;
+    // the transforms of the bodies are interpolated from where they are now
+    _utils->storePreviousTransforms();
+    _utils->storeCurrentTransforms();
+    if (_listener) _listener->setBatched(true);
+    
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    _afterUpdateListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+        _update(Director::getInstance()->getDeltaTime() * Director::getInstance()->getScheduler()->getTimeScale());
+    });
+    // the steps do not outlive the frame, the world is left to the main thread until the next update
+    _afterDrawListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        waitForStep();
+    });
+    // Director::reset removes all the listeners before destroying the runner
+    CC_SAFE_RETAIN(_afterUpdateListener);
+    CC_SAFE_RETAIN(_afterDrawListener);
+}
+
+void PhysicsRunner::stop()
+{
+    if (!isRunning()) return;
+    
+    waitForStep();
+    // the nodes are left where the bodies are
+    _utils->syncNode();
+    if (_listener) _listener->setBatched(false);
+    
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    eventDispatcher->removeEventListener(_afterUpdateListener);
+    CC_SAFE_RELEASE_NULL(_afterUpdateListener);
+    eventDispatcher->removeEventListener(_afterDrawListener);
+    CC_SAFE_RELEASE_NULL(_afterDrawListener);
+}
+
+bool PhysicsRunner::isRunning() const
+{
+    return _afterUpdateListener != nullptr;
+}
+
+void PhysicsRunner::setFixedTimeStep(float fixedTimeStep)
+{
+    CCASSERT(fixedTimeStep > 0, "The fixed time step should be greater than 0.");
+    _fixedTimeStep = fixedTimeStep;
+}
+
+float PhysicsRunner::getFixedTimeStep() const
+{
+    return _fixedTimeStep;
+}
+
+void PhysicsRunner::setIterations(int velocityIterations, int positionIterations)
+{
+    _velocityIterations = velocityIterations;
+    _positionIterations = positionIterations;
+}
+
+void PhysicsRunner::setMaxSubSteps(int maxSubSteps)
+{
+    _maxSubSteps = maxSubSteps;
+}
+
+int PhysicsRunner::getMaxSubSteps() const
+{
+    return _maxSubSteps;
+}
+
+void PhysicsRunner::waitForStep()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _doneCondition.wait(lock, [this] { return !_stepping; });
+    }
+    
+    if (_listener && _listener->isBatched())
+    {
+        _listener->flushContacts(_world);
+    }
+    
+    if (__afterStepCallback)
+    {
+        __afterStepCallback(_world);
+    }
+}
+
+void PhysicsRunner::_update(float dt)
+{
+    waitForStep();
+    
+    // the nodes lag one batch of steps behind the world, they are interpolated from its last two steps
+    _utils->syncInterpolatedNode(_alpha);
+    
+    _accumulator += dt;
+    int steps = (int)(_accumulator / _fixedTimeStep);
+    if (steps > _maxSubSteps)
+    {
+        steps = _maxSubSteps;
+        _accumulator = _fixedTimeStep * steps;
+    }
+    _accumulator -= _fixedTimeStep * steps;
+    _alpha = _accumulator / _fixedTimeStep;
+    
+    if (steps == 0)
+    {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pendingSteps = steps;
+        _stepping = true;
+    }
+    _stepCondition.notify_one();
+}
+
+void PhysicsRunner::_runThread()
+{
+    while (true)
+    {
+        int steps;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _stepCondition.wait(lock, [this] { return _stopping || _pendingSteps > 0; });
+            if (_stopping) return;
+            
+            steps = _pendingSteps;
+            _pendingSteps = 0;
+        }
+        
+        for (int i = 0; i < steps; ++i)
+        {
+            if (i == steps - 1)
+            {
+                _utils->storePreviousTransforms();
+            }
+            _world->Step(_fixedTimeStep, _velocityIterations, _positionIterations);
+        }
+        _utils->storeCurrentTransforms();
+        
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stepping = false;
+        }
+        _doneCondition.notify_all();
+    }
+}
+
+}
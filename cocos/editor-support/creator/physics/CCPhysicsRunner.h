@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2013-2016 Chukong Technologies Inc.
+ 
+ http://www.cocos2d-x.org
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef PhysicsRunner_H
+#define PhysicsRunner_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "Box2D/Box2D.h"
+#include "cocos2d.h"
+
+#include "CCPhysicsUtils.h"
+#include "CCPhysicsContactListener.h"
+
+namespace creator {
+
+// Steps a b2World at a fixed timestep on a worker thread. The steps of a frame run from
+// Director::EVENT_AFTER_UPDATE to Director::EVENT_AFTER_DRAW, while the scene is visited and drawn,
+// so the scripts can use the world from their update callbacks. The nodes are synced at the next
+// EVENT_AFTER_UPDATE, interpolated between the last two steps, and the contacts are then delivered
+// by the listener on the main thread, batched.
+class CC_DLL PhysicsRunner
+{
+public:
+    PhysicsRunner(b2World* world, PhysicsUtils* utils, PhysicsContactListener* listener);
+    ~PhysicsRunner();
+    
+    void start();
+    void stop();
+    bool isRunning() const;
+    
+    void setFixedTimeStep(float fixedTimeStep);
+    float getFixedTimeStep() const;
+    void setIterations(int velocityIterations, int positionIterations);
+    // The steps of a frame are capped, the time left over is dropped.
+    void setMaxSubSteps(int maxSubSteps);
+    int getMaxSubSteps() const;
+    
+    // Waits for the steps of the frame, the world can then be used from the main thread.
+    void waitForStep();
+    
+    // Called on the main thread by waitForStep, once the contacts of the steps are delivered, so the
+    // bindings can release what the worker thread destroyed.
+    static void setAfterStepCallback(const std::function<void(b2World*)>& callback);
+    
+protected:
+    void _update(float dt);
+    void _runThread();
+    
+    static std::function<void(b2World*)> __afterStepCallback;
+    
+    b2World* _world;
+    PhysicsUtils* _utils;
+    PhysicsContactListener* _listener;
+    
+    float _fixedTimeStep;
+    int _velocityIterations;
+    int _positionIterations;
+    int _maxSubSteps;
+    float _accumulator;
+    float _alpha;
+    
+    cocos2d::EventListenerCustom* _afterUpdateListener;
+    cocos2d::EventListenerCustom* _afterDrawListener;
+    
+    std::thread* _thread;
+    std::mutex _mutex;
+    std::condition_variable _stepCondition;
+    std::condition_variable _doneCondition;
+    int _pendingSteps;
+    bool _stepping;
+    bool _stopping;
+};
+    
+}
+
+#endif
@@ -17,6 +17,7 @@ static PhysicsWorldManifoldWrapper _worldManifoldWrapper;
 static PhysicsManifoldWrapper _manifoldWrapper;
 
 PhysicsUtils::PhysicsUtils()
+: _syncIndex(0)
 {
     
 }
@@ -29,6 +30,18 @@ PhysicsUtils::~PhysicsUtils()
 void PhysicsUtils::addB2Body(b2Body* body)
 {
     _bodies.push_back(body);
+    
+    BodyState state;
+    state.position.SetZero();
+    state.angle = 0;
+    state.parent = nullptr;
+    state.synced = false;
+    state.previousPosition.SetZero();
+    state.previousAngle = 0;
+    state.currentPosition.SetZero();
+    state.currentAngle = 0;
+    state.hasTransforms = false;
+    _bodyStates.push_back(state);
 }
     
 void PhysicsUtils::removeB2Body(b2Body *body)
@@ -36,31 +49,137 @@ void PhysicsUtils::removeB2Body(b2Body *body)
     const auto iterator = std::find(_bodies.begin(), _bodies.end(), body);
     if (iterator != _bodies.end())
     {
+        _bodyStates.erase(_bodyStates.begin() + (iterator - _bodies.begin()));
         _bodies.erase(iterator);
     }
 }
     
 void PhysicsUtils::syncNode()
 {
-    for (auto begin = _bodies.begin(); begin != _bodies.end(); begin++)
+    _syncNode(false, 0);
+}
+
+void PhysicsUtils::syncInterpolatedNode(float alpha)
+{
+    _syncNode(true, alpha);
+}
+
+void PhysicsUtils::storePreviousTransforms()
+{
+    for (size_t i = 0, l = _bodies.size(); i < l; ++i)
+    {
+        BodyState& state = _bodyStates[i];
+        state.previousPosition = _bodies[i]->GetPosition();
+        state.previousAngle = _bodies[i]->GetAngle();
+    }
+}
+
+void PhysicsUtils::storeCurrentTransforms()
+{
+    for (size_t i = 0, l = _bodies.size(); i < l; ++i)
+    {
+        BodyState& state = _bodyStates[i];
+        state.currentPosition = _bodies[i]->GetPosition();
+        state.currentAngle = _bodies[i]->GetAngle();
+        state.hasTransforms = true;
+    }
+}
+
+void PhysicsUtils::_syncNode(bool interpolate, float alpha)
+{
+    ++_syncIndex;
+    
+    Node* lastParent = nullptr;
+    const ParentSpace* lastParentSpace = nullptr;
+    
+    for (size_t i = 0, l = _bodies.size(); i < l; ++i)
     {
-        b2Body* body = *begin;
+        b2Body* body = _bodies[i];
+        BodyState& state = _bodyStates[i];
         Node* node = (Node*)body->GetUserData();
+        Node* parent = node->getParent();
+        
+        // the bodies of a parent are mostly consecutive, its space is looked up once for them
+        const bool isInScene = parent && parent->getParent();
+        if (isInScene && parent != lastParent) {
+            lastParent = parent;
+            lastParentSpace = &_getParentSpace(parent);
+        }
+        
+        // a sleeping body keeps its transform, SetTransform does not wake it so its transform is compared too
+        b2Vec2 pos = body->GetPosition();
+        float bodyAngle = body->GetAngle();
+        if (interpolate && state.hasTransforms) {
+            pos = state.previousPosition + alpha * (state.currentPosition - state.previousPosition);
+            bodyAngle = state.previousAngle + alpha * (state.currentAngle - state.previousAngle);
+        }
+        
+        const bool parentChanged = state.parent != parent || (isInScene && lastParentSpace->changed);
+        if (state.synced && !parentChanged && state.position == pos && state.angle == bodyAngle) {
+            continue;
+        }
         
-        const b2Vec2& pos = body->GetPosition();
+        state.position = pos;
+        state.angle = bodyAngle;
+        state.parent = parent;
+        state.synced = true;
         
         Vec2 position(pos.x*CC_PTM_RATIO, pos.y*CC_PTM_RATIO);
-        float angle = -CC_RADIANS_TO_DEGREES(body->GetAngle());
+        float angle = -CC_RADIANS_TO_DEGREES(bodyAngle);
         
-        if (node->getParent() && node->getParent()->getParent()) {
-            node->setPosition( _convertToNodePosition(node->getParent(), position) );
-            node->setRotation( _convertToNodeRotation(node->getParent(), angle) );
+        if (isInScene) {
+            Vec3 nodePosition;
+            lastParentSpace->worldToNode.transformPoint(Vec3(position.x, position.y, 0), &nodePosition);
+            node->setPosition(nodePosition.x, nodePosition.y);
+            node->setRotation(angle - lastParentSpace->rotation);
         }
         else {
             node->setPosition(position);
             node->setRotation(angle);
         }
     }
+    
+    // forget the parents no body used in this sync
+    for (auto iterator = _parentSpaces.begin(); iterator != _parentSpaces.end();)
+    {
+        if (iterator->second.syncIndex != _syncIndex) {
+            iterator = _parentSpaces.erase(iterator);
+        }
+        else {
+            ++iterator;
+        }
+    }
+}
+
+const PhysicsUtils::ParentSpace& PhysicsUtils::_getParentSpace(cocos2d::Node* parent)
+{
+    auto iterator = _parentSpaces.find(parent);
+    if (iterator != _parentSpaces.end() && iterator->second.syncIndex == _syncIndex) {
+        return iterator->second;
+    }
+    
+    const Mat4 nodeToWorld = parent->getNodeToWorldTransform();
+    if (iterator != _parentSpaces.end() && memcmp(iterator->second.nodeToWorld.m, nodeToWorld.m, sizeof(nodeToWorld.m)) == 0) {
+        iterator->second.syncIndex = _syncIndex;
+        iterator->second.changed = false;
+        return iterator->second;
+    }
+    
+    ParentSpace& space = _parentSpaces[parent];
+    space.nodeToWorld = nodeToWorld;
+    space.worldToNode = nodeToWorld.getInversed();
+    if (!parent->isIgnoreAnchorPointForPosition()) {
+        // see _convertToNodePosition
+        const Vec2& anchor = parent->getAnchorPointInPoints();
+        Mat4 toAnchor;
+        Mat4::createTranslation(-anchor.x, -anchor.y, 0, &toAnchor);
+        space.worldToNode = toAnchor * space.worldToNode;
+    }
+    space.rotation = -_convertToNodeRotation(parent, 0);
+    space.syncIndex = _syncIndex;
+    space.changed = true;
+    
+    return space;
 }
     
 const PhysicsWorldManifoldWrapper* PhysicsUtils::getContactWorldManifoldWrapper(b2Contact* contact)
@@ -25,6 +25,7 @@
 #ifndef PhysicsUtils_H
 #define PhysicsUtils_H
 
+#include <unordered_map>
 #include <vector>
 
 #include "Box2D/Box2D.h"
@@ -47,15 +48,53 @@ public:
     void addB2Body(b2Body* body);
     void removeB2Body(b2Body* body);
     
+    // Copies the body transforms to their nodes. The parent spaces are computed once per parent and sync,
+    // and the bodies that did not move under an unchanged parent since the last sync are skipped.
     void syncNode();
+    // Like syncNode, with the transforms interpolated between the two stored by storePreviousTransforms and storeCurrentTransforms,
+    // used by PhysicsRunner. The bodies added since then are synced with their own transform.
+    void syncInterpolatedNode(float alpha);
+    // Copy the body transforms to the buffers read by syncInterpolatedNode, PhysicsRunner calls them on its thread
+    // before and after the last step of a batch.
+    void storePreviousTransforms();
+    void storeCurrentTransforms();
 public:
     static const PhysicsWorldManifoldWrapper* getContactWorldManifoldWrapper(b2Contact* contact);
     static const PhysicsManifoldWrapper* getContactManifoldWrapper(b2Contact* contact);
 protected:
+    struct BodyState
+    {
+        b2Vec2 position;
+        float angle;
+        cocos2d::Node* parent;
+        bool synced;
+        
+        b2Vec2 previousPosition;
+        float previousAngle;
+        b2Vec2 currentPosition;
+        float currentAngle;
+        bool hasTransforms;
+    };
+    
+    struct ParentSpace
+    {
+        cocos2d::Mat4 nodeToWorld;
+        // from the world to the parent, or to its anchor point when the anchor point is not ignored for position
+        cocos2d::Mat4 worldToNode;
+        float rotation;
+        unsigned syncIndex;
+        bool changed;
+    };
+    
     cocos2d::Vec2 _convertToNodePosition(cocos2d::Node* node, cocos2d::Vec2& position);
     float _convertToNodeRotation(cocos2d::Node* node, float rotation);
+    const ParentSpace& _getParentSpace(cocos2d::Node* parent);
+    void _syncNode(bool interpolate, float alpha);
     
     std::vector<b2Body*> _bodies;
+    std::vector<BodyState> _bodyStates;
+    std::unordered_map<cocos2d::Node*, ParentSpace> _parentSpaces;
+    unsigned _syncIndex;
 };
     
 }
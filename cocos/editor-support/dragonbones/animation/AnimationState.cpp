@@ -364,7 +364,7 @@ void AnimationState::_advanceTime(float passedTime, float weightLeft, int index)
 
     if (_weightResult != 0.f)
     {
-        const auto isCacheEnabled = _fadeProgress >= 1.f && index == 0 && _armature->getCacheFrameRate() > 0;
+        const auto isCacheEnabled = _fadeProgress >= 1.f && index == 0 && _armature->getCacheFrameRate() > 0 && !_animationData->cachedFrames.empty();
         const auto cacheTimeToFrameScale = _animationData->cacheTimeToFrameScale;
         auto isUpdatesTimeline = true;
         auto isUpdatesBoneTimeline = true;
@@ -24,6 +24,11 @@ void AnimationTimelineState::_onClear()
 
 void AnimationTimelineState::_onCrossFrame(AnimationFrameData* frame)
 {
+    if (this->_armature->_lockActionAndEvent)
+    {
+        return;
+    }
+
     if (this->_animationState->actionEnabled)
     {
         for (const auto actionData : frame->actions)
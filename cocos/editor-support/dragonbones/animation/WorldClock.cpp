@@ -1,4 +1,5 @@
 #include "WorldClock.h"
+#include "../armature/Armature.h"
 
 DRAGONBONES_NAMESPACE_BEGIN
 
@@ -7,16 +8,37 @@ WorldClock WorldClock::clock;
 WorldClock::WorldClock():
     time(0.f),
     timeScale(1.f),
-    _animatebles()
+    parallelThreshold(0),
+    _animatebles(),
+    _parallelPassedTime(0.f),
+    _nextParallelGroup(0),
+    _pendingThreads(0),
+    _parallelRound(0),
+    _stopping(false)
 {
 }
 WorldClock::~WorldClock()
 {
     clear();
+
+    {
+        std::lock_guard<std::mutex> lock(_threadMutex);
+        _stopping = true;
+    }
+
+    _startCondition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
 }
 
 void WorldClock::advanceTime(float passedTime)
 {
+    // Returned by the workers of the last frame or by other worker threads.
+    BaseObject::returnDeferredObjects();
+
     if (passedTime < 0 || passedTime != passedTime)
     {
         passedTime = 0;
@@ -33,7 +55,11 @@ void WorldClock::advanceTime(float passedTime)
         time += passedTime;
     }
 
-    if (passedTime)
+    if (passedTime && parallelThreshold > 0)
+    {
+        _advanceParallel(passedTime);
+    }
+    else if (passedTime)
     {
         std::size_t i = 0, r = 0, l = _animatebles.size();
 
@@ -108,4 +134,136 @@ void WorldClock::clear()
     }
 }
 
+void WorldClock::_advanceParallel(float passedTime)
+{
+    _animatebles.erase(std::remove(_animatebles.begin(), _animatebles.end(), nullptr), _animatebles.end());
+
+    _parallelArmatures.clear();
+    for (const auto animateble : _animatebles)
+    {
+        const auto armature = dynamic_cast<Armature*>(animateble);
+        if (armature)
+        {
+            _parallelArmatures.push_back(armature);
+        }
+    }
+
+    // The armatures of the same data fill the same frame caches, a group of them is advanced by one thread.
+    std::stable_sort(_parallelArmatures.begin(), _parallelArmatures.end(), [](const Armature* a, const Armature* b)
+    {
+        return std::less<const ArmatureData*>()(a->_armatureData, b->_armatureData);
+    });
+
+    _parallelGroups.clear();
+    for (std::size_t i = 0, l = _parallelArmatures.size(); i < l; ++i)
+    {
+        if (i == 0 || _parallelArmatures[i]->_armatureData != _parallelArmatures[i - 1]->_armatureData)
+        {
+            _parallelGroups.push_back(i);
+        }
+    }
+
+    _parallelGroups.push_back(_parallelArmatures.size());
+    _parallelPassedTime = passedTime;
+    _nextParallelGroup = 0;
+
+    if (_animatebles.size() >= parallelThreshold && _parallelGroups.size() > 2)
+    {
+        if (_threads.empty())
+        {
+            const auto threadCount = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+            for (int i = 0; i < threadCount; ++i)
+            {
+                _threads.push_back(std::thread(&WorldClock::_runThread, this));
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_threadMutex);
+            _pendingThreads = _threads.size();
+            _parallelRound++;
+        }
+
+        _startCondition.notify_all();
+        _advanceParallelGroups();
+
+        {
+            std::unique_lock<std::mutex> lock(_threadMutex);
+            _finishCondition.wait(lock, [this] { return _pendingThreads == 0; });
+        }
+
+        // The animation states and the events the workers returned, before the slots and the listeners use the pools.
+        BaseObject::returnDeferredObjects();
+    }
+    else
+    {
+        _advanceParallelGroups();
+    }
+
+    // An event listener may remove or dispose any armature, the removed ones are skipped.
+    for (std::size_t i = 0, l = _animatebles.size(); i < l; ++i)
+    {
+        const auto animateble = _animatebles[i];
+        if (!animateble)
+        {
+            continue;
+        }
+
+        const auto armature = dynamic_cast<Armature*>(animateble);
+        if (armature)
+        {
+            armature->_advanceSlots(passedTime);
+        }
+        else
+        {
+            animateble->advanceTime(passedTime);
+        }
+    }
+
+    _parallelArmatures.clear();
+}
+
+void WorldClock::_advanceParallelGroups()
+{
+    const auto groupCount = _parallelGroups.size() - 1;
+    for (auto i = _nextParallelGroup++; i < groupCount; i = _nextParallelGroup++)
+    {
+        for (auto j = _parallelGroups[i], l = _parallelGroups[i + 1]; j < l; ++j)
+        {
+            _parallelArmatures[j]->_advanceBones(_parallelPassedTime);
+        }
+    }
+}
+
+void WorldClock::_runThread()
+{
+    unsigned round = 0;
+    while (true)
+    {
+        bool stopping;
+        {
+            std::unique_lock<std::mutex> lock(_threadMutex);
+            _startCondition.wait(lock, [this, round] { return _stopping || _parallelRound != round; });
+            stopping = _stopping;
+            round = _parallelRound;
+        }
+
+        if (stopping)
+        {
+            // The objects this thread kept go back to the shared pools, they are not lost with the thread.
+            BaseObject::flushThreadPool();
+            return;
+        }
+
+        // The thread pool hands its objects to the shared pool past its capacity, it is not flushed after each round.
+        _advanceParallelGroups();
+
+        std::lock_guard<std::mutex> lock(_threadMutex);
+        if (--_pendingThreads == 0)
+        {
+            _finishCondition.notify_all();
+        }
+    }
+}
+
 DRAGONBONES_NAMESPACE_END
@@ -3,8 +3,15 @@
 
 #include "../core/DragonBones.h"
 #include "IAnimateble.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 DRAGONBONES_NAMESPACE_BEGIN
+
+class Armature;
+
 class WorldClock final : public IAnimateble
 {
 public:
@@ -13,9 +20,26 @@ public:
 public:
     float time;
     float timeScale;
+    /**
+     * When the clock holds at least this many animatebles, the animations and the bones of its armatures are advanced on worker threads,
+     * the armatures of the same data on the same thread. The slots, the child armatures, the events and the actions stay on the calling thread.
+     * 0 (default) advances everything on the calling thread.
+     */
+    std::size_t parallelThreshold;
 
 private:
     std::vector<IAnimateble*> _animatebles;
+    std::vector<Armature*> _parallelArmatures;
+    std::vector<std::size_t> _parallelGroups;
+    float _parallelPassedTime;
+    std::atomic<std::size_t> _nextParallelGroup;
+    std::size_t _pendingThreads;
+    unsigned _parallelRound;
+    bool _stopping;
+    std::vector<std::thread> _threads;
+    std::mutex _threadMutex;
+    std::condition_variable _startCondition;
+    std::condition_variable _finishCondition;
 
 public:
     WorldClock();
@@ -29,6 +53,10 @@ public:
 
 private:
     DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(WorldClock);
+
+    void _advanceParallel(float passedTime);
+    void _advanceParallelGroups();
+    void _runThread();
 };
 
 DRAGONBONES_NAMESPACE_END
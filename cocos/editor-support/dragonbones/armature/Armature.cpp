@@ -223,6 +223,12 @@ void Armature::dispose()
 }
 
 void Armature::advanceTime(float passedTime)
+{
+    _advanceBones(passedTime);
+    _advanceSlots(passedTime);
+}
+
+void Armature::_advanceBones(float passedTime)
 {
     if (!_animation) 
     {
@@ -241,6 +247,17 @@ void Armature::advanceTime(float passedTime)
         _sortBones();
     }
 
+    //
+    for (const auto bone : _bones)
+    {
+        bone->_update(_cacheFrameIndex);
+    }
+}
+
+void Armature::_advanceSlots(float passedTime)
+{
+    const auto scaledPassedTime = passedTime * _animation->timeScale;
+
     if (_slotsDirty)
     {
         _slotsDirty = false;
@@ -248,11 +265,6 @@ void Armature::advanceTime(float passedTime)
     }
 
     //
-    for (const auto bone : _bones)
-    {
-        bone->_update(_cacheFrameIndex);
-    }
-
     for (const auto slot : _slots)
     {
         slot->_update(_cacheFrameIndex);
@@ -39,11 +39,12 @@ public: // private
     void* _replacedTexture;
     /** @private */
     Slot* _parent;
+    /** @private */
+    bool _lockActionAndEvent;
 
 protected:
     bool _delayDispose;
     bool _lockDispose;
-    bool _lockActionAndEvent;
     bool _slotsDirty;
     std::vector<Bone*> _bones;
     std::vector<Slot*> _slots;
@@ -78,6 +79,10 @@ public:
     void _bufferAction(ActionData* value);
     /** @private */
     void _bufferEvent(EventObject* value, const std::string& type);
+    /** @private Advances the animation and the bones, it touches no display and may run on a worker thread. */
+    void _advanceBones(float passedTime);
+    /** @private Advances the slots and the child armatures and dispatches the events and the actions. */
+    void _advanceSlots(float passedTime);
 
 public:
     void dispose();
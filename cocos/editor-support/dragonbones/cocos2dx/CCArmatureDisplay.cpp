@@ -22,13 +22,20 @@ CCArmatureDisplay* CCArmatureDisplay::create()
 CCArmatureDisplay::CCArmatureDisplay() :
     _armature(nullptr),
     _dispatcher(nullptr),
+    _batchEnabled(false),
     _eventCallback(nullptr)
 {
     _dispatcher = new cocos2d::EventDispatcher();
     this->setEventDispatcher(_dispatcher);
     _dispatcher->setEnabled(true);
 }
-CCArmatureDisplay::~CCArmatureDisplay() {}
+CCArmatureDisplay::~CCArmatureDisplay()
+{
+    for (auto command : _batchCommands)
+    {
+        delete command;
+    }
+}
 
 // cleared by armature
 void CCArmatureDisplay::_onClear()
@@ -77,6 +84,177 @@ void CCArmatureDisplay::advanceTimeBySelf(bool on)
     }
 }
 
+void CCArmatureDisplay::visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (!_batchEnabled)
+    {
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+
+    if (!_visible)
+    {
+        return;
+    }
+
+    if (_beforeVisitCallback && *_beforeVisitCallback) {
+        (*_beforeVisitCallback)(renderer);
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+
+    _director->pushMatrix(cocos2d::MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    _director->loadMatrix(cocos2d::MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+
+    auto camera = creator::CameraNode::getInstance();
+    if (camera) {
+        if (camera->visitingIndex <= 0) {
+            if (_cameraMask > 0) {
+                camera->visitingIndex ++;
+            }
+        }
+        else {
+            camera->visitingIndex ++;
+        }
+    }
+
+    _batchItems.clear();
+    _batchVertices.clear();
+    _batchIndices.clear();
+    _collectBatch(this, cocos2d::Mat4::IDENTITY);
+    _drawBatch(renderer, flags);
+
+    if (camera && camera->visitingIndex > 0) {
+        camera->visitingIndex --;
+    }
+
+    _director->popMatrix(cocos2d::MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+
+    if (_afterVisitCallback && *_afterVisitCallback) {
+        (*_afterVisitCallback)(renderer);
+    }
+}
+
+void CCArmatureDisplay::_collectBatch(CCArmatureDisplay* display, const cocos2d::Mat4& transform)
+{
+    // the order of the children is the z-order of the slots
+    display->sortAllChildren();
+
+    for (const auto child : display->getChildren())
+    {
+        if (!child->isVisible())
+        {
+            continue;
+        }
+
+        const auto sprite = dynamic_cast<DBCCSprite*>(child);
+        if (sprite)
+        {
+            _appendSprite(sprite, transform * sprite->getNodeToParentTransform());
+            continue;
+        }
+
+        const auto childArmatureDisplay = dynamic_cast<CCArmatureDisplay*>(child);
+        if (childArmatureDisplay)
+        {
+            _collectBatch(childArmatureDisplay, transform * childArmatureDisplay->getNodeToParentTransform());
+            continue;
+        }
+
+        BatchItem item;
+        item.node = child;
+        item.transform = transform;
+        _batchItems.push_back(item);
+    }
+}
+
+void CCArmatureDisplay::_appendSprite(cocos2d::Sprite* sprite, const cocos2d::Mat4& transform)
+{
+    const auto& triangles = sprite->getPolygonInfo().triangles;
+    if (triangles.vertCount <= 0 || triangles.indexCount <= 0)
+    {
+        return;
+    }
+
+    const auto texture = sprite->getTexture();
+    const auto glProgramState = sprite->getGLProgramState();
+    const auto& blendFunc = sprite->getBlendFunc();
+    const auto globalZOrder = sprite->getGlobalZOrder();
+    const auto vertexCount = (int)triangles.vertCount;
+    const auto indexCount = (int)triangles.indexCount;
+
+    // the renderer asserts that a command holds less vertices and indices than its buffers
+    auto item = _batchItems.empty() ? nullptr : &_batchItems.back();
+    if (
+        !item || item->node || item->texture != texture || item->glProgramState != glProgramState ||
+        item->blendFunc != blendFunc || item->globalZOrder != globalZOrder ||
+        item->vertexCount + vertexCount >= cocos2d::Renderer::VBO_SIZE ||
+        item->indexCount + indexCount >= cocos2d::Renderer::INDEX_VBO_SIZE
+    )
+    {
+        _batchItems.emplace_back();
+        item = &_batchItems.back();
+        item->node = nullptr;
+        item->texture = texture;
+        item->glProgramState = glProgramState;
+        item->blendFunc = blendFunc;
+        item->globalZOrder = globalZOrder;
+        item->vertexStart = (int)_batchVertices.size();
+        item->vertexCount = 0;
+        item->indexStart = (int)_batchIndices.size();
+        item->indexCount = 0;
+    }
+
+    const auto m = transform.m;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        auto vertex = triangles.verts[i];
+        const auto x = vertex.vertices.x;
+        const auto y = vertex.vertices.y;
+        vertex.vertices.x = m[0] * x + m[4] * y + m[12];
+        vertex.vertices.y = m[1] * x + m[5] * y + m[13];
+        vertex.vertices.z = m[2] * x + m[6] * y + m[14];
+        _batchVertices.push_back(vertex);
+    }
+
+    const auto offset = (unsigned short)item->vertexCount;
+    for (int i = 0; i < indexCount; ++i)
+    {
+        _batchIndices.push_back(triangles.indices[i] + offset);
+    }
+
+    item->vertexCount += vertexCount;
+    item->indexCount += indexCount;
+}
+
+void CCArmatureDisplay::_drawBatch(cocos2d::Renderer* renderer, uint32_t flags)
+{
+    // commands are only created once the buffers are complete, they point into them
+    std::size_t commandIndex = 0;
+    for (const auto& item : _batchItems)
+    {
+        if (item.node)
+        {
+            item.node->visit(renderer, _modelViewTransform * item.transform, flags);
+            continue;
+        }
+
+        if (commandIndex == _batchCommands.size())
+        {
+            _batchCommands.push_back(new cocos2d::TrianglesCommand());
+        }
+
+        const auto command = _batchCommands[commandIndex++];
+        cocos2d::TrianglesCommand::Triangles triangles;
+        triangles.verts = _batchVertices.data() + item.vertexStart;
+        triangles.vertCount = item.vertexCount;
+        triangles.indices = _batchIndices.data() + item.indexStart;
+        triangles.indexCount = item.indexCount;
+        command->init(item.globalZOrder, item.texture, item.glProgramState, item.blendFunc, triangles, _modelViewTransform, flags);
+        renderer->addCommand(command);
+    }
+}
+
 void CCArmatureDisplay::addEvent(const std::string& type, const std::function<void(EventObject*)>& callback)
 {
     auto lambda = [callback](cocos2d::EventCustom* event) -> void {
@@ -19,6 +19,32 @@ public:
 protected:
     cocos2d::EventDispatcher* _dispatcher;
 
+    /** @private A run of slot vertices drawn with one command, or a child node that is not a slot display. */
+    struct BatchItem
+    {
+        cocos2d::Node* node;
+        cocos2d::Mat4 transform;
+        cocos2d::Texture2D* texture;
+        cocos2d::GLProgramState* glProgramState;
+        cocos2d::BlendFunc blendFunc;
+        float globalZOrder;
+        int vertexStart;
+        int vertexCount;
+        int indexStart;
+        int indexCount;
+    };
+
+    bool _batchEnabled;
+    std::vector<BatchItem> _batchItems;
+    std::vector<cocos2d::V3F_C4B_T2F> _batchVertices;
+    std::vector<unsigned short> _batchIndices;
+    std::vector<cocos2d::TrianglesCommand*> _batchCommands;
+
+    /** @private Appends the slot displays of an armature, transform maps its node space to the one of this display. */
+    void _collectBatch(CCArmatureDisplay* display, const cocos2d::Mat4& transform);
+    void _appendSprite(cocos2d::Sprite* sprite, const cocos2d::Mat4& transform);
+    void _drawBatch(cocos2d::Renderer* renderer, uint32_t flags);
+
 protected:
     CCArmatureDisplay();
     virtual ~CCArmatureDisplay();
@@ -38,6 +64,17 @@ public:
 
 public:
     virtual void advanceTimeBySelf(bool on) override;
+
+    /**
+     * Draws the slots in one vertex buffer instead of visiting a sprite per slot, false by default.
+     * The slot vertices are transformed by the slot matrices into the space of this display, in the z-order of the slots,
+     * and a command is only started when the texture, the blend function or the shader changes. The slots of the child
+     * armatures are drawn in the same buffer, other children are visited at their place in the z-order.
+     */
+    void setBatchEnabled(bool enabled) { _batchEnabled = enabled; }
+    bool isBatchEnabled() const { return _batchEnabled; }
+
+    virtual void visit(cocos2d::Renderer* renderer, const cocos2d::Mat4& parentTransform, uint32_t parentFlags) override;
     
     void addEvent(const std::string& type, const std::function<void(EventObject*)>& callback);
     void removeEvent(const std::string& type);
@@ -7,7 +7,8 @@ DRAGONBONES_NAMESPACE_BEGIN
 
 CCFactory CCFactory::factory;
 
-CCFactory::CCFactory() 
+CCFactory::CCFactory() :
+    _asyncHandle(std::make_shared<CCFactory*>(this))
 {
     if (!EventObject::_soundEventManager) 
     {
@@ -19,6 +20,7 @@ CCFactory::CCFactory()
 }
 CCFactory::~CCFactory() 
 {
+    _asyncHandle.reset();
     clear();
 }
 
@@ -139,8 +141,16 @@ DragonBonesData* CCFactory::loadDragonBonesData(const std::string& filePath, con
         return nullptr;
     }
 
+    // Binary data is checked against the length of the file.
     const auto scale = cocos2d::Director::getInstance()->getContentScaleFactor();
-    return this->parseDragonBonesData(data.c_str(), dragonBonesName, 1.f / scale);
+    const auto dataParser = _dataParser ? _dataParser : &_defaultDataParser;
+    const auto binaryDataParser = dynamic_cast<BinaryDataParser*>(dataParser);
+    const auto dragonBonesData = binaryDataParser ?
+        binaryDataParser->parseDragonBonesData(data.c_str(), data.size(), 1.f / scale) :
+        dataParser->parseDragonBonesData(data.c_str(), 1.f / scale);
+    this->addDragonBonesData(dragonBonesData, dragonBonesName);
+
+    return dragonBonesData;
 }
 
 TextureAtlasData* CCFactory::loadTextureAtlasData(const std::string& filePath, const std::string& dragonBonesName, float scale)
@@ -183,39 +193,7 @@ void CCFactory::_initTextureAtlasData(TextureAtlasData* atlasData)
     if (!texture)
     {
         const auto defaultPixelFormat = cocos2d::Texture2D::getDefaultAlphaPixelFormat();
-        auto pixelFormat = defaultPixelFormat;
-        switch (atlasData->format)
-        {
-            case TextureFormat::RGBA8888:
-                pixelFormat = cocos2d::Texture2D::PixelFormat::RGBA8888;
-                break;
-                
-            case TextureFormat::BGRA8888:
-                pixelFormat = cocos2d::Texture2D::PixelFormat::BGRA8888;
-                break;
-                
-            case TextureFormat::RGBA4444:
-                pixelFormat = cocos2d::Texture2D::PixelFormat::RGBA4444;
-                break;
-                
-            case TextureFormat::RGB888:
-                pixelFormat = cocos2d::Texture2D::PixelFormat::RGB888;
-                break;
-                
-            case TextureFormat::RGB565:
-                pixelFormat = cocos2d::Texture2D::PixelFormat::RGB565;
-                break;
-                
-            case TextureFormat::RGBA5551:
-                pixelFormat = cocos2d::Texture2D::PixelFormat::RGB5A1;
-                break;
-                
-            case TextureFormat::DEFAULT:
-            default:
-                break;
-        }
-        
-        cocos2d::Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+        cocos2d::Texture2D::setDefaultAlphaPixelFormat(_getPixelFormat(atlasData->format));
         texture = textureCache->addImage(atlasData->imagePath);
         cocos2d::Texture2D::setDefaultAlphaPixelFormat(defaultPixelFormat);
     }
@@ -223,6 +201,34 @@ void CCFactory::_initTextureAtlasData(TextureAtlasData* atlasData)
     static_cast<CCTextureAtlasData*>(atlasData)->texture = texture;
 }
 
+cocos2d::Texture2D::PixelFormat CCFactory::_getPixelFormat(TextureFormat format) const
+{
+    switch (format)
+    {
+        case TextureFormat::RGBA8888:
+            return cocos2d::Texture2D::PixelFormat::RGBA8888;
+            
+        case TextureFormat::BGRA8888:
+            return cocos2d::Texture2D::PixelFormat::BGRA8888;
+            
+        case TextureFormat::RGBA4444:
+            return cocos2d::Texture2D::PixelFormat::RGBA4444;
+            
+        case TextureFormat::RGB888:
+            return cocos2d::Texture2D::PixelFormat::RGB888;
+            
+        case TextureFormat::RGB565:
+            return cocos2d::Texture2D::PixelFormat::RGB565;
+            
+        case TextureFormat::RGBA5551:
+            return cocos2d::Texture2D::PixelFormat::RGB5A1;
+            
+        case TextureFormat::DEFAULT:
+        default:
+            return cocos2d::Texture2D::getDefaultAlphaPixelFormat();
+    }
+}
+
 CCArmatureDisplay * CCFactory::buildArmatureDisplay(const std::string& armatureName, const std::string& dragonBonesName, const std::string& skinName) const
 {
     const auto armature = this->buildArmature(armatureName, dragonBonesName, skinName);
@@ -261,4 +267,224 @@ CCArmatureDisplay* CCFactory::getSoundEventManater() const
     return dynamic_cast<CCArmatureDisplay*>(static_cast<IArmatureDisplay*>(EventObject::_soundEventManager));
 }
 
+void CCFactory::bakeDragonBonesDataAsync(const std::string& dragonBonesName, unsigned frameRate, const std::function<void(std::size_t)>& callback)
+{
+    const auto data = this->getDragonBonesData(dragonBonesName);
+    if (!data)
+    {
+        if (callback)
+        {
+            callback(0);
+        }
+
+        return;
+    }
+
+    // Removing the data or clearing the factory cancels the bake, or waits for it when it is running.
+    const auto task = this->_addBakeTask(*data, frameRate);
+    const auto bakedMemory = std::make_shared<std::size_t>(0);
+    cocos2d::AsyncTaskPool::getInstance()->enqueue(
+        cocos2d::AsyncTaskPool::TaskType::TASK_OTHER,
+        [this, task, callback, bakedMemory](void*)
+        {
+            // Only cancelled on the main thread, the factory is not touched once it was.
+            if (task->cancelled)
+            {
+                return;
+            }
+
+            this->_removeBakeTask(task);
+
+            if (callback)
+            {
+                callback(*bakedMemory);
+            }
+        },
+        nullptr,
+        [task, bakedMemory]()
+        {
+            *bakedMemory = _runBakeTask(*task);
+            // The pool threads outlive the task, the objects it kept go back to the shared pools.
+            BaseObject::flushThreadPool();
+        }
+    );
+}
+
+void CCFactory::loadDragonBonesDataAsync(const std::string& filePath, const std::string& dragonBonesName, const std::function<void(DragonBonesData*)>& callback)
+{
+    if (!dragonBonesName.empty())
+    {
+        const auto existedData = this->getDragonBonesData(dragonBonesName);
+        if (existedData)
+        {
+            if (callback)
+            {
+                callback(existedData);
+            }
+
+            return;
+        }
+    }
+
+    const auto fullpath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    const auto scale = cocos2d::Director::getInstance()->getContentScaleFactor();
+    const auto result = std::make_shared<DragonBonesData*>(nullptr);
+    const std::weak_ptr<CCFactory*> handle = _asyncHandle;
+    cocos2d::AsyncTaskPool::getInstance()->enqueue(
+        cocos2d::AsyncTaskPool::TaskType::TASK_IO,
+        [handle, dragonBonesName, callback, result](void*)
+        {
+            auto data = *result;
+            const auto factory = handle.lock();
+            if (!factory)
+            {
+                if (data)
+                {
+                    data->returnToPool();
+                }
+
+                return;
+            }
+
+            if (data)
+            {
+                // The same data may have been loaded while this one was parsed.
+                const auto existedData = (*factory)->getDragonBonesData(dragonBonesName.empty() ? data->name : dragonBonesName);
+                if (existedData)
+                {
+                    data->returnToPool();
+                    data = existedData;
+                }
+                else
+                {
+                    (*factory)->addDragonBonesData(data, dragonBonesName);
+                }
+            }
+
+            if (callback)
+            {
+                callback(data);
+            }
+        },
+        nullptr,
+        [fullpath, scale, result]()
+        {
+            const auto rawData = cocos2d::FileUtils::getInstance()->getStringFromFile(fullpath);
+            if (!rawData.empty())
+            {
+                // The parsers keep state while parsing, each task uses its own.
+                BinaryDataParser dataParser;
+                *result = dataParser.parseDragonBonesData(rawData.c_str(), rawData.size(), 1.f / scale);
+            }
+
+            BaseObject::flushThreadPool();
+        }
+    );
+}
+
+void CCFactory::loadTextureAtlasDataAsync(const std::string& filePath, const std::string& dragonBonesName, float scale, const std::function<void(TextureAtlasData*)>& callback)
+{
+    const auto fullpath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    const auto result = std::make_shared<TextureAtlasData*>(nullptr);
+    const std::weak_ptr<CCFactory*> handle = _asyncHandle;
+    cocos2d::AsyncTaskPool::getInstance()->enqueue(
+        cocos2d::AsyncTaskPool::TaskType::TASK_IO,
+        [handle, filePath, dragonBonesName, callback, result](void*)
+        {
+            const auto textureAtlasData = *result;
+            const auto factory = handle.lock();
+            if (!factory)
+            {
+                if (textureAtlasData)
+                {
+                    textureAtlasData->returnToPool();
+                }
+
+                return;
+            }
+
+            if (!textureAtlasData)
+            {
+                if (callback)
+                {
+                    callback(nullptr);
+                }
+
+                return;
+            }
+
+            const auto pos = filePath.find_last_of("/");
+            if (std::string::npos != pos)
+            {
+                const auto basePath = filePath.substr(0, pos + 1);
+                textureAtlasData->imagePath = basePath + textureAtlasData->imagePath;
+            }
+
+            const auto onTextureLoaded = [handle, textureAtlasData, dragonBonesName, callback](cocos2d::Texture2D* texture)
+            {
+                const auto factory = handle.lock();
+                if (!factory)
+                {
+                    textureAtlasData->returnToPool();
+                    return;
+                }
+
+                static_cast<CCTextureAtlasData*>(textureAtlasData)->texture = texture;
+                (*factory)->addTextureAtlasData(textureAtlasData, dragonBonesName);
+
+                if (callback)
+                {
+                    callback(textureAtlasData);
+                }
+            };
+
+            const auto textureCache = cocos2d::Director::getInstance()->getTextureCache();
+            const auto texture = textureCache->getTextureForKey(textureAtlasData->imagePath);
+            if (texture)
+            {
+                onTextureLoaded(texture);
+            }
+            else
+            {
+                // The texture cache takes the pixel format when the image is queued.
+                const auto defaultPixelFormat = cocos2d::Texture2D::getDefaultAlphaPixelFormat();
+                cocos2d::Texture2D::setDefaultAlphaPixelFormat((*factory)->_getPixelFormat(textureAtlasData->format));
+                textureCache->addImageAsync(textureAtlasData->imagePath, onTextureLoaded);
+                cocos2d::Texture2D::setDefaultAlphaPixelFormat(defaultPixelFormat);
+            }
+        },
+        nullptr,
+        [fullpath, scale, result]()
+        {
+            const auto rawData = cocos2d::FileUtils::getInstance()->getStringFromFile(fullpath);
+            if (!rawData.empty())
+            {
+                // Borrowed as _generateTextureAtlasData does, without touching the factory on this thread.
+                const auto textureAtlasData = BaseObject::borrowObject<CCTextureAtlasData>();
+                BinaryDataParser dataParser;
+                dataParser.parseTextureAtlasData(rawData.c_str(), *textureAtlasData, scale);
+                *result = textureAtlasData;
+            }
+
+            BaseObject::flushThreadPool();
+        }
+    );
+}
+
+bool CCFactory::convertDragonBonesData(const std::string& filePath, const std::string& binaryFilePath)
+{
+    const auto fullpath = cocos2d::FileUtils::getInstance()->fullPathForFilename(filePath);
+    const auto rawData = cocos2d::FileUtils::getInstance()->getStringFromFile(fullpath);
+    std::vector<char> binaryData;
+    if (rawData.empty() || !BinaryDataParser::convertDragonBonesData(rawData.c_str(), binaryData))
+    {
+        return false;
+    }
+
+    cocos2d::Data data;
+    data.copy(reinterpret_cast<const unsigned char*>(binaryData.data()), binaryData.size());
+
+    return cocos2d::FileUtils::getInstance()->writeDataToFile(data, binaryFilePath);
+}
+
 DRAGONBONES_NAMESPACE_END
@@ -4,6 +4,7 @@
 #include "dragonbones/DragonBonesHeaders.h"
 #include "cocos2d.h"
 #include "CCArmatureDisplay.h"
+#include <memory>
 
 DRAGONBONES_NAMESPACE_BEGIN
 
@@ -19,6 +20,9 @@ public:
 private:
     DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(CCFactory);
 
+    /** Expires with the factory, the main thread completions of the asynchronous loads hold it weakly. */
+    std::shared_ptr<CCFactory*> _asyncHandle;
+
 protected:
     virtual TextureAtlasData* _generateTextureAtlasData(TextureAtlasData* textureAtlasData, void* textureAtlas) const override;
     virtual Armature* _generateArmature(const BuildArmaturePackage& dataPackage) const override;
@@ -31,9 +35,33 @@ public:
     virtual CCArmatureDisplay* buildArmatureDisplay(const std::string& armatureName, const std::string& dragonBonesName = "", const std::string& skinName = "") const;
     virtual cocos2d::Sprite* getTextureDisplay(const std::string& textureName, const std::string& dragonBonesName = "") const;
     virtual CCArmatureDisplay* getSoundEventManater() const;
+    /**
+     * Bakes the frame cache of the data on a worker thread, see BaseFactory::bakeDragonBonesData.
+     * The callback is called on the main thread with the memory used by the cache,
+     * the armatures of the data must be built after it. Removing the data or clearing the factory
+     * cancels the bake, the callback is not called then.
+     */
+    virtual void bakeDragonBonesDataAsync(const std::string& dragonBonesName, unsigned frameRate, const std::function<void(std::size_t)>& callback = nullptr);
+    /**
+     * Reads and parses the data on a worker thread, JSON or binary, and adds it on the main thread.
+     * The callback is called on the main thread with the added data, or nullptr if it can not be loaded.
+     */
+    virtual void loadDragonBonesDataAsync(const std::string& filePath, const std::string& dragonBonesName = "", const std::function<void(DragonBonesData*)>& callback = nullptr);
+    /**
+     * Reads and parses the texture atlas data on a worker thread and loads its texture with TextureCache::addImageAsync.
+     * The callback is called on the main thread once the texture is loaded, or with nullptr if the data can not be loaded.
+     */
+    virtual void loadTextureAtlasDataAsync(const std::string& filePath, const std::string& dragonBonesName = "", float scale = 0.f, const std::function<void(TextureAtlasData*)>& callback = nullptr);
+
+public:
+    /**
+     * Converts the JSON DragonBones data of a file to the binary format read by BinaryDataParser.
+     */
+    static bool convertDragonBonesData(const std::string& filePath, const std::string& binaryFilePath);
 
 private:
     void _initTextureAtlasData(TextureAtlasData* atlasData);
+    cocos2d::Texture2D::PixelFormat _getPixelFormat(TextureFormat format) const;
 };
 
 DRAGONBONES_NAMESPACE_END
@@ -1,36 +1,231 @@
 #include "BaseObject.h"
+#include <mutex>
+
+#if defined(_MSC_VER) && _MSC_VER < 1900
+#define DRAGONBONES_THREAD_LOCAL __declspec(thread)
+#else
+#define DRAGONBONES_THREAD_LOCAL thread_local
+#endif
+
 DRAGONBONES_NAMESPACE_BEGIN
 
-std::size_t BaseObject::_hashCode = 0;
-std::size_t BaseObject::_defaultMaxCount = 5000;
-std::unordered_map<std::size_t, std::size_t> BaseObject::_maxCountMap;
-std::unordered_map<std::size_t, std::vector<BaseObject*>> BaseObject::_poolsMap;
+namespace
+{
+    /**
+     * The pool of a type shared by every thread, the threads borrow from it and hand their spare objects to it in batches.
+     * The pools are never deleted, the threads keep pointers to them.
+     */
+    struct SharedPool
+    {
+        bool hasMaxCount;
+        bool hasCapacity;
+        std::atomic<std::size_t> maxCount;
+        std::atomic<std::size_t> capacity;
+        std::atomic<std::size_t> pooledCount; // in the shared pool and in the thread pools
+        std::atomic<std::size_t> sharedCount;
+        std::atomic<unsigned> generation; // the objects of the thread pools of an older generation have been cleared
+        std::atomic<std::size_t> borrowed;
+        std::atomic<std::size_t> recycled;
+        std::atomic<std::size_t> allocated;
+        std::mutex mutex;
+        std::vector<BaseObject*> objects;
+
+        SharedPool(std::size_t maxCount, std::size_t capacity) :
+            hasMaxCount(false),
+            hasCapacity(false),
+            maxCount(maxCount),
+            capacity(capacity),
+            pooledCount(0),
+            sharedCount(0),
+            generation(0),
+            borrowed(0),
+            recycled(0),
+            allocated(0)
+        {}
+    };
+
+    /** The objects of a type kept by one thread, only that thread touches them. */
+    struct ThreadPool
+    {
+        SharedPool* sharedPool;
+        unsigned generation;
+        std::vector<BaseObject*> objects;
+
+        ThreadPool() :
+            sharedPool(nullptr),
+            generation(0)
+        {}
+    };
+
+    typedef std::unordered_map<std::size_t, ThreadPool> ThreadPools;
+
+    std::size_t _defaultMaxCount = 5000;
+    std::size_t _defaultCapacity = 64;
+    std::unordered_map<std::size_t, SharedPool*> _sharedPools;
+    std::mutex _sharedPoolsMutex;
+    // returned on other threads than the one of the recycle callback
+    std::vector<BaseObject*> _deferredObjects;
+    std::mutex _deferredObjectsMutex;
+    // a pointer as the thread locals of the supported compilers can not all run destructors
+    DRAGONBONES_THREAD_LOCAL ThreadPools* _threadPools = nullptr;
+
+    void _deleteObjects(std::vector<BaseObject*>& objects)
+    {
+        // the objects are moved out first, deleting an object may return others to the pools
+        std::vector<BaseObject*> deleteObjects;
+        deleteObjects.swap(objects);
+        for (const auto object : deleteObjects)
+        {
+            delete object;
+        }
+    }
+
+    SharedPool* _getSharedPool(std::size_t classTypeIndex)
+    {
+        std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+        auto& sharedPool = _sharedPools[classTypeIndex];
+        if (!sharedPool)
+        {
+            sharedPool = new SharedPool(_defaultMaxCount, _defaultCapacity);
+        }
+
+        return sharedPool;
+    }
+
+    void _trimSharedPool(SharedPool& sharedPool, std::size_t maxCount)
+    {
+        std::vector<BaseObject*> deleteObjects;
+        {
+            std::lock_guard<std::mutex> lock(sharedPool.mutex);
+            const auto pooledCount = sharedPool.pooledCount.load();
+            if (pooledCount > maxCount)
+            {
+                const auto count = std::min(pooledCount - maxCount, sharedPool.objects.size());
+                deleteObjects.assign(sharedPool.objects.end() - count, sharedPool.objects.end());
+                sharedPool.objects.resize(sharedPool.objects.size() - count);
+                sharedPool.sharedCount -= count;
+                sharedPool.pooledCount -= count;
+            }
+
+            if (sharedPool.pooledCount > maxCount)
+            {
+                // the rest is kept by the thread pools
+                sharedPool.generation++;
+            }
+        }
+
+        _deleteObjects(deleteObjects);
+    }
+
+    void _clearSharedPool(SharedPool& sharedPool)
+    {
+        std::vector<BaseObject*> deleteObjects;
+        {
+            std::lock_guard<std::mutex> lock(sharedPool.mutex);
+            deleteObjects.swap(sharedPool.objects);
+            sharedPool.sharedCount = 0;
+            sharedPool.pooledCount -= deleteObjects.size();
+            sharedPool.generation++;
+        }
+
+        _deleteObjects(deleteObjects);
+    }
+
+    ThreadPool& _getThreadPool(std::size_t classTypeIndex)
+    {
+        if (!_threadPools)
+        {
+            _threadPools = new ThreadPools();
+        }
+
+        // the references to the elements stay valid when the map rehashes
+        auto& threadPool = (*_threadPools)[classTypeIndex];
+        if (!threadPool.sharedPool)
+        {
+            threadPool.sharedPool = _getSharedPool(classTypeIndex);
+            threadPool.generation = threadPool.sharedPool->generation;
+        }
+        else if (threadPool.generation != threadPool.sharedPool->generation)
+        {
+            threadPool.generation = threadPool.sharedPool->generation;
+            threadPool.sharedPool->pooledCount -= threadPool.objects.size();
+            _deleteObjects(threadPool.objects);
+        }
+
+        return threadPool;
+    }
+}
+
+std::atomic<std::size_t> BaseObject::_hashCode(0);
 BaseObject::RecycleOrDestroyCallback BaseObject::_recycleOrDestroyCallback = nullptr;
+std::thread::id BaseObject::_recycleOrDestroyCallbackThreadId;
+
+BaseObject* BaseObject::_borrowObject(std::size_t classTypeIndex)
+{
+    auto& threadPool = _getThreadPool(classTypeIndex);
+    auto& sharedPool = *threadPool.sharedPool;
+    sharedPool.borrowed++;
+
+    if (threadPool.objects.empty() && sharedPool.sharedCount > 0)
+    {
+        std::lock_guard<std::mutex> lock(sharedPool.mutex);
+        const auto count = std::min(sharedPool.objects.size(), std::max(sharedPool.capacity / 2, (std::size_t)1));
+        threadPool.objects.assign(sharedPool.objects.end() - count, sharedPool.objects.end());
+        sharedPool.objects.resize(sharedPool.objects.size() - count);
+        sharedPool.sharedCount -= count;
+    }
+
+    if (threadPool.objects.empty())
+    {
+        sharedPool.allocated++;
+        return nullptr;
+    }
+
+    const auto object = threadPool.objects.back();
+    threadPool.objects.pop_back();
+    sharedPool.pooledCount--;
+    object->_isInPool = false;
+
+    return object;
+}
 
 void BaseObject::_returnObject(BaseObject* object)
 {
-    const auto classTypeIndex = object->getClassTypeIndex();
-    const auto maxCountIterator = _maxCountMap.find(classTypeIndex);
-    const auto maxCount = maxCountIterator != _maxCountMap.end() ? maxCountIterator->second : _defaultMaxCount;
+    const auto hasCallback = _recycleOrDestroyCallback != nullptr && std::this_thread::get_id() == _recycleOrDestroyCallbackThreadId;
+    auto& threadPool = _getThreadPool(object->getClassTypeIndex());
+    auto& sharedPool = *threadPool.sharedPool;
 
-    auto& pool = _poolsMap[classTypeIndex];
-    if (pool.size() < maxCount)
+    if (sharedPool.pooledCount < sharedPool.maxCount)
     {
-        if (std::find(pool.cbegin(), pool.cend(), object) == pool.cend())
+        // the object may be in the pool of another thread or in the shared pool
+        if (!object->_isInPool)
         {
-            pool.push_back(object);
+            object->_isInPool = true;
+            threadPool.objects.push_back(object);
+            sharedPool.pooledCount++;
+            sharedPool.recycled++;
         }
         else
         {
             DRAGONBONES_ASSERT(false, "The object aleady in pool.");
         }
 
-        if (_recycleOrDestroyCallback != nullptr)
+        const auto capacity = sharedPool.capacity.load();
+        if (threadPool.objects.size() > capacity)
+        {
+            const auto count = threadPool.objects.size() - capacity / 2;
+            std::lock_guard<std::mutex> lock(sharedPool.mutex);
+            sharedPool.objects.insert(sharedPool.objects.end(), threadPool.objects.end() - count, threadPool.objects.end());
+            sharedPool.sharedCount += count;
+            threadPool.objects.resize(threadPool.objects.size() - count);
+        }
+
+        if (hasCallback)
             _recycleOrDestroyCallback(object, 0);
     }
     else
     {
-        if (_recycleOrDestroyCallback != nullptr)
+        if (hasCallback)
             _recycleOrDestroyCallback(object, 1);
 
         delete object;
@@ -40,93 +235,171 @@ void BaseObject::_returnObject(BaseObject* object)
 void BaseObject::setObjectRecycleOrDestroyCallback(const std::function<void(BaseObject*, int)>& cb)
 {
     _recycleOrDestroyCallback = cb;
+    _recycleOrDestroyCallbackThreadId = std::this_thread::get_id();
+}
+
+void BaseObject::returnDeferredObjects()
+{
+    std::vector<BaseObject*> objects;
+    {
+        std::lock_guard<std::mutex> lock(_deferredObjectsMutex);
+        objects.swap(_deferredObjects);
+    }
+
+    for (const auto object : objects)
+    {
+        object->returnToPool();
+    }
 }
 
 void BaseObject::setMaxCount(std::size_t classTypeIndex, std::size_t maxCount)
 {
+    std::vector<SharedPool*> trimPools;
     if (classTypeIndex)
     {
-        _maxCountMap[classTypeIndex] = maxCount;
-        const auto iterator = _poolsMap.find(classTypeIndex);
-        if (iterator != _poolsMap.end())
+        const auto sharedPool = _getSharedPool(classTypeIndex);
+        std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+        sharedPool->hasMaxCount = true;
+        sharedPool->maxCount = maxCount;
+        trimPools.push_back(sharedPool);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+        _defaultMaxCount = maxCount;
+        for (const auto& pair : _sharedPools)
         {
-            auto& pool = iterator->second;
-            if (pool.size() > maxCount)
+            if (!pair.second->hasMaxCount)
             {
-                for (auto i = maxCount, l = pool.size(); i < l; ++i)
-                {
-                    delete pool[i];
-                }
-
-                pool.resize(maxCount);
+                pair.second->maxCount = maxCount;
+                trimPools.push_back(pair.second);
             }
         }
     }
-    else
+
+    for (const auto sharedPool : trimPools)
     {
-        _defaultMaxCount = maxCount;
-        for (auto& pair : _poolsMap)
+        _trimSharedPool(*sharedPool, maxCount);
+    }
+}
+
+void BaseObject::clearPool(std::size_t classTypeIndex)
+{
+    std::vector<SharedPool*> clearPools;
+    {
+        std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+        for (const auto& pair : _sharedPools)
         {
-            if (_maxCountMap.find(pair.first) == _maxCountMap.end())
+            if (!classTypeIndex || pair.first == classTypeIndex)
             {
-                continue;
+                clearPools.push_back(pair.second);
             }
+        }
+    }
 
-            _maxCountMap[pair.first] = maxCount;
+    for (const auto sharedPool : clearPools)
+    {
+        _clearSharedPool(*sharedPool);
+    }
 
-            auto& pool = pair.second;
-            if (pool.size() > maxCount)
+    // the other threads delete their objects when they next use the pools
+    if (_threadPools)
+    {
+        std::vector<std::size_t> classTypeIndices;
+        for (const auto& pair : *_threadPools)
+        {
+            if (!classTypeIndex || pair.first == classTypeIndex)
             {
-                for (auto i = maxCount, l = pool.size(); i < l; ++i)
-                {
-                    delete pool[i];
-                }
-
-                pool.resize(maxCount);
+                classTypeIndices.push_back(pair.first);
             }
         }
+
+        for (const auto index : classTypeIndices)
+        {
+            _getThreadPool(index);
+        }
     }
 }
 
-void BaseObject::clearPool(std::size_t classTypeIndex)
+void BaseObject::setCapacityHint(std::size_t classTypeIndex, std::size_t capacity)
 {
     if (classTypeIndex)
     {
-        const auto iterator = _poolsMap.find(classTypeIndex);
-        if (iterator != _poolsMap.end())
+        const auto sharedPool = _getSharedPool(classTypeIndex);
+        std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+        sharedPool->hasCapacity = true;
+        sharedPool->capacity = capacity;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+        _defaultCapacity = capacity;
+        for (const auto& pair : _sharedPools)
         {
-            auto& pool = iterator->second;
-            if (!pool.empty())
+            if (!pair.second->hasCapacity)
             {
-                for (auto object : pool)
-                {
-                    delete object;
-                }
-
-                pool.clear();
+                pair.second->capacity = capacity;
             }
         }
     }
-    else
+}
+
+BaseObject::PoolStats BaseObject::getPoolStats(std::size_t classTypeIndex)
+{
+    PoolStats stats = { 0, 0, 0 };
+
+    std::lock_guard<std::mutex> lock(_sharedPoolsMutex);
+    for (const auto& pair : _sharedPools)
     {
-        for (auto& pair : _poolsMap)
+        if (!classTypeIndex || pair.first == classTypeIndex)
         {
-            auto& pool = pair.second;
-            if (!pool.empty())
-            {
-                for (auto object : pool)
-                {
-                    delete object;
-                }
+            stats.borrowed += pair.second->borrowed;
+            stats.recycled += pair.second->recycled;
+            stats.allocated += pair.second->allocated;
+        }
+    }
 
-                pool.clear();
-            }
+    return stats;
+}
+
+void BaseObject::flushThreadPool()
+{
+    if (!_threadPools)
+    {
+        return;
+    }
+
+    const auto threadPools = _threadPools;
+    _threadPools = nullptr;
+
+    for (auto& pair : *threadPools)
+    {
+        auto& threadPool = pair.second;
+        auto& sharedPool = *threadPool.sharedPool;
+        std::lock_guard<std::mutex> lock(sharedPool.mutex);
+        if (threadPool.generation == sharedPool.generation)
+        {
+            sharedPool.objects.insert(sharedPool.objects.end(), threadPool.objects.begin(), threadPool.objects.end());
+            sharedPool.sharedCount += threadPool.objects.size();
+            threadPool.objects.clear();
+        }
+        else
+        {
+            sharedPool.pooledCount -= threadPool.objects.size();
         }
     }
+
+    for (auto& pair : *threadPools)
+    {
+        _deleteObjects(pair.second.objects);
+    }
+
+    delete threadPools;
 }
 
 BaseObject::BaseObject() :
-    hashCode(BaseObject::_hashCode++)
+    hashCode(BaseObject::_hashCode++),
+    _isInPool(false)
 {}
 BaseObject::~BaseObject()
 {
@@ -136,6 +409,14 @@ BaseObject::~BaseObject()
 
 void BaseObject::returnToPool()
 {
+    // The callback releases the script objects of the object, which may only happen on its thread.
+    if (_recycleOrDestroyCallback != nullptr && std::this_thread::get_id() != _recycleOrDestroyCallbackThreadId)
+    {
+        std::lock_guard<std::mutex> lock(_deferredObjectsMutex);
+        _deferredObjects.push_back(this);
+        return;
+    }
+
     _onClear();
     _returnObject(this);
 }
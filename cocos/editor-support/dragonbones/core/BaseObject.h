@@ -2,6 +2,8 @@
 #define DRAGONBONES_BASE_OBJECT_H
 
 #include "DragonBones.h"
+#include <atomic>
+#include <thread>
 
 #define BIND_CLASS_TYPE(CLASS) \
 public:\
@@ -21,35 +23,55 @@ class BaseObject
 {
 public:
     typedef std::function<void(BaseObject*,int)> RecycleOrDestroyCallback;
+
+    /** The counters of the pool of a type, or of all the pools. */
+    struct PoolStats
+    {
+        /** The objects handed out by borrowObject. */
+        std::size_t borrowed;
+        /** The objects put back in a pool by returnToPool. */
+        std::size_t recycled;
+        /** The objects created because the pools were empty. */
+        std::size_t allocated;
+    };
+
 private:
-    static std::size_t _hashCode;
-    static std::size_t _defaultMaxCount;
-    static std::unordered_map<std::size_t, std::size_t> _maxCountMap;
-    static std::unordered_map<std::size_t, std::vector<BaseObject*>> _poolsMap;
+    static std::atomic<std::size_t> _hashCode;
 
     static RecycleOrDestroyCallback _recycleOrDestroyCallback;
+    static std::thread::id _recycleOrDestroyCallbackThreadId;
+    static BaseObject* _borrowObject(std::size_t classTypeIndex);
     static void _returnObject(BaseObject *object);
 public:
 
+    /**
+     * The callback is only called on the thread that set it. Once it is set, the objects returned on the other threads
+     * are queued until that thread calls returnDeferredObjects.
+     */
     static void setObjectRecycleOrDestroyCallback(const RecycleOrDestroyCallback& cb);
+    /** Returns the objects queued by returnToPool on other threads than the one of the recycle callback, called on that thread. */
+    static void returnDeferredObjects();
     static void setMaxCount(std::size_t classTypeIndex, std::size_t maxCount);
     static void clearPool(std::size_t classTypeIndex);
+    /**
+     * Sets how many objects of a type each thread keeps in its own pool before handing them to the shared one, 0 sets it for every type.
+     * A higher capacity takes the shared pool lock less often.
+     */
+    static void setCapacityHint(std::size_t classTypeIndex, std::size_t capacity);
+    static PoolStats getPoolStats(std::size_t classTypeIndex = 0);
+    /**
+     * Hands the objects kept by the calling thread to the shared pools. A worker thread should call it before it exits,
+     * and a pooled thread when its task ends, the thread pools hand their objects to the shared ones only past their capacity.
+     */
+    static void flushThreadPool();
 
     template<typename T>
     static T* borrowObject() 
     {
-        const auto classTypeIndex = T::getTypeIndex();
-        const auto iterator = _poolsMap.find(classTypeIndex);
-        if (iterator != _poolsMap.end())
+        const auto object = _borrowObject(T::getTypeIndex());
+        if (object)
         {
-            auto& pool = iterator->second;
-            if (!pool.empty())
-            {
-                const auto object = dynamic_cast<T*>(pool.back());
-                pool.pop_back();
-
-                return object;
-            }
+            return dynamic_cast<T*>(object);
         }
 
         return new (std::nothrow) T();
@@ -58,6 +80,10 @@ public:
 public:
     const std::size_t hashCode;
 
+private:
+    // set while the object is in a thread pool or the shared pool, catches the objects returned twice
+    bool _isInPool;
+
 public:
     /** @private */
     BaseObject();
@@ -2,14 +2,157 @@
 
 DRAGONBONES_NAMESPACE_BEGIN
 
-JSONDataParser BaseFactory::_defaultDataParser;
+BinaryDataParser BaseFactory::_defaultDataParser;
+
+namespace
+{
+    /**
+     * Display of the armatures baking frame caches, without events.
+     */
+    class BakeArmatureDisplay final : public IArmatureDisplay
+    {
+    private:
+        Armature* _armature;
+
+    public:
+        explicit BakeArmatureDisplay(Armature* armature) : _armature(armature) {}
+
+        virtual void _onClear() override { delete this; }
+        virtual void _dispatchEvent(EventObject* value) override {}
+        virtual bool hasEvent(const std::string& type) const override { return false; }
+        virtual void dispose() override { _armature->dispose(); }
+        virtual void advanceTimeBySelf(bool on) override {}
+        virtual Armature* getArmature() const override { return _armature; }
+        virtual Animation& getAnimation() const override { return _armature->getAnimation(); }
+    };
+
+    /**
+     * Slot of the armatures baking frame caches, the slot itself stands for its displays.
+     */
+    class BakeSlot final : public Slot
+    {
+        BIND_CLASS_TYPE(BakeSlot);
+
+    public:
+        BakeSlot() { _onClear(); }
+        ~BakeSlot() { _onClear(); }
+
+    private:
+        DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(BakeSlot);
+
+    protected:
+        virtual void _initDisplay(void* value) override {}
+        virtual void _disposeDisplay(void* value) override {}
+        virtual void _onUpdateDisplay() override {}
+        virtual void _addDisplay() override {}
+        virtual void _replaceDisplay(void* value, bool isArmatureDisplayContainer) override {}
+        virtual void _removeDisplay() override {}
+        virtual void _updateColor() override {}
+        virtual void _updateFilters() override {}
+        virtual void _updateFrame() override {}
+        virtual void _updateMesh() override {}
+        virtual void _updateTransform() override {}
+
+    public:
+        virtual void _updateVisible() override {}
+        virtual void _updateBlendMode() override {}
+    };
+
+    /**
+     * Builds the armatures baking frame caches, free of any render object so they can run on a worker thread.
+     * Child armatures are not built, their own data is baked separately.
+     */
+    class BakeFactory final : public BaseFactory
+    {
+    public:
+        BakeFactory() {}
+        ~BakeFactory() {}
+
+    private:
+        DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(BakeFactory);
+
+    protected:
+        virtual TextureAtlasData* _generateTextureAtlasData(TextureAtlasData* textureAtlasData, void* textureAtlas) const override
+        {
+            return textureAtlasData;
+        }
+
+        virtual Armature* _generateArmature(const BuildArmaturePackage& dataPackage) const override
+        {
+            const auto armature = BaseObject::borrowObject<Armature>();
+
+            armature->_armatureData = dataPackage.armature;
+            armature->_skinData = dataPackage.skin;
+            armature->_animation = BaseObject::borrowObject<Animation>();
+            armature->_display = new (std::nothrow) BakeArmatureDisplay(armature);
+            armature->_lockActionAndEvent = true;
+            armature->_animation->_armature = armature;
+
+            armature->getAnimation().setAnimations(dataPackage.armature->animations);
+
+            return armature;
+        }
+
+        virtual Slot* _generateSlot(const BuildArmaturePackage& dataPackage, const SlotDisplayDataSet& slotDisplayDataSet) const override
+        {
+            const auto slot = BaseObject::borrowObject<BakeSlot>();
+            std::vector<std::pair<void*, DisplayType>> displayList;
+
+            slot->name = slotDisplayDataSet.slot->name;
+            slot->_rawDisplay = slot;
+            slot->_meshDisplay = slot;
+
+            displayList.reserve(slotDisplayDataSet.displays.size());
+
+            for (const auto displayData : slotDisplayDataSet.displays)
+            {
+                switch (displayData->type)
+                {
+                    case DisplayType::Image:
+                        displayList.push_back(std::make_pair(slot->_rawDisplay, DisplayType::Image));
+                        break;
+
+                    case DisplayType::Mesh:
+                        displayList.push_back(std::make_pair(slot->_meshDisplay, DisplayType::Mesh));
+                        break;
+
+                    default:
+                        displayList.push_back(std::make_pair(nullptr, DisplayType::Image));
+                        break;
+                }
+            }
+
+            slot->_setDisplayList(displayList);
+
+            return slot;
+        }
+
+    public:
+        Armature* buildBakeArmature(DragonBonesData& data, ArmatureData& armatureData)
+        {
+            BuildArmaturePackage dataPackage;
+            dataPackage.dataName = data.name;
+            dataPackage.data = &data;
+            dataPackage.armature = &armatureData;
+            dataPackage.skin = armatureData.getDefaultSkin();
+
+            const auto armature = _generateArmature(dataPackage);
+            _buildBones(dataPackage, *armature);
+            _buildSlots(dataPackage, *armature);
+
+            return armature;
+        }
+    };
+}
 
 BaseFactory::BaseFactory() :
     autoSearch(false),
 
     _dataParser(&_defaultDataParser),
     _dragonBonesDataMap(),
-    _textureAtlasDataMap()
+    _textureAtlasDataMap(),
+    _bakeMemoryBudget(0),
+    _bakedMemoryMap()
 {}
 BaseFactory::~BaseFactory() {}
 
@@ -265,6 +408,13 @@ void BaseFactory::removeDragonBonesData(const std::string& dragonBonesName, bool
     const auto iterator = _dragonBonesDataMap.find(dragonBonesName);
     if (iterator != _dragonBonesDataMap.end())
     {
+        _cancelBakeTasks(iterator->second);
+
+        {
+            std::lock_guard<std::mutex> lock(_bakeMutex);
+            _bakedMemoryMap.erase(iterator->second);
+        }
+
         if (disposeData)
         {
             iterator->second->returnToPool();
@@ -317,6 +467,8 @@ void BaseFactory::removeTextureAtlasData(const std::string& dragonBonesName, boo
 
 void BaseFactory::clear(bool disposeData)
 {
+    _cancelBakeTasks(nullptr);
+
     if (disposeData)
     {
         for (const auto& pair : _dragonBonesDataMap)
@@ -335,6 +487,9 @@ void BaseFactory::clear(bool disposeData)
 
     _dragonBonesDataMap.clear();
     _textureAtlasDataMap.clear();
+
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    _bakedMemoryMap.clear();
 }
 
 Armature * BaseFactory::buildArmature(const std::string & armatureName, const std::string & dragonBonesName, const std::string & skinName) const
@@ -448,4 +603,171 @@ void BaseFactory::replaceSlotDisplayList(const std::string& dragonBonesName, con
     }
 }
 
+std::size_t BaseFactory::bakeDragonBonesData(DragonBonesData& data, unsigned frameRate)
+{
+    {
+        std::lock_guard<std::mutex> lock(_bakeMutex);
+        _bakedMemoryMap.erase(&data);
+    }
+
+    if (frameRate == 0)
+    {
+        return 0;
+    }
+
+    BakeFactory bakeFactory;
+    std::size_t bakedMemory = 0;
+
+    for (const auto& pair : data.armatures)
+    {
+        const auto armatureData = pair.second;
+        armatureData->cacheFrames(frameRate);
+
+        const auto armature = bakeFactory.buildBakeArmature(data, *armatureData);
+        auto& animation = armature->getAnimation();
+
+        for (const auto& animationPair : armatureData->animations)
+        {
+            const auto animationData = animationPair.second;
+            if (animationData->animation)
+            {
+                continue;
+            }
+
+            if (animationData->cachedFrames.empty()) // Left out of a previous bake by the budget.
+            {
+                animationData->cacheFrames((float)frameRate / armatureData->frameRate);
+            }
+
+            const auto cacheTimeToFrameScale = animationData->cacheTimeToFrameScale;
+            for (std::size_t i = 0, l = animationData->cachedFrames.size(); i < l; ++i)
+            {
+                if (animationData->cachedFrames[i])
+                {
+                    continue;
+                }
+
+                // Three quarters into the cache frame, the animation state rounds the time down to its middle.
+                animation.gotoAndStopByTime(animationPair.first, (i + 0.75f) / cacheTimeToFrameScale);
+                armature->invalidUpdate();
+                armature->advanceTime(0.f);
+            }
+
+            const auto memorySize = animationData->packCachedFrames();
+
+            std::lock_guard<std::mutex> lock(_bakeMutex);
+            auto totalMemory = memorySize;
+            for (const auto& memoryPair : _bakedMemoryMap)
+            {
+                totalMemory += memoryPair.second;
+            }
+
+            if (_bakeMemoryBudget > 0 && totalMemory > _bakeMemoryBudget)
+            {
+                animationData->clearCachedFrames();
+            }
+            else
+            {
+                _bakedMemoryMap[&data] += memorySize;
+                bakedMemory += memorySize;
+            }
+        }
+
+        armature->dispose();
+    }
+
+    BaseObject::clearPool(BakeSlot::getTypeIndex());
+
+    return bakedMemory;
+}
+
+std::shared_ptr<BaseFactory::BakeTask> BaseFactory::_addBakeTask(DragonBonesData& data, unsigned frameRate)
+{
+    const auto task = std::make_shared<BakeTask>();
+    task->factory = this;
+    task->data = &data;
+    task->frameRate = frameRate;
+    task->running = false;
+    task->cancelled = false;
+    _bakeTasks.push_back(task);
+
+    return task;
+}
+
+void BaseFactory::_removeBakeTask(const std::shared_ptr<BakeTask>& task)
+{
+    const auto iterator = std::find(_bakeTasks.begin(), _bakeTasks.end(), task);
+    if (iterator != _bakeTasks.end())
+    {
+        _bakeTasks.erase(iterator);
+    }
+}
+
+void BaseFactory::_cancelBakeTasks(const DragonBonesData* data)
+{
+    for (auto iterator = _bakeTasks.begin(); iterator != _bakeTasks.end();)
+    {
+        const auto task = *iterator;
+        if (data && task->data != data)
+        {
+            ++iterator;
+            continue;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(task->mutex);
+            task->cancelled = true;
+            task->condition.wait(lock, [&task]() { return !task->running; });
+        }
+
+        iterator = _bakeTasks.erase(iterator);
+    }
+}
+
+std::size_t BaseFactory::_runBakeTask(BakeTask& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(task.mutex);
+        if (task.cancelled)
+        {
+            return 0;
+        }
+
+        task.running = true;
+    }
+
+    const auto bakedMemory = task.factory->bakeDragonBonesData(*task.data, task.frameRate);
+
+    // Notified under the lock, the factory waiting for the task may be destroyed as soon as it is released.
+    std::lock_guard<std::mutex> lock(task.mutex);
+    task.running = false;
+    task.condition.notify_all();
+
+    return bakedMemory;
+}
+
+void BaseFactory::setBakeMemoryBudget(std::size_t value)
+{
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    _bakeMemoryBudget = value;
+}
+
+std::size_t BaseFactory::getBakeMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    return _bakeMemoryBudget;
+}
+
+std::size_t BaseFactory::getBakedMemory() const
+{
+    std::lock_guard<std::mutex> lock(_bakeMutex);
+    std::size_t bakedMemory = 0;
+    for (const auto& pair : _bakedMemoryMap)
+    {
+        bakedMemory += pair.second;
+    }
+
+    return bakedMemory;
+}
+
 DRAGONBONES_NAMESPACE_END
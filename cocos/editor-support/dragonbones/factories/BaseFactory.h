@@ -1,11 +1,14 @@
 #ifndef DRAGONBONES_BASE_FACTORY_H
 #define DRAGONBONES_BASE_FACTORY_H
 
-#include "../parsers/JSONDataParser.h"
+#include "../parsers/BinaryDataParser.h"
 #include "../armature/Armature.h"
 #include "../animation/Animation.h"
 #include "../armature/Bone.h"
 #include "../armature/Slot.h"
+#include <mutex>
+#include <condition_variable>
+#include <memory>
 
 DRAGONBONES_NAMESPACE_BEGIN
 
@@ -37,7 +40,7 @@ private:
 class BaseFactory
 {
 protected:
-    static JSONDataParser _defaultDataParser;
+    static BinaryDataParser _defaultDataParser;
 
 public:
     bool autoSearch;
@@ -46,6 +49,24 @@ protected:
     DataParser* _dataParser;
     std::map<std::string, DragonBonesData*> _dragonBonesDataMap;
     std::map<std::string, std::vector<TextureAtlasData*>> _textureAtlasDataMap;
+    std::size_t _bakeMemoryBudget;
+    std::map<DragonBonesData*, std::size_t> _bakedMemoryMap;
+    mutable std::mutex _bakeMutex;
+
+    /**
+     * @private A bake queued for a worker thread. Shared with the task, which checks that it was not cancelled before touching the factory.
+     */
+    struct BakeTask
+    {
+        BaseFactory* factory;
+        DragonBonesData* data;
+        unsigned frameRate;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool running;
+        bool cancelled;
+    };
+    std::vector<std::shared_ptr<BakeTask>> _bakeTasks;
 
 public:
     /** @private */
@@ -64,6 +85,13 @@ protected:
     virtual Armature* _generateArmature(const BuildArmaturePackage& dataPackage) const = 0;
     virtual Slot* _generateSlot(const BuildArmaturePackage& dataPackage, const SlotDisplayDataSet& slotDisplayDataSet) const = 0;
 
+    std::shared_ptr<BakeTask> _addBakeTask(DragonBonesData& data, unsigned frameRate);
+    void _removeBakeTask(const std::shared_ptr<BakeTask>& task);
+    /** Cancels the queued bakes of the data, all of them with nullptr, and waits for the running ones. */
+    void _cancelBakeTasks(const DragonBonesData* data);
+    /** Bakes the data of the task on a worker thread unless it was cancelled, returns the memory used by the frame cache. */
+    static std::size_t _runBakeTask(BakeTask& task);
+
 public:
     virtual DragonBonesData* parseDragonBonesData(const char* rawData, const std::string& dragonBonesName = "", float scale = 1.f);
     virtual TextureAtlasData* parseTextureAtlasData(const char* rawData, void* textureAtlas, const std::string& dragonBonesName = "", float scale = 0.f);
@@ -82,6 +110,21 @@ public:
     virtual void replaceSlotDisplay(const std::string& dragonBonesName, const std::string& armatureName, const std::string& slotName, const std::string& displayName, Slot& slot, int displayIndex = -1) const;
     virtual void replaceSlotDisplayList(const std::string& dragonBonesName, const std::string& armatureName, const std::string& slotName, Slot& slot) const;
 
+    /**
+     * Fills the frame cache of every animation of the data at frameRate ahead of time, as Armature::setCacheFrameRate
+     * does while the animations play, and packs the cached matrices. The armatures built afterwards share the cache,
+     * so the first playthrough is as cheap as the next ones.
+     * Can run on a worker thread: the data must not be removed and no armature of it may be alive or built until it returns.
+     * The animations which do not fit in the bake memory budget are left uncached.
+     * Returns the memory used by the frame cache of the data.
+     */
+    virtual std::size_t bakeDragonBonesData(DragonBonesData& data, unsigned frameRate);
+    /** Sets the memory in bytes the baked frame caches of the factory may use, 0 (no limit) by default. */
+    void setBakeMemoryBudget(std::size_t value);
+    std::size_t getBakeMemoryBudget() const;
+    /** Returns the memory used by the baked frame caches of the data of the factory. */
+    std::size_t getBakedMemory() const;
+
     inline DragonBonesData* getDragonBonesData(const std::string& dragonBonesName) const 
     {
         return mapFind(_dragonBonesDataMap, dragonBonesName);
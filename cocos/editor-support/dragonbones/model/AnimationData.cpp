@@ -62,7 +62,7 @@ void AnimationData::cacheFrames(float value)
     const auto cacheFrameCount = (unsigned)std::max(std::floor((frameCount + 1) * scale * value), 1.f);
 
     cacheTimeToFrameScale = cacheFrameCount / (duration + 0.0000001f);
-    cachedFrames.resize(cacheFrameCount, false);
+    cachedFrames.assign(cacheFrameCount, false);
 
     for (const auto& pair : boneTimelines)
     {
@@ -75,6 +75,38 @@ void AnimationData::cacheFrames(float value)
     }
 }
 
+void AnimationData::clearCachedFrames()
+{
+    cachedFrames.clear();
+
+    for (const auto& pair : boneTimelines)
+    {
+        pair.second->cacheFrames(0);
+    }
+
+    for (const auto& pair : slotTimelines)
+    {
+        pair.second->cacheFrames(0);
+    }
+}
+
+std::size_t AnimationData::packCachedFrames()
+{
+    std::size_t memorySize = cachedFrames.size() / 8;
+
+    for (const auto& pair : boneTimelines)
+    {
+        memorySize += pair.second->packCachedFrames();
+    }
+
+    for (const auto& pair : slotTimelines)
+    {
+        memorySize += pair.second->packCachedFrames();
+    }
+
+    return memorySize;
+}
+
 void AnimationData::addBoneTimeline(BoneTimelineData* value)
 {
     if (value && value->bone && boneTimelines.find(value->bone->name) == boneTimelines.end())
@@ -46,6 +46,10 @@ public:
     /** @private */
     void cacheFrames(float value);
     /** @private */
+    void clearCachedFrames();
+    /** @private */
+    std::size_t packCachedFrames();
+    /** @private */
     void addBoneTimeline(BoneTimelineData* value);
     /** @private */
     void addSlotTimeline(SlotTimelineData* value);
@@ -1,7 +1,103 @@
 #include "TimelineData.h"
+#include <array>
 
 DRAGONBONES_NAMESPACE_BEGIN
 
+namespace
+{
+    // Grid the packed matrices are snapped to, well under a hundredth of a pixel for the usual display sizes.
+    const float CACHE_MATRIX_SCALE_STEP = 1.f / 16384.f;
+    const float CACHE_MATRIX_TRANSLATE_STEP = 1.f / 256.f;
+
+    inline bool _isPackedFrame(const std::vector<Matrix>& packedFrames, const Matrix* matrix)
+    {
+        return !packedFrames.empty() && matrix >= packedFrames.data() && matrix < packedFrames.data() + packedFrames.size();
+    }
+
+    void _deleteUnpackedFrames(const std::vector<Matrix*>& cachedFrames, const std::vector<Matrix>& packedFrames)
+    {
+        // Frames cached while playing share the matrix of the previous frame when the pose did not change.
+        std::vector<Matrix*> matrices;
+        for (const auto matrix : cachedFrames)
+        {
+            if (matrix && !_isPackedFrame(packedFrames, matrix))
+            {
+                matrices.push_back(matrix);
+            }
+        }
+
+        std::sort(matrices.begin(), matrices.end());
+        matrices.erase(std::unique(matrices.begin(), matrices.end()), matrices.end());
+
+        for (const auto matrix : matrices)
+        {
+            delete matrix;
+        }
+    }
+
+    void _clearCachedFrames(std::vector<Matrix*>& cachedFrames, std::vector<Matrix>& packedFrames)
+    {
+        _deleteUnpackedFrames(cachedFrames, packedFrames);
+        cachedFrames.clear();
+        std::vector<Matrix>().swap(packedFrames);
+    }
+
+    std::size_t _packCachedFrames(std::vector<Matrix*>& cachedFrames, std::vector<Matrix>& packedFrames)
+    {
+        std::vector<Matrix> matrices;
+        std::vector<int> matrixIndices(cachedFrames.size(), -1);
+        std::map<std::array<long, 6>, int> keyIndices;
+
+        for (std::size_t i = 0, l = cachedFrames.size(); i < l; ++i)
+        {
+            const auto matrix = cachedFrames[i];
+            if (!matrix)
+            {
+                continue;
+            }
+
+            const std::array<long, 6> key = {{
+                std::lround(matrix->a / CACHE_MATRIX_SCALE_STEP),
+                std::lround(matrix->b / CACHE_MATRIX_SCALE_STEP),
+                std::lround(matrix->c / CACHE_MATRIX_SCALE_STEP),
+                std::lround(matrix->d / CACHE_MATRIX_SCALE_STEP),
+                std::lround(matrix->tx / CACHE_MATRIX_TRANSLATE_STEP),
+                std::lround(matrix->ty / CACHE_MATRIX_TRANSLATE_STEP)
+            }};
+
+            auto iterator = keyIndices.find(key);
+            if (iterator == keyIndices.end())
+            {
+                Matrix packedMatrix;
+                packedMatrix.a = key[0] * CACHE_MATRIX_SCALE_STEP;
+                packedMatrix.b = key[1] * CACHE_MATRIX_SCALE_STEP;
+                packedMatrix.c = key[2] * CACHE_MATRIX_SCALE_STEP;
+                packedMatrix.d = key[3] * CACHE_MATRIX_SCALE_STEP;
+                packedMatrix.tx = key[4] * CACHE_MATRIX_TRANSLATE_STEP;
+                packedMatrix.ty = key[5] * CACHE_MATRIX_TRANSLATE_STEP;
+
+                iterator = keyIndices.insert(std::make_pair(key, (int)matrices.size())).first;
+                matrices.push_back(packedMatrix);
+            }
+
+            matrixIndices[i] = iterator->second;
+        }
+
+        _deleteUnpackedFrames(cachedFrames, packedFrames);
+        packedFrames.swap(matrices);
+        packedFrames.shrink_to_fit();
+
+        for (std::size_t i = 0, l = cachedFrames.size(); i < l; ++i)
+        {
+            cachedFrames[i] = matrixIndices[i] >= 0 ? &packedFrames[matrixIndices[i]] : nullptr;
+        }
+
+        cachedFrames.shrink_to_fit();
+
+        return cachedFrames.capacity() * sizeof(Matrix*) + packedFrames.capacity() * sizeof(Matrix);
+    }
+}
+
 Matrix* BoneTimelineData::cacheFrame(std::vector<Matrix*>& cacheFrames, std::size_t cacheFrameIndex, const Matrix& globalTransformMatrix)
 {
     const auto cacheMatrix = cacheFrames[cacheFrameIndex] = new Matrix();
@@ -26,43 +122,20 @@ void BoneTimelineData::_onClear()
     bone = nullptr;
     originTransform.identity();
 
-    Matrix* prevMatrix = nullptr;
-    for (const auto matrix : cachedFrames)
-    {
-        if (matrix)
-        {
-            if (prevMatrix && prevMatrix != matrix)
-            {
-                delete prevMatrix;
-            }
-
-            prevMatrix = matrix;
-        }
-    }
-
-    cachedFrames.clear();
+    _clearCachedFrames(cachedFrames, packedFrames);
 }
 
 void BoneTimelineData::cacheFrames(std::size_t cacheFrameCount)
 {
-    Matrix* prevMatrix = nullptr;
-    for (const auto matrix : cachedFrames)
-    {
-        if (matrix)
-        {
-            if (prevMatrix && prevMatrix != matrix)
-            {
-                delete prevMatrix;
-            }
-
-            prevMatrix = matrix;
-        }
-    }
-
-    cachedFrames.clear();
+    _clearCachedFrames(cachedFrames, packedFrames);
     cachedFrames.resize(cacheFrameCount, nullptr);
 }
 
+std::size_t BoneTimelineData::packCachedFrames()
+{
+    return _packCachedFrames(cachedFrames, packedFrames);
+}
+
 Matrix* SlotTimelineData::cacheFrame(std::vector<Matrix*>& cacheFrames, std::size_t cacheFrameIndex, const Matrix& globalTransformMatrix)
 {
     const auto cacheMatrix = cacheFrames[cacheFrameIndex] = new Matrix();
@@ -86,43 +159,20 @@ void SlotTimelineData::_onClear()
 
     slot = nullptr;
 
-    Matrix* prevMatrix = nullptr;
-    for (const auto matrix : cachedFrames)
-    {
-        if (matrix)
-        {
-            if (prevMatrix && prevMatrix != matrix)
-            {
-                delete prevMatrix;
-            }
-
-            prevMatrix = matrix;
-        }
-    }
-
-    cachedFrames.clear();
+    _clearCachedFrames(cachedFrames, packedFrames);
 }
 
 void SlotTimelineData::cacheFrames(std::size_t cacheFrameCount)
 {
-    Matrix* prevMatrix = nullptr;
-    for (const auto matrix : cachedFrames)
-    {
-        if (matrix)
-        {
-            if (prevMatrix && prevMatrix != matrix)
-            {
-                delete prevMatrix;
-            }
-
-            prevMatrix = matrix;
-        }
-    }
-
-    cachedFrames.clear();
+    _clearCachedFrames(cachedFrames, packedFrames);
     cachedFrames.resize(cacheFrameCount, nullptr);
 }
 
+std::size_t SlotTimelineData::packCachedFrames()
+{
+    return _packCachedFrames(cachedFrames, packedFrames);
+}
+
 FFDTimelineData::FFDTimelineData()
 {
     _onClear();
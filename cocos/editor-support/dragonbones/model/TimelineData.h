@@ -60,6 +60,7 @@ public:
     BoneData* bone;
     Transform originTransform;
     std::vector<Matrix*> cachedFrames;
+    std::vector<Matrix> packedFrames;
 
     BoneTimelineData();
     ~BoneTimelineData();
@@ -73,6 +74,8 @@ protected:
 public:
     /** @private */
     void cacheFrames(std::size_t cacheFrameCount);
+    /** @private */
+    std::size_t packCachedFrames();
 };
 
 /**
@@ -88,6 +91,7 @@ public:
 public:
     SlotData* slot;
     std::vector<Matrix*> cachedFrames;
+    std::vector<Matrix> packedFrames;
 
     SlotTimelineData();
     ~SlotTimelineData();
@@ -101,6 +105,8 @@ protected:
 public:
     /** @private */
     void cacheFrames(std::size_t cacheFrameCount);
+    /** @private */
+    std::size_t packCachedFrames();
 };
 
 /**
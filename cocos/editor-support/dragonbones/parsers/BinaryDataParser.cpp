@@ -0,0 +1,1252 @@
+#include "BinaryDataParser.h"
+#include <cstring>
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+namespace
+{
+    // Header: magic, version, byte length, string count, int count, float count, as little endian int32.
+    const char BINARY_MAGIC[4] = { 'D', 'B', 'B', 'N' };
+    const int BINARY_VERSION = 1;
+    const std::size_t BINARY_HEADER_SIZE = 24;
+
+    class BinaryDataWriter
+    {
+    private:
+        std::vector<std::string> _strings;
+        std::unordered_map<std::string, int> _stringIndices;
+        std::vector<int> _ints;
+        std::vector<float> _floats;
+        std::vector<BoneData*> _bones;
+        std::vector<SlotData*> _slots;
+
+        template<class T>
+        static int _indexOf(const std::vector<T*>& values, const T* value)
+        {
+            const auto iterator = std::find(values.cbegin(), values.cend(), value);
+            return iterator != values.cend() ? (int)std::distance(values.cbegin(), iterator) : -1;
+        }
+
+        static void _appendInt(std::vector<char>& buffer, int value)
+        {
+            const auto bytes = reinterpret_cast<const char*>(&value);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(int));
+        }
+
+    public:
+        void writeInt(int value)
+        {
+            _ints.push_back(value);
+        }
+
+        void writeFloat(float value)
+        {
+            _floats.push_back(value);
+        }
+
+        void writeString(const std::string& value)
+        {
+            const auto iterator = _stringIndices.find(value);
+            if (iterator != _stringIndices.end())
+            {
+                writeInt(iterator->second);
+            }
+            else
+            {
+                const auto index = (int)_strings.size();
+                _strings.push_back(value);
+                _stringIndices[value] = index;
+                writeInt(index);
+            }
+        }
+
+        void writeBone(const BoneData* value)
+        {
+            writeInt(_indexOf(_bones, value));
+        }
+
+        void writeSlot(const SlotData* value)
+        {
+            writeInt(_indexOf(_slots, value));
+        }
+
+        void writeTransform(const Transform& value)
+        {
+            writeFloat(value.x);
+            writeFloat(value.y);
+            writeFloat(value.skewX);
+            writeFloat(value.skewY);
+            writeFloat(value.scaleX);
+            writeFloat(value.scaleY);
+        }
+
+        void writeMatrix(const Matrix& value)
+        {
+            writeFloat(value.a);
+            writeFloat(value.b);
+            writeFloat(value.c);
+            writeFloat(value.d);
+            writeFloat(value.tx);
+            writeFloat(value.ty);
+        }
+
+        void writeColorTransform(const ColorTransform& value)
+        {
+            writeFloat(value.alphaMultiplier);
+            writeFloat(value.redMultiplier);
+            writeFloat(value.greenMultiplier);
+            writeFloat(value.blueMultiplier);
+            writeInt(value.alphaOffset);
+            writeInt(value.redOffset);
+            writeInt(value.greenOffset);
+            writeInt(value.blueOffset);
+        }
+
+        void writeActions(const std::vector<ActionData*>& actions)
+        {
+            writeInt((int)actions.size());
+            for (const auto action : actions)
+            {
+                const auto& ints = std::get<0>(action->data);
+                const auto& floats = std::get<1>(action->data);
+                const auto& strings = std::get<2>(action->data);
+
+                writeInt((int)action->type);
+                writeBone(action->bone);
+                writeSlot(action->slot);
+
+                writeInt((int)ints.size());
+                for (const auto value : ints)
+                {
+                    writeInt(value);
+                }
+
+                writeInt((int)floats.size());
+                for (const auto value : floats)
+                {
+                    writeFloat(value);
+                }
+
+                writeInt((int)strings.size());
+                for (const auto& value : strings)
+                {
+                    writeString(value);
+                }
+            }
+        }
+
+        void writeEvents(const std::vector<EventData*>& events)
+        {
+            writeInt((int)events.size());
+            for (const auto event : events)
+            {
+                writeInt((int)event->type);
+                writeString(event->name);
+                writeBone(event->bone);
+                writeSlot(event->slot);
+            }
+        }
+
+        template<class T>
+        void writeFrame(const FrameData<T>& frame)
+        {
+            writeFloat(frame.position);
+            writeFloat(frame.duration);
+            writeActions(frame.actions);
+            writeEvents(frame.events);
+        }
+
+        template<class T>
+        void writeTweenFrame(const TweenFrameData<T>& frame)
+        {
+            writeFrame(frame);
+
+            writeFloat(frame.tweenEasing);
+            writeInt((int)frame.curve.size());
+            for (const auto value : frame.curve)
+            {
+                writeFloat(value);
+            }
+        }
+
+        void writeAnimationFrame(const AnimationFrameData& frame)
+        {
+            writeFrame(frame);
+        }
+
+        void writeBoneFrame(const BoneFrameData& frame)
+        {
+            writeTweenFrame(frame);
+
+            writeInt(frame.tweenScale ? 1 : 0);
+            writeInt(frame.tweenRotate);
+            writeBone(frame.parent);
+            writeTransform(frame.transform);
+        }
+
+        void writeSlotFrame(const SlotFrameData& frame)
+        {
+            writeTweenFrame(frame);
+
+            writeInt(frame.displayIndex);
+            writeInt(frame.zOrder);
+            writeInt(frame.color && frame.color != &SlotFrameData::DEFAULT_COLOR ? 1 : 0);
+            if (frame.color && frame.color != &SlotFrameData::DEFAULT_COLOR)
+            {
+                writeColorTransform(*frame.color);
+            }
+        }
+
+        void writeFFDFrame(const ExtensionFrameData& frame)
+        {
+            writeTweenFrame(frame);
+
+            writeInt((int)frame.type);
+            writeInt((int)frame.tweens.size());
+            writeInt((int)frame.keys.size());
+            for (const auto value : frame.tweens)
+            {
+                writeFloat(value);
+            }
+
+            for (const auto value : frame.keys)
+            {
+                writeFloat(value);
+            }
+        }
+
+        template<class T>
+        void writeTimeline(const TimelineData<T>& timeline, const std::function<void(const T&)>& frameWriter)
+        {
+            std::vector<T*> frames;
+            for (const auto frame : timeline.frames)
+            {
+                if (frame && _indexOf(frames, frame) < 0)
+                {
+                    frames.push_back(frame);
+                }
+            }
+
+            writeFloat(timeline.scale);
+            writeFloat(timeline.offset);
+
+            writeInt((int)frames.size());
+            for (const auto frame : frames)
+            {
+                writeInt(_indexOf(frames, frame->prev));
+                writeInt(_indexOf(frames, frame->next));
+                frameWriter(*frame);
+            }
+
+            std::vector<std::pair<int, int>> runs;
+            for (const auto frame : timeline.frames)
+            {
+                const auto frameIndex = _indexOf(frames, frame);
+                if (frameIndex < 0)
+                {
+                    continue;
+                }
+
+                if (!runs.empty() && runs.back().first == frameIndex)
+                {
+                    runs.back().second++;
+                }
+                else
+                {
+                    runs.push_back(std::make_pair(frameIndex, 1));
+                }
+            }
+
+            writeInt((int)runs.size());
+            for (const auto& run : runs)
+            {
+                writeInt(run.first);
+                writeInt(run.second);
+            }
+        }
+
+        void writeMesh(const MeshData& mesh)
+        {
+            writeInt(mesh.skinned ? 1 : 0);
+            writeMatrix(mesh.slotPose);
+
+            writeInt((int)mesh.uvs.size());
+            for (const auto value : mesh.uvs)
+            {
+                writeFloat(value);
+            }
+
+            writeInt((int)mesh.vertices.size());
+            for (const auto value : mesh.vertices)
+            {
+                writeFloat(value);
+            }
+
+            writeInt((int)mesh.vertexIndices.size());
+            for (const auto value : mesh.vertexIndices)
+            {
+                writeInt(value);
+            }
+
+            if (mesh.skinned)
+            {
+                writeInt((int)mesh.bones.size());
+                for (std::size_t i = 0, l = mesh.bones.size(); i < l; ++i)
+                {
+                    writeBone(mesh.bones[i]);
+                    writeMatrix(mesh.inverseBindPose[i]);
+                }
+
+                writeInt((int)mesh.boneIndices.size());
+                for (std::size_t i = 0, l = mesh.boneIndices.size(); i < l; ++i)
+                {
+                    const auto& boneIndices = mesh.boneIndices[i];
+                    writeInt((int)boneIndices.size());
+                    for (std::size_t j = 0, lJ = boneIndices.size(); j < lJ; ++j)
+                    {
+                        writeInt(boneIndices[j]);
+                        writeFloat(mesh.weights[i][j]);
+                        writeFloat(mesh.boneVertices[i][j * 2]);
+                        writeFloat(mesh.boneVertices[i][j * 2 + 1]);
+                    }
+                }
+            }
+        }
+
+        void writeDisplay(const DisplayData& display)
+        {
+            writeString(display.name);
+            writeInt((int)display.type);
+            writeInt(display.isRelativePivot ? 1 : 0);
+            writeFloat(display.pivot.x);
+            writeFloat(display.pivot.y);
+            writeTransform(display.transform);
+
+            writeInt(display.mesh ? 1 : 0);
+            if (display.mesh)
+            {
+                writeMesh(*display.mesh);
+            }
+        }
+
+        void writeSkin(const SkinData& skin)
+        {
+            std::vector<SlotDisplayDataSet*> slotDisplayDataSets;
+            for (const auto& pair : skin.slots)
+            {
+                if (_indexOf(_slots, pair.second->slot) >= 0)
+                {
+                    slotDisplayDataSets.push_back(pair.second);
+                }
+            }
+
+            writeString(skin.name);
+            writeInt((int)slotDisplayDataSets.size());
+            for (const auto slotDisplayDataSet : slotDisplayDataSets)
+            {
+                writeSlot(slotDisplayDataSet->slot);
+                writeInt((int)slotDisplayDataSet->displays.size());
+                for (const auto display : slotDisplayDataSet->displays)
+                {
+                    writeDisplay(*display);
+                }
+            }
+        }
+
+        void writeAnimation(const AnimationData& animation)
+        {
+            writeString(animation.name);
+            writeString(animation.animation ? animation.animation->name : "");
+            writeInt((int)animation.frameCount);
+            writeInt((int)animation.playTimes);
+            writeInt(animation.hasAsynchronyTimeline ? 1 : 0);
+            writeFloat(animation.position);
+            writeFloat(animation.duration);
+            writeFloat(animation.fadeInTime);
+
+            if (animation.animation)
+            {
+                return;
+            }
+
+            writeTimeline<AnimationFrameData>(animation, std::bind(&BinaryDataWriter::writeAnimationFrame, this, std::placeholders::_1));
+
+            writeInt((int)animation.boneTimelines.size());
+            for (const auto& pair : animation.boneTimelines)
+            {
+                writeBone(pair.second->bone);
+                writeTransform(pair.second->originTransform);
+                writeTimeline<BoneFrameData>(*pair.second, std::bind(&BinaryDataWriter::writeBoneFrame, this, std::placeholders::_1));
+            }
+
+            writeInt((int)animation.slotTimelines.size());
+            for (const auto& pair : animation.slotTimelines)
+            {
+                writeSlot(pair.second->slot);
+                writeTimeline<SlotFrameData>(*pair.second, std::bind(&BinaryDataWriter::writeSlotFrame, this, std::placeholders::_1));
+            }
+
+            std::vector<FFDTimelineData*> ffdTimelines;
+            for (const auto& skinPair : animation.ffdTimelines)
+            {
+                for (const auto& slotPair : skinPair.second)
+                {
+                    for (const auto& pair : slotPair.second)
+                    {
+                        ffdTimelines.push_back(pair.second);
+                    }
+                }
+            }
+
+            writeInt((int)ffdTimelines.size());
+            for (const auto ffdTimeline : ffdTimelines)
+            {
+                writeString(ffdTimeline->skin->name);
+                writeString(ffdTimeline->slot->slot->name);
+                writeInt((int)ffdTimeline->displayIndex);
+                writeTimeline<ExtensionFrameData>(*ffdTimeline, std::bind(&BinaryDataWriter::writeFFDFrame, this, std::placeholders::_1));
+            }
+        }
+
+        void writeArmature(ArmatureData& armature)
+        {
+            _bones = armature.getSortedBones(); // copy
+            _slots = armature.getSortedSlots(); // copy
+
+            writeString(armature.name);
+            writeInt((int)armature.frameRate);
+            writeInt((int)armature.type);
+            writeFloat(armature.aabb.x);
+            writeFloat(armature.aabb.y);
+            writeFloat(armature.aabb.width);
+            writeFloat(armature.aabb.height);
+
+            writeInt((int)_bones.size());
+            for (const auto bone : _bones)
+            {
+                writeString(bone->name);
+                writeBone(bone->parent);
+                writeBone(bone->ik);
+                writeInt(bone->inheritTranslation ? 1 : 0);
+                writeInt(bone->inheritRotation ? 1 : 0);
+                writeInt(bone->inheritScale ? 1 : 0);
+                writeInt(bone->bendPositive ? 1 : 0);
+                writeInt((int)bone->chain);
+                writeInt(bone->chainIndex);
+                writeFloat(bone->weight);
+                writeFloat(bone->length);
+                writeTransform(bone->transform);
+            }
+
+            writeInt((int)_slots.size());
+            for (const auto slot : _slots)
+            {
+                writeString(slot->name);
+                writeBone(slot->parent);
+                writeInt(slot->displayIndex);
+                writeInt(slot->zOrder);
+                writeInt((int)slot->blendMode);
+                writeInt(slot->color && slot->color != &SlotData::DEFAULT_COLOR ? 1 : 0);
+                if (slot->color && slot->color != &SlotData::DEFAULT_COLOR)
+                {
+                    writeColorTransform(*slot->color);
+                }
+
+                writeActions(slot->actions);
+            }
+
+            // The first skin and animation added are the default ones.
+            std::vector<SkinData*> skins;
+            skins.push_back(armature.getDefaultSkin());
+            for (const auto& pair : armature.skins)
+            {
+                if (pair.second != armature.getDefaultSkin())
+                {
+                    skins.push_back(pair.second);
+                }
+            }
+
+            writeInt(armature.getDefaultSkin() ? (int)skins.size() : 0);
+            for (const auto skin : skins)
+            {
+                if (skin)
+                {
+                    writeSkin(*skin);
+                }
+            }
+
+            // The animations reusing the timelines of another one come after it.
+            std::vector<AnimationData*> animations;
+            if (armature.getDefaultAnimation())
+            {
+                animations.push_back(armature.getDefaultAnimation());
+            }
+
+            for (const auto& pair : armature.animations)
+            {
+                if (pair.second != armature.getDefaultAnimation() && !pair.second->animation)
+                {
+                    animations.push_back(pair.second);
+                }
+            }
+
+            for (const auto& pair : armature.animations)
+            {
+                if (pair.second != armature.getDefaultAnimation() && pair.second->animation)
+                {
+                    animations.push_back(pair.second);
+                }
+            }
+
+            writeInt((int)animations.size());
+            for (const auto animation : animations)
+            {
+                writeAnimation(*animation);
+            }
+
+            writeActions(armature.actions);
+
+            _bones.clear();
+            _slots.clear();
+        }
+
+        void writeDragonBonesData(const DragonBonesData& data)
+        {
+            writeString(data.name);
+            writeInt((int)data.frameRate);
+            writeInt(data.autoSearch ? 1 : 0);
+
+            const auto& armatureNames = data.getArmatureNames();
+            writeInt((int)armatureNames.size());
+            for (const auto& armatureName : armatureNames)
+            {
+                writeArmature(*data.getArmature(armatureName));
+            }
+        }
+
+        void output(std::vector<char>& buffer) const
+        {
+            std::size_t byteLength = BINARY_HEADER_SIZE + (_ints.size() + _floats.size()) * 4;
+            for (const auto& value : _strings)
+            {
+                byteLength += 4 + value.size();
+            }
+
+            buffer.clear();
+            buffer.reserve(byteLength);
+            buffer.insert(buffer.end(), BINARY_MAGIC, BINARY_MAGIC + 4);
+            _appendInt(buffer, BINARY_VERSION);
+            _appendInt(buffer, (int)byteLength);
+            _appendInt(buffer, (int)_strings.size());
+            _appendInt(buffer, (int)_ints.size());
+            _appendInt(buffer, (int)_floats.size());
+
+            for (const auto& value : _strings)
+            {
+                _appendInt(buffer, (int)value.size());
+                buffer.insert(buffer.end(), value.begin(), value.end());
+            }
+
+            const auto ints = reinterpret_cast<const char*>(_ints.data());
+            buffer.insert(buffer.end(), ints, ints + _ints.size() * 4);
+
+            const auto floats = reinterpret_cast<const char*>(_floats.data());
+            buffer.insert(buffer.end(), floats, floats + _floats.size() * 4);
+        }
+    };
+
+    inline int _getHeaderValue(const char* rawData, std::size_t index)
+    {
+        int value = 0;
+        std::memcpy(&value, rawData + 4 + index * 4, 4);
+        return value;
+    }
+}
+
+bool BinaryDataParser::isBinaryData(const char* rawData)
+{
+    if (!rawData)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        if (rawData[i] != BINARY_MAGIC[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BinaryDataParser::convertDragonBonesData(const char* rawData, std::vector<char>& binaryData)
+{
+    if (!rawData || isBinaryData(rawData))
+    {
+        return false;
+    }
+
+    JSONDataParser dataParser;
+    const auto data = dataParser.parseDragonBonesData(rawData, 1.f);
+    if (!data)
+    {
+        return false;
+    }
+
+    BinaryDataWriter writer;
+    writer.writeDragonBonesData(*data);
+    writer.output(binaryData);
+
+    data->returnToPool();
+
+    return true;
+}
+
+BinaryDataParser::BinaryDataParser() :
+    _intIndex(0),
+    _floatIndex(0),
+    _isValid(true),
+    _scale(1.f)
+{}
+BinaryDataParser::~BinaryDataParser() {}
+
+ArmatureData* BinaryDataParser::_readArmature()
+{
+    const auto armature = BaseObject::borrowObject<ArmatureData>();
+    armature->name = _readString();
+    armature->frameRate = _readInt();
+    armature->type = (ArmatureType)_readInt();
+    armature->scale = _scale;
+    armature->aabb.x = _readFloat();
+    armature->aabb.y = _readFloat();
+    armature->aabb.width = _readFloat();
+    armature->aabb.height = _readFloat();
+
+    if (armature->frameRate == 0)
+    {
+        armature->frameRate = this->_data->frameRate;
+    }
+
+    this->_armature = armature;
+    this->_rawBones.clear();
+    _rawSlots.clear();
+
+    std::vector<int> ikIndices;
+    const auto boneCount = _readCount();
+    for (std::size_t i = 0; i < boneCount && _isValid; ++i)
+    {
+        std::string parentName;
+        int ikIndex = -1;
+        const auto bone = _readBoneData(parentName, ikIndex);
+        if (bone->name.empty() || armature->getBone(bone->name))
+        {
+            _isValid = false;
+            bone->returnToPool();
+            break;
+        }
+
+        armature->addBone(bone, parentName);
+        this->_rawBones.push_back(bone);
+        ikIndices.push_back(ikIndex);
+    }
+
+    for (std::size_t i = 0, l = ikIndices.size(); i < l; ++i)
+    {
+        if (ikIndices[i] >= 0 && (std::size_t)ikIndices[i] < l)
+        {
+            this->_rawBones[i]->ik = this->_rawBones[ikIndices[i]];
+        }
+        else if (ikIndices[i] != -1)
+        {
+            _isValid = false;
+        }
+    }
+
+    const auto slotCount = _readCount();
+    for (std::size_t i = 0; i < slotCount && _isValid; ++i)
+    {
+        const auto slot = _readSlotData();
+        // The factory adds each slot to its parent bone.
+        if (!slot->parent || slot->name.empty() || armature->getSlot(slot->name))
+        {
+            _isValid = false;
+            slot->returnToPool();
+            break;
+        }
+
+        armature->addSlot(slot);
+        _rawSlots.push_back(slot);
+    }
+
+    const auto skinCount = _readCount();
+    for (std::size_t i = 0; i < skinCount && _isValid; ++i)
+    {
+        const auto skin = _readSkin();
+        if (!_isValid || skin->name.empty() || armature->getSkin(skin->name))
+        {
+            _isValid = false;
+            skin->returnToPool();
+            break;
+        }
+
+        armature->addSkin(skin);
+    }
+
+    const auto animationCount = _readCount();
+    for (std::size_t i = 0; i < animationCount && _isValid; ++i)
+    {
+        const auto animation = _readAnimation();
+        if (!_isValid || animation->name.empty() || armature->getAnimation(animation->name))
+        {
+            _isValid = false;
+            animation->returnToPool();
+            break;
+        }
+
+        armature->addAnimation(animation);
+    }
+
+    _readActions(armature->actions);
+
+    this->_armature = nullptr;
+    this->_rawBones.clear();
+    _rawSlots.clear();
+
+    return armature;
+}
+
+BoneData* BinaryDataParser::_readBoneData(std::string& parentName, int& ikIndex)
+{
+    const auto bone = BaseObject::borrowObject<BoneData>();
+    bone->name = _readString();
+
+    const auto parent = _readBone();
+    if (parent)
+    {
+        parentName = parent->name;
+    }
+
+    ikIndex = _readInt();
+    bone->inheritTranslation = _readInt() != 0;
+    bone->inheritRotation = _readInt() != 0;
+    bone->inheritScale = _readInt() != 0;
+    bone->bendPositive = _readInt() != 0;
+    bone->chain = _readInt();
+    bone->chainIndex = _readInt();
+    bone->weight = _readFloat();
+    bone->length = _readLength();
+    _readTransform(bone->transform);
+
+    return bone;
+}
+
+SlotData* BinaryDataParser::_readSlotData()
+{
+    const auto slot = BaseObject::borrowObject<SlotData>();
+    slot->name = _readString();
+    slot->parent = _readBone();
+    slot->displayIndex = _readInt();
+    slot->zOrder = _readInt();
+    slot->blendMode = (BlendMode)_readInt();
+
+    if (_readInt() != 0)
+    {
+        slot->color = SlotData::generateColor();
+        _readColorTransform(*slot->color);
+    }
+    else
+    {
+        slot->color = &SlotData::DEFAULT_COLOR;
+    }
+
+    _readActions(slot->actions);
+
+    return slot;
+}
+
+SkinData* BinaryDataParser::_readSkin()
+{
+    const auto skin = BaseObject::borrowObject<SkinData>();
+    skin->name = _readString();
+
+    const auto slotCount = _readCount();
+    for (std::size_t i = 0; i < slotCount && _isValid; ++i)
+    {
+        const auto slotDisplayDataSet = BaseObject::borrowObject<SlotDisplayDataSet>();
+        slotDisplayDataSet->slot = _readSlot();
+
+        const auto displayCount = _readCount();
+        auto& displayDataSet = slotDisplayDataSet->displays;
+        displayDataSet.reserve(displayCount);
+        for (std::size_t j = 0; j < displayCount && _isValid; ++j)
+        {
+            displayDataSet.push_back(_readDisplay());
+        }
+
+        if (!slotDisplayDataSet->slot || skin->getSlot(slotDisplayDataSet->slot->name))
+        {
+            _isValid = false;
+            slotDisplayDataSet->returnToPool();
+            break;
+        }
+
+        skin->addSlot(slotDisplayDataSet);
+    }
+
+    return skin;
+}
+
+DisplayData* BinaryDataParser::_readDisplay()
+{
+    const auto display = BaseObject::borrowObject<DisplayData>();
+    display->name = _readString();
+    display->type = (DisplayType)_readInt();
+    display->isRelativePivot = _readInt() != 0;
+    display->pivot.x = display->isRelativePivot ? _readFloat() : _readLength();
+    display->pivot.y = display->isRelativePivot ? _readFloat() : _readLength();
+    _readTransform(display->transform);
+
+    if (_readInt() != 0)
+    {
+        display->mesh = _readMesh();
+    }
+
+    return display;
+}
+
+MeshData* BinaryDataParser::_readMesh()
+{
+    const auto mesh = BaseObject::borrowObject<MeshData>();
+    mesh->skinned = _readInt() != 0;
+    _readMatrix(mesh->slotPose);
+
+    mesh->uvs.resize(_readCount());
+    for (auto& value : mesh->uvs)
+    {
+        value = _readFloat();
+    }
+
+    mesh->vertices.resize(_readCount());
+    for (auto& value : mesh->vertices)
+    {
+        value = _readLength();
+    }
+
+    mesh->vertexIndices.resize(_readCount());
+    for (auto& value : mesh->vertexIndices)
+    {
+        const auto vertexIndex = _readInt();
+        if (vertexIndex < 0 || (std::size_t)vertexIndex >= mesh->vertices.size() / 2)
+        {
+            _isValid = false;
+        }
+
+        value = (unsigned short)vertexIndex;
+    }
+
+    if (mesh->skinned)
+    {
+        const auto boneCount = _readCount();
+        mesh->bones.reserve(boneCount);
+        mesh->inverseBindPose.resize(boneCount);
+        for (std::size_t i = 0; i < boneCount; ++i)
+        {
+            mesh->bones.push_back(_readBone());
+            _readMatrix(mesh->inverseBindPose[i]);
+        }
+
+        const auto vertexCount = _readCount();
+        mesh->boneIndices.resize(vertexCount);
+        mesh->weights.resize(vertexCount);
+        mesh->boneVertices.resize(vertexCount);
+        for (std::size_t i = 0; i < vertexCount && _isValid; ++i)
+        {
+            const auto vertexBoneCount = _readCount();
+            auto& boneIndices = mesh->boneIndices[i];
+            auto& weights = mesh->weights[i];
+            auto& boneVertices = mesh->boneVertices[i];
+            boneIndices.reserve(vertexBoneCount);
+            weights.reserve(vertexBoneCount);
+            boneVertices.reserve(vertexBoneCount * 2);
+
+            for (std::size_t j = 0; j < vertexBoneCount; ++j)
+            {
+                const auto boneIndex = _readInt();
+                if (boneIndex < 0 || (std::size_t)boneIndex >= boneCount)
+                {
+                    _isValid = false;
+                }
+
+                boneIndices.push_back((unsigned short)boneIndex);
+                weights.push_back(_readFloat());
+                boneVertices.push_back(_readLength());
+                boneVertices.push_back(_readLength());
+            }
+        }
+
+        if (std::find(mesh->bones.cbegin(), mesh->bones.cend(), nullptr) != mesh->bones.cend())
+        {
+            _isValid = false;
+        }
+    }
+
+    return mesh;
+}
+
+AnimationData* BinaryDataParser::_readAnimation()
+{
+    const auto animation = BaseObject::borrowObject<AnimationData>();
+    animation->name = _readString();
+
+    const auto animationName = _readString();
+    const auto frameCount = _readInt();
+    animation->frameCount = frameCount > 0 ? (unsigned)frameCount : 1;
+    animation->playTimes = _readInt();
+    animation->hasAsynchronyTimeline = _readInt() != 0;
+    animation->position = _readFloat();
+    animation->duration = _readFloat();
+    animation->fadeInTime = _readFloat();
+
+    if (!animationName.empty())
+    {
+        animation->animation = this->_armature->getAnimation(animationName);
+        return animation;
+    }
+
+    this->_animation = animation;
+
+    _readTimeline<AnimationFrameData>(*animation, std::bind(&BinaryDataParser::_readAnimationFrame, this));
+
+    const auto boneTimelineCount = _readCount();
+    for (std::size_t i = 0; i < boneTimelineCount && _isValid; ++i)
+    {
+        const auto timeline = BaseObject::borrowObject<BoneTimelineData>();
+        timeline->bone = _readBone();
+        _readTransform(timeline->originTransform);
+        _readTimeline<BoneFrameData>(*timeline, std::bind(&BinaryDataParser::_readBoneFrame, this));
+
+        if (!timeline->bone || animation->getBoneTimeline(timeline->bone->name))
+        {
+            _isValid = false;
+            timeline->returnToPool();
+            break;
+        }
+
+        animation->addBoneTimeline(timeline);
+    }
+
+    const auto slotTimelineCount = _readCount();
+    for (std::size_t i = 0; i < slotTimelineCount && _isValid; ++i)
+    {
+        const auto timeline = BaseObject::borrowObject<SlotTimelineData>();
+        timeline->slot = _readSlot();
+        _readTimeline<SlotFrameData>(*timeline, std::bind(&BinaryDataParser::_readSlotFrame, this));
+
+        if (!timeline->slot || animation->getSlotTimeline(timeline->slot->name))
+        {
+            _isValid = false;
+            timeline->returnToPool();
+            break;
+        }
+
+        animation->addSlotTimeline(timeline);
+    }
+
+    const auto ffdTimelineCount = _readCount();
+    for (std::size_t i = 0; i < ffdTimelineCount && _isValid; ++i)
+    {
+        const auto timeline = BaseObject::borrowObject<FFDTimelineData>();
+        const auto skinName = _readString();
+        const auto slotName = _readString();
+        timeline->skin = this->_armature->getSkin(skinName);
+        timeline->slot = timeline->skin ? timeline->skin->getSlot(slotName) : nullptr;
+        timeline->displayIndex = _readInt();
+        _readTimeline<ExtensionFrameData>(*timeline, std::bind(&BinaryDataParser::_readFFDFrame, this));
+
+        if (!timeline->slot || animation->getFFDTimeline(skinName, slotName, timeline->displayIndex))
+        {
+            _isValid = false;
+            timeline->returnToPool();
+            break;
+        }
+
+        animation->addFFDTimeline(timeline);
+    }
+
+    this->_animation = nullptr;
+
+    return animation;
+}
+
+void BinaryDataParser::_readActions(std::vector<ActionData*>& actions)
+{
+    const auto actionCount = _readCount();
+    for (std::size_t i = 0; i < actionCount && _isValid; ++i)
+    {
+        const auto actionData = BaseObject::borrowObject<ActionData>();
+        actionData->type = (ActionType)_readInt();
+        actionData->bone = _readBone();
+        actionData->slot = _readSlot();
+
+        auto& ints = std::get<0>(actionData->data);
+        auto& floats = std::get<1>(actionData->data);
+        auto& strings = std::get<2>(actionData->data);
+
+        ints.resize(_readCount());
+        for (auto& value : ints)
+        {
+            value = _readInt();
+        }
+
+        floats.resize(_readCount());
+        for (auto& value : floats)
+        {
+            value = _readFloat();
+        }
+
+        strings.resize(_readCount());
+        for (auto& value : strings)
+        {
+            value = _readString();
+        }
+
+        actions.push_back(actionData);
+    }
+}
+
+void BinaryDataParser::_readEvents(std::vector<EventData*>& events)
+{
+    const auto eventCount = _readCount();
+    for (std::size_t i = 0; i < eventCount && _isValid; ++i)
+    {
+        const auto eventData = BaseObject::borrowObject<EventData>();
+        eventData->type = (EventType)_readInt();
+        eventData->name = _readString();
+        eventData->bone = _readBone();
+        eventData->slot = _readSlot();
+        events.push_back(eventData);
+    }
+}
+
+void BinaryDataParser::_readTransform(Transform& transform)
+{
+    transform.x = _readLength();
+    transform.y = _readLength();
+    transform.skewX = _readFloat();
+    transform.skewY = _readFloat();
+    transform.scaleX = _readFloat();
+    transform.scaleY = _readFloat();
+}
+
+void BinaryDataParser::_readMatrix(Matrix& matrix)
+{
+    matrix.a = _readFloat();
+    matrix.b = _readFloat();
+    matrix.c = _readFloat();
+    matrix.d = _readFloat();
+    matrix.tx = _readLength();
+    matrix.ty = _readLength();
+}
+
+void BinaryDataParser::_readColorTransform(ColorTransform& color)
+{
+    color.alphaMultiplier = _readFloat();
+    color.redMultiplier = _readFloat();
+    color.greenMultiplier = _readFloat();
+    color.blueMultiplier = _readFloat();
+    color.alphaOffset = _readInt();
+    color.redOffset = _readInt();
+    color.greenOffset = _readInt();
+    color.blueOffset = _readInt();
+}
+
+AnimationFrameData* BinaryDataParser::_readAnimationFrame()
+{
+    const auto frame = BaseObject::borrowObject<AnimationFrameData>();
+    _readFrame(*frame);
+
+    return frame;
+}
+
+BoneFrameData* BinaryDataParser::_readBoneFrame()
+{
+    const auto frame = BaseObject::borrowObject<BoneFrameData>();
+    _readTweenFrame(*frame);
+
+    frame->tweenScale = _readInt() != 0;
+    frame->tweenRotate = _readInt();
+    frame->parent = _readBone();
+    _readTransform(frame->transform);
+
+    return frame;
+}
+
+SlotFrameData* BinaryDataParser::_readSlotFrame()
+{
+    const auto frame = BaseObject::borrowObject<SlotFrameData>();
+    _readTweenFrame(*frame);
+
+    frame->displayIndex = _readInt();
+    frame->zOrder = _readInt();
+
+    if (_readInt() != 0)
+    {
+        frame->color = SlotFrameData::generateColor();
+        _readColorTransform(*frame->color);
+    }
+    else
+    {
+        frame->color = &SlotFrameData::DEFAULT_COLOR;
+    }
+
+    return frame;
+}
+
+ExtensionFrameData* BinaryDataParser::_readFFDFrame()
+{
+    const auto frame = BaseObject::borrowObject<ExtensionFrameData>();
+    _readTweenFrame(*frame);
+
+    frame->type = (ExtensionType)_readInt();
+    frame->tweens.resize(_readCount());
+    frame->keys.resize(_readCount());
+
+    for (auto& value : frame->tweens)
+    {
+        value = frame->type == ExtensionType::FFD ? _readLength() : _readFloat();
+    }
+
+    for (auto& value : frame->keys)
+    {
+        value = _readFloat();
+    }
+
+    return frame;
+}
+
+DragonBonesData* BinaryDataParser::parseDragonBonesData(const char* rawData, float scale)
+{
+    if (!isBinaryData(rawData))
+    {
+        return JSONDataParser::parseDragonBonesData(rawData, scale);
+    }
+
+    DRAGONBONES_ASSERT(false, "Binary data is parsed with its length.");
+    return nullptr;
+}
+
+DragonBonesData* BinaryDataParser::parseDragonBonesData(const char* rawData, std::size_t length, float scale)
+{
+    if (!rawData || length < sizeof(BINARY_MAGIC) || !isBinaryData(rawData))
+    {
+        return JSONDataParser::parseDragonBonesData(rawData, scale);
+    }
+
+    if (length < BINARY_HEADER_SIZE)
+    {
+        DRAGONBONES_ASSERT(false, "Argument error.");
+        return nullptr;
+    }
+
+    const auto version = _getHeaderValue(rawData, 0);
+    if (version != BINARY_VERSION)
+    {
+        DRAGONBONES_ASSERT(false, "Nonsupport data version.");
+        return nullptr;
+    }
+
+    // Each string takes 4 bytes at least, as each int and float.
+    const auto maxCount = length / 4;
+    const auto byteLength = (std::size_t)(unsigned)_getHeaderValue(rawData, 1);
+    const auto stringCount = (std::size_t)(unsigned)_getHeaderValue(rawData, 2);
+    const auto intCount = (std::size_t)(unsigned)_getHeaderValue(rawData, 3);
+    const auto floatCount = (std::size_t)(unsigned)_getHeaderValue(rawData, 4);
+    if (byteLength != length || stringCount > maxCount || intCount > maxCount || floatCount > maxCount)
+    {
+        DRAGONBONES_ASSERT(false, "Argument error.");
+        return nullptr;
+    }
+
+    _strings.clear();
+    _strings.reserve(stringCount);
+    _isValid = true;
+    _scale = scale;
+
+    std::size_t offset = BINARY_HEADER_SIZE;
+    for (std::size_t i = 0; i < stringCount && _isValid; ++i)
+    {
+        int stringLength = -1;
+        if (offset + 4 <= byteLength)
+        {
+            std::memcpy(&stringLength, rawData + offset, 4);
+            offset += 4;
+        }
+
+        if (stringLength >= 0 && (std::size_t)stringLength <= byteLength - offset)
+        {
+            _strings.push_back(std::string(rawData + offset, stringLength));
+            offset += stringLength;
+        }
+        else
+        {
+            _isValid = false;
+        }
+    }
+
+    if (!_isValid || offset + (intCount + floatCount) * 4 != byteLength)
+    {
+        DRAGONBONES_ASSERT(false, "Argument error.");
+        return nullptr;
+    }
+
+    _ints.resize(intCount);
+    _floats.resize(floatCount);
+    std::memcpy(_ints.data(), rawData + offset, intCount * 4);
+    std::memcpy(_floats.data(), rawData + offset + intCount * 4, floatCount * 4);
+    _intIndex = 0;
+    _floatIndex = 0;
+
+    const auto data = BaseObject::borrowObject<DragonBonesData>();
+    data->name = _readString();
+    data->frameRate = _readInt();
+    data->autoSearch = _readInt() != 0;
+    if (data->frameRate == 0)
+    {
+        data->frameRate = 24;
+    }
+
+    this->_data = data;
+
+    const auto armatureCount = _readCount();
+    for (std::size_t i = 0; i < armatureCount && _isValid; ++i)
+    {
+        const auto armature = _readArmature();
+        if (!_isValid || armature->name.empty() || data->getArmature(armature->name))
+        {
+            _isValid = false;
+            armature->returnToPool();
+            break;
+        }
+
+        data->addArmature(armature);
+    }
+
+    this->_data = nullptr;
+
+    _strings.clear();
+    _ints.clear();
+    _floats.clear();
+
+    if (!_isValid)
+    {
+        data->returnToPool();
+        DRAGONBONES_ASSERT(false, "Argument error.");
+        return nullptr;
+    }
+
+    return data;
+}
+
+DRAGONBONES_NAMESPACE_END
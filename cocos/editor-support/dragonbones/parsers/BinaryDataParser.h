@@ -0,0 +1,231 @@
+#ifndef DRAGONBONES_BINARY_DATA_PARSER_H
+#define DRAGONBONES_BINARY_DATA_PARSER_H
+
+#include "JSONDataParser.h"
+
+DRAGONBONES_NAMESPACE_BEGIN
+
+/**
+ * @private
+ * Parses the binary DragonBones data written by convertDragonBonesData, any other data is parsed as JSON.
+ * The binary data holds the parsed model in a string table and two flat arrays of ints and floats, read back in order.
+ */
+class BinaryDataParser : public JSONDataParser
+{
+public:
+    /** Returns whether the data starts like binary DragonBones data. */
+    static bool isBinaryData(const char* rawData);
+
+    /**
+     * Parses JSON DragonBones data and writes it in the binary format, returns false if the data can not be parsed.
+     * The lengths are written at scale 1, the scale is applied when the binary data is parsed.
+     */
+    static bool convertDragonBonesData(const char* rawData, std::vector<char>& binaryData);
+
+protected:
+    std::vector<std::string> _strings;
+    std::vector<int> _ints;
+    std::vector<float> _floats;
+    std::size_t _intIndex;
+    std::size_t _floatIndex;
+    bool _isValid;
+    float _scale;
+    std::vector<SlotData*> _rawSlots;
+
+public:
+    BinaryDataParser();
+    ~BinaryDataParser();
+
+private:
+    DRAGONBONES_DISALLOW_COPY_AND_ASSIGN(BinaryDataParser);
+
+protected:
+    inline int _readInt()
+    {
+        if (_intIndex < _ints.size())
+        {
+            return _ints[_intIndex++];
+        }
+
+        _isValid = false;
+        return 0;
+    }
+
+    inline float _readFloat()
+    {
+        if (_floatIndex < _floats.size())
+        {
+            return _floats[_floatIndex++];
+        }
+
+        _isValid = false;
+        return 0.f;
+    }
+
+    inline float _readLength()
+    {
+        return _readFloat() * _scale;
+    }
+
+    inline std::size_t _readCount()
+    {
+        const auto value = _readInt();
+        if (value < 0 || (std::size_t)value > _ints.size() + _floats.size())
+        {
+            _isValid = false;
+            return 0;
+        }
+
+        return (std::size_t)value;
+    }
+
+    inline std::string _readString()
+    {
+        const auto index = _readInt();
+        if (index >= 0 && (std::size_t)index < _strings.size())
+        {
+            return _strings[index];
+        }
+
+        _isValid = false;
+        return "";
+    }
+
+    // -1 is written for no bone or slot, any other index must have been read before.
+    inline BoneData* _readBone()
+    {
+        const auto index = _readInt();
+        if (index >= 0 && (std::size_t)index < _rawBones.size())
+        {
+            return _rawBones[index];
+        }
+
+        if (index != -1)
+        {
+            _isValid = false;
+        }
+
+        return nullptr;
+    }
+
+    inline SlotData* _readSlot()
+    {
+        const auto index = _readInt();
+        if (index >= 0 && (std::size_t)index < _rawSlots.size())
+        {
+            return _rawSlots[index];
+        }
+
+        if (index != -1)
+        {
+            _isValid = false;
+        }
+
+        return nullptr;
+    }
+
+    virtual ArmatureData* _readArmature();
+    virtual BoneData* _readBoneData(std::string& parentName, int& ikIndex);
+    virtual SlotData* _readSlotData();
+    virtual SkinData* _readSkin();
+    virtual DisplayData* _readDisplay();
+    virtual MeshData* _readMesh();
+    virtual AnimationData* _readAnimation();
+    virtual void _readActions(std::vector<ActionData*>& actions);
+    virtual void _readEvents(std::vector<EventData*>& events);
+    virtual void _readTransform(Transform& transform);
+    virtual void _readMatrix(Matrix& matrix);
+    virtual void _readColorTransform(ColorTransform& color);
+    virtual AnimationFrameData* _readAnimationFrame();
+    virtual BoneFrameData* _readBoneFrame();
+    virtual SlotFrameData* _readSlotFrame();
+    virtual ExtensionFrameData* _readFFDFrame();
+
+    template<class T>
+    void _readFrame(FrameData<T>& frame)
+    {
+        frame.position = _readFloat();
+        frame.duration = _readFloat();
+        _readActions(frame.actions);
+        _readEvents(frame.events);
+    }
+
+    template<class T>
+    void _readTweenFrame(TweenFrameData<T>& frame)
+    {
+        _readFrame(frame);
+
+        frame.tweenEasing = _readFloat();
+        frame.curve.resize(_readCount());
+        for (auto& value : frame.curve)
+        {
+            value = _readFloat();
+        }
+    }
+
+    template<class T>
+    void _readTimeline(TimelineData<T>& timeline, const std::function<T*()>& frameReader)
+    {
+        timeline.scale = _readFloat();
+        timeline.offset = _readFloat();
+
+        const auto frameCount = _readCount();
+        std::vector<T*> frames;
+        std::vector<int> links;
+        frames.reserve(frameCount);
+        links.reserve(frameCount * 2);
+
+        for (std::size_t i = 0; i < frameCount && _isValid; ++i)
+        {
+            links.push_back(_readInt());
+            links.push_back(_readInt());
+            frames.push_back(frameReader());
+        }
+
+        for (std::size_t i = 0, l = frames.size(); i < l; ++i)
+        {
+            const auto prevIndex = links[i * 2];
+            const auto nextIndex = links[i * 2 + 1];
+            frames[i]->prev = (prevIndex >= 0 && (std::size_t)prevIndex < l) ? frames[prevIndex] : nullptr;
+            frames[i]->next = (nextIndex >= 0 && (std::size_t)nextIndex < l) ? frames[nextIndex] : nullptr;
+        }
+
+        // The frames are stored once, the timeline repeats each of them for every frame it lasts,
+        // at most once for each frame of the animation and the end, as the JSON parser does.
+        const auto maxFrameCount = (std::size_t)this->_animation->frameCount + 1;
+        const auto runCount = _readCount();
+        for (std::size_t i = 0; i < runCount && _isValid; ++i)
+        {
+            const auto frameIndex = _readInt();
+            const auto runLength = _readCount();
+            if (frameIndex >= 0 && (std::size_t)frameIndex < frames.size() && runLength <= maxFrameCount - timeline.frames.size())
+            {
+                timeline.frames.insert(timeline.frames.end(), runLength, frames[frameIndex]);
+            }
+            else
+            {
+                _isValid = false;
+            }
+        }
+
+        if (timeline.frames.empty())
+        {
+            for (const auto frame : frames)
+            {
+                frame->returnToPool();
+            }
+        }
+    }
+
+public:
+    /** Binary data can only be parsed with its length, see the overload below. */
+    virtual DragonBonesData* parseDragonBonesData(const char* rawData, float scale = 1.f) override;
+    /**
+     * Parses length bytes of binary data, or JSON data, which must still be null terminated.
+     * Every offset and count of the binary data is checked against the length, nullptr is returned if one is out of range.
+     */
+    DragonBonesData* parseDragonBonesData(const char* rawData, std::size_t length, float scale = 1.f);
+};
+
+DRAGONBONES_NAMESPACE_END
+#endif // DRAGONBONES_BINARY_DATA_PARSER_H
@@ -33,6 +33,9 @@ RegionAttachment.c \
 Skeleton.c \
 SkeletonAnimation.cpp \
 SkeletonBatch.cpp \
+SkeletonCache.cpp \
+SkeletonDataCache.cpp \
+SkeletonSystem.cpp \
 SkeletonBinary.c \
 SkeletonBounds.c \
 SkeletonData.c \
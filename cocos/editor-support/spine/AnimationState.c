@@ -47,6 +47,7 @@ void _spAnimationState_disposeTrackEntry (spTrackEntry* entry);
 void _spAnimationState_disposeTrackEntries (spAnimationState* state, spTrackEntry* entry);
 void _spAnimationState_updateMixingFrom (spAnimationState* self, spTrackEntry* entry, float delta);
 float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* entry, spSkeleton* skeleton);
+void _spAnimationState_applyMixingFromEvents (spAnimationState* self, spTrackEntry* entry, spSkeleton* skeleton);
 void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline* timeline, spSkeleton* skeleton, float time, float alpha, int /*boolean*/ setupPose, float* timelinesRotation, int i, int /*boolean*/ firstFrame);
 void _spAnimationState_queueEvents (spAnimationState* self, spTrackEntry* entry, float animationTime);
 void _spAnimationState_setCurrent (spAnimationState* self, int index, spTrackEntry* current, int /*boolean*/ interrupt);
@@ -315,6 +316,15 @@ void _spAnimationState_updateMixingFrom (spAnimationState* self, spTrackEntry* e
 }
 
 void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
+	spAnimationState_applyPose(self, skeleton);
+	spAnimationState_drainEvents(self);
+}
+
+void spAnimationState_drainEvents (spAnimationState* self) {
+	_spEventQueue_drain(SUB_CAST(_spAnimationState, self)->queue);
+}
+
+void spAnimationState_applyPose (spAnimationState* self, spSkeleton* skeleton) {
 	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
 	spTrackEntry* current;
 	int i, ii, n;
@@ -366,6 +376,32 @@ void spAnimationState_apply (spAnimationState* self, spSkeleton* skeleton) {
 		current->nextAnimationLast = animationTime;
 		current->nextTrackLast = current->trackTime;
 	}
+}
+
+void spAnimationState_applyEvents (spAnimationState* self, spSkeleton* skeleton) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	spTrackEntry* current;
+	int i, ii, n;
+	float animationLast, animationTime;
+
+	for (i = 0, n = self->tracksCount; i < n; i++) {
+		current = self->tracks[i];
+		if (!current || current->delay > 0) continue;
+
+		/* The entries mixed out still fire their events and complete and end callbacks. */
+		if (current->mixingFrom) _spAnimationState_applyMixingFromEvents(self, current, skeleton);
+
+		animationLast = current->animationLast; animationTime = spTrackEntry_getAnimationTime(current);
+		for (ii = 0; ii < current->animation->timelinesCount; ii++) {
+			spTimeline* timeline = current->animation->timelines[ii];
+			if (timeline->type == SP_TIMELINE_EVENT)
+				spTimeline_apply(timeline, skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, 1, 1, 0);
+		}
+		_spAnimationState_queueEvents(self, current, animationTime);
+		internal->eventsCount = 0;
+		current->nextAnimationLast = animationTime;
+		current->nextTrackLast = current->trackTime;
+	}
 
 	_spEventQueue_drain(internal->queue);
 }
@@ -434,6 +470,39 @@ float _spAnimationState_applyMixingFrom (spAnimationState* self, spTrackEntry* e
 	return mix;
 }
 
+void _spAnimationState_applyMixingFromEvents (spAnimationState* self, spTrackEntry* entry, spSkeleton* skeleton) {
+	_spAnimationState* internal = SUB_CAST(_spAnimationState, self);
+	float mix;
+	float animationLast;
+	float animationTime;
+	int i;
+
+	spTrackEntry* from = entry->mixingFrom;
+	if (from->mixingFrom) _spAnimationState_applyMixingFromEvents(self, from, skeleton);
+
+	if (entry->mixDuration == 0)
+		mix = 1;
+	else {
+		mix = entry->mixTime / entry->mixDuration;
+		if (mix > 1) mix = 1;
+	}
+
+	animationLast = from->animationLast;
+	animationTime = spTrackEntry_getAnimationTime(from);
+	if (mix < from->eventThreshold) {
+		for (i = 0; i < from->animation->timelinesCount; i++) {
+			spTimeline* timeline = from->animation->timelines[i];
+			if (timeline->type == SP_TIMELINE_EVENT)
+				spTimeline_apply(timeline, skeleton, animationLast, animationTime, internal->events, &internal->eventsCount, 1, 1, 1);
+		}
+	}
+
+	if (entry->mixDuration > 0) _spAnimationState_queueEvents(self, from, animationTime);
+	internal->eventsCount = 0;
+	from->nextAnimationLast = animationTime;
+	from->nextTrackLast = from->trackTime;
+}
+
 void _spAnimationState_applyRotateTimeline (spAnimationState* self, spTimeline* timeline, spSkeleton* skeleton, float time, float alpha, int /*boolean*/ setupPose, float* timelinesRotation, int i, int /*boolean*/ firstFrame) {
 	spRotateTimeline *rotateTimeline;
 	float *frames;
@@ -113,6 +113,13 @@ void spAnimationState_dispose (spAnimationState* self);
 
 void spAnimationState_update (spAnimationState* self, float delta);
 void spAnimationState_apply (spAnimationState* self, struct spSkeleton* skeleton);
+/* Fires the events and completions spAnimationState_apply would, without posing the skeleton. For renderers sampling the
+ * current animations themselves. */
+void spAnimationState_applyEvents (spAnimationState* self, struct spSkeleton* skeleton);
+/* Applies the animations like spAnimationState_apply but keeps the events queued until spAnimationState_drainEvents. Lets
+ * the skeletons of different states be posed on other threads, the listeners being called on the thread draining. */
+void spAnimationState_applyPose (spAnimationState* self, struct spSkeleton* skeleton);
+void spAnimationState_drainEvents (spAnimationState* self);
 
 void spAnimationState_clearTracks (spAnimationState* self);
 void spAnimationState_clearTrack (spAnimationState* self, int trackIndex);
@@ -159,6 +166,9 @@ typedef spAnimationState AnimationState;
 #define AnimationState_dispose(...) spAnimationState_dispose(__VA_ARGS__)
 #define AnimationState_update(...) spAnimationState_update(__VA_ARGS__)
 #define AnimationState_apply(...) spAnimationState_apply(__VA_ARGS__)
+#define AnimationState_applyEvents(...) spAnimationState_applyEvents(__VA_ARGS__)
+#define AnimationState_applyPose(...) spAnimationState_applyPose(__VA_ARGS__)
+#define AnimationState_drainEvents(...) spAnimationState_drainEvents(__VA_ARGS__)
 #define AnimationState_clearTracks(...) spAnimationState_clearTracks(__VA_ARGS__)
 #define AnimationState_clearTrack(...) spAnimationState_clearTrack(__VA_ARGS__)
 #define AnimationState_setAnimationByName(...) spAnimationState_setAnimationByName(__VA_ARGS__)
@@ -30,6 +30,8 @@
 
 #include <spine/SkeletonAnimation.h>
 #include <spine/spine-cocos2dx.h>
+#include <spine/SkeletonCache.h>
+#include <spine/SkeletonSystem.h>
 #include <spine/extension.h>
 #include <algorithm>
 
@@ -85,8 +87,7 @@ SkeletonAnimation* SkeletonAnimation::createWithJsonFile (const std::string& ske
 
 SkeletonAnimation* SkeletonAnimation::createWithJsonFile (const std::string& skeletonJsonFile, const std::string& atlasFile, float scale) {
 	SkeletonAnimation* node = new SkeletonAnimation();
-	spAtlas* atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-	node->initWithJsonFile(skeletonJsonFile, atlas, scale);
+	node->initWithJsonFile(skeletonJsonFile, atlasFile, scale);
 	node->autorelease();
 	return node;
 }
@@ -100,8 +101,7 @@ SkeletonAnimation* SkeletonAnimation::createWithBinaryFile (const std::string& s
 
 SkeletonAnimation* SkeletonAnimation::createWithBinaryFile (const std::string& skeletonBinaryFile, const std::string& atlasFile, float scale) {
 	SkeletonAnimation* node = new SkeletonAnimation();
-	spAtlas* atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-	node->initWithBinaryFile(skeletonBinaryFile, atlas, scale);
+	node->initWithBinaryFile(skeletonBinaryFile, atlasFile, scale);
 	node->autorelease();
 	return node;
 }
@@ -116,10 +116,15 @@ void SkeletonAnimation::initialize () {
 	_state->listener = animationCallback;
 
 	_spAnimationState* stateInternal = (_spAnimationState*)_state;
+
+	_bakedCacheEnabled = false;
+	_bakedAnimation = nullptr;
+	_bakedTime = 0;
+	_updatedBySystem = false;
 }
 
 SkeletonAnimation::SkeletonAnimation ()
-		: SkeletonRenderer() {
+		: SkeletonRenderer(), _bakedCacheEnabled(false), _bakedAnimation(nullptr), _bakedTime(0), _updatedBySystem(false) {
 }
 
 SkeletonAnimation::SkeletonAnimation (spSkeletonData *skeletonData, bool ownsSkeletonData)
@@ -147,10 +152,99 @@ void SkeletonAnimation::update (float deltaTime) {
 
 	deltaTime *= _timeScale;
 	spAnimationState_update(_state, deltaTime);
+
+	if (_bakedCacheEnabled) {
+		// the events are fired as usual, the pose is sampled from the cache when drawn
+		spAnimationState_applyEvents(_state, _skeleton);
+		spTrackEntry* entry = spAnimationState_getCurrent(_state, 0);
+		if (entry && entry->delay <= 0) {
+			_bakedAnimation = entry->animation;
+			_bakedTime = spTrackEntry_getAnimationTime(entry);
+		} else {
+			_bakedAnimation = nullptr;
+		}
+		return;
+	}
+
+	// applied on the worker threads of the SkeletonSystem after all the updates
+	if (_updatedBySystem) return;
+
 	spAnimationState_apply(_state, _skeleton);
 	spSkeleton_updateWorldTransform(_skeleton);
 }
 
+void SkeletonAnimation::onEnter () {
+	super::onEnter();
+	SkeletonSystem* system = SkeletonSystem::getInstance();
+	if (system->isEnabled() && !_updatedBySystem) system->addSkeleton(this);
+}
+
+void SkeletonAnimation::onExit () {
+	if (_updatedBySystem) SkeletonSystem::getInstance()->removeSkeleton(this);
+	super::onExit();
+}
+
+void SkeletonAnimation::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	if (_updatedBySystem) SkeletonSystem::getInstance()->waitForUpdate();
+	if (_bakedCacheEnabled && _bakedAnimation) {
+		drawBakedFrame(renderer, transform, transformFlags);
+		return;
+	}
+	super::draw(renderer, transform, transformFlags);
+}
+
+void SkeletonAnimation::drawBakedFrame (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	const SkeletonCache::Frame* frame = SkeletonCache::getInstance()->getFrame(_skeleton, _bakedAnimation, _bakedTime, _premultipliedAlpha);
+	SkeletonBatch* batch = SkeletonBatch::getInstance();
+
+	// the cached colors are modulated by the skeleton color as SkeletonRenderer::prepareVertices does
+	updateSkeletonColor();
+	float alpha = _skeleton->a;
+	bool tinted = _skeleton->r != 1 || _skeleton->g != 1 || _skeleton->b != 1 || alpha < 1;
+	float multiplier = _premultipliedAlpha ? alpha : 1;
+	float r = _skeleton->r * multiplier;
+	float g = _skeleton->g * multiplier;
+	float b = _skeleton->b * multiplier;
+
+	TrianglesCommand::Triangles triangles;
+	for (const auto& segment : frame->segments) {
+		triangles.verts = const_cast<V3F_C4B_T2F*>(&frame->vertices[segment.vertexStart]);
+		triangles.vertCount = segment.vertexCount;
+		triangles.indices = const_cast<unsigned short*>(&frame->indices[segment.indexStart]);
+		triangles.indexCount = segment.indexCount;
+
+		if (tinted) {
+			_bakedVertices.assign(triangles.verts, triangles.verts + triangles.vertCount);
+			for (auto& vertex : _bakedVertices) {
+				vertex.colors.r = (GLubyte)(vertex.colors.r * r);
+				vertex.colors.g = (GLubyte)(vertex.colors.g * g);
+				vertex.colors.b = (GLubyte)(vertex.colors.b * b);
+				vertex.colors.a = (GLubyte)(vertex.colors.a * alpha);
+			}
+			triangles.verts = _bakedVertices.data();
+		}
+
+		batch->addCommand(renderer, _globalZOrder, segment.texture->getName(), _glProgramState, getBlendFunc(segment.blendMode),
+			triangles, transform, transformFlags);
+	}
+}
+
+void SkeletonAnimation::setBakedCacheEnabled (bool enabled) {
+	if (_bakedCacheEnabled == enabled) return;
+	if (_updatedBySystem) SkeletonSystem::getInstance()->waitForUpdate();
+	_bakedCacheEnabled = enabled;
+	_bakedAnimation = nullptr;
+	if (!enabled) {
+		// pose the skeleton again for the next draw
+		spAnimationState_apply(_state, _skeleton);
+		spSkeleton_updateWorldTransform(_skeleton);
+	}
+}
+
+bool SkeletonAnimation::isBakedCacheEnabled () const {
+	return _bakedCacheEnabled;
+}
+
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
 	CCASSERT(stateData, "stateData cannot be null.");
 
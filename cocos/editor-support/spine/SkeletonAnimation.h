@@ -67,6 +67,15 @@ public:
 	}
 
 	virtual void update (float deltaTime) override;
+	virtual void draw (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags) override;
+	virtual void onEnter () override;
+	virtual void onExit () override;
+
+	/* Draws the animation of track 0 from the frames shared in the SkeletonCache instead of posing the skeleton, false by
+	 * default. Mixing, the other tracks and the attachments changed at runtime are not drawn, the listeners are still
+	 * called. For crowds of skeletons playing the same animations. */
+	void setBakedCacheEnabled (bool enabled);
+	bool isBakedCacheEnabled () const;
 
 	void setAnimationStateData (spAnimationStateData* stateData);
 	void setMix (const std::string& fromAnimation, const std::string& toAnimation, float duration);
@@ -106,6 +115,8 @@ CC_CONSTRUCTOR_ACCESS:
 	virtual void initialize () override;
 
 protected:
+	void drawBakedFrame (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags);
+
 	spAnimationState* _state;
 
 	bool _ownsAnimationStateData;
@@ -117,7 +128,17 @@ protected:
 	CompleteListener _completeListener;
 	EventListener _eventListener;
 
+	bool _bakedCacheEnabled;
+	// the animation of track 0 and its time, drawn from the cache
+	spAnimation* _bakedAnimation;
+	float _bakedTime;
+	std::vector<cocos2d::V3F_C4B_T2F> _bakedVertices;
+
+	// posed by the SkeletonSystem after the updates
+	bool _updatedBySystem;
+
 private:
+	friend class SkeletonSystem;
 	typedef SkeletonRenderer super;
 };
 
@@ -53,10 +53,20 @@ namespace spine {
     }
 
     SkeletonBatch::SkeletonBatch ()
+    : _pageIndex(0)
+    , _commandIndex(0)
+    , _command(nullptr)
+    , _globalOrder(0)
+    , _textureID(0)
+    , _glProgramState(nullptr)
+    , _flags(0)
+    , _commandCount(0)
+    , _trianglesCount(0)
+    , _copiedBytes(0)
+    , _lastCommandCount(0)
+    , _lastTrianglesCount(0)
+    , _lastCopiedBytes(0)
     {
-        _firstCommand = new Command();
-        _command = _firstCommand;
-
         Director::getInstance()->getEventDispatcher()->addCustomEventListener(EVENT_AFTER_DRAW_RESET_POSITION, [this](EventCustom* eventCustom){
             this->update(0);
         });;
@@ -65,53 +75,103 @@ namespace spine {
     SkeletonBatch::~SkeletonBatch () {
         Director::getInstance()->getEventDispatcher()->removeCustomEventListeners(EVENT_AFTER_DRAW_RESET_POSITION);
 
-        Command* command = _firstCommand;
-        while (command) {
-            Command* next = command->next;
+        for (auto& page : _pages) {
+            delete [] page.vertices;
+            delete [] page.indices;
+        }
+        for (auto command : _commands) {
             delete command;
-            command = next;
         }
     }
 
     void SkeletonBatch::update (float delta) {
-        _command = _firstCommand;
+        for (size_t i = 0; i <= _pageIndex && i < _pages.size(); ++i) {
+            _pages[i].vertexCount = 0;
+            _pages[i].indexCount = 0;
+        }
+        _pageIndex = 0;
+        _commandIndex = 0;
+        _command = nullptr;
+
+        _lastCommandCount = _commandCount;
+        _lastTrianglesCount = _trianglesCount;
+        _lastCopiedBytes = _copiedBytes;
+        _commandCount = 0;
+        _trianglesCount = 0;
+        _copiedBytes = 0;
     }
 
     void SkeletonBatch::addCommand (cocos2d::Renderer* renderer, float globalZOrder, GLuint textureID, GLProgramState* glProgramState,
                                     BlendFunc blendFunc, const TrianglesCommand::Triangles& triangles, const Mat4& transform, uint32_t transformFlags
                                     ) {
-        if (_command->triangles->verts) {
-            free(_command->triangles->verts);
-            _command->triangles->verts = NULL;
+        CCASSERT(triangles.vertCount <= PAGE_VERTICES && triangles.indexCount <= PAGE_INDICES, "SkeletonBatch: too many vertices in one attachment");
+
+        if (_pages.empty()) {
+            _pages.push_back(Page{ new V3F_C4B_T2F[PAGE_VERTICES], new unsigned short[PAGE_INDICES], 0, 0 });
+        }
+        Page* page = &_pages[_pageIndex];
+        bool newPage = false;
+        if (page->vertexCount + triangles.vertCount > PAGE_VERTICES || page->indexCount + triangles.indexCount > PAGE_INDICES) {
+            if (++_pageIndex == _pages.size()) {
+                _pages.push_back(Page{ new V3F_C4B_T2F[PAGE_VERTICES], new unsigned short[PAGE_INDICES], 0, 0 });
+            }
+            page = &_pages[_pageIndex];
+            newPage = true;
         }
-        
-        _command->triangles->verts = (V3F_C4B_T2F *)malloc(sizeof(V3F_C4B_T2F) * triangles.vertCount);
-        memcpy(_command->triangles->verts, triangles.verts, sizeof(V3F_C4B_T2F) * triangles.vertCount);
-        
-        _command->triangles->vertCount = triangles.vertCount;
-        _command->triangles->indexCount = triangles.indexCount;
-        _command->triangles->indices = triangles.indices;
-        
-        _command->trianglesCommand->init(globalZOrder, textureID, glProgramState, blendFunc, *_command->triangles, transform, transformFlags);
-        renderer->addCommand(_command->trianglesCommand);
-        
-        if (!_command->next) _command->next = new Command();
-        _command = _command->next;
-    }
 
-    SkeletonBatch::Command::Command () :
-    next(nullptr)
-    {
-        trianglesCommand = new TrianglesCommand();
-        triangles = new TrianglesCommand::Triangles();
-    }
+        // appends to the last command when nothing was drawn since
+        bool append = _command && !newPage && renderer->getLastCommand() == _command
+            && _globalOrder == globalZOrder && _textureID == textureID && _glProgramState == glProgramState
+            && _blendFunc.src == blendFunc.src && _blendFunc.dst == blendFunc.dst && _flags == transformFlags;
+        if (!append) {
+            if (_commandIndex == _commands.size()) {
+                _commands.push_back(new TrianglesCommand());
+            }
+            _command = _commands[_commandIndex++];
+            _triangles.verts = page->vertices + page->vertexCount;
+            _triangles.indices = page->indices + page->indexCount;
+            _triangles.vertCount = 0;
+            _triangles.indexCount = 0;
+            _globalOrder = globalZOrder;
+            _textureID = textureID;
+            _glProgramState = glProgramState;
+            _blendFunc = blendFunc;
+            _flags = transformFlags;
+            ++_commandCount;
+        }
+
+        // in world space, the skeletons of a command have different transforms, the identity model view
+        // of the command tells the renderer not to transform them again
+        const float* m = transform.m;
+        V3F_C4B_T2F* vertices = _triangles.verts + _triangles.vertCount;
+        for (ssize_t i = 0; i < triangles.vertCount; ++i) {
+            const V3F_C4B_T2F& source = triangles.verts[i];
+            V3F_C4B_T2F& vertex = vertices[i];
+            float x = source.vertices.x, y = source.vertices.y, z = source.vertices.z;
+            vertex.vertices.x = m[0] * x + m[4] * y + m[8] * z + m[12];
+            vertex.vertices.y = m[1] * x + m[5] * y + m[9] * z + m[13];
+            vertex.vertices.z = m[2] * x + m[6] * y + m[10] * z + m[14];
+            vertex.colors = source.colors;
+            vertex.texCoords = source.texCoords;
+        }
+
+        unsigned short base = (unsigned short)_triangles.vertCount;
+        unsigned short* indices = _triangles.indices + _triangles.indexCount;
+        for (ssize_t i = 0; i < triangles.indexCount; ++i) {
+            indices[i] = triangles.indices[i] + base;
+        }
+
+        _triangles.vertCount += triangles.vertCount;
+        _triangles.indexCount += triangles.indexCount;
+        page->vertexCount += (int)triangles.vertCount;
+        page->indexCount += (int)triangles.indexCount;
+        ++_trianglesCount;
+        _copiedBytes += triangles.vertCount * sizeof(V3F_C4B_T2F) + triangles.indexCount * sizeof(unsigned short);
 
-    SkeletonBatch::Command::~Command () {
-        if (triangles->verts) {
-            free(triangles->verts);
+        _command->init(globalZOrder, textureID, glProgramState, blendFunc, _triangles, Mat4::IDENTITY, transformFlags);
+        if (!append) {
+            renderer->addCommand(_command);
         }
-        delete triangles;
-        delete trianglesCommand;
     }
 
 }
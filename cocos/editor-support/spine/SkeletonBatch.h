@@ -33,9 +33,13 @@
 
 #include <spine/spine.h>
 #include "cocos2d.h"
+#include <vector>
 
 namespace spine {
     
+    /* Copies the triangles of the skeletons in world space into buffers kept from frame to frame. Consecutive triangles
+     * with the same texture, shader, blend function and global order are drawn by one command, across skeletons, as long
+     * as no other command was added to the renderer in between. */
     class SkeletonBatch {
     public:
         static SkeletonBatch* getInstance ();
@@ -47,22 +51,48 @@ namespace spine {
         void addCommand (cocos2d::Renderer* renderer, float globalOrder, GLuint textureID, cocos2d::GLProgramState* glProgramState,
                          cocos2d::BlendFunc blendType, const cocos2d::TrianglesCommand:: Triangles& triangles, const cocos2d::Mat4& mv, uint32_t flags);
         
+        /* Returns the number of commands added to the renderer during the last frame. */
+        int getCommandCount () const { return _lastCommandCount; }
+        /* Returns the number of triangle lists batched during the last frame, one per attachment. */
+        int getTrianglesCount () const { return _lastTrianglesCount; }
+        /* Returns the number of vertex and index bytes copied during the last frame. */
+        size_t getCopiedBytes () const { return _lastCopiedBytes; }
+        
     protected:
         SkeletonBatch ();
         virtual ~SkeletonBatch ();
         
-        class Command {
-        public:
-            Command ();
-            virtual ~Command ();
-            
-            cocos2d::TrianglesCommand* trianglesCommand;
-            cocos2d::TrianglesCommand::Triangles* triangles;
-            Command* next;
+        // the index range of one page fits the 16-bit indices and the vertex buffer of the renderer
+        static const int PAGE_VERTICES = 8192;
+        static const int PAGE_INDICES = PAGE_VERTICES * 3;
+        
+        struct Page {
+            cocos2d::V3F_C4B_T2F* vertices;
+            unsigned short* indices;
+            int vertexCount;
+            int indexCount;
         };
         
-        Command* _firstCommand;
-        Command* _command;
+        std::vector<Page> _pages;
+        size_t _pageIndex;
+        std::vector<cocos2d::TrianglesCommand*> _commands;
+        size_t _commandIndex;
+        
+        // the command being appended to, with the triangles it draws
+        cocos2d::TrianglesCommand* _command;
+        cocos2d::TrianglesCommand::Triangles _triangles;
+        float _globalOrder;
+        GLuint _textureID;
+        cocos2d::GLProgramState* _glProgramState;
+        cocos2d::BlendFunc _blendFunc;
+        uint32_t _flags;
+        
+        int _commandCount;
+        int _trianglesCount;
+        size_t _copiedBytes;
+        int _lastCommandCount;
+        int _lastTrianglesCount;
+        size_t _lastCopiedBytes;
     };
     
 }
@@ -35,9 +35,20 @@
 #include <spine/Animation.h>
 #include "kvec.h"
 
+/* Names are copied by the runtime objects created with them, the strings read for that come from blocks released
+ * together at the end of the read instead of being allocated and freed one by one. */
+#define SCRATCH_BLOCK_SIZE 4096
+
+typedef struct _spScratchBlock {
+	struct _spScratchBlock* next;
+	int capacity;
+	int used;
+} _spScratchBlock;
+
 typedef struct {
 	const unsigned char* cursor; 
 	const unsigned char* end;
+	_spScratchBlock* scratch;
 } _dataInput;
 
 typedef struct {
@@ -71,13 +82,8 @@ spSkeletonBinary* spSkeletonBinary_create (spAtlas* atlas) {
 }
 
 void spSkeletonBinary_dispose (spSkeletonBinary* self) {
-	int i;
 	_spSkeletonBinary* internal = SUB_CAST(_spSkeletonBinary, self);
 	if (internal->ownsLoader) spAttachmentLoader_dispose(self->attachmentLoader);
-	for (i = 0; i < internal->linkedMeshCount; ++i) {
-		FREE(internal->linkedMeshes[i].parent);
-		FREE(internal->linkedMeshes[i].skin);
-	}
 	FREE(internal->linkedMeshes);
 	FREE(self->error);
 	FREE(self);
@@ -158,6 +164,46 @@ char* readString (_dataInput* input) {
 	return string;
 }
 
+static char* _allocScratch (_dataInput* input, int size) {
+	_spScratchBlock* block = input->scratch;
+	char* ptr;
+	if (!block || block->used + size > block->capacity) {
+		int capacity = size > SCRATCH_BLOCK_SIZE ? size : SCRATCH_BLOCK_SIZE;
+		block = (_spScratchBlock*)MALLOC(char, sizeof(_spScratchBlock) + capacity);
+		block->next = input->scratch;
+		block->capacity = capacity;
+		block->used = 0;
+		input->scratch = block;
+	}
+	ptr = (char*)(block + 1) + block->used;
+	block->used += size;
+	return ptr;
+}
+
+/* Reads a string valid until the end of the read, for names copied by the objects created with them. */
+static const char* readScratchString (_dataInput* input) {
+	int length = readVarint(input, 1);
+	char* string;
+	if (length == 0) {
+		return 0;
+	}
+	string = _allocScratch(input, length);
+	memcpy(string, input->cursor, length - 1);
+	input->cursor += length - 1;
+	string[length - 1] = '\0';
+	return string;
+}
+
+static void _disposeInput (_dataInput* input) {
+	_spScratchBlock* block = input->scratch;
+	while (block) {
+		_spScratchBlock* next = block->next;
+		FREE(block);
+		block = next;
+	}
+	FREE(input);
+}
+
 static void readColor (_dataInput* input, float *r, float *g, float *b, float *a) {
 	*r = readByte(input) / 255.0f;
 	*g = readByte(input) / 255.0f;
@@ -280,10 +326,8 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 					timeline->slotIndex = slotIndex;
 					for (frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
 						float time = readFloat(input);
-						const char* attachmentName = readString(input);
-						/* TODO Avoid copying of attachmentName inside */
+						const char* attachmentName = readScratchString(input);
 						spAttachmentTimeline_setFrame(timeline, frameIndex, time, attachmentName);
-						FREE(attachmentName);
 					}
 					kv_push(spTimeline*, timelines, SUPER(timeline));
 					duration = MAX(duration, timeline->frames[frameCount - 1]);
@@ -459,7 +503,7 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 				float* tempDeform;
 				spDeformTimeline *timeline;
 				int weighted, deformLength;
-				const char* attachmentName = readString(input);
+				const char* attachmentName = readScratchString(input);
 				int frameCount;
 
 				spVertexAttachment* attachment = SUB_CAST(spVertexAttachment,
@@ -470,10 +514,8 @@ static spAnimation* _spSkeletonBinary_readAnimation (spSkeletonBinary* self, con
 						spTimeline_dispose(kv_A(timelines, i));
 					kv_destroy(timelines);
 					_spSkeletonBinary_setError(self, "Attachment not found: ", attachmentName);
-					FREE(attachmentName);
 					return 0;
 				}
-				FREE(attachmentName);
 
 				weighted = attachment->bones != 0;
 				deformLength = weighted ? attachment->verticesCount / 3 * 2 : attachment->verticesCount;
@@ -660,12 +702,8 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 		spSkin* skin, int slotIndex, const char* attachmentName, int/*bool*/ nonessential) {
 	int i;
 	spAttachmentType type;
-	const char* name = readString(input);
-	int freeName = name != 0;
-	if (!name) {
-		freeName = 0;
-		name = attachmentName;
-	}
+	const char* name = readScratchString(input);
+	if (!name) name = attachmentName;
 
 	type = (spAttachmentType)readByte(input);
 
@@ -689,7 +727,6 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			readColor(input, &region->r, &region->g, &region->b, &region->a);
 			spRegionAttachment_updateOffset(region);
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_BOUNDING_BOX: {
@@ -699,7 +736,6 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			_readVertices(self, input, SUB_CAST(spVertexAttachment, attachment), vertexCount);
 			if (nonessential) readInt(input); /* Skip color. */
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_MESH: {
@@ -728,7 +764,6 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 				mesh->height = 0;
 			}
 			spAttachmentLoader_configureAttachment(self->attachmentLoader, attachment);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_LINKED_MESH: {
@@ -742,15 +777,14 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 			mesh = SUB_CAST(spMeshAttachment, attachment);
 			mesh->path = path;
 			readColor(input, &mesh->r, &mesh->g, &mesh->b, &mesh->a);
-			skinName = readString(input);
-			parent = readString(input);
+			skinName = readScratchString(input);
+			parent = readScratchString(input);
 			mesh->inheritDeform = readBoolean(input);
 			if (nonessential) {
 				mesh->width = readFloat(input) * self->scale;
 				mesh->height = readFloat(input) * self->scale;
 			}
 			_spSkeletonBinary_addLinkedMesh(self, mesh, skinName, slotIndex, parent);
-			if (freeName) FREE(name);
 			return attachment;
 		}
 		case SP_ATTACHMENT_PATH: {
@@ -768,12 +802,10 @@ spAttachment* spSkeletonBinary_readAttachment(spSkeletonBinary* self, _dataInput
 				path->lengths[i] = readFloat(input) * self->scale;
 			}
 			if (nonessential) readInt(input); /* Skip color. */
-			if (freeName) FREE(name);
 			return attachment;
 		}
 	}
 
-	if (freeName) FREE(name);
 	return 0;
 }
 
@@ -788,10 +820,9 @@ spSkin* spSkeletonBinary_readSkin(spSkeletonBinary* self, _dataInput* input,
 	for (i = 0; i < slotCount; ++i) {
 		int slotIndex = readVarint(input, 1);
 		for (ii = 0, nn = readVarint(input, 1); ii < nn; ++ii) {
-			const char* name = readString(input);
+			const char* name = readScratchString(input);
 			spAttachment* attachment = spSkeletonBinary_readAttachment(self, input, skin, slotIndex, name, nonessential);
 			if (attachment) spSkin_addAttachment(skin, slotIndex, name, attachment);
-			FREE(name);
 		}
 	}
 	return skin;
@@ -817,6 +848,7 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	_spSkeletonBinary* internal = SUB_CAST(_spSkeletonBinary, self);
 
 	_dataInput* input = NEW(_dataInput);
+	input->scratch = 0;
 	input->cursor = binary;
 	input->end = binary + length;
 
@@ -846,7 +878,7 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	if (nonessential) {
 		/* Skip images path & fps */
 		readFloat(input);
-		FREE(readString(input));
+		readScratchString(input);
 	}
 
 	/* Bones. */
@@ -855,11 +887,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	for (i = 0; i < skeletonData->bonesCount; ++i) {
 		spBoneData* data;
 		int mode;
-		const char* name = readString(input);
+		const char* name = readScratchString(input);
 		spBoneData* parent = i == 0 ? 0 : skeletonData->bones[readVarint(input, 1)];
-		/* TODO Avoid copying of name */
 		data = spBoneData_create(i, name, parent);
-		FREE(name);
 		data->rotation = readFloat(input);
 		data->x = readFloat(input) * self->scale;
 		data->y = readFloat(input) * self->scale;
@@ -884,11 +914,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->slotsCount = readVarint(input, 1);
 	skeletonData->slots = MALLOC(spSlotData*, skeletonData->slotsCount);
 	for (i = 0; i < skeletonData->slotsCount; ++i) {
-		const char* slotName = readString(input);
+		const char* slotName = readScratchString(input);
 		spBoneData* boneData = skeletonData->bones[readVarint(input, 1)];
-		/* TODO Avoid copying of slotName */
 		spSlotData* slotData = spSlotData_create(i, slotName, boneData);
-		FREE(slotName);
 		readColor(input, &slotData->r, &slotData->g, &slotData->b, &slotData->a);
 		slotData->attachmentName = readString(input);
 		slotData->blendMode = (spBlendMode)readVarint(input, 1);
@@ -899,11 +927,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->ikConstraintsCount = readVarint(input, 1);
 	skeletonData->ikConstraints = MALLOC(spIkConstraintData*, skeletonData->ikConstraintsCount);
 	for (i = 0; i < skeletonData->ikConstraintsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of name */
+		const char* name = readScratchString(input);
 		spIkConstraintData* data = spIkConstraintData_create(name);
 		data->order = readVarint(input, 1);
-		FREE(name);
 		data->bonesCount = readVarint(input, 1);
 		data->bones = MALLOC(spBoneData*, data->bonesCount);
 		for (ii = 0; ii < data->bonesCount; ++ii)
@@ -919,11 +945,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->transformConstraints = MALLOC(
 			spTransformConstraintData*, skeletonData->transformConstraintsCount);
 	for (i = 0; i < skeletonData->transformConstraintsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of name */
+		const char* name = readScratchString(input);
 		spTransformConstraintData* data = spTransformConstraintData_create(name);
 		data->order = readVarint(input, 1);
-		FREE(name);
 		data->bonesCount = readVarint(input, 1);
 		CONST_CAST(spBoneData**, data->bones) = MALLOC(spBoneData*, data->bonesCount);
 		for (ii = 0; ii < data->bonesCount; ++ii)
@@ -946,11 +970,9 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->pathConstraintsCount = readVarint(input, 1);
 	skeletonData->pathConstraints = MALLOC(spPathConstraintData*, skeletonData->pathConstraintsCount);
 	for (i = 0; i < skeletonData->pathConstraintsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of name */
+		const char* name = readScratchString(input);
 		spPathConstraintData* data = spPathConstraintData_create(name);
 		data->order = readVarint(input, 1);
-		FREE(name);
 		data->bonesCount = readVarint(input, 1);
 		CONST_CAST(spBoneData**, data->bones) = MALLOC(spBoneData*, data->bonesCount);
 		for (ii = 0; ii < data->bonesCount; ++ii)
@@ -983,10 +1005,8 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 
 	/* Skins. */
 	for (i = skeletonData->defaultSkin ? 1 : 0; i < skeletonData->skinsCount; ++i) {
-		const char* skinName = readString(input);
-		/* TODO Avoid copying of skinName */
+		const char* skinName = readScratchString(input);
 		skeletonData->skins[i] = spSkeletonBinary_readSkin(self, input, skinName, nonessential);
-		FREE(skinName);
 	}
 
 	/* Linked meshes. */
@@ -995,16 +1015,16 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 		spSkin* skin = !linkedMesh->skin ? skeletonData->defaultSkin : spSkeletonData_findSkin(skeletonData, linkedMesh->skin);
 		spAttachment* parent;
 		if (!skin) {
-			FREE(input);
-			spSkeletonData_dispose(skeletonData);
 			_spSkeletonBinary_setError(self, "Skin not found: ", linkedMesh->skin);
+			_disposeInput(input);
+			spSkeletonData_dispose(skeletonData);
 			return 0;
 		}
 		parent = spSkin_getAttachment(skin, linkedMesh->slotIndex, linkedMesh->parent);
 		if (!parent) {
-			FREE(input);
-			spSkeletonData_dispose(skeletonData);
 			_spSkeletonBinary_setError(self, "Parent mesh not found: ", linkedMesh->parent);
+			_disposeInput(input);
+			spSkeletonData_dispose(skeletonData);
 			return 0;
 		}
 		spMeshAttachment_setParentMesh(linkedMesh->mesh, SUB_CAST(spMeshAttachment, parent));
@@ -1016,10 +1036,8 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->eventsCount = readVarint(input, 1);
 	skeletonData->events = MALLOC(spEventData*, skeletonData->eventsCount);
 	for (i = 0; i < skeletonData->eventsCount; ++i) {
-		const char* name = readString(input);
-		/* TODO Avoid copying of skinName */
+		const char* name = readScratchString(input);
 		spEventData* eventData = spEventData_create(name);
-		FREE(name);
 		eventData->intValue = readVarint(input, 0);
 		eventData->floatValue = readFloat(input);
 		eventData->stringValue = readString(input);
@@ -1030,17 +1048,16 @@ spSkeletonData* spSkeletonBinary_readSkeletonData (spSkeletonBinary* self, const
 	skeletonData->animationsCount = readVarint(input, 1);
 	skeletonData->animations = MALLOC(spAnimation*, skeletonData->animationsCount);
 	for (i = 0; i < skeletonData->animationsCount; ++i) {
-		const char* name = readString(input);
+		const char* name = readScratchString(input);
 		spAnimation* animation = _spSkeletonBinary_readAnimation(self, name, input, skeletonData);
-		FREE(name);
 		if (!animation) {
-			FREE(input);
+			_disposeInput(input);
 			spSkeletonData_dispose(skeletonData);
 			return 0;
 		}
 		skeletonData->animations[i] = animation;
 	}
 
-	FREE(input);
+	_disposeInput(input);
 	return skeletonData;
 }
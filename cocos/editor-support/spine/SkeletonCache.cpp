@@ -0,0 +1,262 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonCache.h>
+#include <spine/extension.h>
+#include <spine/AttachmentVertices.h>
+#include <algorithm>
+
+USING_NS_CC;
+
+namespace spine {
+
+static SkeletonCache* instance = nullptr;
+
+SkeletonCache* SkeletonCache::getInstance () {
+	if (!instance) instance = new SkeletonCache();
+	return instance;
+}
+
+void SkeletonCache::destroyInstance () {
+	if (instance) {
+		delete instance;
+		instance = nullptr;
+	}
+}
+
+SkeletonCache::SkeletonCache ()
+	: _frameRate(30), _memoryBudget(16 * 1024 * 1024), _memoryUsage(0) {
+}
+
+SkeletonCache::~SkeletonCache () {
+	removeAll();
+}
+
+void SkeletonCache::setFrameRate (float frameRate) {
+	CCASSERT(frameRate > 0, "frameRate must be positive");
+	_frameRate = frameRate;
+}
+
+float SkeletonCache::getFrameRate () const {
+	return _frameRate;
+}
+
+void SkeletonCache::setMemoryBudget (size_t bytes) {
+	_memoryBudget = bytes;
+	trim();
+}
+
+size_t SkeletonCache::getMemoryBudget () const {
+	return _memoryBudget;
+}
+
+size_t SkeletonCache::getMemoryUsage () const {
+	return _memoryUsage;
+}
+
+const SkeletonCache::Frame* SkeletonCache::getFrame (spSkeleton* skeleton, spAnimation* animation, float time, bool premultipliedAlpha) {
+	AnimationData* data = getAnimationData(skeleton, animation, premultipliedAlpha);
+	data->lastUsedFrame = Director::getInstance()->getTotalFrames();
+
+	int index = (int)(std::max(time, 0.0f) * data->frameRate);
+	index = std::min(index, (int)data->frames.size() - 1);
+	Frame* frame = data->frames[index];
+	if (!frame) {
+		frame = bakeFrame(data, index);
+		trim();
+	}
+	return frame;
+}
+
+SkeletonCache::AnimationData* SkeletonCache::getAnimationData (spSkeleton* skeleton, spAnimation* animation, bool premultipliedAlpha) {
+	std::vector<AnimationData*>& variants = _animations[animation];
+	for (auto data : variants) {
+		if (data->skeletonData == skeleton->data && data->skin == skeleton->skin && data->premultipliedAlpha == premultipliedAlpha)
+			return data;
+	}
+
+	AnimationData* data = new AnimationData();
+	data->skeletonData = skeleton->data;
+	data->skin = skeleton->skin;
+	data->animation = animation;
+	data->premultipliedAlpha = premultipliedAlpha;
+	data->frameRate = _frameRate;
+	data->frames.resize((size_t)(animation->duration * _frameRate) + 1, nullptr);
+	data->memory = 0;
+	data->lastUsedFrame = 0;
+	variants.push_back(data);
+	return data;
+}
+
+SkeletonCache::Frame* SkeletonCache::bakeFrame (AnimationData* data, int index) {
+	spSkeleton*& skeleton = _samplers[data->skeletonData];
+	if (!skeleton) skeleton = spSkeleton_create(data->skeletonData);
+
+	spSkeleton_setSkin(skeleton, data->skin);
+	spSkeleton_setToSetupPose(skeleton);
+	float time = std::min(index / data->frameRate, data->animation->duration);
+	// no events are collected, lastTime == time fires none
+	spAnimation_apply(data->animation, skeleton, time, time, 0, nullptr, nullptr, 1, 1, 0);
+	spSkeleton_updateWorldTransform(skeleton);
+
+	Frame* frame = new Frame();
+	for (int i = 0, n = skeleton->slotsCount; i < n; ++i) {
+		spSlot* slot = skeleton->drawOrder[i];
+		if (!slot->attachment) continue;
+
+		AttachmentVertices* attachmentVertices = nullptr;
+		Color4F color;
+		switch (slot->attachment->type) {
+		case SP_ATTACHMENT_REGION: {
+			spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
+			_worldVertices.resize(8);
+			spRegionAttachment_computeWorldVertices(attachment, slot->bone, _worldVertices.data());
+			attachmentVertices = (AttachmentVertices*)attachment->rendererObject;
+			color = Color4F(attachment->r, attachment->g, attachment->b, attachment->a);
+			break;
+		}
+		case SP_ATTACHMENT_MESH: {
+			spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
+			_worldVertices.resize(attachment->super.worldVerticesLength);
+			spMeshAttachment_computeWorldVertices(attachment, slot, _worldVertices.data());
+			attachmentVertices = (AttachmentVertices*)attachment->rendererObject;
+			color = Color4F(attachment->r, attachment->g, attachment->b, attachment->a);
+			break;
+		}
+		default:
+			continue;
+		}
+
+		// as SkeletonRenderer::draw, the node color is applied when drawing
+		color.a *= slot->a * 255;
+		float multiplier = data->premultipliedAlpha ? color.a : 255;
+		color.r *= slot->r * multiplier;
+		color.g *= slot->g * multiplier;
+		color.b *= slot->b * multiplier;
+
+		const TrianglesCommand::Triangles* triangles = attachmentVertices->_triangles;
+		Segment segment;
+		segment.texture = attachmentVertices->_texture;
+		segment.blendMode = slot->data->blendMode;
+		segment.vertexStart = (int)frame->vertices.size();
+		segment.vertexCount = triangles->vertCount;
+		segment.indexStart = (int)frame->indices.size();
+		segment.indexCount = triangles->indexCount;
+		frame->segments.push_back(segment);
+
+		for (int v = 0, w = 0, vn = triangles->vertCount; v < vn; ++v, w += 2) {
+			V3F_C4B_T2F vertex = triangles->verts[v];
+			vertex.vertices.x = _worldVertices[w];
+			vertex.vertices.y = _worldVertices[w + 1];
+			vertex.colors.r = (GLubyte)color.r;
+			vertex.colors.g = (GLubyte)color.g;
+			vertex.colors.b = (GLubyte)color.b;
+			vertex.colors.a = (GLubyte)color.a;
+			frame->vertices.push_back(vertex);
+		}
+		frame->indices.insert(frame->indices.end(), triangles->indices, triangles->indices + triangles->indexCount);
+	}
+	frame->vertices.shrink_to_fit();
+	frame->indices.shrink_to_fit();
+	frame->segments.shrink_to_fit();
+
+	size_t memory = sizeof(Frame) + frame->vertices.size() * sizeof(V3F_C4B_T2F)
+		+ frame->indices.size() * sizeof(unsigned short) + frame->segments.size() * sizeof(Segment);
+	data->frames[index] = frame;
+	data->memory += memory;
+	_memoryUsage += memory;
+	return frame;
+}
+
+void SkeletonCache::releaseFrames (AnimationData* data) {
+	for (auto& frame : data->frames) {
+		delete frame;
+		frame = nullptr;
+	}
+	_memoryUsage -= data->memory;
+	data->memory = 0;
+}
+
+void SkeletonCache::trim () {
+	unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+	while (_memoryUsage > _memoryBudget) {
+		AnimationData* oldest = nullptr;
+		for (auto& item : _animations) {
+			for (auto data : item.second) {
+				if (data->memory > 0 && data->lastUsedFrame != currentFrame && (!oldest || data->lastUsedFrame < oldest->lastUsedFrame))
+					oldest = data;
+			}
+		}
+		// the rest is drawn during this frame
+		if (!oldest) break;
+		releaseFrames(oldest);
+	}
+}
+
+void SkeletonCache::removeSkeletonData (spSkeletonData* skeletonData) {
+	for (auto it = _animations.begin(); it != _animations.end(); ) {
+		std::vector<AnimationData*>& variants = it->second;
+		for (auto dataIt = variants.begin(); dataIt != variants.end(); ) {
+			if ((*dataIt)->skeletonData == skeletonData) {
+				releaseFrames(*dataIt);
+				delete *dataIt;
+				dataIt = variants.erase(dataIt);
+			} else {
+				++dataIt;
+			}
+		}
+		if (variants.empty())
+			it = _animations.erase(it);
+		else
+			++it;
+	}
+
+	auto sampler = _samplers.find(skeletonData);
+	if (sampler != _samplers.end()) {
+		spSkeleton_dispose(sampler->second);
+		_samplers.erase(sampler);
+	}
+}
+
+void SkeletonCache::removeAll () {
+	for (auto& item : _animations) {
+		for (auto data : item.second) {
+			releaseFrames(data);
+			delete data;
+		}
+	}
+	_animations.clear();
+
+	for (auto& item : _samplers)
+		spSkeleton_dispose(item.second);
+	_samplers.clear();
+}
+
+}
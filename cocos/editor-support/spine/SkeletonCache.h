@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONCACHE_H_
+#define SPINE_SKELETONCACHE_H_
+
+#include <spine/spine.h>
+#include "cocos2d.h"
+#include <unordered_map>
+#include <vector>
+
+namespace spine {
+
+/* Animations sampled at a fixed frame rate into ready to draw vertices, shared by the skeletons of the same data, skin and
+ * alpha mode. A frame is filled the first time it is drawn. Past the memory budget, the frames of the least recently drawn
+ * animations are dropped and filled again when needed. */
+class SkeletonCache {
+public:
+	static SkeletonCache* getInstance ();
+	static void destroyInstance ();
+
+	/* Vertices of one attachment, drawn with one command. */
+	struct Segment {
+		cocos2d::Texture2D* texture;
+		spBlendMode blendMode;
+		int vertexStart;
+		int vertexCount;
+		int indexStart;
+		int indexCount;
+	};
+
+	/* Skeleton vertices at one sample, colored by the slots and attachments but not by the node. */
+	struct Frame {
+		std::vector<cocos2d::V3F_C4B_T2F> vertices;
+		std::vector<unsigned short> indices;
+		std::vector<Segment> segments;
+	};
+
+	/* Returns the frame of an animation at time, sampled with the skin of the skeleton. */
+	const Frame* getFrame (spSkeleton* skeleton, spAnimation* animation, float time, bool premultipliedAlpha);
+
+	/* Sets the samples per second of the animations cached afterwards, 30 by default. */
+	void setFrameRate (float frameRate);
+	float getFrameRate () const;
+
+	/* Sets the memory the frames may use, 16 MB by default. The frames drawn during the current frame are never dropped. */
+	void setMemoryBudget (size_t bytes);
+	size_t getMemoryBudget () const;
+	size_t getMemoryUsage () const;
+
+	/* Drops the animations of a skeleton data, to call before disposing of it. */
+	void removeSkeletonData (spSkeletonData* skeletonData);
+	void removeAll ();
+
+protected:
+	SkeletonCache ();
+	virtual ~SkeletonCache ();
+
+	struct AnimationData {
+		spSkeletonData* skeletonData;
+		spSkin* skin;
+		spAnimation* animation;
+		bool premultipliedAlpha;
+		float frameRate;
+		std::vector<Frame*> frames;
+		size_t memory;
+		unsigned int lastUsedFrame;
+	};
+
+	AnimationData* getAnimationData (spSkeleton* skeleton, spAnimation* animation, bool premultipliedAlpha);
+	Frame* bakeFrame (AnimationData* data, int index);
+	void releaseFrames (AnimationData* data);
+	void trim ();
+
+	// the variants of an animation, by skin and alpha mode
+	std::unordered_map<spAnimation*, std::vector<AnimationData*>> _animations;
+	// skeletons posed to sample the animations of a skeleton data
+	std::unordered_map<spSkeletonData*, spSkeleton*> _samplers;
+	std::vector<float> _worldVertices;
+	float _frameRate;
+	size_t _memoryBudget;
+	size_t _memoryUsage;
+};
+
+}
+
+#endif /* SPINE_SKELETONCACHE_H_ */
@@ -0,0 +1,287 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonDataCache.h>
+#include <spine/SkeletonCache.h>
+#include <spine/Cocos2dAttachmentLoader.h>
+#include <spine/extension.h>
+#include "base/CCAsyncTaskPool.h"
+
+USING_NS_CC;
+
+namespace spine {
+
+static SkeletonDataCache* instance = nullptr;
+
+static std::string makeKey (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
+	return StringUtils::format("%s|%s|%g", skeletonDataFile.c_str(), atlasFile.c_str(), scale);
+}
+
+/* JSON skeletons start with an object, binary skeletons with the length of their hash. */
+static bool isJsonData (const Data& data) {
+	const unsigned char* bytes = data.getBytes();
+	ssize_t size = data.getSize(), i = 0;
+	if (size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) i = 3;
+	while (i < size && isspace(bytes[i]))
+		++i;
+	return i < size && bytes[i] == '{';
+}
+
+SkeletonDataCache* SkeletonDataCache::getInstance () {
+	if (!instance) instance = new SkeletonDataCache();
+	return instance;
+}
+
+void SkeletonDataCache::destroyInstance () {
+	if (instance) {
+		delete instance;
+		instance = nullptr;
+	}
+}
+
+SkeletonDataCache::SkeletonDataCache () {
+}
+
+SkeletonDataCache::~SkeletonDataCache () {
+	std::vector<Entry*> entries;
+	for (auto& pair : _entries)
+		entries.push_back(pair.second);
+	for (Entry* entry : entries) {
+		if (entry->load) {
+			// a task not started yet never runs, a started one still uses the entry
+			std::shared_ptr<LoadState> state = entry->load;
+			std::unique_lock<std::mutex> lock(state->mutex);
+			if (state->started) {
+				state->condition.wait(lock, [&state]() { return state->parsed; });
+				entry->skeletonData = state->skeletonData;
+			} else
+				state->cancelled = true;
+		}
+		removeEntry(entry);
+	}
+}
+
+spSkeletonData* SkeletonDataCache::retainSkeletonData (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
+	std::string key = makeKey(skeletonDataFile, atlasFile, scale);
+	auto it = _entries.find(key);
+	if (it != _entries.end() && it->second->load) {
+		finishLoading(it->second);
+		it = _entries.find(key);
+	}
+
+	Entry* entry;
+	if (it != _entries.end())
+		entry = it->second;
+	else {
+		entry = createEntry(key, skeletonDataFile, atlasFile, scale);
+		if (!entry) return nullptr;
+		std::string error;
+		spSkeletonData* skeletonData = parse(entry, error);
+		if (!skeletonData) {
+			CCLOG("%s", error.c_str());
+			removeEntry(entry);
+			return nullptr;
+		}
+		entry->skeletonData = skeletonData;
+		_entriesByData[skeletonData] = entry;
+	}
+	++entry->referenceCount;
+	return entry->skeletonData;
+}
+
+void SkeletonDataCache::releaseSkeletonData (spSkeletonData* skeletonData) {
+	auto it = _entriesByData.find(skeletonData);
+	CCASSERT(it != _entriesByData.end(), "The skeleton data does not come from the cache.");
+	if (it == _entriesByData.end()) return;
+	CCASSERT(it->second->referenceCount > 0, "The skeleton data is released more than retained.");
+	--it->second->referenceCount;
+}
+
+void SkeletonDataCache::loadSkeletonDataAsync (const std::string& skeletonDataFile, const std::string& atlasFile, float scale,
+		const LoadCallback& callback) {
+	std::string key = makeKey(skeletonDataFile, atlasFile, scale);
+	auto it = _entries.find(key);
+	if (it != _entries.end()) {
+		if (it->second->load)
+			it->second->callbacks.push_back(callback);
+		else if (callback)
+			callback(it->second->skeletonData);
+		return;
+	}
+
+	Entry* entry = createEntry(key, skeletonDataFile, atlasFile, scale);
+	if (!entry) {
+		if (callback) callback(nullptr);
+		return;
+	}
+	std::shared_ptr<LoadState> state = std::make_shared<LoadState>();
+	state->started = false;
+	state->parsed = false;
+	state->cancelled = false;
+	state->skeletonData = nullptr;
+	entry->load = state;
+	entry->callbacks.push_back(callback);
+
+	AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [key, state](void*) {
+		if (!instance) return;
+		auto it = instance->_entries.find(key);
+		if (it != instance->_entries.end() && it->second->load == state) instance->finishLoading(it->second);
+	}, nullptr, [entry, state]() {
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+			if (state->cancelled) return;
+			state->started = true;
+		}
+		std::string error;
+		spSkeletonData* skeletonData = parse(entry, error);
+		std::lock_guard<std::mutex> lock(state->mutex);
+		state->skeletonData = skeletonData;
+		state->error = error;
+		state->parsed = true;
+		state->condition.notify_all();
+	});
+}
+
+void SkeletonDataCache::removeUnusedSkeletonData () {
+	std::vector<Entry*> unused;
+	for (auto& pair : _entries) {
+		if (pair.second->referenceCount == 0 && !pair.second->load) unused.push_back(pair.second);
+	}
+	for (Entry* entry : unused)
+		removeEntry(entry);
+}
+
+SkeletonDataCache::Entry* SkeletonDataCache::createEntry (const std::string& key, const std::string& skeletonDataFile,
+		const std::string& atlasFile, float scale) {
+	spAtlas* atlas = retainAtlas(atlasFile);
+	if (!atlas) {
+		CCLOG("Error reading atlas file: %s", atlasFile.c_str());
+		return nullptr;
+	}
+
+	Entry* entry = new Entry();
+	entry->key = key;
+	entry->atlasFile = atlasFile;
+	// resolved here, FileUtils only reads files on other threads
+	entry->fullPath = FileUtils::getInstance()->fullPathForFilename(skeletonDataFile);
+	entry->scale = scale;
+	entry->attachmentLoader = SUPER(Cocos2dAttachmentLoader_create(atlas));
+	entry->skeletonData = nullptr;
+	entry->referenceCount = 0;
+	_entries[key] = entry;
+	return entry;
+}
+
+spSkeletonData* SkeletonDataCache::parse (Entry* entry, std::string& error) {
+	Data data = FileUtils::getInstance()->getDataFromFile(entry->fullPath);
+	if (data.isNull()) {
+		error = "Error reading skeleton data file: " + entry->fullPath;
+		return nullptr;
+	}
+
+	spSkeletonData* skeletonData = nullptr;
+	if (!isJsonData(data)) {
+		// parsed from the file data, without the copy made by spSkeletonBinary_readSkeletonDataFile
+		spSkeletonBinary* binary = spSkeletonBinary_createWithLoader(entry->attachmentLoader);
+		binary->scale = entry->scale;
+		skeletonData = spSkeletonBinary_readSkeletonData(binary, data.getBytes(), (int)data.getSize());
+		if (!skeletonData) error = binary->error ? binary->error : "Error reading skeleton data file.";
+		spSkeletonBinary_dispose(binary);
+	} else {
+		std::string json((const char*)data.getBytes(), data.getSize());
+		spSkeletonJson* reader = spSkeletonJson_createWithLoader(entry->attachmentLoader);
+		reader->scale = entry->scale;
+		skeletonData = spSkeletonJson_readSkeletonData(reader, json.c_str());
+		if (!skeletonData) error = reader->error ? reader->error : "Error reading skeleton data file.";
+		spSkeletonJson_dispose(reader);
+	}
+	return skeletonData;
+}
+
+void SkeletonDataCache::finishLoading (Entry* entry) {
+	std::shared_ptr<LoadState> state = entry->load;
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->condition.wait(lock, [&state]() { return state->parsed; });
+	}
+	entry->load = nullptr;
+
+	std::vector<LoadCallback> callbacks;
+	callbacks.swap(entry->callbacks);
+	spSkeletonData* skeletonData = state->skeletonData;
+	if (skeletonData) {
+		entry->skeletonData = skeletonData;
+		_entriesByData[skeletonData] = entry;
+	} else {
+		CCLOG("%s", state->error.c_str());
+		removeEntry(entry);
+	}
+	// the callbacks may create skeletons or remove unused data
+	for (auto& callback : callbacks) {
+		if (callback) callback(skeletonData);
+	}
+}
+
+void SkeletonDataCache::removeEntry (Entry* entry) {
+	if (entry->skeletonData) {
+		SkeletonCache::getInstance()->removeSkeletonData(entry->skeletonData);
+		_entriesByData.erase(entry->skeletonData);
+		spSkeletonData_dispose(entry->skeletonData);
+	}
+	spAttachmentLoader_dispose(entry->attachmentLoader);
+	releaseAtlas(entry->atlasFile);
+	_entries.erase(entry->key);
+	delete entry;
+}
+
+spAtlas* SkeletonDataCache::retainAtlas (const std::string& atlasFile) {
+	auto it = _atlases.find(atlasFile);
+	if (it != _atlases.end()) {
+		++it->second.referenceCount;
+		return it->second.atlas;
+	}
+	spAtlas* atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
+	if (!atlas) return nullptr;
+	AtlasEntry& atlasEntry = _atlases[atlasFile];
+	atlasEntry.atlas = atlas;
+	atlasEntry.referenceCount = 1;
+	return atlas;
+}
+
+void SkeletonDataCache::releaseAtlas (const std::string& atlasFile) {
+	auto it = _atlases.find(atlasFile);
+	if (it == _atlases.end()) return;
+	if (--it->second.referenceCount == 0) {
+		spAtlas_dispose(it->second.atlas);
+		_atlases.erase(it);
+	}
+}
+
+}
@@ -0,0 +1,122 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONDATACACHE_H_
+#define SPINE_SKELETONDATACACHE_H_
+
+#include <spine/spine.h>
+#include "cocos2d.h"
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+
+namespace spine {
+
+/* Skeleton data loaded from files, shared by the skeletons created from the same skeleton file, atlas file and scale.
+ *
+ * The atlases are shared by all the skeleton data using them. Each skeleton created from a cached data holds a
+ * reference on it, the data no longer referenced stays in the cache until removeUnusedSkeletonData is called, which
+ * Director::purgeCachedData does on memory warnings. The JSON and
+ * binary formats are told apart from the content of the file. */
+class SkeletonDataCache {
+public:
+	typedef std::function<void(spSkeletonData*)> LoadCallback;
+
+	static SkeletonDataCache* getInstance ();
+	static void destroyInstance ();
+
+	/* Returns the data of a skeleton file with a reference, loading it the first time. Returns 0 if loading failed. */
+	spSkeletonData* retainSkeletonData (const std::string& skeletonDataFile, const std::string& atlasFile, float scale = 1);
+	/* Drops a reference returned by retainSkeletonData. */
+	void releaseSkeletonData (spSkeletonData* skeletonData);
+
+	/* Loads the data of a skeleton file in the background, the callback is called on the main thread with the data, or 0 if
+	 * loading failed. The data has no reference held for the caller, skeletons created afterwards from the same files
+	 * share it without parsing the file again. The atlas and its textures are loaded before returning. */
+	void loadSkeletonDataAsync (const std::string& skeletonDataFile, const std::string& atlasFile, float scale,
+		const LoadCallback& callback);
+
+	/* Disposes of the data and atlases no skeleton references. */
+	void removeUnusedSkeletonData ();
+
+protected:
+	SkeletonDataCache ();
+	virtual ~SkeletonDataCache ();
+
+	struct AtlasEntry {
+		spAtlas* atlas;
+		int referenceCount;
+	};
+
+	/* Shared with the background task, which may outlive the cache when the task pool drops it. */
+	struct LoadState {
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool started;
+		bool parsed;
+		bool cancelled;
+		spSkeletonData* skeletonData;
+		std::string error;
+	};
+
+	struct Entry {
+		std::string key;
+		std::string atlasFile;
+		std::string fullPath;
+		float scale;
+		spAttachmentLoader* attachmentLoader;
+		spSkeletonData* skeletonData;
+		int referenceCount;
+		// set while the file is parsed in the background
+		std::shared_ptr<LoadState> load;
+		std::vector<LoadCallback> callbacks;
+	};
+
+	Entry* createEntry (const std::string& key, const std::string& skeletonDataFile, const std::string& atlasFile, float scale);
+	/* Reads and parses the skeleton file of an entry, called on any thread. */
+	static spSkeletonData* parse (Entry* entry, std::string& error);
+	/* Takes the data parsed in the background, waiting for it if needed, and calls the load callbacks. */
+	void finishLoading (Entry* entry);
+	void removeEntry (Entry* entry);
+
+	spAtlas* retainAtlas (const std::string& atlasFile);
+	void releaseAtlas (const std::string& atlasFile);
+
+	std::unordered_map<std::string, Entry*> _entries;
+	std::unordered_map<spSkeletonData*, Entry*> _entriesByData;
+	std::unordered_map<std::string, AtlasEntry> _atlases;
+};
+
+}
+
+#endif /* SPINE_SKELETONDATACACHE_H_ */
@@ -31,6 +31,8 @@
 #include <spine/SkeletonRenderer.h>
 #include <spine/extension.h>
 #include <spine/SkeletonBatch.h>
+#include <spine/SkeletonCache.h>
+#include <spine/SkeletonDataCache.h>
 #include <spine/AttachmentVertices.h>
 #include <spine/Cocos2dAttachmentLoader.h>
 #include <algorithm>
@@ -61,6 +63,7 @@ SkeletonRenderer* SkeletonRenderer::createWithFile (const std::string& skeletonD
 
 void SkeletonRenderer::initialize () {
 	_worldVertices = new float[1000]; // Max number of vertices per mesh.
+	_verticesPrepared = false;
 
 	_blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 	setOpacityModifyRGB(true);
@@ -74,26 +77,30 @@ void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsS
 }
 
 SkeletonRenderer::SkeletonRenderer ()
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
 }
 
 SkeletonRenderer::SkeletonRenderer (spSkeletonData *skeletonData, bool ownsSkeletonData)
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
 	initWithData(skeletonData, ownsSkeletonData);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, spAtlas* atlas, float scale)
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
 	initWithJsonFile(skeletonDataFile, atlas, scale);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, const std::string& atlasFile, float scale)
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _timeScale(1) {
 	initWithJsonFile(skeletonDataFile, atlasFile, scale);
 }
 
 SkeletonRenderer::~SkeletonRenderer () {
-	if (_ownsSkeletonData) spSkeletonData_dispose(_skeleton->data);
+	if (_ownsSkeletonData) {
+		SkeletonCache::getInstance()->removeSkeletonData(_skeleton->data);
+		spSkeletonData_dispose(_skeleton->data);
+	} else if (_cachedSkeletonData)
+		SkeletonDataCache::getInstance()->releaseSkeletonData(_skeleton->data);
 	spSkeleton_dispose(_skeleton);
 	if (_atlas) spAtlas_dispose(_atlas);
 	if (_attachmentLoader) spAttachmentLoader_dispose(_attachmentLoader);
@@ -122,20 +129,7 @@ void SkeletonRenderer::initWithJsonFile (const std::string& skeletonDataFile, sp
 }
 
 void SkeletonRenderer::initWithJsonFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
-	_atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-	CCASSERT(_atlas, "Error reading atlas file.");
-
-	_attachmentLoader = SUPER(Cocos2dAttachmentLoader_create(_atlas));
-
-	spSkeletonJson* json = spSkeletonJson_createWithLoader(_attachmentLoader);
-	json->scale = scale;
-	spSkeletonData* skeletonData = spSkeletonJson_readSkeletonDataFile(json, skeletonDataFile.c_str());
-	CCASSERT(skeletonData, json->error ? json->error : "Error reading skeleton data file.");
-	spSkeletonJson_dispose(json);
-
-	setSkeletonData(skeletonData, true);
-
-	initialize();
+	initWithCachedFile(skeletonDataFile, atlasFile, scale);
 }
     
 void SkeletonRenderer::initWithBinaryFile (const std::string& skeletonDataFile, spAtlas* atlas, float scale) {
@@ -154,20 +148,17 @@ void SkeletonRenderer::initWithBinaryFile (const std::string& skeletonDataFile,
 }
 
 void SkeletonRenderer::initWithBinaryFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
-    _atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-    CCASSERT(_atlas, "Error reading atlas file.");
-    
-    _attachmentLoader = SUPER(Cocos2dAttachmentLoader_create(_atlas));
-    
-    spSkeletonBinary* binary = spSkeletonBinary_createWithLoader(_attachmentLoader);
-    binary->scale = scale;
-    spSkeletonData* skeletonData = spSkeletonBinary_readSkeletonDataFile(binary, skeletonDataFile.c_str());
-    CCASSERT(skeletonData, binary->error ? binary->error : "Error reading skeleton data file.");
-    spSkeletonBinary_dispose(binary);
-    
-    setSkeletonData(skeletonData, true);
-    
-    initialize();
+    initWithCachedFile(skeletonDataFile, atlasFile, scale);
+}
+
+void SkeletonRenderer::initWithCachedFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
+	spSkeletonData* skeletonData = SkeletonDataCache::getInstance()->retainSkeletonData(skeletonDataFile, atlasFile, scale);
+	CCASSERT(skeletonData, "Error reading skeleton data file.");
+
+	setSkeletonData(skeletonData, false);
+	_cachedSkeletonData = true;
+
+	initialize();
 }
 
 
@@ -176,15 +167,41 @@ void SkeletonRenderer::update (float deltaTime) {
 }
 
 void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	if (!_verticesPrepared) {
+		updateSkeletonColor();
+		prepareVertices();
+	}
+	_verticesPrepared = false;
+
 	SkeletonBatch* batch = SkeletonBatch::getInstance();
+	TrianglesCommand::Triangles triangles;
+	for (const auto& segment : _segments) {
+		triangles.verts = &_vertices[segment.vertexStart];
+		triangles.vertCount = segment.vertexCount;
+		triangles.indices = segment.indices;
+		triangles.indexCount = segment.indexCount;
+		batch->addCommand(renderer, _globalZOrder, segment.texture->getName(), _glProgramState, getBlendFunc(segment.blendMode),
+			triangles, transform, transformFlags);
+	}
 
+	if (_debugSlots || _debugBones) {
+        drawDebug(renderer, transform, transformFlags);
+	}
+}
+
+void SkeletonRenderer::updateSkeletonColor () {
 	Color3B nodeColor = getColor();
 	_skeleton->r = nodeColor.r / (float)255;
 	_skeleton->g = nodeColor.g / (float)255;
 	_skeleton->b = nodeColor.b / (float)255;
 	_skeleton->a = getDisplayedOpacity() / (float)255;
-    
-    Color4F color;
+}
+
+void SkeletonRenderer::prepareVertices () {
+	_vertices.clear();
+	_segments.clear();
+
+	Color4F color;
 	AttachmentVertices* attachmentVertices = nullptr;
 	for (int i = 0, n = _skeleton->slotsCount; i < n; ++i) {
 		spSlot* slot = _skeleton->drawOrder[i];
@@ -220,45 +237,30 @@ void SkeletonRenderer::draw (Renderer* renderer, const Mat4& transform, uint32_t
 		color.r *= _skeleton->r * slot->r * multiplier;
 		color.g *= _skeleton->g * slot->g * multiplier;
 		color.b *= _skeleton->b * slot->b * multiplier;
-        
-        
-        
-		for (int v = 0, w = 0, vn = attachmentVertices->_triangles->vertCount; v < vn; ++v, w += 2) {
-			V3F_C4B_T2F* vertex = attachmentVertices->_triangles->verts + v;
-			vertex->vertices.x = _worldVertices[w];
-			vertex->vertices.y = _worldVertices[w + 1];
-            vertex->colors.r = (GLubyte)color.r;
-            vertex->colors.g = (GLubyte)color.g;
-            vertex->colors.b = (GLubyte)color.b;
-            vertex->colors.a = (GLubyte)color.a;
-		}
 
-		BlendFunc blendFunc;
-		switch (slot->data->blendMode) {
-		case SP_BLEND_MODE_ADDITIVE:
-			blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
-			blendFunc.dst = GL_ONE;
-			break;
-		case SP_BLEND_MODE_MULTIPLY:
-			blendFunc.src = GL_DST_COLOR;
-			blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
-			break;
-		case SP_BLEND_MODE_SCREEN:
-			blendFunc.src = GL_ONE;
-			blendFunc.dst = GL_ONE_MINUS_SRC_COLOR;
-			break;
-		default:
-			blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
-			blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+		// the attachment vertices are shared by the skeletons of the data, only their texture coordinates are used
+		const TrianglesCommand::Triangles* attachmentTriangles = attachmentVertices->_triangles;
+		Segment segment;
+		segment.texture = attachmentVertices->_texture;
+		segment.blendMode = slot->data->blendMode;
+		segment.vertexStart = (int)_vertices.size();
+		segment.vertexCount = attachmentTriangles->vertCount;
+		segment.indices = attachmentTriangles->indices;
+		segment.indexCount = attachmentTriangles->indexCount;
+		_segments.push_back(segment);
+
+		for (int v = 0, w = 0, vn = attachmentTriangles->vertCount; v < vn; ++v, w += 2) {
+			V3F_C4B_T2F vertex = attachmentTriangles->verts[v];
+			vertex.vertices.x = _worldVertices[w];
+			vertex.vertices.y = _worldVertices[w + 1];
+            vertex.colors.r = (GLubyte)color.r;
+            vertex.colors.g = (GLubyte)color.g;
+            vertex.colors.b = (GLubyte)color.b;
+            vertex.colors.a = (GLubyte)color.a;
+			_vertices.push_back(vertex);
 		}
-
-		batch->addCommand(renderer, _globalZOrder, attachmentVertices->_texture->getName(), _glProgramState, blendFunc,
-			*attachmentVertices->_triangles, transform, transformFlags);
-	}
-
-	if (_debugSlots || _debugBones) {
-        drawDebug(renderer, transform, transformFlags);
 	}
+	_verticesPrepared = true;
 }
 
 void SkeletonRenderer::drawDebug (Renderer* renderer, const Mat4 &transform, uint32_t transformFlags) {
@@ -317,6 +319,28 @@ AttachmentVertices* SkeletonRenderer::getAttachmentVertices (spMeshAttachment* a
 	return (AttachmentVertices*)attachment->rendererObject;
 }
 
+BlendFunc SkeletonRenderer::getBlendFunc (spBlendMode blendMode) const {
+	BlendFunc blendFunc;
+	switch (blendMode) {
+	case SP_BLEND_MODE_ADDITIVE:
+		blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+		blendFunc.dst = GL_ONE;
+		break;
+	case SP_BLEND_MODE_MULTIPLY:
+		blendFunc.src = GL_DST_COLOR;
+		blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+		break;
+	case SP_BLEND_MODE_SCREEN:
+		blendFunc.src = GL_ONE;
+		blendFunc.dst = GL_ONE_MINUS_SRC_COLOR;
+		break;
+	default:
+		blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+		blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+	}
+	return blendFunc;
+}
+
 Rect SkeletonRenderer::getBoundingBox () const {
 	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
 	float scaleX = getScaleX(), scaleY = getScaleY();
@@ -111,6 +111,9 @@ CC_CONSTRUCTOR_ACCESS:
 	void initWithJsonFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale = 1);
     void initWithBinaryFile (const std::string& skeletonDataFile, spAtlas* atlas, float scale = 1);
     void initWithBinaryFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale = 1);
+	/* Shares the skeleton data and the atlas loaded from the same files through the SkeletonDataCache. The JSON and binary
+	 * file overloads taking an atlas file both use it. */
+	void initWithCachedFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale = 1);
 
 	virtual void initialize ();
 
@@ -118,8 +121,27 @@ protected:
 	void setSkeletonData (spSkeletonData* skeletonData, bool ownsSkeletonData);
 	virtual AttachmentVertices* getAttachmentVertices (spRegionAttachment* attachment) const;
 	virtual AttachmentVertices* getAttachmentVertices (spMeshAttachment* attachment) const;
+	cocos2d::BlendFunc getBlendFunc (spBlendMode blendMode) const;
+
+	/* Copies the node color to the skeleton, read by prepareVertices. */
+	void updateSkeletonColor ();
+	/* Computes the vertices of the attachments in the current pose into the buffers of this renderer. Only reads the
+	 * skeleton and the attachments, several skeletons can be prepared on different threads. */
+	void prepareVertices ();
+
+	/* Vertices of one attachment, drawn with one command. */
+	struct Segment {
+		cocos2d::Texture2D* texture;
+		spBlendMode blendMode;
+		int vertexStart;
+		int vertexCount;
+		unsigned short* indices;
+		int indexCount;
+	};
 
 	bool _ownsSkeletonData;
+	// the skeleton data is referenced in the SkeletonDataCache
+	bool _cachedSkeletonData;
 	spAtlas* _atlas;
 	spAttachmentLoader* _attachmentLoader;
 	cocos2d::CustomCommand _debugCommand;
@@ -130,6 +152,11 @@ protected:
 	float _timeScale;
 	bool _debugSlots;
 	bool _debugBones;
+
+	std::vector<cocos2d::V3F_C4B_T2F> _vertices;
+	std::vector<Segment> _segments;
+	// the vertices were prepared for the next draw
+	bool _verticesPrepared;
 };
 
 }
@@ -0,0 +1,220 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#include <spine/SkeletonSystem.h>
+#include <spine/SkeletonAnimation.h>
+#include "base/CCThreadPool.h"
+#include <algorithm>
+#include <thread>
+
+USING_NS_CC;
+
+namespace spine {
+
+static SkeletonSystem* instance = nullptr;
+
+static bool isVisibleInTree (Node* node) {
+	for (; node; node = node->getParent())
+		if (!node->isVisible()) return false;
+	return true;
+}
+
+SkeletonSystem* SkeletonSystem::getInstance () {
+	if (!instance) instance = new (std::nothrow) SkeletonSystem();
+	return instance;
+}
+
+void SkeletonSystem::destroyInstance () {
+	CC_SAFE_RELEASE_NULL(instance);
+}
+
+SkeletonSystem::SkeletonSystem ()
+	: _enabled(false)
+	, _threadCount(std::max(1, (int)std::thread::hardware_concurrency() - 1))
+	, _minParallelSkeletons(4)
+	, _threadPool(nullptr)
+	, _afterUpdateListener(nullptr)
+	, _afterVisitListener(nullptr)
+	, _hasPendingUpdate(false)
+	, _pendingTasks(0) {
+}
+
+SkeletonSystem::~SkeletonSystem () {
+	setEnabled(false);
+	waitForUpdate();
+	// the destructor of the pool joins its threads
+	delete _threadPool;
+}
+
+void SkeletonSystem::setEnabled (bool enabled) {
+	if (_enabled == enabled) return;
+
+	waitForUpdate();
+	_enabled = enabled;
+
+	auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+	if (_enabled) {
+		_afterUpdateListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [this](EventCustom*) {
+			update();
+		});
+		// joins the work when no skeleton was drawn
+		_afterVisitListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_VISIT, [this](EventCustom*) {
+			waitForUpdate();
+		});
+		// Director::reset removes all the listeners before destroying the system
+		CC_SAFE_RETAIN(_afterUpdateListener);
+		CC_SAFE_RETAIN(_afterVisitListener);
+	} else {
+		if (_afterUpdateListener) {
+			eventDispatcher->removeEventListener(_afterUpdateListener);
+			CC_SAFE_RELEASE_NULL(_afterUpdateListener);
+		}
+		if (_afterVisitListener) {
+			eventDispatcher->removeEventListener(_afterVisitListener);
+			CC_SAFE_RELEASE_NULL(_afterVisitListener);
+		}
+
+		for (auto skeleton : _skeletons)
+			skeleton->_updatedBySystem = false;
+		_skeletons.clear();
+	}
+}
+
+bool SkeletonSystem::isEnabled () const {
+	return _enabled;
+}
+
+void SkeletonSystem::setThreadCount (int count) {
+	waitForUpdate();
+
+	_threadCount = std::max(1, count);
+	delete _threadPool;
+	_threadPool = nullptr;
+}
+
+int SkeletonSystem::getThreadCount () const {
+	return _threadCount;
+}
+
+void SkeletonSystem::setMinParallelSkeletons (int count) {
+	_minParallelSkeletons = count;
+}
+
+int SkeletonSystem::getMinParallelSkeletons () const {
+	return _minParallelSkeletons;
+}
+
+void SkeletonSystem::addSkeleton (SkeletonAnimation* skeleton) {
+	CCASSERT(!skeleton->_updatedBySystem, "SkeletonSystem: the skeleton is already registered");
+
+	skeleton->_updatedBySystem = true;
+	_skeletons.push_back(skeleton);
+}
+
+void SkeletonSystem::removeSkeleton (SkeletonAnimation* skeleton) {
+	waitForUpdate();
+
+	auto it = std::find(_skeletons.begin(), _skeletons.end(), skeleton);
+	if (it == _skeletons.end()) return;
+
+	skeleton->_updatedBySystem = false;
+	_skeletons.erase(it);
+}
+
+void SkeletonSystem::update () {
+	waitForUpdate();
+
+	// the hidden skeletons are still posed, their bones may be read and their events fire,
+	// the node colors and visibility are read on the main thread
+	auto scheduler = Director::getInstance()->getScheduler();
+	for (auto skeleton : _skeletons) {
+		if (skeleton->isBakedCacheEnabled() || scheduler->isTargetPaused(skeleton)) continue;
+
+		bool visible = isVisibleInTree(skeleton);
+		if (visible) skeleton->updateSkeletonColor();
+		_updatedSkeletons.push_back(skeleton);
+		_visibleSkeletons.push_back(visible);
+	}
+
+	if (_updatedSkeletons.empty()) return;
+	_hasPendingUpdate = true;
+
+	// not worth waking the worker threads
+	if ((int)_updatedSkeletons.size() < _minParallelSkeletons) {
+		updateSkeletons(0, _updatedSkeletons.size());
+		return;
+	}
+
+	if (!_threadPool) _threadPool = experimental::ThreadPool::newFixedThreadPool(_threadCount);
+
+	// one task per thread, with consecutive skeletons
+	size_t taskCount = std::min((size_t)_threadCount, _updatedSkeletons.size());
+	size_t skeletonsPerTask = (_updatedSkeletons.size() + taskCount - 1) / taskCount;
+	{
+		std::lock_guard<std::mutex> lock(_taskMutex);
+		_pendingTasks = (int)((_updatedSkeletons.size() + skeletonsPerTask - 1) / skeletonsPerTask);
+	}
+	for (size_t first = 0; first < _updatedSkeletons.size(); first += skeletonsPerTask) {
+		size_t last = std::min(first + skeletonsPerTask, _updatedSkeletons.size());
+		_threadPool->pushTask([this, first, last](int /*threadId*/) {
+			updateSkeletons(first, last);
+			finishTask();
+		});
+	}
+}
+
+void SkeletonSystem::updateSkeletons (size_t begin, size_t end) {
+	for (size_t i = begin; i < end; ++i) {
+		SkeletonAnimation* skeleton = _updatedSkeletons[i];
+		// the events stay queued, the next update of the skeleton fires them on the main thread
+		spAnimationState_applyPose(skeleton->_state, skeleton->_skeleton);
+		spSkeleton_updateWorldTransform(skeleton->_skeleton);
+		if (_visibleSkeletons[i]) skeleton->prepareVertices();
+	}
+}
+
+void SkeletonSystem::finishTask () {
+	std::lock_guard<std::mutex> lock(_taskMutex);
+	if (--_pendingTasks == 0) _taskCondition.notify_all();
+}
+
+void SkeletonSystem::waitForUpdate () {
+	if (!_hasPendingUpdate) return;
+
+	{
+		std::unique_lock<std::mutex> lock(_taskMutex);
+		_taskCondition.wait(lock, [this] { return _pendingTasks == 0; });
+	}
+	_hasPendingUpdate = false;
+	_updatedSkeletons.clear();
+	_visibleSkeletons.clear();
+}
+
+}
@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Spine Runtimes Software License v2.5
+ *
+ * Copyright (c) 2013-2016, Esoteric Software
+ * All rights reserved.
+ *
+ * You are granted a perpetual, non-exclusive, non-sublicensable, and
+ * non-transferable license to use, install, execute, and perform the Spine
+ * Runtimes software and derivative works solely for personal or internal
+ * use. Without the written permission of Esoteric Software (see Section 2 of
+ * the Spine Software License Agreement), you may not (a) modify, translate,
+ * adapt, or develop new applications using the Spine Runtimes or otherwise
+ * create derivative works or improvements of the Spine Runtimes or (b) remove,
+ * delete, alter, or obscure any trademarks or any copyright, trademark, patent,
+ * or other intellectual property or proprietary rights notices on or in the
+ * Software, including any copy thereof. Redistributions in binary or source
+ * form must include this license and terms.
+ *
+ * THIS SOFTWARE IS PROVIDED BY ESOTERIC SOFTWARE "AS IS" AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO
+ * EVENT SHALL ESOTERIC SOFTWARE BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES, BUSINESS INTERRUPTION, OR LOSS OF
+ * USE, DATA, OR PROFITS) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER
+ * IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef SPINE_SKELETONSYSTEM_H_
+#define SPINE_SKELETONSYSTEM_H_
+
+#include <spine/spine.h>
+#include "cocos2d.h"
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+namespace cocos2d {
+namespace experimental {
+	class ThreadPool;
+}
+}
+
+namespace spine {
+
+class SkeletonAnimation;
+
+/* Poses the running skeleton animations together on worker threads.
+ *
+ * When enabled, a SkeletonAnimation entering the scene registers itself here. Its scheduled update still advances the
+ * animation state and calls the listeners on the main thread. After all the updates, the system applies the animations and
+ * updates the world transforms of all of them, and computes the vertices of the visible ones, on the worker threads. Every skeleton
+ * writes only its own bones and vertices. The work is joined before the first registered skeleton draws, or at the latest
+ * after the visit. The events fired by the animations are called from the next update of their skeleton. */
+class SkeletonSystem: public cocos2d::Ref {
+public:
+	static SkeletonSystem* getInstance ();
+	static void destroyInstance ();
+
+	/* Enables the parallel update, disabled by default. Skeletons entering the scene afterwards are posed by the system,
+	 * disabling it lets the registered skeletons pose themselves again. */
+	void setEnabled (bool enabled);
+	bool isEnabled () const;
+
+	/* Sets the number of worker threads, by default one less than the number of CPU cores and at least one. */
+	void setThreadCount (int count);
+	int getThreadCount () const;
+
+	/* Sets the number of skeletons under which a frame is posed on the main thread, 4 by default. */
+	void setMinParallelSkeletons (int count);
+	int getMinParallelSkeletons () const;
+
+	/* Registers a running skeleton, called by SkeletonAnimation::onEnter. */
+	void addSkeleton (SkeletonAnimation* skeleton);
+	/* Unregisters a skeleton, called by SkeletonAnimation::onExit. Waits for the pending work first. */
+	void removeSkeleton (SkeletonAnimation* skeleton);
+
+	/* Waits for the worker threads. Does nothing when no work is pending. */
+	void waitForUpdate ();
+
+	/* Starts posing the registered skeletons, called after the scheduled updates while enabled. */
+	void update ();
+
+CC_CONSTRUCTOR_ACCESS:
+	SkeletonSystem ();
+	virtual ~SkeletonSystem ();
+
+protected:
+	void updateSkeletons (size_t begin, size_t end);
+	void finishTask ();
+
+	bool _enabled;
+	int _threadCount;
+	int _minParallelSkeletons;
+	cocos2d::experimental::ThreadPool* _threadPool;
+	cocos2d::EventListenerCustom* _afterUpdateListener;
+	cocos2d::EventListenerCustom* _afterVisitListener;
+
+	// weak references, cleared by removeSkeleton
+	std::vector<SkeletonAnimation*> _skeletons;
+	// skeletons handed to the worker threads this frame
+	std::vector<SkeletonAnimation*> _updatedSkeletons;
+	// whether the updated skeletons and all their ancestors are visible, only those are drawn
+	std::vector<bool> _visibleSkeletons;
+	bool _hasPendingUpdate;
+
+	int _pendingTasks;
+	std::mutex _taskMutex;
+	std::condition_variable _taskCondition;
+};
+
+}
+
+#endif /* SPINE_SKELETONSYSTEM_H_ */
@@ -36,7 +36,10 @@
 #include <spine/Cocos2dAttachmentLoader.h>
 #include <spine/SkeletonRenderer.h>
 #include <spine/SkeletonAnimation.h>
-#include <spine/SkeletonBatch.h>
+#include <spine/SkeletonBatch.h>
+#include <spine/SkeletonCache.h>
+#include <spine/SkeletonDataCache.h>
+#include <spine/SkeletonSystem.h>
 
 namespace spine {
 	typedef cocos2d::Texture2D* (*CustomTextureLoader)(const char* path);
@@ -28,6 +28,7 @@ THE SOFTWARE.
 
 #include <string>
 #include <ctype.h>
+#include <climits>
 
 #include "base/CCData.h"
 #include "base/ccConfig.h" // CC_USE_JPEG, CC_USE_TIFF, CC_USE_WEBP
@@ -85,6 +86,8 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "base/ccUTF8.h"
+#include "xxhash/xxhash.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/CCFileUtils-android.h"
 #endif
@@ -232,6 +235,9 @@ namespace
         _pixel3_formathash::value_type(PVR3TexturePixelFormat::PVRTC4BPP_RGBA,      Texture2D::PixelFormat::PVRTC4A),
 
         _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC1,        Texture2D::PixelFormat::ETC),
+        _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC2_RGB,    Texture2D::PixelFormat::ETC2_RGB),
+        _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC2_RGBA,   Texture2D::PixelFormat::ETC2_RGBA),
+        _pixel3_formathash::value_type(PVR3TexturePixelFormat::ETC2_RGBA1,  Texture2D::PixelFormat::ETC2_RGB_A1),
     };
 
     static const int PVR3_MAX_TABLE_ELEMENTS = sizeof(v3_pixel_formathash_value) / sizeof(v3_pixel_formathash_value[0]);
@@ -281,6 +287,141 @@ namespace
 }
 //pvr structure end
 
+//////////////////////////////////////////////////////////////////////////
+//struct and data for ktx structure
+
+namespace
+{
+    static const unsigned char gKTX1Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    static const unsigned char gKTX2Identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    static const uint32_t KTX_ENDIAN_REF = 0x04030201;
+
+    // KHR_DF_FLAG_ALPHA_PREMULTIPLIED in the basic data format descriptor block
+    static const unsigned char KTX2_DF_FLAG_ALPHA_PREMULTIPLIED = 1;
+
+    static std::string _transcodeCacheDirectory;
+
+    // glInternalFormat values used by KTX 1.1
+    typedef const std::map<uint32_t, Texture2D::PixelFormat> _ktx1_formathash;
+    static const _ktx1_formathash::value_type ktx1_formathash_value[] =
+    {
+        _ktx1_formathash::value_type(0x8D64, Texture2D::PixelFormat::ETC),          // GL_ETC1_RGB8_OES
+        _ktx1_formathash::value_type(0x9274, Texture2D::PixelFormat::ETC2_RGB),     // GL_COMPRESSED_RGB8_ETC2
+        _ktx1_formathash::value_type(0x9276, Texture2D::PixelFormat::ETC2_RGB_A1),  // GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+        _ktx1_formathash::value_type(0x9278, Texture2D::PixelFormat::ETC2_RGBA),    // GL_COMPRESSED_RGBA8_ETC2_EAC
+        _ktx1_formathash::value_type(0x93B0, Texture2D::PixelFormat::ASTC_4x4),     // GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+        _ktx1_formathash::value_type(0x93B4, Texture2D::PixelFormat::ASTC_6x6),     // GL_COMPRESSED_RGBA_ASTC_6x6_KHR
+        _ktx1_formathash::value_type(0x93B7, Texture2D::PixelFormat::ASTC_8x8),     // GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+        _ktx1_formathash::value_type(0x8C00, Texture2D::PixelFormat::PVRTC4),       // GL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG
+        _ktx1_formathash::value_type(0x8C01, Texture2D::PixelFormat::PVRTC2),       // GL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG
+        _ktx1_formathash::value_type(0x8C02, Texture2D::PixelFormat::PVRTC4A),      // GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG
+        _ktx1_formathash::value_type(0x8C03, Texture2D::PixelFormat::PVRTC2A),      // GL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG
+    };
+
+    static const _ktx1_formathash ktx1_formathash(ktx1_formathash_value, ktx1_formathash_value + sizeof(ktx1_formathash_value) / sizeof(ktx1_formathash_value[0]));
+
+    // VkFormat values used by KTX 2.0, sRGB variants are uploaded as their UNORM counterparts
+    typedef const std::map<uint32_t, Texture2D::PixelFormat> _ktx2_formathash;
+    static const _ktx2_formathash::value_type ktx2_formathash_value[] =
+    {
+        _ktx2_formathash::value_type(147, Texture2D::PixelFormat::ETC2_RGB),        // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+        _ktx2_formathash::value_type(148, Texture2D::PixelFormat::ETC2_RGB),        // VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK
+        _ktx2_formathash::value_type(149, Texture2D::PixelFormat::ETC2_RGB_A1),     // VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+        _ktx2_formathash::value_type(150, Texture2D::PixelFormat::ETC2_RGB_A1),     // VK_FORMAT_ETC2_R8G8B8A1_SRGB_BLOCK
+        _ktx2_formathash::value_type(151, Texture2D::PixelFormat::ETC2_RGBA),       // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+        _ktx2_formathash::value_type(152, Texture2D::PixelFormat::ETC2_RGBA),       // VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK
+        _ktx2_formathash::value_type(157, Texture2D::PixelFormat::ASTC_4x4),        // VK_FORMAT_ASTC_4x4_UNORM_BLOCK
+        _ktx2_formathash::value_type(158, Texture2D::PixelFormat::ASTC_4x4),        // VK_FORMAT_ASTC_4x4_SRGB_BLOCK
+        _ktx2_formathash::value_type(165, Texture2D::PixelFormat::ASTC_6x6),        // VK_FORMAT_ASTC_6x6_UNORM_BLOCK
+        _ktx2_formathash::value_type(166, Texture2D::PixelFormat::ASTC_6x6),        // VK_FORMAT_ASTC_6x6_SRGB_BLOCK
+        _ktx2_formathash::value_type(171, Texture2D::PixelFormat::ASTC_8x8),        // VK_FORMAT_ASTC_8x8_UNORM_BLOCK
+        _ktx2_formathash::value_type(172, Texture2D::PixelFormat::ASTC_8x8),        // VK_FORMAT_ASTC_8x8_SRGB_BLOCK
+    };
+
+    static const _ktx2_formathash ktx2_formathash(ktx2_formathash_value, ktx2_formathash_value + sizeof(ktx2_formathash_value) / sizeof(ktx2_formathash_value[0]));
+
+#ifdef _MSC_VER
+#pragma pack(push,1)
+#endif
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t endianness;
+        uint32_t glType;
+        uint32_t glTypeSize;
+        uint32_t glFormat;
+        uint32_t glInternalFormat;
+        uint32_t glBaseInternalFormat;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t numberOfArrayElements;
+        uint32_t numberOfFaces;
+        uint32_t numberOfMipmapLevels;
+        uint32_t bytesOfKeyValueData;
+#ifdef _MSC_VER
+    } KTXv1TexHeader;
+#else
+    } __attribute__((packed)) KTXv1TexHeader;
+#endif
+
+    typedef struct
+    {
+        unsigned char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+#ifdef _MSC_VER
+    } KTXv2TexHeader;
+#else
+    } __attribute__((packed)) KTXv2TexHeader;
+#endif
+
+    typedef struct
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+#ifdef _MSC_VER
+    } KTXv2LevelIndex;
+#else
+    } __attribute__((packed)) KTXv2LevelIndex;
+#endif
+
+    // header of the files written to the transcode cache directory
+    typedef struct
+    {
+        char identifier[4];
+        uint32_t version;
+        uint32_t pixelFormat;
+        uint32_t width;
+        uint32_t height;
+        uint32_t numberOfMipmaps;
+        uint32_t premultipliedAlpha;
+#ifdef _MSC_VER
+    } TranscodeCacheHeader;
+#pragma pack(pop)
+#else
+    } __attribute__((packed)) TranscodeCacheHeader;
+#endif
+
+    static const char gTranscodeCacheIdentifier[4] = {'C', 'C', 'T', 'C'};
+    static const uint32_t TRANSCODE_CACHE_VERSION = 1;
+}
+//ktx structure end
+
 namespace
 {
     typedef struct
@@ -306,6 +447,16 @@ namespace
         }
     }
 #endif //CC_USE_PNG
+
+    static void premultiplyRow(unsigned char* row, int pixels)
+    {
+        unsigned int* fourBytes = (unsigned int*)row;
+        for (int i = 0; i < pixels; i++)
+        {
+            unsigned char* p = row + i * 4;
+            fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        }
+    }
 }
 
 Texture2D::PixelFormat getDevicePixelFormat(Texture2D::PixelFormat format)
@@ -344,6 +495,8 @@ Image::Image()
 , _renderFormat(Texture2D::PixelFormat::NONE)
 , _numberOfMipmaps(0)
 , _hasPremultipliedAlpha(true)
+, _targetFormat(Texture2D::PixelFormat::NONE)
+, _externalData(false)
 {
 
 }
@@ -355,7 +508,7 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (!_externalData)
         CC_SAFE_FREE(_data);
 }
 
@@ -374,6 +527,24 @@ bool Image::initWithImageFile(const std::string& path)
     return ret;
 }
 
+bool Image::initWithImageFile(const std::string& path, Texture2D::PixelFormat format)
+{
+    _targetFormat = format;
+    bool ret = initWithImageFile(path);
+    _targetFormat = Texture2D::PixelFormat::NONE;
+    return ret;
+}
+
+bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format, const DecodeBufferAllocator& allocator)
+{
+    _targetFormat = format;
+    _decodeBufferAllocator = allocator;
+    bool ret = initWithImageData(data, dataLen);
+    _targetFormat = Texture2D::PixelFormat::NONE;
+    _decodeBufferAllocator = nullptr;
+    return ret;
+}
+
 bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
 {
     bool ret = false;
@@ -422,6 +593,9 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ETC:
             ret = initWithETCData(unpackedData, unpackedLen);
             break;
+        case Format::KTX:
+            ret = initWithKTXData(unpackedData, unpackedLen);
+            break;
         default:
             {
                 // load and detect image format
@@ -467,6 +641,17 @@ bool Image::isEtc(const unsigned char * data, ssize_t dataLen)
     return etc1_pkm_is_valid((etc1_byte*)data) ? true : false;
 }
 
+bool Image::isKtx(const unsigned char * data, ssize_t dataLen)
+{
+    if (dataLen <= static_cast<ssize_t>(sizeof(gKTX1Identifier)))
+    {
+        return false;
+    }
+
+    return memcmp(data, gKTX1Identifier, sizeof(gKTX1Identifier)) == 0
+        || memcmp(data, gKTX2Identifier, sizeof(gKTX2Identifier)) == 0;
+}
+
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -546,6 +731,10 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::ETC;
     }
+    else if (isKtx(data, dataLen))
+    {
+        return Format::KTX;
+    }
     else
     {
         return Format::UNKNOWN;
@@ -641,6 +830,8 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
     /* libjpeg data structure for storing one row, that is, scanline of an image */
     JSAMPROW row_pointer[1] = {0};
     unsigned long location = 0;
+    // volatile as it is assigned after setjmp and freed after longjmp
+    unsigned char* volatile rowBuffer = nullptr;
 
     bool ret = false;
     do
@@ -655,6 +846,7 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
              * We need to clean up the JPEG object, close the input file, and return.
              */
             jpeg_destroy_decompress(&cinfo);
+            CC_SAFE_FREE(rowBuffer);
             break;
         }
 
@@ -691,17 +883,52 @@ bool Image::initWithJpgData(const unsigned char * data, ssize_t dataLen)
         _height = cinfo.output_height;
         _hasPremultipliedAlpha = false;
 
-        _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        CC_BREAK_IF(! _data);
+        if (_targetFormat != Texture2D::PixelFormat::NONE)
+        {
+            /* convert each scan line into the texture format as it is decoded */
+            Texture2D::PixelFormat outFormat = Texture2D::getConvertedFormat(_renderFormat, _targetFormat);
+            ssize_t inRowBytes = cinfo.output_width*cinfo.output_components;
+            ssize_t outRowBytes = _width * Texture2D::getPixelFormatInfoMap().at(outFormat).bpp / 8;
+            if (!allocateDecodeBuffer(outRowBytes * _height))
+            {
+                jpeg_destroy_decompress( &cinfo );
+                break;
+            }
+
+            rowBuffer = static_cast<unsigned char*>(malloc(inRowBytes));
+            if (!rowBuffer)
+            {
+                jpeg_destroy_decompress( &cinfo );
+                break;
+            }
 
-        /* now actually read the jpeg into the raw buffer */
-        /* read one scan line at a time */
-        while (cinfo.output_scanline < cinfo.output_height)
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                unsigned char* outRow = _data + outRowBytes * cinfo.output_scanline;
+                row_pointer[0] = (outFormat == _renderFormat) ? outRow : rowBuffer;
+                jpeg_read_scanlines(&cinfo, row_pointer, 1);
+                if (outFormat != _renderFormat)
+                {
+                    Texture2D::convertDataToBuffer(rowBuffer, inRowBytes, _renderFormat, outFormat, outRow);
+                }
+            }
+            _renderFormat = outFormat;
+            CC_SAFE_FREE(rowBuffer);
+        }
+        else
         {
-            row_pointer[0] = _data + location;
-            location += cinfo.output_width*cinfo.output_components;
-            jpeg_read_scanlines(&cinfo, row_pointer, 1);
+            _dataLen = cinfo.output_width*cinfo.output_height*cinfo.output_components;
+            _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+            CC_BREAK_IF(! _data);
+
+            /* now actually read the jpeg into the raw buffer */
+            /* read one scan line at a time */
+            while (cinfo.output_scanline < cinfo.output_height)
+            {
+                row_pointer[0] = _data + location;
+                location += cinfo.output_width*cinfo.output_components;
+                jpeg_read_scanlines(&cinfo, row_pointer, 1);
+            }
         }
 
         /* When read image file with broken data, jpeg_finish_decompress() may cause error.
@@ -733,6 +960,9 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
     png_byte        header[PNGSIGSIZE]   = {0};
     png_structp     png_ptr     =   0;
     png_infop       info_ptr    = 0;
+    png_size_t      rowbytes    = 0;
+    // volatile as it is assigned after setjmp and freed after longjmp
+    unsigned char* volatile rowBuffer = nullptr;
 
     do
     {
@@ -825,12 +1055,48 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
                 break;
         }
 
+        rowbytes = png_get_rowbytes(png_ptr, info_ptr);
+
+        // interlaced images only have complete rows after the last pass, decode them whole
+        if (_targetFormat != Texture2D::PixelFormat::NONE && png_get_interlace_type(png_ptr, info_ptr) == PNG_INTERLACE_NONE)
+        {
+            // convert and premultiply each row as it is decoded
+            Texture2D::PixelFormat outFormat = Texture2D::getConvertedFormat(_renderFormat, _targetFormat);
+            ssize_t outRowBytes = _width * Texture2D::getPixelFormatInfoMap().at(outFormat).bpp / 8;
+            bool premultiply = PNG_PREMULTIPLIED_ALPHA_ENABLED && color_type == PNG_COLOR_TYPE_RGB_ALPHA;
+            CC_BREAK_IF(!allocateDecodeBuffer(outRowBytes * _height));
+
+            if (outFormat != _renderFormat)
+            {
+                rowBuffer = static_cast<unsigned char*>(malloc(rowbytes));
+                CC_BREAK_IF(!rowBuffer);
+            }
+
+            for (int i = 0; i < _height; ++i)
+            {
+                unsigned char* outRow = _data + outRowBytes * i;
+                unsigned char* row = rowBuffer ? rowBuffer : outRow;
+                png_read_row(png_ptr, row, nullptr);
+                if (premultiply)
+                {
+                    premultiplyRow(row, _width);
+                }
+                if (rowBuffer)
+                {
+                    Texture2D::convertDataToBuffer(rowBuffer, rowbytes, _renderFormat, outFormat, outRow);
+                }
+            }
+            png_read_end(png_ptr, nullptr);
+
+            _renderFormat = outFormat;
+            _hasPremultipliedAlpha = premultiply;
+            ret = true;
+            break;
+        }
+
         // read png data
-        png_size_t rowbytes;
         png_bytep* row_pointers = (png_bytep*)malloc( sizeof(png_bytep) * _height );
 
-        rowbytes = png_get_rowbytes(png_ptr, info_ptr);
-
         _dataLen = rowbytes * _height;
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
         if (!_data)
@@ -872,6 +1138,7 @@ bool Image::initWithPngData(const unsigned char * data, ssize_t dataLen)
     {
         png_destroy_read_struct(&png_ptr, (info_ptr) ? &info_ptr : 0, 0);
     }
+    CC_SAFE_FREE(rowBuffer);
     return ret;
 #else
     CCLOG("png is not enabled, please enable it in ccConfig.h");
@@ -1073,6 +1340,11 @@ namespace
             case PVR3TexturePixelFormat::BGRA8888:
                 return Configuration::getInstance()->supportsBGRA8888();
 
+            case PVR3TexturePixelFormat::ETC2_RGB:
+            case PVR3TexturePixelFormat::ETC2_RGBA:
+            case PVR3TexturePixelFormat::ETC2_RGBA1:
+                return Configuration::getInstance()->supportsETC2();
+
             case PVR3TexturePixelFormat::PVRTC2BPP_RGB:
             case PVR3TexturePixelFormat::PVRTC2BPP_RGBA:
             case PVR3TexturePixelFormat::PVRTC4BPP_RGB:
@@ -1327,6 +1599,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
 
     for (int i = 0; i < _numberOfMipmaps; i++)
     {
+        bool etc2Blocks = false;
         switch ((PVR3TexturePixelFormat)pixelFormat)
         {
             case PVR3TexturePixelFormat::PVRTC2BPP_RGB :
@@ -1377,6 +1650,15 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
                 widthBlocks = width / 4;
                 heightBlocks = height / 4;
                 break;
+            case PVR3TexturePixelFormat::ETC2_RGB:
+            case PVR3TexturePixelFormat::ETC2_RGBA:
+            case PVR3TexturePixelFormat::ETC2_RGBA1:
+                // ETC2 levels round up to whole 4x4 blocks, there is no 2 blocks minimum like PVRTC
+                etc2Blocks = true;
+                blockSize = 4 * 4;
+                widthBlocks = MAX((width + 3) / 4, 1);
+                heightBlocks = MAX((height + 3) / 4, 1);
+                break;
             case PVR3TexturePixelFormat::BGRA8888:
                 if (! Configuration::getInstance()->supportsBGRA8888())
                 {
@@ -1391,11 +1673,11 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
         }
 
         // Clamp to minimum number of blocks
-        if (widthBlocks < 2)
+        if (widthBlocks < 2 && !etc2Blocks)
         {
             widthBlocks = 2;
         }
-        if (heightBlocks < 2)
+        if (heightBlocks < 2 && !etc2Blocks)
         {
             heightBlocks = 2;
         }
@@ -1483,6 +1765,420 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
     return false;
 }
 
+bool Image::initWithKTXData(const unsigned char * data, ssize_t dataLen)
+{
+    if (memcmp(data, gKTX2Identifier, sizeof(gKTX2Identifier)) == 0)
+    {
+        return initWithKTXv2Data(data, dataLen);
+    }
+    return initWithKTXv1Data(data, dataLen);
+}
+
+bool Image::initWithKTXv1Data(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTXv1TexHeader))
+    {
+        return false;
+    }
+
+    KTXv1TexHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if (header.endianness != KTX_ENDIAN_REF)
+    {
+        CCLOG("cocos2d: WARNING: KTX file endianness does not match the device, re-export it. FILE: %s", _filePath.c_str());
+        return false;
+    }
+
+    if (header.glType != 0 || header.numberOfFaces > 1 || header.numberOfArrayElements > 0 || header.pixelDepth > 1)
+    {
+        CCLOG("cocos2d: WARNING: Only compressed 2D KTX textures are supported. FILE: %s", _filePath.c_str());
+        return false;
+    }
+
+    auto it = ktx1_formathash.find(header.glInternalFormat);
+    if (it == ktx1_formathash.end())
+    {
+        CCLOG("cocos2d: WARNING: Unsupported KTX glInternalFormat: 0x%04X. FILE: %s", header.glInternalFormat, _filePath.c_str());
+        return false;
+    }
+
+    int levelCount = MAX(static_cast<int>(header.numberOfMipmapLevels), 1);
+    if (levelCount > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: KTX file has %d mipmaps, at most %d are supported", levelCount, MIPMAP_MAX);
+        return false;
+    }
+
+    // each level is prefixed by its imageSize and padded to 4 bytes
+    MipmapInfo levels[MIPMAP_MAX];
+    ssize_t offset = sizeof(KTXv1TexHeader) + header.bytesOfKeyValueData;
+    for (int i = 0; i < levelCount; ++i)
+    {
+        uint32_t imageSize = 0;
+        if (offset + static_cast<ssize_t>(sizeof(imageSize)) > dataLen)
+        {
+            return false;
+        }
+        memcpy(&imageSize, data + offset, sizeof(imageSize));
+        offset += sizeof(imageSize);
+
+        if (offset + static_cast<ssize_t>(imageSize) > dataLen)
+        {
+            CCLOG("cocos2d: WARNING: KTX file is truncated. FILE: %s", _filePath.c_str());
+            return false;
+        }
+        levels[i].address = const_cast<unsigned char*>(data) + offset;
+        levels[i].len = static_cast<int>(imageSize);
+        offset += (imageSize + 3) & ~3;
+    }
+
+    _width = header.pixelWidth;
+    _height = header.pixelHeight;
+    // KTX 1.1 has no standard premultiplied alpha flag
+    _hasPremultipliedAlpha = false;
+
+    return initWithCompressedLevels(data, dataLen, it->second, levels, levelCount);
+}
+
+bool Image::initWithKTXv2Data(const unsigned char * data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTXv2TexHeader))
+    {
+        return false;
+    }
+
+    KTXv2TexHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if (header.supercompressionScheme != 0)
+    {
+        CCLOG("cocos2d: WARNING: Supercompressed KTX2 files (BasisLZ / zstd) are not supported, re-export without supercompression. FILE: %s", _filePath.c_str());
+        return false;
+    }
+
+    if (header.faceCount > 1 || header.layerCount > 0 || header.pixelDepth > 1)
+    {
+        CCLOG("cocos2d: WARNING: Only 2D KTX2 textures are supported. FILE: %s", _filePath.c_str());
+        return false;
+    }
+
+    auto it = ktx2_formathash.find(header.vkFormat);
+    if (it == ktx2_formathash.end())
+    {
+        CCLOG("cocos2d: WARNING: Unsupported KTX2 vkFormat: %u. FILE: %s", header.vkFormat, _filePath.c_str());
+        return false;
+    }
+
+    int levelCount = MAX(static_cast<int>(header.levelCount), 1);
+    if (levelCount > MIPMAP_MAX)
+    {
+        CCLOG("cocos2d: WARNING: KTX2 file has %d mipmaps, at most %d are supported", levelCount, MIPMAP_MAX);
+        return false;
+    }
+
+    if (static_cast<size_t>(dataLen) < sizeof(KTXv2TexHeader) + levelCount * sizeof(KTXv2LevelIndex))
+    {
+        return false;
+    }
+
+    // the level index is ordered from the base level down, whatever the order of the data in the file
+    MipmapInfo levels[MIPMAP_MAX];
+    for (int i = 0; i < levelCount; ++i)
+    {
+        KTXv2LevelIndex index;
+        memcpy(&index, data + sizeof(KTXv2TexHeader) + i * sizeof(KTXv2LevelIndex), sizeof(index));
+
+        if (index.byteOffset + index.byteLength > static_cast<uint64_t>(dataLen))
+        {
+            CCLOG("cocos2d: WARNING: KTX2 file is truncated. FILE: %s", _filePath.c_str());
+            return false;
+        }
+        levels[i].address = const_cast<unsigned char*>(data) + index.byteOffset;
+        levels[i].len = static_cast<int>(index.byteLength);
+    }
+
+    _width = header.pixelWidth;
+    _height = header.pixelHeight;
+
+    // the flags byte of the basic descriptor block follows dfdTotalSize, the block header and the color model fields
+    const size_t flagsOffset = header.dfdByteOffset + 4 + 8 + 3;
+    if (header.dfdByteLength > 0 && flagsOffset < static_cast<size_t>(dataLen))
+    {
+        _hasPremultipliedAlpha = (data[flagsOffset] & KTX2_DF_FLAG_ALPHA_PREMULTIPLIED) != 0;
+    }
+    else
+    {
+        _hasPremultipliedAlpha = false;
+    }
+
+    return initWithCompressedLevels(data, dataLen, it->second, levels, levelCount);
+}
+
+bool Image::initWithCompressedLevels(const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format, const MipmapInfo* levels, int levelCount)
+{
+    // the decoded base level is width * height * 4 bytes at most, it has to fit in the int length of a mipmap
+    if (_width <= 0 || _height <= 0 || _width > INT_MAX / 4 / _height)
+    {
+        CCLOG("cocos2d: WARNING: Invalid compressed texture size %dx%d. FILE: %s", _width, _height, _filePath.c_str());
+        return false;
+    }
+
+    Configuration *configuration = Configuration::getInstance();
+
+    bool supported = false;
+    switch (format)
+    {
+        case Texture2D::PixelFormat::ETC:
+            supported = configuration->supportsETC();
+            break;
+        case Texture2D::PixelFormat::ETC2_RGB:
+        case Texture2D::PixelFormat::ETC2_RGBA:
+        case Texture2D::PixelFormat::ETC2_RGB_A1:
+            supported = configuration->supportsETC2();
+            break;
+        case Texture2D::PixelFormat::ASTC_4x4:
+        case Texture2D::PixelFormat::ASTC_6x6:
+        case Texture2D::PixelFormat::ASTC_8x8:
+            supported = configuration->supportsASTC();
+            break;
+        case Texture2D::PixelFormat::PVRTC4:
+        case Texture2D::PixelFormat::PVRTC4A:
+        case Texture2D::PixelFormat::PVRTC2:
+        case Texture2D::PixelFormat::PVRTC2A:
+            supported = configuration->supportsPVRTC();
+            break;
+        default:
+            break;
+    }
+
+    if (supported)
+    {
+        // upload the payload as is, all levels are packed into one block owned by _data
+        _dataLen = 0;
+        for (int i = 0; i < levelCount; ++i)
+        {
+            _dataLen += levels[i].len;
+        }
+        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+        if (_data == nullptr)
+        {
+            _dataLen = 0;
+            return false;
+        }
+
+        ssize_t offset = 0;
+        for (int i = 0; i < levelCount; ++i)
+        {
+            memcpy(_data + offset, levels[i].address, levels[i].len);
+            _mipmaps[i].address = _data + offset;
+            _mipmaps[i].len = levels[i].len;
+            offset += levels[i].len;
+        }
+        _numberOfMipmaps = levelCount;
+        _renderFormat = format;
+        return true;
+    }
+
+    // software decoding, the only CPU decoders we ship are ETC1 and PVRTC
+    if (format != Texture2D::PixelFormat::ETC
+        && format != Texture2D::PixelFormat::PVRTC4 && format != Texture2D::PixelFormat::PVRTC4A
+        && format != Texture2D::PixelFormat::PVRTC2 && format != Texture2D::PixelFormat::PVRTC2A)
+    {
+        CCLOG("cocos2d: WARNING: No hardware decoder for the KTX pixel format %d on this device. FILE: %s", static_cast<int>(format), _filePath.c_str());
+        return false;
+    }
+
+    std::string cacheKey;
+    if (!_transcodeCacheDirectory.empty())
+    {
+        cacheKey = StringUtils::format("%08x%08x_%u_%d.cctc",
+                                       XXH32(data, dataLen, 0), XXH32(data, dataLen, 0x9E3779B1),
+                                       static_cast<unsigned>(dataLen), static_cast<int>(format));
+        if (loadTranscodeCache(cacheKey))
+        {
+            return true;
+        }
+    }
+
+    CCLOG("cocos2d: Hardware decoder for KTX pixel format %d not present. Using software decoder", static_cast<int>(format));
+
+    int width = _width;
+    int height = _height;
+    int bytePerPixel = (format == Texture2D::PixelFormat::ETC) ? 3 : 4;
+    bool is2bpp = (format == Texture2D::PixelFormat::PVRTC2 || format == Texture2D::PixelFormat::PVRTC2A);
+    _unpack = true;
+    for (int i = 0; i < levelCount; ++i)
+    {
+        // the decoders read whole blocks, ETC1 4x4 blocks of 8 bytes, PVRTC at least 2x2 blocks of 8 bytes
+        size_t requiredLen = 0;
+        if (format == Texture2D::PixelFormat::ETC)
+        {
+            requiredLen = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * 8;
+        }
+        else if (is2bpp)
+        {
+            requiredLen = static_cast<size_t>(MAX(width, 16)) * MAX(height, 8) * 2 / 8;
+        }
+        else
+        {
+            requiredLen = static_cast<size_t>(MAX(width, 8)) * MAX(height, 8) * 4 / 8;
+        }
+        if (levels[i].len < 0 || static_cast<size_t>(levels[i].len) < requiredLen)
+        {
+            CCLOG("cocos2d: WARNING: Compressed texture level %d is truncated. FILE: %s", i, _filePath.c_str());
+            return false;
+        }
+
+        _mipmaps[i].address = new (std::nothrow) unsigned char[width * height * bytePerPixel];
+        if (_mipmaps[i].address == nullptr)
+        {
+            return false;
+        }
+        _mipmaps[i].len = width * height * bytePerPixel;
+        _numberOfMipmaps = i + 1;
+
+        if (format == Texture2D::PixelFormat::ETC)
+        {
+            if (etc1_decode_image(levels[i].address, static_cast<etc1_byte*>(_mipmaps[i].address), width, height, bytePerPixel, width * bytePerPixel) != 0)
+            {
+                return false;
+            }
+        }
+        else
+        {
+            PVRTDecompressPVRTC(levels[i].address, width, height, _mipmaps[i].address, is2bpp);
+        }
+
+        width = MAX(width >> 1, 1);
+        height = MAX(height >> 1, 1);
+    }
+
+    _renderFormat = (format == Texture2D::PixelFormat::ETC) ? Texture2D::PixelFormat::RGB888 : Texture2D::PixelFormat::RGBA8888;
+    _data = _mipmaps[0].address;
+    _dataLen = _mipmaps[0].len;
+
+    if (!cacheKey.empty())
+    {
+        saveTranscodeCache(cacheKey);
+    }
+    return true;
+}
+
+bool Image::loadTranscodeCache(const std::string& key)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string path = _transcodeCacheDirectory + key;
+    if (!fileUtils->isFileExist(path))
+    {
+        return false;
+    }
+
+    Data cached = fileUtils->getDataFromFile(path);
+    const unsigned char* bytes = cached.getBytes();
+    ssize_t size = cached.getSize();
+    if (static_cast<size_t>(size) < sizeof(TranscodeCacheHeader))
+    {
+        return false;
+    }
+
+    TranscodeCacheHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.identifier, gTranscodeCacheIdentifier, sizeof(gTranscodeCacheIdentifier)) != 0
+        || header.version != TRANSCODE_CACHE_VERSION
+        || header.numberOfMipmaps == 0 || header.numberOfMipmaps > MIPMAP_MAX)
+    {
+        return false;
+    }
+
+    // validate the whole file before taking ownership of anything
+    ssize_t offset = sizeof(TranscodeCacheHeader);
+    for (uint32_t i = 0; i < header.numberOfMipmaps; ++i)
+    {
+        uint32_t len = 0;
+        if (offset + static_cast<ssize_t>(sizeof(len)) > size)
+        {
+            return false;
+        }
+        memcpy(&len, bytes + offset, sizeof(len));
+        offset += sizeof(len) + len;
+        if (offset > size)
+        {
+            return false;
+        }
+    }
+
+    offset = sizeof(TranscodeCacheHeader);
+    _unpack = true;
+    _numberOfMipmaps = header.numberOfMipmaps;
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        uint32_t len = 0;
+        memcpy(&len, bytes + offset, sizeof(len));
+        offset += sizeof(len);
+        _mipmaps[i].len = static_cast<int>(len);
+        _mipmaps[i].address = new (std::nothrow) unsigned char[len];
+        memcpy(_mipmaps[i].address, bytes + offset, len);
+        offset += len;
+    }
+
+    _renderFormat = static_cast<Texture2D::PixelFormat>(header.pixelFormat);
+    _width = header.width;
+    _height = header.height;
+    _hasPremultipliedAlpha = header.premultipliedAlpha != 0;
+    _data = _mipmaps[0].address;
+    _dataLen = _mipmaps[0].len;
+    return true;
+}
+
+void Image::saveTranscodeCache(const std::string& key)
+{
+    TranscodeCacheHeader header;
+    memcpy(header.identifier, gTranscodeCacheIdentifier, sizeof(gTranscodeCacheIdentifier));
+    header.version = TRANSCODE_CACHE_VERSION;
+    header.pixelFormat = static_cast<uint32_t>(_renderFormat);
+    header.width = _width;
+    header.height = _height;
+    header.numberOfMipmaps = _numberOfMipmaps;
+    header.premultipliedAlpha = _hasPremultipliedAlpha ? 1 : 0;
+
+    ssize_t size = sizeof(header);
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        size += sizeof(uint32_t) + _mipmaps[i].len;
+    }
+
+    unsigned char* bytes = static_cast<unsigned char*>(malloc(size));
+    if (bytes == nullptr)
+    {
+        return;
+    }
+
+    memcpy(bytes, &header, sizeof(header));
+    ssize_t offset = sizeof(header);
+    for (int i = 0; i < _numberOfMipmaps; ++i)
+    {
+        uint32_t len = static_cast<uint32_t>(_mipmaps[i].len);
+        memcpy(bytes + offset, &len, sizeof(len));
+        offset += sizeof(len);
+        memcpy(bytes + offset, _mipmaps[i].address, len);
+        offset += len;
+    }
+
+    Data cached;
+    cached.fastSet(bytes, size);
+
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isDirectoryExist(_transcodeCacheDirectory))
+    {
+        fileUtils->createDirectory(_transcodeCacheDirectory);
+    }
+    if (!fileUtils->writeDataToFile(cached, _transcodeCacheDirectory + key))
+    {
+        CCLOG("cocos2d: WARNING: failed to write transcode cache %s", key.c_str());
+    }
+}
+
 bool Image::initWithTGAData(tImageTGA* tgaData)
 {
     bool ret = false;
@@ -1906,6 +2602,23 @@ bool Image::saveImageToJPG(const std::string& filePath)
 #endif // CC_USE_JPEG
 }
 
+bool Image::allocateDecodeBuffer(ssize_t dataLen)
+{
+    _dataLen = dataLen;
+    if (_decodeBufferAllocator)
+    {
+        _data = _decodeBufferAllocator(_width, _height, dataLen);
+        if (_data != nullptr)
+        {
+            _externalData = true;
+            return true;
+        }
+    }
+
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+    return _data != nullptr;
+}
+
 void Image::premultipliedAlpha()
 {
     if (PNG_PREMULTIPLIED_ALPHA_ENABLED && _renderFormat == Texture2D::PixelFormat::RGBA8888)
@@ -1932,5 +2645,19 @@ void Image::setPVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied)
     _PVRHaveAlphaPremultiplied = haveAlphaPremultiplied;
 }
 
+void Image::setTranscodeCacheDirectory(const std::string& path)
+{
+    _transcodeCacheDirectory = path;
+    if (!_transcodeCacheDirectory.empty() && _transcodeCacheDirectory.back() != '/')
+    {
+        _transcodeCacheDirectory += '/';
+    }
+}
+
+const std::string& Image::getTranscodeCacheDirectory()
+{
+    return _transcodeCacheDirectory;
+}
+
 NS_CC_END
 
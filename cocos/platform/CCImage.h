@@ -27,6 +27,8 @@ THE SOFTWARE.
 #define __CC_IMAGE_H__
 /// @cond DO_NOT_SHOW
 
+#include <functional>
+
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 
@@ -63,6 +65,12 @@ public:
      */
     Image();
 
+    /** Provides the buffer a streamed decode writes its pixels into, such as a mapped buffer or a pooled allocation.
+     Called once the image header is parsed. The returned memory must hold dataLen bytes and stays owned by the caller;
+     return nullptr to let the Image allocate it.
+     */
+    typedef std::function<unsigned char*(int width, int height, ssize_t dataLen)> DecodeBufferAllocator;
+
     /** Supported formats for Image */
     enum class Format
     {
@@ -78,6 +86,8 @@ public:
         PVR,
         //! ETC
         ETC,
+        //! KTX / KTX2 container (ETC1, ETC2, ASTC, PVRTC payloads)
+        KTX,
         //! S3TC
 //        S3TC,
         //! ATITC
@@ -105,6 +115,16 @@ public:
      */
     static void setPVRImagesHavePremultipliedAlpha(bool haveAlphaPremultiplied);
 
+    /** Sets the directory used to cache software transcoded textures.
+     When a KTX payload has to be decoded on the CPU because the GPU lacks the codec,
+     the decoded mip chain is stored there, keyed by a hash of the file content,
+     and reused by later loads of the same data.
+
+     An empty path disables the cache. By default it is disabled.
+     */
+    static void setTranscodeCacheDirectory(const std::string& path);
+    static const std::string& getTranscodeCacheDirectory();
+
     /**
     @brief Load the image from the specified path.
     @param path   the absolute file path.
@@ -122,6 +142,30 @@ public:
     */
     bool initWithImageData(const unsigned char * data, ssize_t dataLen);
 
+    /**
+    @brief Load the image from the specified path, decoding PNG and JPEG data straight into the given pixel format.
+    @param path   the absolute file path.
+    @param format the pixel format the texture will use, Texture2D::PixelFormat::AUTO keeps the decoded format.
+    @return true if loaded correctly.
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageFile(const std::string& path, Texture2D::PixelFormat format);
+
+    /**
+    @brief Load image from stream buffer, decoding PNG and JPEG data straight into the given pixel format.
+    PNG and JPEG rows are converted and premultiplied one at a time, so no full size intermediate buffer is
+    allocated. Other formats decode as usual and are converted later by Texture2D.
+    @param data  stream buffer which holds the image data.
+    @param dataLen  data length expressed in (number of) bytes.
+    @param format the pixel format the texture will use, Texture2D::PixelFormat::AUTO keeps the decoded format.
+    @param allocator optional provider of the destination buffer, see DecodeBufferAllocator.
+    @return true if loaded correctly.
+    * @js NA
+    * @lua NA
+    */
+    bool initWithImageData(const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format, const DecodeBufferAllocator& allocator = nullptr);
+
     // @warning kFmtRawData only support RGBA8888
     bool initWithRawData(const unsigned char * data, ssize_t dataLen, int width, int height, int bitsPerComponent, bool preMulti = false);
 
@@ -157,6 +201,13 @@ protected:
     bool initWithPVRv2Data(const unsigned char * data, ssize_t dataLen);
     bool initWithPVRv3Data(const unsigned char * data, ssize_t dataLen);
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXData(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXv1Data(const unsigned char * data, ssize_t dataLen);
+    bool initWithKTXv2Data(const unsigned char * data, ssize_t dataLen);
+    bool initWithCompressedLevels(const unsigned char * data, ssize_t dataLen, Texture2D::PixelFormat format, const MipmapInfo* levels, int levelCount);
+
+    bool loadTranscodeCache(const std::string& key);
+    void saveTranscodeCache(const std::string& key);
 
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
@@ -166,6 +217,8 @@ protected:
 
     void premultipliedAlpha();
 
+    bool allocateDecodeBuffer(ssize_t dataLen);
+
 protected:
     /**
      @brief Determine how many mipmaps can we have.
@@ -188,6 +241,11 @@ protected:
     // false if we can't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
     std::string _filePath;
+    // format PNG / JPEG rows are converted to while decoding, NONE decodes into the file's own format
+    Texture2D::PixelFormat _targetFormat;
+    DecodeBufferAllocator _decodeBufferAllocator;
+    // true if _data was handed out by _decodeBufferAllocator and must not be freed
+    bool _externalData;
 
 protected:
     // noncopyable
@@ -211,6 +269,7 @@ protected:
     bool isWebp(const unsigned char * data, ssize_t dataLen);
     bool isPvr(const unsigned char * data, ssize_t dataLen);
     bool isEtc(const unsigned char * data, ssize_t dataLen);
+    bool isKtx(const unsigned char * data, ssize_t dataLen);
 };
 
 // end of platform group
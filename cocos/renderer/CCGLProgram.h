@@ -192,6 +192,8 @@ public:
     /**Built in shader for ui effects */
     static const char* SHADER_NAME_POSITION_GRAYSCALE;
     static const char* SHADER_NAME_SPRITE_DISTORTION;
+    /**Built in shader expanding particle records to quads, for ParticleSystemQuad::RenderMode::GPU_EXPANDED */
+    static const char* SHADER_NAME_PARTICLE_EXPANDED;
     /** @{
         Built in shader for label and label with effects.
     */
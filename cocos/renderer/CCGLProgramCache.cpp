@@ -54,6 +54,7 @@ enum {
     kShaderType_LabelDistanceFieldGlow,
     kShaderType_UIGrayScale,
     kShaderType_SpriteDistortion,
+    kShaderType_ParticleExpanded,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
     kShaderType_CameraClear,
@@ -198,6 +199,10 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_SpriteDistortion);
     _programs.insert(std::make_pair(GLProgram::SHADER_NAME_SPRITE_DISTORTION, p));
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_ParticleExpanded);
+    _programs.insert(std::make_pair(GLProgram::SHADER_NAME_PARTICLE_EXPANDED, p));
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_LabelNormal);
     _programs.insert( std::make_pair(GLProgram::SHADER_NAME_LABEL_NORMAL, p) );
@@ -314,6 +319,10 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p = getGLProgram(GLProgram::SHADER_NAME_SPRITE_DISTORTION);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_SpriteDistortion);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_PARTICLE_EXPANDED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_ParticleExpanded);
 }
 
 void GLProgramCache::reloadDefaultGLProgramsRelativeToLights()
@@ -373,6 +382,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_SpriteDistortion:
             p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccSprite_Distortion_frag);
             break;
+        case kShaderType_ParticleExpanded:
+            p->initWithByteArrays(ccParticleExpanded_vert, ccPositionTextureColor_frag);
+            break;
         case kShaderType_LabelNormal:
             p->initWithByteArrays(ccLabel_vert, ccLabelNormal_frag);
             break;
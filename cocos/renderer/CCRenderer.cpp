@@ -175,6 +175,7 @@ Renderer::Renderer()
 ,_filledIndex(0)
 ,_glViewAssigned(false)
 ,_isRendering(false)
+,_lastCommand(nullptr)
 ,_isDepthTestFor2D(false)
 ,_triBatchesToDraw(nullptr)
 ,_triBatchesToDrawCapacity(-1)
@@ -324,18 +325,21 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
     _renderGroups[renderQueue].push_back(command);
+    _lastCommand = command;
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.push(renderQueueID);
+    _lastCommand = nullptr;
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
     _commandGroupStack.pop();
+    _lastCommand = nullptr;
 }
 
 int Renderer::createRenderQueue()
@@ -570,6 +574,7 @@ void Renderer::clean()
     _queuedTriangleCommands.clear();
     _filledVertex = 0;
     _filledIndex = 0;
+    _lastCommand = nullptr;
 }
 
 void Renderer::clear()
@@ -604,11 +609,14 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
     memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
 
-    // fill vertex, and convert them to world coordinates
+    // fill vertex, and convert them to world coordinates, unless they already are
     const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
+    if (!modelView.isIdentity())
     {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
+        {
+            modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        }
     }
 
     // fill index
@@ -161,6 +161,11 @@ public:
     /** Adds a `RenderComamnd` into the renderer specifying a particular render queue ID */
     void addCommand(RenderCommand* command, int renderQueue);
 
+    /** Returns the last command added during this frame, or nullptr.
+     A batch can keep appending to its last command as long as nothing was added after it.
+     */
+    RenderCommand* getLastCommand() const { return _lastCommand; }
+
     /** Pushes a group into the render queue */
     void pushGroup(int renderQueueID);
 
@@ -264,6 +269,8 @@ protected:
     //the flag for checking whether renderer is rendering
     bool _isRendering;
 
+    RenderCommand* _lastCommand;
+
     bool _isDepthTestFor2D;
 
     GroupCommandManager* _groupCommandManager;
@@ -53,6 +53,27 @@ THE SOFTWARE.
 #endif
 
 #include <unordered_set>
+#include <vector>
+
+// ETC2 and ASTC enums are missing from the GLES2 / desktop GL headers we build against
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                                     0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2                 0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                                0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR                             0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_6x6_KHR
+#define GL_COMPRESSED_RGBA_ASTC_6x6_KHR                             0x93B4
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_8x8_KHR
+#define GL_COMPRESSED_RGBA_ASTC_8x8_KHR                             0x93B7
+#endif
 
 NS_CC_BEGIN
 
@@ -107,6 +128,15 @@ namespace {
         PixelFormatInfoMapValue(Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA, Texture2D::PixelFormatInfo(GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD,
             0xFFFFFFFF, 0xFFFFFFFF, 8, true, false)),
 #endif
+
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGB, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGB8_ETC2, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, false)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGBA, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA8_ETC2_EAC, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ETC2_RGB_A1, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, true)),
+
+        // bpp of 6x6 blocks is 3.56, rounded up so memory estimates never undercount
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_4x4, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_4x4_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 8, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_6x6, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_6x6_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 4, true, true)),
+        PixelFormatInfoMapValue(Texture2D::PixelFormat::ASTC_8x8, Texture2D::PixelFormatInfo(GL_COMPRESSED_RGBA_ASTC_8x8_KHR, 0xFFFFFFFF, 0xFFFFFFFF, 2, true, true)),
     };
 }
 
@@ -432,6 +462,31 @@ void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataL
 // converter function end
 //////////////////////////////////////////////////////////////////////////
 static std::unordered_set<Texture2D*> s_allGLTexture2D;
+// the textures indexed by their GL name for markTextureUsed, the names are small as GL reuses the freed ones
+static std::vector<Texture2D*> s_texture2DByName;
+static const GLuint MAX_TRACKED_TEXTURE_NAME = 65536;
+
+static void setTexture2DForName(GLuint name, Texture2D* texture)
+{
+    if (name == 0 || name >= MAX_TRACKED_TEXTURE_NAME)
+        return;
+
+    if (name >= s_texture2DByName.size())
+    {
+        if (!texture)
+            return;
+        s_texture2DByName.resize(name + 1, nullptr);
+    }
+    s_texture2DByName[name] = texture;
+}
+
+void Texture2D::markTextureUsed(GLuint name)
+{
+    if (name < s_texture2DByName.size() && s_texture2DByName[name])
+    {
+        s_texture2DByName[name]->_lastUsedFrame = Director::getInstance()->getTotalFrames();
+    }
+}
 
 void Texture2D::forceDeleteALLTexture2D()
 {
@@ -451,6 +506,7 @@ Texture2D::Texture2D()
 , _maxT(0.0)
 , _hasPremultipliedAlpha(false)
 , _hasMipmaps(false)
+, _lastUsedFrame(0)
 , _shaderProgram(nullptr)
 , _antialiasEnabled(true)
 , _ninePatchInfo(nullptr)
@@ -477,6 +533,7 @@ Texture2D::~Texture2D()
 
     if(_name)
     {
+        setTexture2DForName(_name, nullptr);
         GL::deleteTexture(_name);
     }
 }
@@ -485,9 +542,11 @@ void Texture2D::releaseGLTexture()
 {
     if(_name)
     {
+        setTexture2DForName(_name, nullptr);
         GL::deleteTexture(_name);
     }
     _name = 0;
+    _lastUsedFrame = 0;
 }
 
 Texture2D::PixelFormat Texture2D::getPixelFormat() const
@@ -599,11 +658,13 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     const PixelFormatInfo& info = _pixelFormatInfoTables.at(pixelFormat);
 
     if (info.compressed && !Configuration::getInstance()->supportsPVRTC()
-                        && !Configuration::getInstance()->supportsETC())
+                        && !Configuration::getInstance()->supportsETC()
+                        && !Configuration::getInstance()->supportsETC2()
+                        && !Configuration::getInstance()->supportsASTC())
 //                        && !Configuration::getInstance()->supportsS3TC()
 //                        && !Configuration::getInstance()->supportsATITC())
     {
-        CCLOG("cocos2d: WARNING: PVRTC/ETC images are not supported");
+        CCLOG("cocos2d: WARNING: PVRTC/ETC/ASTC images are not supported");
         return false;
     }
 
@@ -635,11 +696,13 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
     if(_name != 0)
     {
+        setTexture2DForName(_name, nullptr);
         GL::deleteTexture(_name);
         _name = 0;
     }
 
     glGenTextures(1, &_name);
+    setTexture2DForName(_name, this);
     GL::bindTexture2D(_name);
 
     if (mipmapsNum == 1)
@@ -1078,6 +1141,111 @@ Texture2D::PixelFormat Texture2D::convertDataToFormat(const unsigned char* data,
     }
 }
 
+Texture2D::PixelFormat Texture2D::getConvertedFormat(PixelFormat originFormat, PixelFormat format)
+{
+    if (format == originFormat || format == PixelFormat::AUTO)
+    {
+        return originFormat;
+    }
+
+    switch (format)
+    {
+    case PixelFormat::RGBA8888:
+    case PixelFormat::RGB888:
+    case PixelFormat::RGB565:
+    case PixelFormat::I8:
+    case PixelFormat::AI88:
+    case PixelFormat::RGBA4444:
+    case PixelFormat::RGB5A1:
+        break;
+    case PixelFormat::A8:
+        // gray images have nothing to put into an alpha mask
+        if (originFormat == PixelFormat::I8)
+        {
+            return originFormat;
+        }
+        break;
+    default:
+        return originFormat;
+    }
+
+    switch (originFormat)
+    {
+    case PixelFormat::I8:
+    case PixelFormat::AI88:
+    case PixelFormat::RGB888:
+    case PixelFormat::RGBA8888:
+        return format;
+    default:
+        return originFormat;
+    }
+}
+
+void Texture2D::convertDataToBuffer(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char* outData)
+{
+    format = getConvertedFormat(originFormat, format);
+
+    switch (originFormat)
+    {
+    case PixelFormat::I8:
+        switch (format)
+        {
+        case PixelFormat::RGBA8888: convertI8ToRGBA8888(data, dataLen, outData); return;
+        case PixelFormat::RGB888:   convertI8ToRGB888(data, dataLen, outData); return;
+        case PixelFormat::RGB565:   convertI8ToRGB565(data, dataLen, outData); return;
+        case PixelFormat::AI88:     convertI8ToAI88(data, dataLen, outData); return;
+        case PixelFormat::RGBA4444: convertI8ToRGBA4444(data, dataLen, outData); return;
+        case PixelFormat::RGB5A1:   convertI8ToRGB5A1(data, dataLen, outData); return;
+        default: break;
+        }
+        break;
+    case PixelFormat::AI88:
+        switch (format)
+        {
+        case PixelFormat::RGBA8888: convertAI88ToRGBA8888(data, dataLen, outData); return;
+        case PixelFormat::RGB888:   convertAI88ToRGB888(data, dataLen, outData); return;
+        case PixelFormat::RGB565:   convertAI88ToRGB565(data, dataLen, outData); return;
+        case PixelFormat::A8:       convertAI88ToA8(data, dataLen, outData); return;
+        case PixelFormat::I8:       convertAI88ToI8(data, dataLen, outData); return;
+        case PixelFormat::RGBA4444: convertAI88ToRGBA4444(data, dataLen, outData); return;
+        case PixelFormat::RGB5A1:   convertAI88ToRGB5A1(data, dataLen, outData); return;
+        default: break;
+        }
+        break;
+    case PixelFormat::RGB888:
+        switch (format)
+        {
+        case PixelFormat::RGBA8888: convertRGB888ToRGBA8888(data, dataLen, outData); return;
+        case PixelFormat::RGB565:   convertRGB888ToRGB565(data, dataLen, outData); return;
+        case PixelFormat::A8:       convertRGB888ToA8(data, dataLen, outData); return;
+        case PixelFormat::I8:       convertRGB888ToI8(data, dataLen, outData); return;
+        case PixelFormat::AI88:     convertRGB888ToAI88(data, dataLen, outData); return;
+        case PixelFormat::RGBA4444: convertRGB888ToRGBA4444(data, dataLen, outData); return;
+        case PixelFormat::RGB5A1:   convertRGB888ToRGB5A1(data, dataLen, outData); return;
+        default: break;
+        }
+        break;
+    case PixelFormat::RGBA8888:
+        switch (format)
+        {
+        case PixelFormat::RGB888:   convertRGBA8888ToRGB888(data, dataLen, outData); return;
+        case PixelFormat::RGB565:   convertRGBA8888ToRGB565(data, dataLen, outData); return;
+        case PixelFormat::A8:       convertRGBA8888ToA8(data, dataLen, outData); return;
+        case PixelFormat::I8:       convertRGBA8888ToI8(data, dataLen, outData); return;
+        case PixelFormat::AI88:     convertRGBA8888ToAI88(data, dataLen, outData); return;
+        case PixelFormat::RGBA4444: convertRGBA8888ToRGBA4444(data, dataLen, outData); return;
+        case PixelFormat::RGB5A1:   convertRGBA8888ToRGB5A1(data, dataLen, outData); return;
+        default: break;
+        }
+        break;
+    default:
+        break;
+    }
+
+    // same format, or a format we can't convert
+    memcpy(outData, data, dataLen);
+}
+
 // implementation Texture2D (Text)
 bool Texture2D::initWithString(const std::string& text, const std::string& fontName, float fontSize, const Size& dimensions/* = Size(0, 0)*/, TextHAlignment hAlignment/* =  TextHAlignment::CENTER */, TextVAlignment vAlignment/* =  TextVAlignment::TOP */, bool enableWrap /* = false */, int overflow /* = 0 */)
 {
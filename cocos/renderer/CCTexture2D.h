@@ -114,6 +114,18 @@ public:
         ATC_EXPLICIT_ALPHA,
         //! ATITC-compressed texture: ATC_INTERPOLATED_ALPHA
         ATC_INTERPOLATED_ALPHA,
+        //! ETC2-compressed texture: ETC2_RGB8
+        ETC2_RGB,
+        //! ETC2-compressed texture: ETC2_RGBA8 (EAC alpha)
+        ETC2_RGBA,
+        //! ETC2-compressed texture: ETC2_RGB8 with punchthrough alpha
+        ETC2_RGB_A1,
+        //! ASTC-compressed texture: 4x4 block (8 bpp)
+        ASTC_4x4,
+        //! ASTC-compressed texture: 6x6 block (3.56 bpp)
+        ASTC_6x6,
+        //! ASTC-compressed texture: 8x8 block (2 bpp)
+        ASTC_8x8,
         //! Default texture format: AUTO
         DEFAULT = AUTO,
 
@@ -346,6 +358,14 @@ public:
     /** Whether or not the texture has mip maps.*/
     bool hasMipmaps() const;
 
+    /** Returns the Director frame in which the texture was last bound, 0 if it has never been bound. */
+    unsigned int getLastUsedFrame() const { return _lastUsedFrame; }
+
+    /** Records that the texture with the given GL name is bound by the frame being rendered.
+    * Called by GL::bindTexture2DN, please do not call it outside.
+    */
+    static void markTextureUsed(GLuint name);
+
     /** Gets the pixel format of the texture. */
     Texture2D::PixelFormat getPixelFormat() const;
 
@@ -460,6 +480,18 @@ private:
     static PixelFormat convertRGB888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertRGBA8888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
 
+    /**
+    Returns the format convertDataToFormat would produce for originFormat data, without converting anything.
+    */
+    static PixelFormat getConvertedFormat(PixelFormat originFormat, PixelFormat format);
+
+    /**
+    Convert dataLen bytes of originFormat pixels into format, writing into the caller owned outData.
+    outData must hold the converted size, and may not alias data. Use getConvertedFormat to learn which format is written.
+    Works on any whole number of pixels, so image decoders can convert one row at a time.
+    */
+    static void convertDataToBuffer(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char* outData);
+
     //I8 to XXX
     static void convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
     static void convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
@@ -523,6 +555,9 @@ protected:
     /** whether or not the texture has mip maps*/
     bool _hasMipmaps;
 
+    /** Director frame in which the texture was last bound */
+    unsigned int _lastUsedFrame;
+
     /** shader program used by drawAtPoint and drawInRect */
     GLProgram* _shaderProgram;
 
@@ -532,6 +567,7 @@ protected:
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
     friend class TextureCache;
+    friend class Image;
     friend class ui::Scale9Sprite;
 
     bool _valid;
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -47,6 +48,18 @@ using namespace std;
 
 NS_CC_BEGIN
 
+namespace
+{
+    size_t getTextureBytes(Texture2D* texture)
+    {
+        size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+        // a full mipmap chain adds a third of the base level
+        if (texture->hasMipmaps())
+            bytes += bytes / 3;
+        return bytes;
+    }
+}
+
 // implementation TextureCache
 
 TextureCache* TextureCache::getInstance()
@@ -58,6 +71,7 @@ TextureCache::TextureCache()
 : _loadingThread(nullptr)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _memoryBudget(0)
 {
 }
 
@@ -235,8 +249,15 @@ void TextureCache::loadImage()
             continue;
         }
 
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image->initWithImageFile(asyncStruct->filename);
+        // load image, decoding straight into the texture format unless the 9-patch parser needs RGBA8888
+        if (NinePatchImageParser::isNinePatchImage(asyncStruct->filename))
+        {
+            asyncStruct->loadSuccess = asyncStruct->image->initWithImageFile(asyncStruct->filename);
+        }
+        else
+        {
+            asyncStruct->loadSuccess = asyncStruct->image->initWithImageFile(asyncStruct->filename, asyncStruct->pixelFormat);
+        }
 
         // push the asyncStruct to response queue
         _responseMutex.lock();
@@ -296,7 +317,9 @@ void TextureCache::addImageAsyncCallBack(float dt)
 #endif
                 // cache the texture. retain it, since it is added in the map
                 _textures.insert( std::make_pair(asyncStruct->filename, texture) );
+                _imageKeys.erase(asyncStruct->filename);
                 texture->retain();
+                Texture2D::markTextureUsed(texture->getName());
 
                 texture->autorelease();
             } else {
@@ -316,6 +339,11 @@ void TextureCache::addImageAsyncCallBack(float dt)
         --_asyncRefCount;
     }
 
+    if (_memoryBudget > 0)
+    {
+        evictToBudget();
+    }
+
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
@@ -347,7 +375,9 @@ Texture2D * TextureCache::addImage(const std::string &path)
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = NinePatchImageParser::isNinePatchImage(path)
+                ? image->initWithImageFile(fullpath)
+                : image->initWithImageFile(fullpath, Texture2D::getDefaultAlphaPixelFormat());
             CC_BREAK_IF(!bRet);
 
             texture = new (std::nothrow) Texture2D();
@@ -360,9 +390,14 @@ Texture2D * TextureCache::addImage(const std::string &path)
 #endif
                 // texture already retained, no need to re-retain it
                 _textures.insert( std::make_pair(fullpath, texture) );
+                _imageKeys.erase(fullpath);
+                Texture2D::markTextureUsed(texture->getName());
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+
+                if (_memoryBudget > 0)
+                    evictToBudget();
             }
             else
             {
@@ -408,9 +443,14 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         if(texture && texture->initWithImage(image))
         {
             _textures.insert( std::make_pair(key, texture) );
+            _imageKeys.insert(key);
             texture->retain();
+            Texture2D::markTextureUsed(texture->getName());
 
             texture->autorelease();
+
+            if (_memoryBudget > 0)
+                evictToBudget();
         }
         else
         {
@@ -458,7 +498,7 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
+            bool bRet = image->initWithImageFile(fullpath, Texture2D::getDefaultAlphaPixelFormat());
             CC_BREAK_IF(!bRet);
 
             ret = texture->initWithImage(image);
@@ -487,6 +527,7 @@ void TextureCache::removeAllTextures()
         (it->second)->release();
     }
     _textures.clear();
+    _imageKeys.clear();
 }
 
 void TextureCache::removeUnusedTextures()
@@ -497,6 +538,7 @@ void TextureCache::removeUnusedTextures()
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
             tex->release();
+            _imageKeys.erase(it->first);
             it = _textures.erase(it);
         }
         else {
@@ -516,6 +558,7 @@ void TextureCache::removeTexture(Texture2D* texture)
     for( auto it=_textures.cbegin(); it!=_textures.cend(); /* nothing */ ) {
         if( it->second == texture ) {
             it->second->release();
+            _imageKeys.erase(it->first);
             it = _textures.erase(it);
             break;
         }
@@ -536,6 +579,7 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
 
     if( it != _textures.end() ) {
         (it->second)->release();
+        _imageKeys.erase(key);
         _textures.erase(it);
     }
 }
@@ -627,6 +671,79 @@ std::string TextureCache::getCachedTextureInfo() const
     return buffer;
 }
 
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    if (_memoryBudget > 0)
+    {
+        evictToBudget();
+    }
+}
+
+size_t TextureCache::getResidentBytes() const
+{
+    size_t totalBytes = 0;
+    for (auto& item : _textures)
+    {
+        totalBytes += getTextureBytes(item.second);
+    }
+    return totalBytes;
+}
+
+std::vector<TextureCache::TextureResidency> TextureCache::getTextureResidency() const
+{
+    std::vector<TextureResidency> residency;
+    residency.reserve(_textures.size());
+
+    for (auto& item : _textures)
+    {
+        Texture2D* tex = item.second;
+
+        TextureResidency info;
+        info.key = item.first;
+        info.texture = tex;
+        info.bytes = getTextureBytes(tex);
+        info.lastUsedFrame = tex->getLastUsedFrame();
+        residency.push_back(info);
+    }
+    return residency;
+}
+
+size_t TextureCache::evictToBudget()
+{
+    size_t totalBytes = getResidentBytes();
+    if (_memoryBudget == 0 || totalBytes <= _memoryBudget)
+        return 0;
+
+    auto currentFrame = Director::getInstance()->getTotalFrames();
+
+    // only textures that nobody but the cache holds and that can be reloaded from a file can be removed, oldest first
+    std::vector<TextureResidency> candidates;
+    for (auto& info : getTextureResidency())
+    {
+        if (info.texture->getReferenceCount() == 1 && info.lastUsedFrame < currentFrame && _imageKeys.count(info.key) == 0)
+            candidates.push_back(info);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const TextureResidency& a, const TextureResidency& b) {
+        return a.lastUsedFrame < b.lastUsedFrame;
+    });
+
+    size_t releasedBytes = 0;
+    for (auto& info : candidates)
+    {
+        if (totalBytes - releasedBytes <= _memoryBudget)
+            break;
+
+        CCLOG("cocos2d: TextureCache: evicting texture over budget: %s", info.key.c_str());
+        _textures.erase(info.key);
+        // VolatileTextureMgr drops its entry with the texture, addImage() reloads it from the file on demand
+        info.texture->release();
+        releasedBytes += info.bytes;
+    }
+
+    return releasedBytes;
+}
+
 void TextureCache::renameTextureWithKey(const std::string& srcName, const std::string& dstName)
 {
     std::string key = srcName;
@@ -650,6 +767,8 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
                 tex->initWithImage(image);
                 _textures.insert(std::make_pair(fullpath, tex));
                 _textures.erase(it);
+                // the texture is loaded from dstName now, it can be reloaded from the file
+                _imageKeys.erase(key);
             }
             CC_SAFE_RELEASE(image);
         }
@@ -817,7 +936,7 @@ void VolatileTextureMgr::reloadAllTextures()
 
                 Data data = FileUtils::getInstance()->getDataFromFile(vt->_fileName);
 
-                if (image && image->initWithImageData(data.getBytes(), data.getSize()))
+                if (image && image->initWithImageData(data.getBytes(), data.getSize(), vt->_pixelFormat))
                 {
                     Texture2D::PixelFormat oldPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
                     Texture2D::setDefaultAlphaPixelFormat(vt->_pixelFormat);
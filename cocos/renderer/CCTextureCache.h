@@ -34,7 +34,9 @@ THE SOFTWARE.
 #include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
@@ -212,6 +214,39 @@ public:
     */
     void renameTextureWithKey(const std::string& srcName, const std::string& dstName);
 
+    /** Residency of one cached texture, as returned by getTextureResidency(). */
+    struct TextureResidency
+    {
+        std::string key;
+        Texture2D* texture;
+        /** Estimated GPU memory of the texture in bytes, mipmaps included. */
+        size_t bytes;
+        /** Director frame in which the texture was last bound, 0 if it has never been bound. */
+        unsigned int lastUsedFrame;
+    };
+
+    /** Sets the texture memory budget in bytes.
+    * When the textures in the cache take up more than the budget, the textures that are only referenced by the cache
+    * are removed in least recently used order until the cache fits again. Removed textures are reloaded from their
+    * file the next time they are requested with addImage(), the textures added from an Image are never removed.
+    * @param bytes The budget in bytes, 0 disables the budget (the default).
+    */
+    void setMemoryBudget(size_t bytes);
+
+    /** Returns the texture memory budget in bytes, 0 if there is no budget. */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Returns the estimated GPU memory in bytes taken up by all the textures in the cache. */
+    size_t getResidentBytes() const;
+
+    /** Returns the size and last used frame of every texture in the cache. */
+    std::vector<TextureResidency> getTextureResidency() const;
+
+    /** Removes unused textures in least recently used order until the cache fits in the memory budget.
+    * Textures used in the current frame are never removed.
+    * @return The number of bytes released.
+    */
+    size_t evictToBudget();
 
 private:
     void addImageAsyncCallBack(float dt);
@@ -237,6 +272,10 @@ protected:
     int _asyncRefCount;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    size_t _memoryBudget;
+    // the keys of the textures added from an Image, they have no file to be reloaded from
+    std::unordered_set<std::string> _imageKeys;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
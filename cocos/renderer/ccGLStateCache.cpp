@@ -31,6 +31,11 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/ccConfig.h"
 #include "base/CCConfiguration.h"
+#include "renderer/CCTexture2D.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+#include <EGL/egl.h>
+#endif
 
 NS_CC_BEGIN
 
@@ -53,6 +58,14 @@ namespace
     static GLenum    s_activeTexture = -1;
 
 #endif // CC_ENABLE_GL_STATE_CACHE
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    typedef void (GL_APIENTRYP VertexAttribDivisorProc)(GLuint index, GLuint divisor);
+    typedef void (GL_APIENTRYP DrawElementsInstancedProc)(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei instanceCount);
+
+    static VertexAttribDivisorProc s_vertexAttribDivisor = nullptr;
+    static DrawElementsInstancedProc s_drawElementsInstanced = nullptr;
+#endif
 }
 
 // GL State Cache functions
@@ -157,6 +170,8 @@ void bindTexture2D(Texture2D* texture)
 
 void bindTexture2DN(GLuint textureUnit, GLuint textureId)
 {
+    // marked before the state cache skips the bind, the texture is used by this frame either way
+    Texture2D::markTextureUsed(textureId);
 #if CC_ENABLE_GL_STATE_CACHE
     CCASSERT(textureUnit < MAX_ACTIVE_TEXTURE, "textureUnit is too big");
     if (s_currentBoundTexture[textureUnit] != textureId)
@@ -261,6 +276,46 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+// Instanced drawing functions
+
+void vertexAttribDivisor(GLuint index, GLuint divisor)
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    s_vertexAttribDivisor(index, divisor);
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+    glVertexAttribDivisorEXT(index, divisor);
+#else
+    CCASSERT(false, "Instanced arrays are not supported on this platform");
+#endif
+}
+
+void drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei instanceCount)
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    s_drawElementsInstanced(mode, count, type, indices, instanceCount);
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+    glDrawElementsInstancedEXT(mode, count, type, indices, instanceCount);
+#else
+    CCASSERT(false, "Instanced arrays are not supported on this platform");
+#endif
+}
+
+bool loadInstancedArrays(const char* suffix)
+{
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    std::string divisorName = std::string("glVertexAttribDivisor") + suffix;
+    std::string drawName = std::string("glDrawElementsInstanced") + suffix;
+    s_vertexAttribDivisor = (VertexAttribDivisorProc)eglGetProcAddress(divisorName.c_str());
+    s_drawElementsInstanced = (DrawElementsInstancedProc)eglGetProcAddress(drawName.c_str());
+    return s_vertexAttribDivisor && s_drawElementsInstanced;
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_IOS
+    // GL_EXT_instanced_arrays is part of the iOS SDK
+    return strcmp(suffix, "EXT") == 0;
+#else
+    return false;
+#endif
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
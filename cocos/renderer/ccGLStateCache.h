@@ -175,6 +175,28 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/**
+ * Sets the divisor of a vertex attribute for instanced drawing.
+ *
+ * Only available when Configuration::supportsInstancedArrays() returns true.
+ */
+void CC_DLL vertexAttribDivisor(GLuint index, GLuint divisor);
+
+/**
+ * Draws instanceCount instances of the indexed primitives.
+ *
+ * Only available when Configuration::supportsInstancedArrays() returns true.
+ */
+void CC_DLL drawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices, GLsizei instanceCount);
+
+/**
+ * Resolves the instanced drawing functions, called by Configuration.
+ *
+ * @param suffix "" for the OpenGL ES 3 functions, or the extension suffix, "EXT" or "ANGLE".
+ * @return False if the functions are not available on this platform.
+ */
+bool CC_DLL loadInstancedArrays(const char* suffix);
+
 // end of support group
 /// @}
 
@@ -0,0 +1,52 @@
+/****************************************************************************
+Copyright (c) 2013-2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Expands a ParticleRecord to one corner of its quad: a_position is (x, y, size, rotation in degrees),
+// a_texCoord1 the corner, -0.5 or 0.5 on each axis.
+const char* ccParticleExpanded_vert = STRINGIFY(
+attribute vec4 a_position;
+attribute vec4 a_color;
+attribute vec2 a_texCoord;
+attribute vec2 a_texCoord1;
+
+\n#ifdef GL_ES\n
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+\n#else\n
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+\n#endif\n
+
+void main()
+{
+    float r = -radians(a_position.w);
+    float c = cos(r);
+    float s = sin(r);
+    vec2 corner = a_texCoord1 * a_position.z;
+    vec2 position = vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c) + a_position.xy;
+    gl_Position = CC_MVPMatrix * vec4(position, 0.0, 1.0);
+    v_fragmentColor = a_color;
+    v_texCoord = a_texCoord;
+}
+);
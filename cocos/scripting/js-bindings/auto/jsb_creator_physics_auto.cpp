@@ -8,6 +8,7 @@
 #include "editor-support/creator/physics/CCPhysicsRayCastCallback.h"
 #include "editor-support/creator/physics/CCPhysicsWorldManifoldWrapper.h"
 #include "editor-support/creator/physics/CCPhysicsContactImpulse.h"
+#include "editor-support/creator/physics/CCPhysicsRunner.h"
 
 se::Object* __jsb_creator_PhysicsDebugDraw_proto = nullptr;
 se::Class* __jsb_creator_PhysicsDebugDraw_class = nullptr;
@@ -1046,6 +1047,228 @@ bool js_register_creator_physics_PhysicsRayCastCallback(se::Object* obj)
     return true;
 }
 
+se::Object* __jsb_creator_PhysicsRunner_proto = nullptr;
+se::Class* __jsb_creator_PhysicsRunner_class = nullptr;
+
+static bool js_creator_physics_PhysicsRunner_waitForStep(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_waitForStep : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->waitForStep();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_waitForStep)
+
+static bool js_creator_physics_PhysicsRunner_setIterations(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_setIterations : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 2) {
+        int arg0 = 0;
+        int arg1 = 0;
+        ok &= seval_to_int32(args[0], (int32_t*)&arg0);
+        ok &= seval_to_int32(args[1], (int32_t*)&arg1);
+        SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_setIterations : Error processing arguments");
+        cobj->setIterations(arg0, arg1);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 2);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_setIterations)
+
+static bool js_creator_physics_PhysicsRunner_getMaxSubSteps(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_getMaxSubSteps : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        int result = cobj->getMaxSubSteps();
+        ok &= int32_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_getMaxSubSteps : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_getMaxSubSteps)
+
+static bool js_creator_physics_PhysicsRunner_stop(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_stop : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->stop();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_stop)
+
+static bool js_creator_physics_PhysicsRunner_setMaxSubSteps(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_setMaxSubSteps : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        int arg0 = 0;
+        ok &= seval_to_int32(args[0], (int32_t*)&arg0);
+        SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_setMaxSubSteps : Error processing arguments");
+        cobj->setMaxSubSteps(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_setMaxSubSteps)
+
+static bool js_creator_physics_PhysicsRunner_getFixedTimeStep(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_getFixedTimeStep : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        float result = cobj->getFixedTimeStep();
+        ok &= float_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_getFixedTimeStep : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_getFixedTimeStep)
+
+static bool js_creator_physics_PhysicsRunner_isRunning(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_isRunning : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 0) {
+        bool result = cobj->isRunning();
+        ok &= boolean_to_seval(result, &s.rval());
+        SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_isRunning : Error processing arguments");
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_isRunning)
+
+static bool js_creator_physics_PhysicsRunner_start(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_start : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    if (argc == 0) {
+        cobj->start();
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 0);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_start)
+
+static bool js_creator_physics_PhysicsRunner_setFixedTimeStep(se::State& s)
+{
+    creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+    SE_PRECONDITION2(cobj, false, "js_creator_physics_PhysicsRunner_setFixedTimeStep : Invalid Native Object");
+    const auto& args = s.args();
+    size_t argc = args.size();
+    CC_UNUSED bool ok = true;
+    if (argc == 1) {
+        float arg0 = 0;
+        ok &= seval_to_float(args[0], &arg0);
+        SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_setFixedTimeStep : Error processing arguments");
+        cobj->setFixedTimeStep(arg0);
+        return true;
+    }
+    SE_REPORT_ERROR("wrong number of arguments: %d, was expecting %d", (int)argc, 1);
+    return false;
+}
+SE_BIND_FUNC(js_creator_physics_PhysicsRunner_setFixedTimeStep)
+
+SE_DECLARE_FINALIZE_FUNC(js_creator_PhysicsRunner_finalize)
+
+static bool js_creator_physics_PhysicsRunner_constructor(se::State& s)
+{
+    CC_UNUSED bool ok = true;
+    const auto& args = s.args();
+    b2World* arg0 = nullptr;
+    creator::PhysicsUtils* arg1 = nullptr;
+    creator::PhysicsContactListener* arg2 = nullptr;
+    ok &= seval_to_native_ptr(args[0], &arg0);
+    ok &= seval_to_native_ptr(args[1], &arg1);
+    ok &= seval_to_native_ptr(args[2], &arg2);
+    SE_PRECONDITION2(ok, false, "js_creator_physics_PhysicsRunner_constructor : Error processing arguments");
+    creator::PhysicsRunner* cobj = new (std::nothrow) creator::PhysicsRunner(arg0, arg1, arg2);
+    s.thisObject()->setPrivateData(cobj);
+    se::NonRefNativePtrCreatedByCtorMap::emplace(cobj);
+    return true;
+}
+SE_BIND_CTOR(js_creator_physics_PhysicsRunner_constructor, __jsb_creator_PhysicsRunner_class, js_creator_PhysicsRunner_finalize)
+
+
+
+
+static bool js_creator_PhysicsRunner_finalize(se::State& s)
+{
+    CCLOGINFO("jsbindings: finalizing JS object %p (creator::PhysicsRunner)", s.nativeThisObject());
+    auto iter = se::NonRefNativePtrCreatedByCtorMap::find(s.nativeThisObject());
+    if (iter != se::NonRefNativePtrCreatedByCtorMap::end())
+    {
+        se::NonRefNativePtrCreatedByCtorMap::erase(iter);
+        creator::PhysicsRunner* cobj = (creator::PhysicsRunner*)s.nativeThisObject();
+        delete cobj;
+    }
+    return true;
+}
+SE_BIND_FINALIZE_FUNC(js_creator_PhysicsRunner_finalize)
+
+bool js_register_creator_physics_PhysicsRunner(se::Object* obj)
+{
+    auto cls = se::Class::create("PhysicsRunner", obj, nullptr, _SE(js_creator_physics_PhysicsRunner_constructor));
+
+    cls->defineFunction("waitForStep", _SE(js_creator_physics_PhysicsRunner_waitForStep));
+    cls->defineFunction("setIterations", _SE(js_creator_physics_PhysicsRunner_setIterations));
+    cls->defineFunction("getMaxSubSteps", _SE(js_creator_physics_PhysicsRunner_getMaxSubSteps));
+    cls->defineFunction("stop", _SE(js_creator_physics_PhysicsRunner_stop));
+    cls->defineFunction("setMaxSubSteps", _SE(js_creator_physics_PhysicsRunner_setMaxSubSteps));
+    cls->defineFunction("getFixedTimeStep", _SE(js_creator_physics_PhysicsRunner_getFixedTimeStep));
+    cls->defineFunction("isRunning", _SE(js_creator_physics_PhysicsRunner_isRunning));
+    cls->defineFunction("start", _SE(js_creator_physics_PhysicsRunner_start));
+    cls->defineFunction("setFixedTimeStep", _SE(js_creator_physics_PhysicsRunner_setFixedTimeStep));
+    cls->defineFinalizeFunction(_SE(js_creator_PhysicsRunner_finalize));
+    cls->install();
+    JSBClassType::registerClass<creator::PhysicsRunner>(cls);
+
+    __jsb_creator_PhysicsRunner_proto = cls->getProto();
+    __jsb_creator_PhysicsRunner_class = cls;
+
+    se::ScriptEngine::getInstance()->clearException();
+    return true;
+}
+
 bool register_all_creator_physics(se::Object* obj)
 {
     // Get the ns
@@ -1064,6 +1287,7 @@ bool register_all_creator_physics(se::Object* obj)
     js_register_creator_physics_PhysicsContactListener(ns);
     js_register_creator_physics_PhysicsContactImpulse(ns);
     js_register_creator_physics_PhysicsUtils(ns);
+    js_register_creator_physics_PhysicsRunner(ns);
     js_register_creator_physics_PhysicsWorldManifoldWrapper(ns);
     js_register_creator_physics_PhysicsAABBQueryCallback(ns);
     return true;
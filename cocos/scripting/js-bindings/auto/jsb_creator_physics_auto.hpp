@@ -93,3 +93,19 @@ SE_DECLARE_FUNC(js_creator_physics_PhysicsRayCastCallback_init);
 SE_DECLARE_FUNC(js_creator_physics_PhysicsRayCastCallback_getFractions);
 SE_DECLARE_FUNC(js_creator_physics_PhysicsRayCastCallback_PhysicsRayCastCallback);
 
+extern se::Object* __jsb_creator_PhysicsRunner_proto;
+extern se::Class* __jsb_creator_PhysicsRunner_class;
+
+bool js_register_creator_PhysicsRunner(se::Object* obj);
+bool register_all_creator_physics(se::Object* obj);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_waitForStep);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_setIterations);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_getMaxSubSteps);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_stop);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_setMaxSubSteps);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_getFixedTimeStep);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_isRunning);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_start);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_setFixedTimeStep);
+SE_DECLARE_FUNC(js_creator_physics_PhysicsRunner_PhysicsRunner);
+
@@ -6,6 +6,11 @@
 #include "cocos/scripting/js-bindings/auto/jsb_box2d_auto.hpp"
 
 #include "cocos/editor-support/creator/physics/CCPhysicsContactListener.h"
+#include "cocos/editor-support/creator/physics/CCPhysicsRunner.h"
+
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 bool seval_to_b2BodyDef(const se::Value& v, b2BodyDef* ret)
 {
@@ -1055,6 +1060,65 @@ static bool js_box2dclasses_b2ChainShape_CreateChain(se::State& s)
 }
 SE_BIND_FUNC(js_box2dclasses_b2ChainShape_CreateChain)
 
+namespace {
+    struct DestroyedObject
+    {
+        void* obj;
+        b2ObjectType type;
+        std::string typeName;
+    };
+
+    std::thread::id __mainThreadId;
+    std::mutex __destroyedObjectsMutex;
+    std::vector<DestroyedObject> __destroyedObjects;
+}
+
+static void onBox2DObjectDestroyed(void* obj, b2ObjectType type, const std::string& typeName)
+{
+    std::string typeNameStr = typeName;
+    auto cleanup = [obj, typeNameStr](){
+
+        if (!se::ScriptEngine::getInstance()->isValid())
+            return;
+
+        se::AutoHandleScope hs;
+        se::ScriptEngine::getInstance()->clearException();
+
+        auto iter = se::NativePtrToObjectMap::find(obj);
+        if (iter != se::NativePtrToObjectMap::end())
+        {
+//                CCLOG("%s, %p was recycled!", typeNameStr.c_str(), obj);
+            se::Object* seObj = iter->second;
+            seObj->clearPrivateData();
+            seObj->unroot();
+            seObj->decRef();
+        }
+        else
+        {
+//                 CCLOG("Didn't find %s, %p in map", typeNameStr.c_str(), obj);
+//                 assert(false);
+        }
+    };
+
+    if (!se::ScriptEngine::getInstance()->isGarbageCollecting())
+    {
+        cleanup();
+    }
+    else
+    {
+        CleanupTask::pushTaskToAutoReleasePool(cleanup);
+    }
+
+    if (type == b2ObjectType::FIXTURE)
+    {
+        const auto& instances = creator::PhysicsContactListener::getAllInstances();
+        for (auto listener : instances)
+        {
+            listener->unregisterContactFixture(reinterpret_cast<b2Fixture*>(obj));
+        }
+    }
+}
+
 bool register_all_box2d_manual(se::Object* obj)
 {
     __jsb_b2Shape_proto->defineFunction("SetRadius", _SE(js_box2dclasses_b2Shape_SetRadius));
@@ -1079,48 +1143,40 @@ bool register_all_box2d_manual(se::Object* obj)
 
     se::ScriptEngine::getInstance()->clearException();
 
+    __mainThreadId = std::this_thread::get_id();
     b2SetObjectDestroyNotifier([](void* obj, b2ObjectType type, const char* typeName){
+        // the contacts destroyed by the steps of a PhysicsRunner are released on the main thread
+        if (std::this_thread::get_id() != __mainThreadId)
+        {
+            std::lock_guard<std::mutex> lock(__destroyedObjectsMutex);
+            __destroyedObjects.push_back({obj, type, typeName});
+            return;
+        }
 
-        std::string typeNameStr = typeName;
-        auto cleanup = [obj, typeNameStr](){
-
-            if (!se::ScriptEngine::getInstance()->isValid())
-                return;
-
-            se::AutoHandleScope hs;
-            se::ScriptEngine::getInstance()->clearException();
-
-            auto iter = se::NativePtrToObjectMap::find(obj);
-            if (iter != se::NativePtrToObjectMap::end())
-            {
-//                CCLOG("%s, %p was recycled!", typeNameStr.c_str(), obj);
-                se::Object* seObj = iter->second;
-                seObj->clearPrivateData();
-                seObj->unroot();
-                seObj->decRef();
-            }
-            else
-            {
-//                 CCLOG("Didn't find %s, %p in map", typeNameStr.c_str(), obj);
-//                 assert(false);
-            }
-        };
+        onBox2DObjectDestroyed(obj, type, typeName);
+    });
 
-        if (!se::ScriptEngine::getInstance()->isGarbageCollecting())
+    creator::PhysicsRunner::setAfterStepCallback([](b2World* world){
+        std::vector<DestroyedObject> objects;
         {
-            cleanup();
+            std::lock_guard<std::mutex> lock(__destroyedObjectsMutex);
+            objects.swap(__destroyedObjects);
         }
-        else
+        if (objects.empty())
+            return;
+
+        // the memory of a destroyed contact may hold a newer contact by now, which keeps the script object
+        std::unordered_set<void*> liveContacts;
+        for (b2Contact* contact = world->GetContactList(); contact; contact = contact->GetNext())
         {
-            CleanupTask::pushTaskToAutoReleasePool(cleanup);
+            liveContacts.insert(contact);
         }
 
-        if (type == b2ObjectType::FIXTURE)
+        for (const auto& object : objects)
         {
-            const auto& instances = creator::PhysicsContactListener::getAllInstances();
-            for (auto listener : instances)
+            if (liveContacts.find(object.obj) == liveContacts.end())
             {
-                listener->unregisterContactFixture(reinterpret_cast<b2Fixture*>(obj));
+                onBox2DObjectDestroyed(object.obj, object.type, object.typeName);
             }
         }
     });
@@ -191,6 +191,21 @@ static bool js_creator_PhysicsContactListener_setEndContact(se::State& s)
                     se::ScriptEngine::getInstance()->clearException();
                     se::AutoHandleScope hs;
 
+                    // a snapshot stands for a destroyed contact, the script object of the contact is kept
+                    // so the scripts find what they stored on it, it only points to the snapshot for the call
+                    auto snapshot = dynamic_cast<creator::PhysicsContactSnapshot*>(larg0);
+                    se::Object* contactObj = nullptr;
+                    if (snapshot)
+                    {
+                        auto iter = se::NativePtrToObjectMap::find(snapshot->getContact());
+                        if (iter != se::NativePtrToObjectMap::end())
+                        {
+                            contactObj = iter->second;
+                            contactObj->clearPrivateData();
+                            contactObj->setPrivateData(snapshot);
+                        }
+                    }
+
                     CC_UNUSED bool ok = true;
                     se::ValueArray args;
                     args.resize(1);
@@ -202,6 +217,20 @@ static bool js_creator_PhysicsContactListener_setEndContact(se::State& s)
                     if (!succeed) {
                         se::ScriptEngine::getInstance()->clearException();
                     }
+
+                    // the snapshot lives on the stack of the caller
+                    if (contactObj)
+                    {
+                        contactObj->clearPrivateData();
+                        contactObj->setPrivateData(snapshot->getContact());
+                    }
+                    else if (snapshot && args[0].isObject())
+                    {
+                        se::Object* seObj = args[0].toObject();
+                        seObj->clearPrivateData();
+                        seObj->unroot();
+                        seObj->decRef();
+                    }
                 };
                 arg0 = lambda;
             }
@@ -86,6 +86,12 @@ _Class.PIXEL_FORMAT_S3TC_DXT5 = 17;
 _Class.PIXEL_FORMAT_ATC_RGB = 18;
 _Class.PIXEL_FORMAT_ATC_EXPLICIT_ALPHA = 19;
 _Class.PIXEL_FORMAT_ATC_INTERPOLATED_ALPHA = 20;
+_Class.PIXEL_FORMAT_ETC2_RGB = 21;
+_Class.PIXEL_FORMAT_ETC2_RGBA = 22;
+_Class.PIXEL_FORMAT_ETC2_RGB_A1 = 23;
+_Class.PIXEL_FORMAT_ASTC_4x4 = 24;
+_Class.PIXEL_FORMAT_ASTC_6x6 = 25;
+_Class.PIXEL_FORMAT_ASTC_8x8 = 26;
 _Class.PIXEL_FORMAT_DEFAULT = _Class.PIXEL_FORMAT_AUTO;
 _Class.defaultPixelFormat = _Class.PIXEL_FORMAT_DEFAULT;
 